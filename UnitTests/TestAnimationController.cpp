@@ -0,0 +1,199 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "framework/Game.h"
+#include "animation/AnimationController.h"
+#include "animation/Animation.h"
+#include "animation/AnimationClip.h"
+#include "animation/Joint.h"
+
+using namespace gameplay;
+
+class TestAnimationController : public ::testing::Test {
+protected:
+  static constexpr unsigned int JOINT_COUNT = 3;
+
+  // A joint that can be created outside of a skin.
+  class TestJoint : public Joint {
+  public:
+    TestJoint(const char* id) : Joint(id) {}
+  };
+
+  // Counts the end events of a clip and optionally plays it again from its end listener.
+  class EndListener : public AnimationClip::Listener {
+  public:
+    void animationEvent(AnimationClip* clip, EventType type) override {
+      if (type != END)
+        return;
+      ++endCount;
+      if (replay)
+        clip->play();
+    }
+
+    int endCount = 0;
+    bool replay = false;
+  };
+
+  void TearDown() override {
+    // Joints own their animations, which unschedule their clips from the controllers.
+    for (unsigned int i = 0; i < JOINT_COUNT; ++i) {
+      SAFE_RELEASE(joints[i]);
+      SAFE_RELEASE(references[i]);
+    }
+  }
+
+  // Creates the joints of a skin (a chain of three) and a matching chain of reference joints.
+  void createJoints() {
+    for (unsigned int i = 0; i < JOINT_COUNT; ++i) {
+      joints[i] = new TestJoint("joint");
+      references[i] = new TestJoint("reference");
+      if (i > 0) {
+        joints[i - 1]->addChild(joints[i]);
+        references[i - 1]->addChild(references[i]);
+      }
+    }
+  }
+
+  // Creates the clips of a joint on the given controller and plays them.
+  static void playClips(Joint* joint, unsigned int i, AnimationController* animationController) {
+    // A rotation and translation track with a "walk" and a "run" clip.
+    unsigned int keyTimes[] = { 0, 500, 1000, 1500, 2000 };
+    float keyValues[5 * 7];
+    for (unsigned int k = 0; k < 5; ++k) {
+      Quaternion rotation(Vector3(0.0f, 0.0f, 1.0f), 0.3f * (float)(k + i));
+      float* key = keyValues + k * 7;
+      key[0] = rotation.x;
+      key[1] = rotation.y;
+      key[2] = rotation.z;
+      key[3] = rotation.w;
+      key[4] = (float)k;
+      key[5] = (float)(i * 2) - (float)k * 0.5f;
+      key[6] = 0.25f * (float)(k * k);
+    }
+    Animation* motion = joint->createAnimation("motion", Transform::ANIMATE_ROTATE_TRANSLATE, 5, keyTimes, keyValues, Curve::LINEAR);
+    motion->setAnimationController(animationController);
+
+    // A scale track with a single clip.
+    unsigned int scaleTimes[] = { 0, 800 };
+    float scaleValues[] = { 1.0f, 1.0f, 1.0f, 2.0f + (float)i, 0.5f, 1.5f };
+    Animation* scale = joint->createAnimation("scale", Transform::ANIMATE_SCALE, 2, scaleTimes, scaleValues, Curve::SMOOTH);
+    scale->setAnimationController(animationController);
+
+    AnimationClip* walk = motion->createClip("walk", 0, 1000);
+    AnimationClip* run = motion->createClip("run", 1000, 1800);
+    AnimationClip* grow = scale->createClip("grow", 0, 800);
+    walk->setRepeatCount(AnimationClip::REPEAT_INDEFINITE);
+    run->setRepeatCount(AnimationClip::REPEAT_INDEFINITE);
+    run->setBlendWeight(0.35f);
+    grow->setRepeatCount(AnimationClip::REPEAT_INDEFINITE);
+    grow->setBlendWeight(0.6f);
+
+    walk->play();
+    grow->play();
+    run->play();
+  }
+
+  static void expectSamePose(Joint* expected, Joint* actual) {
+    EXPECT_FLOAT_EQ(expected->getScaleX(), actual->getScaleX());
+    EXPECT_FLOAT_EQ(expected->getScaleY(), actual->getScaleY());
+    EXPECT_FLOAT_EQ(expected->getScaleZ(), actual->getScaleZ());
+    const Quaternion& a = expected->getRotation();
+    const Quaternion& b = actual->getRotation();
+    EXPECT_FLOAT_EQ(a.x, b.x);
+    EXPECT_FLOAT_EQ(a.y, b.y);
+    EXPECT_FLOAT_EQ(a.z, b.z);
+    EXPECT_FLOAT_EQ(a.w, b.w);
+    EXPECT_FLOAT_EQ(expected->getTranslationX(), actual->getTranslationX());
+    EXPECT_FLOAT_EQ(expected->getTranslationY(), actual->getTranslationY());
+    EXPECT_FLOAT_EQ(expected->getTranslationZ(), actual->getTranslationZ());
+    const Matrix& world = expected->getWorldMatrix();
+    const Matrix& actualWorld = actual->getWorldMatrix();
+    for (int k = 0; k < 16; ++k)
+      EXPECT_NEAR(world.m[k], actualWorld.m[k], 1e-5f);
+  }
+
+  Game game;
+  AnimationController controller;
+  AnimationController referenceControllers[JOINT_COUNT];
+  Joint* joints[JOINT_COUNT] = {};
+  Joint* references[JOINT_COUNT] = {};
+};
+
+// Test that several blended clips on the joints of a skin give the same pose as applying the clips of each joint on their own
+TEST_F(TestAnimationController, PoseMatchesPerJointBlending) {
+  createJoints();
+
+  // The joints share one controller, while each reference joint has a controller of its own,
+  // which applies the values of its clips one after the other.
+  for (unsigned int i = 0; i < JOINT_COUNT; ++i) {
+    playClips(joints[i], i, &controller);
+    playClips(references[i], i, &referenceControllers[i]);
+  }
+
+  for (int frame = 0; frame < 40; ++frame) {
+    float elapsedTime = frame % 4 == 0 ? 16.0f : 45.0f;
+    controller.update(elapsedTime);
+    for (unsigned int i = 0; i < JOINT_COUNT; ++i)
+      referenceControllers[i].update(elapsedTime);
+    for (unsigned int i = 0; i < JOINT_COUNT; ++i)
+      expectSamePose(references[i], joints[i]);
+  }
+
+  // A stopped clip no longer contributes to the pose.
+  for (unsigned int i = 0; i < JOINT_COUNT; ++i) {
+    joints[i]->getAnimation("motion")->stop("run");
+    references[i]->getAnimation("motion")->stop("run");
+  }
+  for (int frame = 0; frame < 3; ++frame) {
+    controller.update(16.0f);
+    for (unsigned int i = 0; i < JOINT_COUNT; ++i)
+      referenceControllers[i].update(16.0f);
+  }
+  for (unsigned int i = 0; i < JOINT_COUNT; ++i) {
+    EXPECT_FALSE(joints[i]->getAnimation("motion")->getClip("run")->isPlaying());
+    expectSamePose(references[i], joints[i]);
+  }
+}
+
+// Test that a clip played again from its end listener after being stopped runs once, from its start
+TEST_F(TestAnimationController, StoppedClipPlayedFromEndListener) {
+  joints[0] = new TestJoint("joint");
+  unsigned int keyTimes[] = { 0, 1000, 2000 };
+  float keyValues[] = { 0.0f, 10.0f, 20.0f };
+  Animation* animation = joints[0]->createAnimation("slide", Transform::ANIMATE_TRANSLATE_X, 3, keyTimes, keyValues, Curve::LINEAR);
+  animation->setAnimationController(&controller);
+  AnimationClip* clip = animation->createClip("slide", 0, 2000);
+
+  EndListener listener;
+  clip->addEndListener(&listener);
+  clip->play();
+  controller.update(16.0f);
+  controller.update(100.0f);
+  EXPECT_FLOAT_EQ(1.0f, joints[0]->getTranslationX());
+  unsigned int refCount = clip->getRefCount();
+
+  // Stopping ends the clip, and its end listener plays it again from the start.
+  listener.replay = true;
+  clip->stop();
+  controller.update(100.0f);
+  EXPECT_EQ(1, listener.endCount);
+  EXPECT_TRUE(clip->isPlaying());
+  EXPECT_FLOAT_EQ(0.0f, joints[0]->getTranslationX());
+  EXPECT_EQ(refCount, clip->getRefCount());
+
+  // It is scheduled once, so it only advances by the elapsed time once per update.
+  controller.update(100.0f);
+  EXPECT_FLOAT_EQ(1.0f, joints[0]->getTranslationX());
+  controller.update(100.0f);
+  EXPECT_FLOAT_EQ(2.0f, joints[0]->getTranslationX());
+
+  // Stopped again without replaying, it ends for good.
+  listener.replay = false;
+  clip->stop();
+  controller.update(100.0f);
+  EXPECT_EQ(2, listener.endCount);
+  EXPECT_FALSE(clip->isPlaying());
+  controller.update(100.0f);
+  EXPECT_FALSE(clip->isPlaying());
+  EXPECT_FLOAT_EQ(2.0f, joints[0]->getTranslationX());
+}
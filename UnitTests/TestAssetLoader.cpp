@@ -0,0 +1,144 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "framework/AssetLoader.h"
+
+using namespace gameplay;
+
+class TestAssetLoader : public ::testing::Test {
+protected:
+  void SetUp() override {
+    loader = new AssetLoader(0);
+  }
+
+  void TearDown() override {
+    delete loader;
+  }
+
+  AssetLoader* loader;
+};
+
+// Test that queued requests load highest priority first, and in request order within a priority
+TEST_F(TestAssetLoader, LoadsInPriorityOrder) {
+  std::vector<int> order;
+  auto record = [&order](int id) { return [&order, id]() { order.push_back(id); return true; }; };
+
+  loader->load("a", record(0), nullptr, 0);
+  loader->load("b", record(1), nullptr, 5);
+  loader->load("c", record(2), nullptr, 0);
+  loader->load("d", record(3), nullptr, 10);
+  AssetLoader::Request* e = loader->load("e", record(4), nullptr, 0);
+  loader->setPriority(e, 7);
+  EXPECT_EQ(loader->getPendingCount(), 5u);
+
+  loader->update(1000.0f);
+
+  ASSERT_EQ(order.size(), 5u);
+  EXPECT_EQ(order[0], 3);
+  EXPECT_EQ(order[1], 4);
+  EXPECT_EQ(order[2], 1);
+  EXPECT_EQ(order[3], 0);
+  EXPECT_EQ(order[4], 2);
+  EXPECT_EQ(loader->getPendingCount(), 0u);
+}
+
+// Test that loads run on the I/O threads and finalization on the thread calling update()
+TEST_F(TestAssetLoader, FinalizesOnCallingThread) {
+  AssetLoader threaded(2);
+  EXPECT_EQ(threaded.getThreadCount(), 2u);
+
+  std::thread::id caller = std::this_thread::get_id();
+  std::atomic<int> loaded(0);
+  int finalized = 0;
+  for (int i = 0; i < 16; ++i) {
+    threaded.load("asset",
+      [&]() { EXPECT_NE(std::this_thread::get_id(), caller); ++loaded; return true; },
+      [&](bool ok) { EXPECT_TRUE(ok); EXPECT_EQ(std::this_thread::get_id(), caller); ++finalized; return true; });
+  }
+
+  while (threaded.getPendingCount() > 0) {
+    threaded.update(1000.0f);
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(loaded, 16);
+  EXPECT_EQ(finalized, 16);
+}
+
+// Test that a cancelled request never finalizes and releases the data it captured
+TEST_F(TestAssetLoader, CancelDiscardsResult) {
+  std::shared_ptr<int> data(new int(42));
+  std::weak_ptr<int> watch = data;
+  bool finalized = false;
+
+  AssetLoader::Request* request = loader->load("cancelled", [data]() { return true; },
+    [data, &finalized](bool) { finalized = true; return true; });
+  data.reset();
+  request->addRef();
+
+  loader->cancel(request);
+  EXPECT_EQ(request->getState(), AssetLoader::Request::CANCELLED);
+  EXPECT_TRUE(request->isDone());
+  EXPECT_TRUE(watch.expired());
+  EXPECT_EQ(loader->getPendingCount(), 0u);
+
+  loader->update(1000.0f);
+  EXPECT_FALSE(finalized);
+  request->release();
+}
+
+// Test that finish() completes a request immediately, even when the I/O thread is busy
+TEST_F(TestAssetLoader, FinishLoadsImmediately) {
+  AssetLoader threaded(1);
+  std::atomic<bool> started(false);
+  std::atomic<bool> release(false);
+  threaded.load("slow", [&]() { started = true; while (!release) std::this_thread::yield(); return true; }, nullptr);
+  while (!started)
+    std::this_thread::yield();
+
+  bool finalized = false;
+  AssetLoader::Request* request = threaded.load("urgent", []() { return true; },
+    [&finalized](bool) { finalized = true; return true; });
+  request->addRef();
+  EXPECT_EQ(request->getState(), AssetLoader::Request::QUEUED);
+
+  EXPECT_TRUE(threaded.finish(request));
+  EXPECT_TRUE(finalized);
+  EXPECT_EQ(request->getState(), AssetLoader::Request::COMPLETE);
+  EXPECT_EQ(threaded.getPendingCount(), 1u);
+  request->release();
+
+  release = true;
+}
+
+// Test that a failed load still finalizes, with its result, and marks the request failed
+TEST_F(TestAssetLoader, FailedLoad) {
+  bool result = true;
+  AssetLoader::Request* request = loader->load("missing", []() { return false; },
+    [&result](bool ok) { result = ok; return ok; });
+  request->addRef();
+
+  loader->update(1000.0f);
+  EXPECT_FALSE(result);
+  EXPECT_EQ(request->getState(), AssetLoader::Request::FAILED);
+  request->release();
+}
+
+// Test that update() stops finalizing once its time budget is spent, but always makes progress
+TEST_F(TestAssetLoader, UpdateRespectsBudget) {
+  static constexpr int REQUEST_COUNT = 5;
+  int finalized = 0;
+  for (int i = 0; i < REQUEST_COUNT; ++i) {
+    loader->load("slow", nullptr, [&finalized](bool) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      ++finalized;
+      return true;
+    });
+  }
+
+  loader->update(1.0f);
+  EXPECT_EQ(finalized, 1);
+  loader->update(0.0f);
+  EXPECT_EQ(finalized, 2);
+  loader->update(1000.0f);
+  EXPECT_EQ(finalized, REQUEST_COUNT);
+}
@@ -0,0 +1,127 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "graphics/Curve.h"
+
+using namespace gameplay;
+
+class TestCurve : public ::testing::Test {
+protected:
+  void SetUp() override {
+    // A mocap-like curve: one key per frame at 120 frames per second.
+    curve = Curve::create(KEY_COUNT, COMPONENTS);
+    for (unsigned int i = 0; i < KEY_COUNT; ++i) {
+      float time = (float)i / (float)(KEY_COUNT - 1);
+      float value[COMPONENTS] = { sinf(time * 40.0f), cosf(time * 25.0f), time * 3.0f };
+      curve->setPoint(i, time, value, Curve::LINEAR);
+    }
+  }
+
+  void TearDown() override {
+    SAFE_RELEASE(curve);
+  }
+
+  static constexpr unsigned int KEY_COUNT = 120 * 60 * 2;
+  static constexpr unsigned int COMPONENTS = 3;
+  Curve* curve;
+};
+
+TEST_F(TestCurve, CursorMatchesSearch) {
+  Curve::Cursor cursor;
+  float expected[COMPONENTS];
+  float actual[COMPONENTS];
+
+  // Forward, backward and jumping playback.
+  for (int i = 0; i <= 1000; ++i) {
+    float time = (float)i / 1000.0f;
+    curve->evaluate(time, 0.0f, 1.0f, 0.0f, expected);
+    curve->evaluate(time, 0.0f, 1.0f, 0.0f, actual, &cursor);
+    for (unsigned int j = 0; j < COMPONENTS; ++j)
+      EXPECT_EQ(actual[j], expected[j]);
+  }
+  for (int i = 1000; i >= 0; --i) {
+    float time = (float)i / 1000.0f;
+    curve->evaluate(time, 0.0f, 1.0f, 0.0f, expected);
+    curve->evaluate(time, 0.0f, 1.0f, 0.0f, actual, &cursor);
+    for (unsigned int j = 0; j < COMPONENTS; ++j)
+      EXPECT_EQ(actual[j], expected[j]);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    float time = (float)((i * 7919) % 1000) / 1000.0f;
+    curve->evaluate(time, 0.0f, 1.0f, 0.0f, expected);
+    curve->evaluate(time, 0.0f, 1.0f, 0.0f, actual, &cursor);
+    for (unsigned int j = 0; j < COMPONENTS; ++j)
+      EXPECT_EQ(actual[j], expected[j]);
+  }
+}
+
+TEST_F(TestCurve, CursorWithSubregion) {
+  Curve::Cursor cursor;
+  float expected[COMPONENTS];
+  float actual[COMPONENTS];
+  for (int i = 0; i <= 500; ++i) {
+    float time = (float)i / 500.0f;
+    curve->evaluate(time, 0.25f, 0.5f, 0.0f, expected);
+    curve->evaluate(time, 0.25f, 0.5f, 0.0f, actual, &cursor);
+    for (unsigned int j = 0; j < COMPONENTS; ++j)
+      EXPECT_EQ(actual[j], expected[j]);
+
+    // Switching subregions with the same cursor must not reuse the cached range.
+    curve->evaluate(time, 0.5f, 0.75f, 0.0f, expected);
+    curve->evaluate(time, 0.5f, 0.75f, 0.0f, actual, &cursor);
+    for (unsigned int j = 0; j < COMPONENTS; ++j)
+      EXPECT_EQ(actual[j], expected[j]);
+  }
+}
+
+TEST_F(TestCurve, Bake) {
+  EXPECT_EQ(curve->getBakedSampleCount(), 0u);
+
+  // Sampling at the key rate reproduces a linear curve.
+  float expected[COMPONENTS];
+  float baked[COMPONENTS];
+  std::vector<float> reference(1001 * COMPONENTS);
+  for (int i = 0; i <= 1000; ++i)
+    curve->evaluate((float)i / 1000.0f, &reference[i * COMPONENTS]);
+
+  curve->bake(KEY_COUNT);
+  EXPECT_EQ(curve->getBakedSampleCount(), KEY_COUNT);
+  for (int i = 0; i <= 1000; ++i) {
+    curve->evaluate((float)i / 1000.0f, baked);
+    for (unsigned int j = 0; j < COMPONENTS; ++j)
+      EXPECT_NEAR(baked[j], reference[i * COMPONENTS + j], 1e-4f);
+  }
+
+  // Changing a point discards the samples.
+  curve->getPointValues(10, expected, nullptr, nullptr);
+  curve->setPoint(10, curve->getPointTime(10), expected, Curve::LINEAR);
+  EXPECT_EQ(curve->getBakedSampleCount(), 0u);
+}
+
+TEST_F(TestCurve, Compress) {
+  Curve* compressed = curve->compress();
+  ASSERT_TRUE(compressed != nullptr);
+  EXPECT_TRUE(compressed->isCompressed());
+  EXPECT_FALSE(curve->isCompressed());
+  EXPECT_EQ(compressed->getPointCount(), curve->getPointCount());
+  EXPECT_TRUE(compressed->compress() == nullptr);
+  EXPECT_LT(compressed->getDataSize() * 2, curve->getDataSize());
+
+  // Values stay within half a quantization step of the range of each component.
+  const float tolerance[COMPONENTS] = { 2.0f / 65535.0f, 2.0f / 65535.0f, 3.0f / 65535.0f };
+  Curve::Cursor cursor;
+  float expected[COMPONENTS];
+  float actual[COMPONENTS];
+  float cursorValue[COMPONENTS];
+  for (int i = 0; i <= 1000; ++i) {
+    float time = (float)i / 1000.0f;
+    curve->evaluate(time, 0.25f, 0.75f, 0.0f, expected);
+    compressed->evaluate(time, 0.25f, 0.75f, 0.0f, actual);
+    compressed->evaluate(time, 0.25f, 0.75f, 0.0f, cursorValue, &cursor);
+    for (unsigned int j = 0; j < COMPONENTS; ++j) {
+      EXPECT_NEAR(actual[j], expected[j], tolerance[j]);
+      EXPECT_EQ(cursorValue[j], actual[j]);
+    }
+  }
+  SAFE_RELEASE(compressed);
+}
@@ -0,0 +1,86 @@
+#include "pch.h"
+
+#include <cstdio>
+
+#include "framework/Base.h"
+#include "framework/FileSystem.h"
+#include "framework/Stream.h"
+
+using namespace gameplay;
+
+class TestFileSystem : public ::testing::Test {
+protected:
+  void SetUp() override {
+    writeFile(PATH, CONTENTS, sizeof(CONTENTS) - 1);
+    writeFile(EMPTY_PATH, "", 0);
+  }
+
+  void TearDown() override {
+    remove(PATH);
+    remove(EMPTY_PATH);
+  }
+
+  static void writeFile(const char* path, const char* contents, size_t length) {
+    Stream* stream = FileSystem::open(path, FileSystem::WRITE);
+    ASSERT_TRUE(stream != nullptr);
+    EXPECT_EQ(stream->write(contents, 1, length), length);
+    SAFE_DELETE(stream);
+  }
+
+  static constexpr const char* PATH = "TestFileSystem.bin";
+  static constexpr const char* EMPTY_PATH = "TestFileSystemEmpty.bin";
+  static constexpr const char CONTENTS[] = "first line\nsecond line\n0123456789";
+};
+
+// Test that a mapped stream reads the same bytes as a regular stream
+TEST_F(TestFileSystem, MappedStreamMatchesFileStream) {
+  Stream* file = FileSystem::open(PATH);
+  Stream* mapped = FileSystem::open(PATH, FileSystem::READ | FileSystem::MAPPED);
+  ASSERT_TRUE(file != nullptr);
+  ASSERT_TRUE(mapped != nullptr);
+
+  EXPECT_TRUE(file->data() == nullptr);
+  ASSERT_TRUE(mapped->data() != nullptr);
+  EXPECT_EQ(memcmp(mapped->data(), CONTENTS, sizeof(CONTENTS) - 1), 0);
+  EXPECT_EQ(mapped->length(), file->length());
+  EXPECT_TRUE(mapped->canRead());
+  EXPECT_FALSE(mapped->canWrite());
+
+  char expected[32];
+  char actual[32];
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_TRUE(file->readLine(expected, sizeof(expected)) != nullptr);
+    ASSERT_TRUE(mapped->readLine(actual, sizeof(actual)) != nullptr);
+    EXPECT_STREQ(actual, expected);
+  }
+
+  // Only whole elements are counted at the end of the stream.
+  EXPECT_EQ(mapped->read(actual, 4, 8), file->read(expected, 4, 8));
+  EXPECT_EQ(memcmp(actual, expected, 8), 0);
+  EXPECT_EQ(mapped->position(), file->position());
+
+  EXPECT_TRUE(mapped->seek(-4, SEEK_END));
+  EXPECT_TRUE(file->seek(-4, SEEK_END));
+  EXPECT_EQ(mapped->read(actual, 1, 8), file->read(expected, 1, 8));
+  EXPECT_EQ(memcmp(actual, expected, 4), 0);
+  EXPECT_TRUE(mapped->eof());
+  EXPECT_TRUE(mapped->readLine(actual, sizeof(actual)) == nullptr);
+
+  EXPECT_TRUE(mapped->rewind());
+  EXPECT_EQ(mapped->position(), 0);
+  EXPECT_FALSE(mapped->seek(1, SEEK_END));
+  EXPECT_FALSE(mapped->seek(-1, SEEK_SET));
+  EXPECT_EQ(mapped->position(), 0);
+
+  SAFE_DELETE(file);
+  SAFE_DELETE(mapped);
+}
+
+// Test that files which cannot be mapped open as regular streams
+TEST_F(TestFileSystem, EmptyFileIsNotMapped) {
+  Stream* stream = FileSystem::open(EMPTY_PATH, FileSystem::READ | FileSystem::MAPPED);
+  ASSERT_TRUE(stream != nullptr);
+  EXPECT_TRUE(stream->data() == nullptr);
+  EXPECT_EQ(stream->length(), 0u);
+  SAFE_DELETE(stream);
+}
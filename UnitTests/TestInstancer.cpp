@@ -0,0 +1,77 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "renderer/Instancer.h"
+
+using namespace gameplay;
+
+class TestInstancer : public ::testing::Test {
+protected:
+  // Grouping never dereferences models, meshes or materials, so tests can use distinct fake pointers.
+  template <class T>
+  static T* fake(uintptr_t id) {
+    return reinterpret_cast<T*>(id * 16);
+  }
+
+  static Matrix translation(float x) {
+    return Matrix::createTranslation(x, 0.0f, 0.0f);
+  }
+};
+
+// Test that instances are grouped by mesh and material, contiguously and in the order they were added
+TEST_F(TestInstancer, Build) {
+  static constexpr int instanceCount = 30;
+  Mesh* meshes[2] = { fake<Mesh>(1), fake<Mesh>(2) };
+  Material* materials[2] = { fake<Material>(3), fake<Material>(4) };
+
+  Instancer instancer;
+  for (int i = 0; i < instanceCount; ++i) {
+    // Cycles through groups (mesh 0, material 0), (mesh 1, material 0) and (mesh 0, material 1).
+    int g = i % 3;
+    instancer.add(fake<Model>(100 + i), meshes[g == 1], materials[g == 2], translation((float)i));
+  }
+  instancer.build();
+
+  ASSERT_EQ(3u, instancer.getGroupCount());
+  ASSERT_EQ((unsigned int)instanceCount, instancer.getInstanceCount());
+  EXPECT_EQ(0u, instancer.getSingleModelCount());
+  for (unsigned int g = 0; g < 3; ++g) {
+    const Instancer::Group& group = instancer.getGroup(g);
+    EXPECT_EQ(meshes[g == 1], group.mesh);
+    EXPECT_EQ(materials[g == 2], group.material);
+    EXPECT_EQ(g * instanceCount / 3, group.first);
+    EXPECT_EQ((unsigned int)instanceCount / 3, group.count);
+    for (unsigned int k = 0; k < group.count; ++k) {
+      int i = (int)(k * 3 + g);
+      EXPECT_EQ(fake<Model>(100 + i), instancer.getInstanceModel(group.first + k));
+      EXPECT_EQ((float)i, instancer.getInstanceMatrix(group.first + k).m[12]);
+    }
+  }
+
+  // Building again gives the same layout.
+  instancer.build();
+  ASSERT_EQ(3u, instancer.getGroupCount());
+  EXPECT_EQ(20u, instancer.getGroup(2).first);
+  EXPECT_EQ(fake<Model>(102), instancer.getInstanceModel(20));
+}
+
+// Test that clearing removes every group, and that groups are numbered again from the next instance added
+TEST_F(TestInstancer, Clear) {
+  Instancer instancer;
+  instancer.add(fake<Model>(1), fake<Mesh>(1), fake<Material>(1), Matrix::identity());
+  instancer.add(fake<Model>(2), fake<Mesh>(2), fake<Material>(1), Matrix::identity());
+  instancer.build();
+  ASSERT_EQ(2u, instancer.getGroupCount());
+
+  instancer.clear();
+  EXPECT_EQ(0u, instancer.getGroupCount());
+  EXPECT_EQ(0u, instancer.getInstanceCount());
+
+  instancer.add(fake<Model>(3), fake<Mesh>(2), fake<Material>(1), translation(5.0f));
+  instancer.build();
+  ASSERT_EQ(1u, instancer.getGroupCount());
+  EXPECT_EQ(fake<Mesh>(2), instancer.getGroup(0).mesh);
+  EXPECT_EQ(0u, instancer.getGroup(0).first);
+  EXPECT_EQ(1u, instancer.getGroup(0).count);
+  EXPECT_EQ(5.0f, instancer.getInstanceMatrix(0).m[12]);
+}
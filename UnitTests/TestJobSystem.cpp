@@ -0,0 +1,163 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "framework/JobSystem.h"
+
+using namespace gameplay;
+
+class TestJobSystem : public ::testing::Test {
+protected:
+  void SetUp() override {
+    jobs = new JobSystem(3);
+  }
+
+  void TearDown() override {
+    delete jobs;
+  }
+
+  JobSystem* jobs;
+};
+
+// Test that every iteration of a parallel loop runs exactly once
+TEST_F(TestJobSystem, ParallelForRunsEveryIteration) {
+  EXPECT_EQ(jobs->getWorkerCount(), 3u);
+
+  std::vector<int> hits(1000, 0);
+  for (int pass = 0; pass < 20; ++pass) {
+    jobs->parallelFor((unsigned int)hits.size(), [&hits](unsigned int i) { ++hits[i]; });
+  }
+
+  for (size_t i = 0; i < hits.size(); ++i)
+    EXPECT_EQ(hits[i], 20);
+}
+
+// Test that parallel loops can be nested inside each other
+TEST_F(TestJobSystem, NestedParallelFor) {
+  std::atomic<unsigned int> total(0);
+  jobs->parallelFor(16, [&](unsigned int) {
+    jobs->parallelFor(64, [&](unsigned int) { ++total; });
+  });
+  EXPECT_EQ(total, 16u * 64u);
+}
+
+// Test that a job system without workers runs everything on the calling thread
+TEST_F(TestJobSystem, NoWorkers) {
+  JobSystem inline_(0);
+  std::thread::id caller = std::this_thread::get_id();
+  int count = 0;
+  inline_.parallelFor(10, [&](unsigned int) {
+    EXPECT_EQ(std::this_thread::get_id(), caller);
+    ++count;
+  });
+  EXPECT_EQ(count, 10);
+
+  TaskGraph graph;
+  graph.addTask("a", [&]() { ++count; });
+  inline_.run(graph);
+  EXPECT_EQ(count, 11);
+}
+
+// Test that tasks start only after all of their dependencies have finished
+TEST_F(TestJobSystem, TaskGraphRespectsDependencies) {
+  std::mutex mutex;
+  std::vector<std::string> order;
+  auto record = [&](const char* name) {
+    return [&, name]() {
+      std::lock_guard<std::mutex> lock(mutex);
+      order.push_back(name);
+    };
+  };
+
+  TaskGraph graph;
+  TaskGraph::Task a = graph.addTask("a", record("a"));
+  TaskGraph::Task b = graph.addTask("b", record("b"));
+  TaskGraph::Task c = graph.addTask("c", record("c"));
+  TaskGraph::Task d = graph.addTask("d", record("d"));
+  graph.addDependency(a, b);
+  graph.addDependency(a, c);
+  graph.addDependency(b, d);
+  graph.addDependency(c, d);
+
+  for (int pass = 0; pass < 50; ++pass) {
+    order.clear();
+    jobs->run(graph);
+    ASSERT_EQ(order.size(), 4u);
+    EXPECT_EQ(order.front(), "a");
+    EXPECT_EQ(order.back(), "d");
+  }
+}
+
+// Test that main-thread tasks run on the thread that created the job system
+TEST_F(TestJobSystem, MainThreadTasks) {
+  std::thread::id mainThread = std::this_thread::get_id();
+  std::atomic<unsigned int> count(0);
+
+  TaskGraph graph;
+  TaskGraph::Task previous = TaskGraph::INVALID_TASK;
+  for (int i = 0; i < 8; ++i) {
+    TaskGraph::Task task = graph.addTask("main", [&]() {
+      EXPECT_EQ(std::this_thread::get_id(), mainThread);
+      ++count;
+    }, true);
+    if (previous != TaskGraph::INVALID_TASK)
+      graph.addDependency(previous, task);
+    previous = graph.addTask("worker", [&]() { ++count; });
+    graph.addDependency(task, previous);
+  }
+
+  jobs->run(graph);
+  EXPECT_EQ(count, 16u);
+}
+
+// Test that a main-thread task waiting on a parallel loop does not run other main-thread tasks meanwhile
+TEST_F(TestJobSystem, MainThreadTasksAreNotNested) {
+  std::atomic<bool> inside(false);
+  std::atomic<unsigned int> nested(0);
+  std::atomic<unsigned int> count(0);
+
+  TaskGraph graph;
+  for (int i = 0; i < 4; ++i) {
+    graph.addTask("main", [&]() {
+      if (inside.exchange(true))
+        ++nested;
+      jobs->parallelFor(256, [&](unsigned int) { ++count; });
+      inside = false;
+    }, true);
+  }
+
+  for (int pass = 0; pass < 20; ++pass)
+    jobs->run(graph);
+  EXPECT_EQ(nested, 0u);
+  EXPECT_EQ(count, 20u * 4u * 256u);
+}
+
+// Test that graphs without main-thread tasks can be run from inside a job
+TEST_F(TestJobSystem, NestedTaskGraph) {
+  std::atomic<unsigned int> count(0);
+  jobs->parallelFor(8, [&](unsigned int) {
+    TaskGraph graph;
+    TaskGraph::Task first = graph.addTask("first", [&]() { ++count; });
+    TaskGraph::Task second = graph.addTask("second", [&]() { ++count; });
+    graph.addDependency(first, second);
+    jobs->run(graph);
+  });
+  EXPECT_EQ(count, 16u);
+}
+
+// Test task lookup and disabling
+TEST_F(TestJobSystem, DisabledTasksAreSkipped) {
+  int ran = 0;
+  TaskGraph graph;
+  TaskGraph::Task first = graph.addTask("first", [&]() { ran |= 1; });
+  TaskGraph::Task second = graph.addTask("second", [&]() { ran |= 2; });
+  graph.addDependency(first, second);
+
+  EXPECT_EQ(graph.findTask("second"), second);
+  EXPECT_EQ(graph.findTask("missing"), TaskGraph::INVALID_TASK);
+  EXPECT_STREQ(graph.getTaskName(first), "first");
+
+  graph.setTaskEnabled(first, false);
+  EXPECT_FALSE(graph.isTaskEnabled(first));
+  jobs->run(graph);
+  EXPECT_EQ(ran, 2);
+}
@@ -0,0 +1,219 @@
+#include "pch.h"
+
+#include <vector>
+
+#include "framework/Base.h"
+#include "math/Matrix.h"
+#include "math/Vector3.h"
+#include "math/Vector4.h"
+
+using namespace gameplay;
+
+namespace
+{
+  // Plain scalar reference implementations, used to validate the SIMD kernels.
+  void referenceMultiply(const float* a, const float* b, float* dst)
+  {
+    float product[16];
+    for (int col = 0; col < 4; ++col)
+    {
+      for (int row = 0; row < 4; ++row)
+      {
+        float sum = 0.0f;
+        for (int k = 0; k < 4; ++k)
+          sum += a[k * 4 + row] * b[col * 4 + k];
+        product[col * 4 + row] = sum;
+      }
+    }
+    memcpy(dst, product, sizeof(product));
+  }
+
+  void referenceTransform(const float* m, const float* v, float* dst)
+  {
+    float result[4];
+    for (int row = 0; row < 4; ++row)
+      result[row] = m[row] * v[0] + m[4 + row] * v[1] + m[8 + row] * v[2] + m[12 + row] * v[3];
+    memcpy(dst, result, sizeof(result));
+  }
+
+  Matrix randomMatrix(unsigned int& seed)
+  {
+    Matrix result;
+    for (int i = 0; i < 16; ++i)
+    {
+      seed = seed * 1664525u + 1013904223u;
+      result.m[i] = (float)(seed >> 8) / (float)(1u << 24) * 4.0f - 2.0f;
+    }
+    return result;
+  }
+}
+
+class TestMatrix : public ::testing::Test {
+protected:
+  void SetUp() override {
+    unsigned int seed = 12345;
+    for (int i = 0; i < COUNT; ++i) {
+      a.push_back(randomMatrix(seed));
+      b.push_back(randomMatrix(seed));
+    }
+  }
+
+  void TearDown() override {
+    a.clear();
+    b.clear();
+  }
+
+  static const int COUNT = 64;
+  std::vector<Matrix> a;
+  std::vector<Matrix> b;
+};
+
+// Test single matrix multiplication against the scalar reference
+TEST_F(TestMatrix, MultiplyMatchesReference) {
+  for (int i = 0; i < COUNT; ++i) {
+    Matrix result;
+    float expected[16];
+    Matrix::multiply(a[i], b[i], &result);
+    referenceMultiply(a[i].m, b[i].m, expected);
+    for (int j = 0; j < 16; ++j)
+      EXPECT_NEAR(result.m[j], expected[j], 1e-4f);
+  }
+}
+
+// Test multiplication when the destination is also an operand
+TEST_F(TestMatrix, MultiplyInPlace) {
+  float expected[16];
+  referenceMultiply(a[0].m, b[0].m, expected);
+  Matrix::multiply(a[0], b[0], &a[0]);
+  for (int j = 0; j < 16; ++j)
+    EXPECT_NEAR(a[0].m[j], expected[j], 1e-4f);
+
+  referenceMultiply(a[1].m, b[1].m, expected);
+  Matrix::multiply(a[1], b[1], &b[1]);
+  for (int j = 0; j < 16; ++j)
+    EXPECT_NEAR(b[1].m[j], expected[j], 1e-4f);
+}
+
+// Test that the batched multiplication matches multiplying one pair at a time
+TEST_F(TestMatrix, BatchedMultiplyMatchesReference) {
+  std::vector<Matrix> result(COUNT);
+  Matrix::multiply(a.data(), b.data(), COUNT, result.data());
+  for (int i = 0; i < COUNT; ++i) {
+    float expected[16];
+    referenceMultiply(a[i].m, b[i].m, expected);
+    for (int j = 0; j < 16; ++j)
+      EXPECT_NEAR(result[i].m[j], expected[j], 1e-4f);
+  }
+
+  // In place, with an odd count.
+  std::vector<Matrix> copy = a;
+  Matrix::multiply(copy.data(), b.data(), COUNT - 1, copy.data());
+  for (int i = 0; i < COUNT - 1; ++i) {
+    for (int j = 0; j < 16; ++j)
+      EXPECT_NEAR(copy[i].m[j], result[i].m[j], 1e-4f);
+  }
+  for (int j = 0; j < 16; ++j)
+    EXPECT_FLOAT_EQ(copy[COUNT - 1].m[j], a[COUNT - 1].m[j]);
+}
+
+// Test that the affine palette multiply matches the first three rows of the full product
+TEST_F(TestMatrix, AffineMultiplyMatchesReference) {
+  std::vector<Matrix> affineA = a;
+  std::vector<Matrix> affineB = b;
+  for (int i = 0; i < COUNT; ++i) {
+    affineA[i].m[3] = affineA[i].m[7] = affineA[i].m[11] = 0.0f;
+    affineA[i].m[15] = 1.0f;
+    affineB[i].m[3] = affineB[i].m[7] = affineB[i].m[11] = 0.0f;
+    affineB[i].m[15] = 1.0f;
+  }
+
+  std::vector<Vector4> palette(COUNT * 3);
+  Matrix::multiplyAffine(affineA.data(), affineB.data(), COUNT, palette.data());
+  for (int i = 0; i < COUNT; ++i) {
+    float expected[16];
+    referenceMultiply(affineA[i].m, affineB[i].m, expected);
+    for (int row = 0; row < 3; ++row) {
+      const Vector4& v = palette[i * 3 + row];
+      EXPECT_NEAR(v.x, expected[row], 1e-4f);
+      EXPECT_NEAR(v.y, expected[4 + row], 1e-4f);
+      EXPECT_NEAR(v.z, expected[8 + row], 1e-4f);
+      EXPECT_NEAR(v.w, expected[12 + row], 1e-4f);
+    }
+  }
+}
+
+// Test transpose, add, subtract and negate
+TEST_F(TestMatrix, ComponentWiseOperations) {
+  Matrix result;
+  a[0].transpose(&result);
+  for (int col = 0; col < 4; ++col)
+    for (int row = 0; row < 4; ++row)
+      EXPECT_FLOAT_EQ(result.m[col * 4 + row], a[0].m[row * 4 + col]);
+
+  Matrix::add(a[0], b[0], &result);
+  for (int j = 0; j < 16; ++j)
+    EXPECT_FLOAT_EQ(result.m[j], a[0].m[j] + b[0].m[j]);
+
+  Matrix::subtract(a[0], b[0], &result);
+  for (int j = 0; j < 16; ++j)
+    EXPECT_FLOAT_EQ(result.m[j], a[0].m[j] - b[0].m[j]);
+
+  a[0].negate(&result);
+  for (int j = 0; j < 16; ++j)
+    EXPECT_FLOAT_EQ(result.m[j], -a[0].m[j]);
+
+  Matrix::multiply(a[0], 2.0f, &result);
+  for (int j = 0; j < 16; ++j)
+    EXPECT_FLOAT_EQ(result.m[j], a[0].m[j] * 2.0f);
+}
+
+// Test that transforming a Vector3 only writes three floats
+TEST_F(TestMatrix, TransformVector3DoesNotOverrun) {
+  float buffer[4] = { 0.0f, 0.0f, 0.0f, 42.0f };
+  a[0].transformVector(1.0f, 2.0f, 3.0f, 1.0f, (Vector3*)buffer);
+
+  float v[4] = { 1.0f, 2.0f, 3.0f, 1.0f };
+  float expected[4];
+  referenceTransform(a[0].m, v, expected);
+  for (int j = 0; j < 3; ++j)
+    EXPECT_NEAR(buffer[j], expected[j], 1e-4f);
+  EXPECT_FLOAT_EQ(buffer[3], 42.0f);
+}
+
+// Test batched point and vector transforms against the scalar reference
+TEST_F(TestMatrix, BatchedTransformsMatchReference) {
+  std::vector<Vector3> points(COUNT);
+  std::vector<Vector4> vectors(COUNT);
+  for (int i = 0; i < COUNT; ++i) {
+    points[i].set(b[i].m[0], b[i].m[1], b[i].m[2]);
+    vectors[i].set(b[i].m[4], b[i].m[5], b[i].m[6], b[i].m[7]);
+  }
+
+  std::vector<Vector3> transformedPoints(COUNT);
+  std::vector<Vector4> transformedVectors(COUNT);
+  a[0].transformPoints(points.data(), COUNT, transformedPoints.data());
+  a[0].transformVectors(vectors.data(), COUNT - 1, transformedVectors.data());
+
+  for (int i = 0; i < COUNT; ++i) {
+    float p[4] = { points[i].x, points[i].y, points[i].z, 1.0f };
+    float expected[4];
+    referenceTransform(a[0].m, p, expected);
+    EXPECT_NEAR(transformedPoints[i].x, expected[0], 1e-4f);
+    EXPECT_NEAR(transformedPoints[i].y, expected[1], 1e-4f);
+    EXPECT_NEAR(transformedPoints[i].z, expected[2], 1e-4f);
+  }
+  for (int i = 0; i < COUNT - 1; ++i) {
+    float expected[4];
+    referenceTransform(a[0].m, &vectors[i].x, expected);
+    EXPECT_NEAR(transformedVectors[i].x, expected[0], 1e-4f);
+    EXPECT_NEAR(transformedVectors[i].y, expected[1], 1e-4f);
+    EXPECT_NEAR(transformedVectors[i].z, expected[2], 1e-4f);
+    EXPECT_NEAR(transformedVectors[i].w, expected[3], 1e-4f);
+  }
+  EXPECT_EQ(transformedVectors[COUNT - 1], Vector4::zero());
+
+  // In place.
+  a[0].transformPoints(points.data(), COUNT, points.data());
+  for (int i = 0; i < COUNT; ++i)
+    EXPECT_EQ(points[i], transformedPoints[i]);
+}
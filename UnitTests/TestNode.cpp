@@ -0,0 +1,158 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "scene/Scene.h"
+#include "renderer/Camera.h"
+
+using namespace gameplay;
+
+class TestNode : public ::testing::Test {
+protected:
+  void SetUp() override {
+    scene = Scene::create();
+    Camera* camera = Camera::createPerspective(60.0f, 1.5f, 0.5f, 100.0f);
+    cameraNode = scene->addNode("camera");
+    cameraNode->setCamera(camera);
+    cameraNode->setTranslation(0.0f, 2.0f, 10.0f);
+    scene->setActiveCamera(camera);
+    SAFE_RELEASE(camera);
+
+    parent = scene->addNode("parent");
+    parent->setTranslation(1.0f, 0.0f, -2.0f);
+    node = Node::create("node");
+    node->setTranslation(0.5f, 1.0f, 0.0f);
+    node->setScale(2.0f, 1.0f, 0.5f);
+    node->rotateY(0.4f);
+    parent->addChild(node);
+    node->release();
+  }
+
+  void TearDown() override {
+    SAFE_RELEASE(scene);
+  }
+
+  // Checks every derived matrix of the node against one computed from scratch.
+  void expectDerivedMatrices() {
+    Camera* camera = scene->getActiveCamera();
+    const Matrix& world = node->getWorldMatrix();
+
+    Matrix expected;
+    Matrix::multiply(camera->getViewMatrix(), world, &expected);
+    expectMatrixNear(expected, node->getWorldViewMatrix());
+
+    expected.invert();
+    expected.transpose();
+    expectMatrixNear(expected, node->getInverseTransposeWorldViewMatrix());
+
+    world.invert(&expected);
+    expected.transpose();
+    expectMatrixNear(expected, node->getInverseTransposeWorldMatrix());
+
+    Matrix::multiply(camera->getViewProjectionMatrix(), world, &expected);
+    expectMatrixNear(expected, node->getWorldViewProjectionMatrix());
+
+    cameraNode->getWorldMatrix().invert(&expected);
+    expectMatrixNear(expected, node->getViewMatrix());
+    expectMatrixNear(cameraNode->getWorldMatrix(), node->getInverseViewMatrix());
+  }
+
+  static void expectMatrixNear(const Matrix& expected, const Matrix& actual) {
+    for (int i = 0; i < 16; ++i)
+      EXPECT_NEAR(expected.m[i], actual.m[i], 1e-4f) << "element " << i;
+  }
+
+  static bool differs(const Matrix& a, const Matrix& b) {
+    for (int i = 0; i < 16; ++i) {
+      if (fabs(a.m[i] - b.m[i]) > 1e-4f)
+        return true;
+    }
+    return false;
+  }
+
+  Scene* scene;
+  Node* cameraNode;
+  Node* parent;
+  Node* node;
+};
+
+// Test that moving the node or one of its ancestors recomputes its cached matrices
+TEST_F(TestNode, DerivedMatricesFollowNode) {
+  expectDerivedMatrices();
+  Matrix worldViewProjection = node->getWorldViewProjectionMatrix();
+  Matrix inverseTransposeWorld = node->getInverseTransposeWorldMatrix();
+
+  node->translateX(3.0f);
+  expectDerivedMatrices();
+  EXPECT_TRUE(differs(worldViewProjection, node->getWorldViewProjectionMatrix()));
+
+  worldViewProjection = node->getWorldViewProjectionMatrix();
+  node->setScale(1.0f, 4.0f, 1.0f);
+  expectDerivedMatrices();
+  EXPECT_TRUE(differs(inverseTransposeWorld, node->getInverseTransposeWorldMatrix()));
+  EXPECT_TRUE(differs(worldViewProjection, node->getWorldViewProjectionMatrix()));
+
+  worldViewProjection = node->getWorldViewProjectionMatrix();
+  parent->rotateX(0.7f);
+  expectDerivedMatrices();
+  EXPECT_TRUE(differs(worldViewProjection, node->getWorldViewProjectionMatrix()));
+
+  // Also through a transform store, which notifies descendants later.
+  scene->setTransformStoreEnabled(true);
+  expectDerivedMatrices();
+  worldViewProjection = node->getWorldViewProjectionMatrix();
+  parent->translateY(-5.0f);
+  expectDerivedMatrices();
+  EXPECT_TRUE(differs(worldViewProjection, node->getWorldViewProjectionMatrix()));
+}
+
+// Test that moving the camera recomputes the view-dependent matrices of the node
+TEST_F(TestNode, DerivedMatricesFollowCamera) {
+  expectDerivedMatrices();
+  Matrix worldView = node->getWorldViewMatrix();
+  Matrix inverseView = node->getInverseViewMatrix();
+
+  cameraNode->translateZ(5.0f);
+  expectDerivedMatrices();
+  EXPECT_TRUE(differs(worldView, node->getWorldViewMatrix()));
+  EXPECT_TRUE(differs(inverseView, node->getInverseViewMatrix()));
+
+  worldView = node->getWorldViewMatrix();
+  Matrix inverseTransposeWorldView = node->getInverseTransposeWorldViewMatrix();
+  cameraNode->rotateY(0.3f);
+  expectDerivedMatrices();
+  EXPECT_TRUE(differs(worldView, node->getWorldViewMatrix()));
+  EXPECT_TRUE(differs(inverseTransposeWorldView, node->getInverseTransposeWorldViewMatrix()));
+}
+
+// Test that changing the projection or the active camera recomputes the node's world-view-projection matrix
+TEST_F(TestNode, DerivedMatricesFollowProjection) {
+  Camera* camera = scene->getActiveCamera();
+  expectDerivedMatrices();
+
+  Matrix worldViewProjection = node->getWorldViewProjectionMatrix();
+  camera->setFieldOfView(30.0f);
+  expectDerivedMatrices();
+  EXPECT_TRUE(differs(worldViewProjection, node->getWorldViewProjectionMatrix()));
+
+  worldViewProjection = node->getWorldViewProjectionMatrix();
+  camera->setAspectRatio(0.75f);
+  expectDerivedMatrices();
+  EXPECT_TRUE(differs(worldViewProjection, node->getWorldViewProjectionMatrix()));
+
+  worldViewProjection = node->getWorldViewProjectionMatrix();
+  camera->setNearPlane(2.0f);
+  camera->setFarPlane(20.0f);
+  expectDerivedMatrices();
+  EXPECT_TRUE(differs(worldViewProjection, node->getWorldViewProjectionMatrix()));
+
+  // A camera at the same place with the same projection still counts as a change.
+  worldViewProjection = node->getWorldViewProjectionMatrix();
+  Camera* other = Camera::createOrthographic(4.0f, 4.0f, 1.0f, 0.5f, 100.0f);
+  Node* otherNode = scene->addNode("other");
+  otherNode->setCamera(other);
+  otherNode->setTranslation(cameraNode->getTranslation());
+  scene->setActiveCamera(other);
+  expectDerivedMatrices();
+  EXPECT_TRUE(differs(worldViewProjection, node->getWorldViewProjectionMatrix()));
+  SAFE_RELEASE(other);
+}
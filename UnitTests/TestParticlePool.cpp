@@ -0,0 +1,108 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "graphics/ParticlePool.h"
+
+using namespace gameplay;
+
+class TestParticlePool : public ::testing::Test {
+protected:
+  void SetUp() override {
+    pool = new ParticlePool(COUNT);
+  }
+
+  void TearDown() override {
+    delete pool;
+  }
+
+  // Adds a particle at rest with the given energy (in milliseconds).
+  unsigned int addParticle(float energy) {
+    unsigned int i = pool->add();
+    pool->_positionX[i] = pool->_positionY[i] = pool->_positionZ[i] = 0.0f;
+    pool->_velocityX[i] = pool->_velocityY[i] = pool->_velocityZ[i] = 0.0f;
+    pool->_accelerationX[i] = pool->_accelerationY[i] = pool->_accelerationZ[i] = 0.0f;
+    pool->_colorStartR[i] = pool->_colorStartG[i] = pool->_colorStartB[i] = pool->_colorStartA[i] = 0.0f;
+    pool->_colorEndR[i] = pool->_colorEndG[i] = pool->_colorEndB[i] = pool->_colorEndA[i] = 1.0f;
+    pool->_sizeStart[i] = 1.0f;
+    pool->_sizeEnd[i] = 3.0f;
+    pool->_energy[i] = pool->_energyStart[i] = energy;
+    pool->_angle[i] = 0.0f;
+    pool->_rotationPerParticleSpeed[i] = 0.0f;
+    pool->_rotationSpeed[i] = 0.0f;
+    pool->_rotationAxisX[i] = pool->_rotationAxisY[i] = pool->_rotationAxisZ[i] = 0.0f;
+    pool->_frame[i] = i;
+    pool->_timeOnCurrentFrame[i] = 0.0f;
+    return i;
+  }
+
+  static constexpr unsigned int COUNT = 11;
+  ParticlePool* pool;
+};
+
+// Test that velocity and position are integrated for every particle, including the non-SIMD tail
+TEST_F(TestParticlePool, UpdateIntegratesMotion) {
+  for (unsigned int i = 0; i < COUNT; ++i) {
+    addParticle(1000.0f);
+    pool->_velocityX[i] = 1.0f;
+    pool->_accelerationY[i] = 2.0f;
+  }
+
+  pool->update(500.0f);
+
+  for (unsigned int i = 0; i < COUNT; ++i) {
+    EXPECT_FLOAT_EQ(pool->_velocityY[i], 1.0f);
+    EXPECT_FLOAT_EQ(pool->_positionX[i], 0.5f);
+    EXPECT_FLOAT_EQ(pool->_positionY[i], 0.5f);
+    EXPECT_FLOAT_EQ(pool->_energy[i], 500.0f);
+  }
+}
+
+// Test that color and size are interpolated by the fraction of energy spent
+TEST_F(TestParticlePool, UpdateInterpolatesColorAndSize) {
+  for (unsigned int i = 0; i < COUNT; ++i)
+    addParticle(1000.0f);
+
+  pool->update(250.0f);
+
+  for (unsigned int i = 0; i < COUNT; ++i) {
+    EXPECT_FLOAT_EQ(pool->_percent[i], 0.25f);
+    EXPECT_FLOAT_EQ(pool->_colorR[i], 0.25f);
+    EXPECT_FLOAT_EQ(pool->_colorA[i], 0.25f);
+    EXPECT_FLOAT_EQ(pool->_size[i], 1.5f);
+  }
+}
+
+// Test that velocity is rotated around the particle's rotation axis
+TEST_F(TestParticlePool, UpdateRotatesVelocity) {
+  unsigned int i = addParticle(10000.0f);
+  pool->_velocityX[i] = 1.0f;
+  pool->_rotationAxisZ[i] = 1.0f;
+  pool->_rotationSpeed[i] = MATH_PIOVER2;
+
+  // A quarter turn in one second, with no acceleration the particle travels along +y.
+  pool->update(1000.0f);
+
+  EXPECT_NEAR(pool->_velocityX[i], 0.0f, 1e-5f);
+  EXPECT_NEAR(pool->_velocityY[i], 1.0f, 1e-5f);
+  EXPECT_NEAR(pool->_velocityZ[i], 0.0f, 1e-5f);
+  EXPECT_NEAR(pool->_positionY[i], 1.0f, 1e-5f);
+}
+
+// Test that dead particles are removed and living ones are compacted
+TEST_F(TestParticlePool, RemoveDeadCompactsLivingParticles) {
+  for (unsigned int i = 0; i < COUNT; ++i)
+    addParticle((i % 2) ? 2000.0f : 500.0f);
+
+  pool->update(1000.0f);
+  pool->removeDead();
+
+  ASSERT_EQ(pool->getCount(), COUNT / 2);
+  for (unsigned int i = 0; i < pool->getCount(); ++i) {
+    EXPECT_FLOAT_EQ(pool->_energy[i], 1000.0f);
+    EXPECT_EQ(pool->_frame[i] % 2, 1u);
+  }
+
+  pool->clear();
+  EXPECT_EQ(pool->getCount(), 0u);
+  EXPECT_EQ(pool->getCapacity(), COUNT);
+}
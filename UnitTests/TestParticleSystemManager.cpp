@@ -0,0 +1,91 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "framework/JobSystem.h"
+#include "graphics/ParticleSystemManager.h"
+#include "graphics/ParticlePool.h"
+#include "scene/Scene.h"
+
+using namespace gameplay;
+
+class TestParticleSystemManager : public ::testing::Test {
+protected:
+  static constexpr unsigned int EMITTER_COUNT = 32;
+
+  // An emitter without a texture, which is simulated but never drawn.
+  class TestEmitter : public ParticleEmitter {
+  public:
+    TestEmitter(unsigned int particleCountMax) : ParticleEmitter(particleCountMax) {}
+  };
+
+  // Creates a scene of started emitters that differ in position, rate and seed, but not between calls.
+  static Scene* createScene(std::vector<ParticleEmitter*>& emitters) {
+    Scene* scene = Scene::create();
+    for (unsigned int i = 0; i < EMITTER_COUNT; ++i) {
+      ParticleEmitter* emitter = new TestEmitter(256);
+      emitter->setRandomSeed(i + 1);
+      emitter->setEmissionRate(50 + i * 10);
+      emitter->setEnergy(200, 1200);
+      emitter->setVelocity(Vector3(0.0f, 1.0f, 0.0f), Vector3(1.0f, 1.0f, 1.0f));
+      emitter->start();
+
+      Node* node = scene->addNode();
+      node->setTranslation((float)i, 0.0f, 0.0f);
+      node->setDrawable(emitter);
+      emitter->release();
+      emitters.push_back(emitter);
+    }
+    return scene;
+  }
+
+  // Checks that two emitters have the same particles, in the same slots.
+  static void expectSameParticles(ParticleEmitter* expected, ParticleEmitter* actual) {
+    const ParticlePool* a = expected->getParticles();
+    const ParticlePool* b = actual->getParticles();
+    ASSERT_EQ(a->getCount(), b->getCount());
+    for (unsigned int i = 0; i < a->getCount(); ++i) {
+      EXPECT_EQ(a->_positionX[i], b->_positionX[i]);
+      EXPECT_EQ(a->_positionY[i], b->_positionY[i]);
+      EXPECT_EQ(a->_energy[i], b->_energy[i]);
+    }
+  }
+};
+
+// Test that emitters simulated in parallel by the manager end up with the same particles as emitters updated one by one
+TEST_F(TestParticleSystemManager, ParallelUpdateMatchesSerial) {
+  JobSystem jobs(3);
+  std::vector<ParticleEmitter*> parallel;
+  std::vector<ParticleEmitter*> serial;
+  Scene* parallelScene = createScene(parallel);
+  Scene* serialScene = createScene(serial);
+
+  ParticleSystemManager* manager = ParticleSystemManager::create(parallelScene, &jobs);
+  EXPECT_EQ(parallelScene, manager->getScene());
+
+  unsigned int total = 0;
+  for (int frame = 0; frame < 90; ++frame) {
+    // Vary the step so that some frames fall below the update rate cap.
+    float elapsedTime = (frame % 3 == 0) ? 5.0f : 33.0f;
+    manager->update(elapsedTime);
+    for (unsigned int i = 0; i < EMITTER_COUNT; ++i)
+      serial[i]->update(elapsedTime);
+
+    EXPECT_EQ(EMITTER_COUNT, manager->getEmitterCount());
+    for (unsigned int i = 0; i < EMITTER_COUNT; ++i)
+      ASSERT_EQ(serial[i]->getParticlesCount(), parallel[i]->getParticlesCount()) << "emitter " << i << " frame " << frame;
+  }
+  for (unsigned int i = 0; i < EMITTER_COUNT; ++i)
+    expectSameParticles(serial[i], parallel[i]);
+  for (unsigned int i = 0; i < EMITTER_COUNT; ++i)
+    total += parallel[i]->getParticlesCount();
+  EXPECT_GT(total, 0u);
+
+  // Stopped emitters stay managed while they have living particles.
+  parallel[0]->stop();
+  manager->update(33.0f);
+  EXPECT_EQ(EMITTER_COUNT, manager->getEmitterCount());
+
+  SAFE_RELEASE(manager);
+  SAFE_RELEASE(parallelScene);
+  SAFE_RELEASE(serialScene);
+}
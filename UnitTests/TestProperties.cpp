@@ -0,0 +1,313 @@
+#include "pch.h"
+
+#include <cstdio>
+
+#include "framework/Base.h"
+#include "framework/FileSystem.h"
+#include "framework/Stream.h"
+#include "scene/Properties.h"
+#include "utils/ResourceRegistry.h"
+
+using namespace gameplay;
+
+class TestProperties : public ::testing::Test {
+protected:
+  void SetUp() override {
+    writeFile(PATH, CONTENTS);
+  }
+
+  void TearDown() override {
+    Properties::clearCache();
+    remove(PATH);
+    remove(BINARY_PATH);
+  }
+
+  static void writeFile(const char* path, const char* contents) {
+    Stream* stream = FileSystem::open(path, FileSystem::WRITE);
+    ASSERT_TRUE(stream != nullptr);
+    EXPECT_EQ(stream->write(contents, 1, strlen(contents)), strlen(contents));
+    SAFE_DELETE(stream);
+  }
+
+  // Checks the values of the test file, whichever format it was loaded from
+  static void expectContents(Properties* root) {
+    Properties* game = root->getNamespace("game", true);
+    ASSERT_TRUE(game != nullptr);
+    EXPECT_STREQ(game->getString("title"), "Test Game");
+    EXPECT_EQ(game->getInt("width"), 1280);
+    EXPECT_FLOAT_EQ(game->getFloat("scale"), 0.5f);
+    EXPECT_STREQ(game->getString("color"), "#ff0000ff");
+
+    Properties* derived = root->getNamespace("derived", true);
+    ASSERT_TRUE(derived != nullptr);
+    EXPECT_EQ(derived->getInt("a"), 1);
+    EXPECT_EQ(derived->getInt("b"), 3);
+    Properties* child = derived->getNamespace("child", true);
+    ASSERT_TRUE(child != nullptr);
+    EXPECT_STREQ(child->getString("value"), "inherited");
+  }
+
+  // Checks that two namespaces have the same ids, properties and nested namespaces, in the same order
+  static void expectSameProperties(Properties* expected, Properties* actual) {
+    EXPECT_STREQ(expected->getNamespace(), actual->getNamespace());
+    EXPECT_STREQ(expected->getId(), actual->getId());
+    expected->rewind();
+    actual->rewind();
+    const char* name;
+    while ((name = expected->getNextProperty()) != nullptr) {
+      const char* actualName = actual->getNextProperty();
+      ASSERT_TRUE(actualName != nullptr) << "missing property " << name;
+      EXPECT_STREQ(name, actualName);
+      EXPECT_STREQ(expected->getString(), actual->getString());
+    }
+    EXPECT_TRUE(actual->getNextProperty() == nullptr);
+
+    Properties* space;
+    while ((space = expected->getNextNamespace()) != nullptr) {
+      Properties* actualSpace = actual->getNextNamespace();
+      ASSERT_TRUE(actualSpace != nullptr) << "missing namespace " << space->getId();
+      expectSameProperties(space, actualSpace);
+    }
+    EXPECT_TRUE(actual->getNextNamespace() == nullptr);
+  }
+
+  static constexpr const char* PATH = "TestProperties.properties";
+  static constexpr const char* BINARY_PATH = "TestProperties.bin";
+  static constexpr const char* CONTENTS =
+    "game game\n"
+    "{\n"
+    "    title = Test Game\n"
+    "    width = 1280\n"
+    "    scale = 0.5\n"
+    "    color = ${red}\n"
+    "    window window\n"
+    "    {\n"
+    "        inner inner\n"
+    "        {\n"
+    "            depth = 2\n"
+    "        }\n"
+    "    }\n"
+    "}\n"
+    "${red} = #ff0000ff\n"
+    "base base\n"
+    "{\n"
+    "    a = 1\n"
+    "    b = 2\n"
+    "    child\n"
+    "    {\n"
+    "        value = inherited\n"
+    "    }\n"
+    "}\n"
+    "derived derived : base\n"
+    "{\n"
+    "    b = 3\n"
+    "}\n";
+};
+
+// Test that a file is parsed once and every create() returns an independent copy
+TEST_F(TestProperties, CachesParsedFile) {
+  const ResourceRegistry* cache = nullptr;
+  for (ResourceRegistry* registry : ResourceRegistry::getRegistries()) {
+    if (strcmp(registry->getName(), "properties") == 0)
+      cache = registry;
+  }
+  ASSERT_TRUE(cache != nullptr);
+  unsigned int hits = cache->getHitCount();
+
+  Properties* first = Properties::create(PATH);
+  Properties* second = Properties::create(PATH);
+  ASSERT_TRUE(first != nullptr);
+  ASSERT_TRUE(second != nullptr);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(cache->getCount(), 1u);
+  EXPECT_GT(cache->getHitCount(), hits);
+
+  first->getNamespace("game", true)->setString("title", "Changed");
+  EXPECT_STREQ(second->getNamespace("game", true)->getString("title"), "Test Game");
+  expectContents(second);
+  SAFE_DELETE(first);
+  SAFE_DELETE(second);
+
+  Properties::clearCache();
+  EXPECT_EQ(cache->getCount(), 0u);
+}
+
+// Test that a file written after it was cached is parsed again once invalidated
+TEST_F(TestProperties, InvalidateRereadsFile) {
+  Properties* properties = Properties::create(PATH);
+  ASSERT_TRUE(properties != nullptr);
+  EXPECT_STREQ(properties->getNamespace("game", true)->getString("title"), "Test Game");
+  SAFE_DELETE(properties);
+
+  writeFile(PATH, "game game\n{\n    title = Rewritten\n}\n");
+  properties = Properties::create(PATH);
+  EXPECT_STREQ(properties->getNamespace("game", true)->getString("title"), "Test Game");
+  SAFE_DELETE(properties);
+
+  Properties::invalidate(PATH);
+  properties = Properties::create(PATH);
+  ASSERT_TRUE(properties != nullptr);
+  EXPECT_STREQ(properties->getNamespace("game", true)->getString("title"), "Rewritten");
+  SAFE_DELETE(properties);
+
+  // Compiling over a cached binary file invalidates it as well.
+  ASSERT_TRUE(Properties::compile(PATH, BINARY_PATH));
+  properties = Properties::create(BINARY_PATH);
+  SAFE_DELETE(properties);
+  writeFile(PATH, CONTENTS);
+  ASSERT_TRUE(Properties::compile(PATH, BINARY_PATH));
+  properties = Properties::create(BINARY_PATH);
+  ASSERT_TRUE(properties != nullptr);
+  expectContents(properties);
+  SAFE_DELETE(properties);
+}
+
+// Test that a url selects a nested namespace by id
+TEST_F(TestProperties, NamespaceUrl) {
+  Properties* inner = Properties::create("TestProperties.properties#game/window/inner");
+  ASSERT_TRUE(inner != nullptr);
+  EXPECT_STREQ(inner->getNamespace(), "inner");
+  EXPECT_EQ(inner->getInt("depth"), 2);
+  SAFE_DELETE(inner);
+
+  Properties* derived = Properties::create("TestProperties.properties#derived");
+  ASSERT_TRUE(derived != nullptr);
+  EXPECT_EQ(derived->getInt("a"), 1);
+  SAFE_DELETE(derived);
+}
+
+// Test that a precompiled file loads with the same values as its text source
+TEST_F(TestProperties, CompiledMatchesText) {
+  ASSERT_TRUE(Properties::compile(PATH, BINARY_PATH));
+
+  Properties* text = Properties::create(PATH);
+  Properties* binary = Properties::create(BINARY_PATH);
+  ASSERT_TRUE(text != nullptr);
+  ASSERT_TRUE(binary != nullptr);
+  expectContents(text);
+  expectContents(binary);
+
+  Properties* inner = Properties::create("TestProperties.bin#game/window/inner");
+  ASSERT_TRUE(inner != nullptr);
+  EXPECT_EQ(inner->getInt("depth"), 2);
+  SAFE_DELETE(inner);
+  SAFE_DELETE(text);
+  SAFE_DELETE(binary);
+}
+
+// Test that a truncated precompiled file fails to load instead of reading past its end
+TEST_F(TestProperties, TruncatedCompiledFile) {
+  ASSERT_TRUE(Properties::compile(PATH, BINARY_PATH));
+  Stream* stream = FileSystem::open(BINARY_PATH);
+  ASSERT_TRUE(stream != nullptr);
+  std::vector<char> data(stream->length());
+  stream->read(data.data(), 1, data.size());
+  SAFE_DELETE(stream);
+
+  stream = FileSystem::open(BINARY_PATH, FileSystem::WRITE);
+  ASSERT_TRUE(stream != nullptr);
+  stream->write(data.data(), 1, data.size() / 2);
+  SAFE_DELETE(stream);
+
+  Properties* properties = Properties::create(BINARY_PATH);
+  EXPECT_TRUE(properties == nullptr);
+  SAFE_DELETE(properties);
+}
+
+// Test that lookups in a large namespace find the first property with a name, including ones added later
+TEST_F(TestProperties, LargeNamespaceLookup) {
+  std::string contents = "large large\n{\n";
+  for (int i = 0; i < 64; ++i)
+    contents += "    key" + std::to_string(i) + " = " + std::to_string(i) + "\n";
+  contents += "    key10 = duplicate\n}\n";
+  writeFile(PATH, contents.c_str());
+
+  Properties* properties = Properties::create("TestProperties.properties#large");
+  ASSERT_TRUE(properties != nullptr);
+  EXPECT_EQ(properties->getInt("key0"), 0);
+  EXPECT_EQ(properties->getInt("key63"), 63);
+  EXPECT_EQ(properties->getInt("key10"), 10);
+  EXPECT_FALSE(properties->exists("key64"));
+
+  EXPECT_TRUE(properties->setString("key64", "64"));
+  EXPECT_TRUE(properties->exists("key64"));
+  EXPECT_EQ(properties->getInt("key64"), 64);
+  SAFE_DELETE(properties);
+}
+
+// Test that cached parsed values follow changes to the property and to the variables it references
+TEST_F(TestProperties, TypedValuesFollowChanges) {
+  Properties* properties = Properties::create("TestProperties.properties#game");
+  ASSERT_TRUE(properties != nullptr);
+  EXPECT_EQ(properties->getInt("width"), 1280);
+  EXPECT_EQ(properties->getInt("width"), 1280);
+  EXPECT_FLOAT_EQ(properties->getFloat("width"), 1280.0f);
+  properties->setString("width", "640");
+  EXPECT_EQ(properties->getInt("width"), 640);
+
+  properties->setString("offset", "1,2,3");
+  Vector3 v;
+  EXPECT_TRUE(properties->getVector3("offset", &v));
+  EXPECT_TRUE(properties->getVector3("offset", &v));
+  EXPECT_EQ(v, Vector3(1.0f, 2.0f, 3.0f));
+  properties->setString("offset", "4,5,6");
+  EXPECT_TRUE(properties->getVector3("offset", &v));
+  EXPECT_EQ(v, Vector3(4.0f, 5.0f, 6.0f));
+
+  Vector4 color;
+  EXPECT_TRUE(properties->getColor("color", &color));
+  EXPECT_EQ(color, Vector4(1.0f, 0.0f, 0.0f, 1.0f));
+  properties->setVariable("red", "#00ff00ff");
+  EXPECT_TRUE(properties->getColor("color", &color));
+  EXPECT_EQ(color, Vector4(0.0f, 1.0f, 0.0f, 1.0f));
+  SAFE_DELETE(properties);
+}
+
+// Test that recursive namespace lookups return the first match in depth-first order
+TEST_F(TestProperties, RecursiveNamespaceLookup) {
+  Properties* root = Properties::create(PATH);
+  ASSERT_TRUE(root != nullptr);
+  Properties* inner = root->getNamespace("inner");
+  ASSERT_TRUE(inner != nullptr);
+  EXPECT_EQ(inner->getInt("depth"), 2);
+  EXPECT_TRUE(root->getNamespace("inner", false, false) == nullptr);
+  EXPECT_EQ(root->getNamespace("window", true), root->getNamespace("game")->getNamespace("window"));
+  EXPECT_EQ(root->getNamespace("child", true), root->getNamespace("base")->getNamespace("child", true));
+  EXPECT_TRUE(root->getNamespace("missing") == nullptr);
+  SAFE_DELETE(root);
+}
+
+// Test that a large scene file loads from its compiled form with the same namespaces and values
+TEST_F(TestProperties, LargeCompiledFileRoundTrips) {
+  static constexpr int NODE_COUNT = 2000;
+
+  std::string scene = "scene\n{\n    path = res/scene.gpb\n";
+  for (int i = 0; i < NODE_COUNT; ++i) {
+    std::string id = std::to_string(i);
+    scene += "    node node" + id + "\n    {\n        material = res/materials/node" + std::to_string(i % 7) + ".material\n";
+    scene += "        translate = " + id + ",0,0\n        scale = 1,1,1\n        rotate = 0,1,0,90\n";
+    scene += "        collisionObject = res/physics.physics#box\n        tags\n        {\n            dynamic = true\n        }\n    }\n";
+  }
+  scene += "}\n";
+  writeFile(PATH, scene.c_str());
+  ASSERT_TRUE(Properties::compile(PATH, BINARY_PATH));
+
+  Properties* text = Properties::create(PATH);
+  Properties* binary = Properties::create(BINARY_PATH);
+  ASSERT_TRUE(text != nullptr);
+  ASSERT_TRUE(binary != nullptr);
+  expectSameProperties(text, binary);
+
+  // Lookups by id find the same nodes in both.
+  Vector3 translate;
+  for (int i = 0; i < NODE_COUNT; i += 97) {
+    std::string id = "node" + std::to_string(i);
+    Properties* node = binary->getNamespace(id.c_str());
+    ASSERT_TRUE(node != nullptr);
+    EXPECT_TRUE(node->getVector3("translate", &translate));
+    EXPECT_EQ(translate.x, (float)i);
+    EXPECT_STREQ(node->getString("material"), text->getNamespace(id.c_str())->getString("material"));
+  }
+  SAFE_DELETE(text);
+  SAFE_DELETE(binary);
+}
@@ -0,0 +1,83 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "renderer/RenderQueue.h"
+
+using namespace gameplay;
+
+class TestRenderQueue : public ::testing::Test {
+protected:
+  // Headless queues never dereference passes, so tests can use distinct fake pointers.
+  static Pass* fakePass(uintptr_t id) {
+    return reinterpret_cast<Pass*>(id * 16);
+  }
+};
+
+// Test that keys order by layer, then opaque before transparent, then state for opaque and depth for transparent
+TEST_F(TestRenderQueue, KeyOrder) {
+  EXPECT_LT(RenderQueue::makeKey(0, true, 9, 9, 1.0f), RenderQueue::makeKey(1, false, 0, 0, 0.0f));
+  EXPECT_LT(RenderQueue::makeKey(0, false, 9, 9, 1.0f), RenderQueue::makeKey(0, true, 0, 0, 0.0f));
+
+  // Opaque items group by effect, then pass, then draw front to back.
+  EXPECT_LT(RenderQueue::makeKey(0, false, 1, 2, 1.0f), RenderQueue::makeKey(0, false, 2, 1, 0.0f));
+  EXPECT_LT(RenderQueue::makeKey(0, false, 1, 1, 1.0f), RenderQueue::makeKey(0, false, 1, 2, 0.0f));
+  EXPECT_LT(RenderQueue::makeKey(0, false, 1, 1, 0.25f), RenderQueue::makeKey(0, false, 1, 1, 0.5f));
+
+  // Transparent items draw back to front whatever their state.
+  EXPECT_LT(RenderQueue::makeKey(0, true, 2, 2, 0.5f), RenderQueue::makeKey(0, true, 1, 1, 0.25f));
+
+  // Depth is clamped.
+  EXPECT_EQ(RenderQueue::makeKey(0, false, 1, 1, -1.0f), RenderQueue::makeKey(0, false, 1, 1, 0.0f));
+  EXPECT_EQ(RenderQueue::makeKey(0, true, 1, 1, 2.0f), RenderQueue::makeKey(0, true, 1, 1, 1.0f));
+}
+
+// Test that the radix sort matches a stable sort, keeping items with equal keys in the order they were added
+TEST_F(TestRenderQueue, Sort) {
+  static constexpr int itemCount = 1000;
+  RenderQueue queue(true);
+  std::vector<std::pair<unsigned long long, int> > expected;
+  unsigned long long seed = 12345;
+  for (int i = 0; i < itemCount; ++i) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    // Few distinct keys, so that there are many ties, spread over all of the bits.
+    unsigned long long key = (seed >> 59) * 0x0801020408102041ull;
+    queue.add(key, nullptr, nullptr, i);
+    expected.push_back(std::make_pair(key, i));
+  }
+  std::stable_sort(expected.begin(), expected.end(),
+    [](const std::pair<unsigned long long, int>& a, const std::pair<unsigned long long, int>& b) { return a.first < b.first; });
+
+  queue.sort();
+  ASSERT_EQ(queue.getItemCount(), (unsigned int)itemCount);
+  for (unsigned int i = 0; i < itemCount; ++i) {
+    EXPECT_EQ(queue.getItem(i).key, expected[i].first);
+    EXPECT_EQ(queue.getItem(i).partIndex, expected[i].second);
+  }
+}
+
+// Test that submitting sorted items binds each pass and effect once
+TEST_F(TestRenderQueue, SubmitCounters) {
+  RenderQueue queue(true);
+  // Two items for each of 4 passes, which alternate between 2 effects.
+  for (int i = 0; i < 8; ++i) {
+    unsigned int pass = 1 + i % 4;
+    unsigned int effect = 1 + i % 2;
+    queue.add(RenderQueue::makeKey(0, false, effect, pass, i < 4 ? 0.5f : 0.25f), fakePass(pass), nullptr, -1);
+  }
+  queue.add(RenderQueue::makeKey(0, true, 0, 0, 0.5f), nullptr, nullptr, -1);
+
+  // In the order added, every item changes the pass.
+  EXPECT_EQ(queue.submit(), 9u);
+  EXPECT_EQ(queue.getPassBindCount(), 8u);
+
+  queue.sort();
+  EXPECT_EQ(queue.submit(), 9u);
+  EXPECT_EQ(queue.getDrawCallCount(), 9u);
+  EXPECT_EQ(queue.getPassBindCount(), 4u);
+  EXPECT_EQ(queue.getEffectChangeCount(), 2u);
+  EXPECT_TRUE(queue.getItem(8).pass == nullptr);
+
+  queue.clear();
+  EXPECT_EQ(queue.getItemCount(), 0u);
+  EXPECT_EQ(queue.getDrawCallCount(), 0u);
+}
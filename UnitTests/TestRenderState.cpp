@@ -0,0 +1,24 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "renderer/RenderState.h"
+
+using namespace gameplay;
+
+class TestRenderState : public ::testing::Test {};
+
+// Test that every built-in auto binding is found by its name, and that other names are not
+TEST_F(TestRenderState, AutoBindingNames) {
+  for (int i = RenderState::WORLD_MATRIX; i <= RenderState::SCENE_AMBIENT_COLOR; ++i) {
+    RenderState::AutoBinding autoBinding = (RenderState::AutoBinding)i;
+    const char* name = RenderState::getAutoBindingName(autoBinding);
+    ASSERT_TRUE(name != nullptr);
+    EXPECT_EQ(autoBinding, RenderState::getAutoBinding(name));
+  }
+
+  EXPECT_STREQ("WORLD_VIEW_PROJECTION_MATRIX", RenderState::getAutoBindingName(RenderState::WORLD_VIEW_PROJECTION_MATRIX));
+  EXPECT_EQ(nullptr, RenderState::getAutoBindingName(RenderState::NONE));
+  EXPECT_EQ(RenderState::NONE, RenderState::getAutoBinding("WORLD_MATRIX_"));
+  EXPECT_EQ(RenderState::NONE, RenderState::getAutoBinding("world_matrix"));
+  EXPECT_EQ(RenderState::NONE, RenderState::getAutoBinding(""));
+}
@@ -0,0 +1,106 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "utils/ResourceRegistry.h"
+
+using namespace gameplay;
+
+class TestResourceRegistry : public ::testing::Test {
+protected:
+  struct Resource {
+    int value;
+  };
+
+  void SetUp() override {
+    cache = new ResourceCache<Resource>("test");
+  }
+
+  void TearDown() override {
+    delete cache;
+  }
+
+  ResourceCache<Resource>* cache;
+};
+
+// Test that lookups find resources by path and count hits and misses
+TEST_F(TestResourceRegistry, FindCountsHitsAndMisses) {
+  Resource a = { 1 };
+  Resource b = { 2 };
+  cache->add("res/a.png", &a, 100);
+  cache->add("res/b.png", &b, 50);
+
+  EXPECT_TRUE(cache->find("res/a.png") == &a);
+  EXPECT_TRUE(cache->find(std::string("res/b.png")) == &b);
+  EXPECT_TRUE(cache->find("res/c.png") == nullptr);
+  EXPECT_TRUE(cache->find("res/A.png") == nullptr);
+
+  EXPECT_EQ(cache->getCount(), 2u);
+  EXPECT_EQ(cache->getHitCount(), 2u);
+  EXPECT_EQ(cache->getMissCount(), 2u);
+  EXPECT_EQ(cache->getMemoryUsage(), 150u);
+
+  cache->resetCounters();
+  EXPECT_EQ(cache->getHitCount(), 0u);
+  EXPECT_EQ(cache->getMissCount(), 0u);
+  EXPECT_EQ(cache->getCount(), 2u);
+}
+
+// Test that removing only affects the resource actually cached under the path
+TEST_F(TestResourceRegistry, RemoveAndReplace) {
+  Resource a = { 1 };
+  Resource b = { 2 };
+  cache->add("res/a.png", &a, 100);
+
+  cache->remove("res/a.png", &b);
+  EXPECT_TRUE(cache->find("res/a.png") == &a);
+
+  cache->add("res/a.png", &b, 30);
+  EXPECT_TRUE(cache->find("res/a.png") == &b);
+  EXPECT_EQ(cache->getCount(), 1u);
+  EXPECT_EQ(cache->getMemoryUsage(), 30u);
+
+  cache->remove("res/a.png", &b);
+  EXPECT_TRUE(cache->find("res/a.png") == nullptr);
+  EXPECT_EQ(cache->getCount(), 0u);
+  EXPECT_EQ(cache->getMemoryUsage(), 0u);
+}
+
+// Test that resources can be taken out of the cache by path, or all at once
+TEST_F(TestResourceRegistry, RemoveByPathAndClear) {
+  Resource a = { 1 };
+  Resource b = { 2 };
+  cache->add("res/a.png", &a, 100);
+  cache->add("res/b.png", &b, 50);
+
+  EXPECT_TRUE(cache->remove("res/a.png") == &a);
+  EXPECT_TRUE(cache->remove("res/a.png") == nullptr);
+  EXPECT_EQ(cache->getCount(), 1u);
+  EXPECT_EQ(cache->getMemoryUsage(), 50u);
+  EXPECT_EQ(cache->getHitCount(), 0u);
+  EXPECT_EQ(cache->getMissCount(), 0u);
+
+  cache->add("res/a.png", &a, 100);
+  std::vector<Resource*> removed;
+  cache->clear(&removed);
+  ASSERT_EQ(removed.size(), 2u);
+  EXPECT_TRUE(std::find(removed.begin(), removed.end(), &a) != removed.end());
+  EXPECT_TRUE(std::find(removed.begin(), removed.end(), &b) != removed.end());
+  EXPECT_EQ(cache->getCount(), 0u);
+  EXPECT_EQ(cache->getMemoryUsage(), 0u);
+  EXPECT_TRUE(cache->find("res/b.png") == nullptr);
+}
+
+// Test that caches register themselves for as long as they exist
+TEST_F(TestResourceRegistry, Registries) {
+  const std::vector<ResourceRegistry*>& registries = ResourceRegistry::getRegistries();
+  EXPECT_TRUE(std::find(registries.begin(), registries.end(), cache) != registries.end());
+
+  {
+    ResourceCache<Resource> other("other");
+    EXPECT_TRUE(std::find(registries.begin(), registries.end(), &other) != registries.end());
+    EXPECT_STREQ(other.getName(), "other");
+  }
+
+  for (size_t i = 0; i < registries.size(); ++i)
+    EXPECT_STRNE(registries[i]->getName(), "other");
+}
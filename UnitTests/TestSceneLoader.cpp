@@ -0,0 +1,102 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "framework/FileSystem.h"
+#include "framework/Game.h"
+#include "framework/Stream.h"
+#include "graphics/Light.h"
+#include "scene/Node.h"
+#include "scene/Properties.h"
+#include "scene/Scene.h"
+
+using namespace gameplay;
+
+class TestSceneLoader : public ::testing::Test {
+protected:
+  void SetUp() override {
+    writeFile(LIGHTS_PATH, LIGHTS);
+    writeFile(SCENE_PATH, SCENE);
+  }
+
+  void TearDown() override {
+    Properties::clearCache();
+    remove(LIGHTS_PATH);
+    remove(SCENE_PATH);
+  }
+
+  static void writeFile(const char* path, const char* contents) {
+    Stream* stream = FileSystem::open(path, FileSystem::WRITE);
+    ASSERT_TRUE(stream != nullptr);
+    EXPECT_EQ(stream->write(contents, 1, strlen(contents)), strlen(contents));
+    SAFE_DELETE(stream);
+  }
+
+  // The loader reaches the subsystems through the game, which is not started, so nothing runs on other threads.
+  Game game;
+
+  static constexpr const char* LIGHTS_PATH = "TestSceneLoader.lights";
+  static constexpr const char* SCENE_PATH = "TestSceneLoader.scene";
+  static constexpr const char* LIGHTS =
+    "group indoor\n"
+    "{\n"
+    "    light lamp\n"
+    "    {\n"
+    "        type = POINT\n"
+    "        color = 0.0, 1.0, 0.0\n"
+    "        range = 10\n"
+    "    }\n"
+    "}\n"
+    "group outdoor\n"
+    "{\n"
+    "    group sky\n"
+    "    {\n"
+    "        light moon\n"
+    "        {\n"
+    "            type = DIRECTIONAL\n"
+    "            color = 0.1, 0.1, 0.2\n"
+    "        }\n"
+    "        light sun\n"
+    "        {\n"
+    "            type = DIRECTIONAL\n"
+    "            color = 1.0, 0.5, 0.25\n"
+    "        }\n"
+    "    }\n"
+    "}\n";
+  static constexpr const char* SCENE =
+    "scene test\n"
+    "{\n"
+    "    node moon\n"
+    "    {\n"
+    "        light = TestSceneLoader.lights#outdoor/sky/moon\n"
+    "    }\n"
+    "    node sun\n"
+    "    {\n"
+    "        light = TestSceneLoader.lights#outdoor/sky/sun\n"
+    "    }\n"
+    "    node lamp\n"
+    "    {\n"
+    "        light = TestSceneLoader.lights#indoor/lamp\n"
+    "    }\n"
+    "}\n";
+};
+
+// Test that the urls of a scene select nested namespaces by id, whatever their depth and order
+TEST_F(TestSceneLoader, ReferencedNamespacePaths) {
+  Scene* scene = Scene::load(SCENE_PATH);
+  ASSERT_TRUE(scene != nullptr);
+
+  Node* sun = scene->findNode("sun");
+  ASSERT_TRUE(sun != nullptr && sun->getLight() != nullptr);
+  EXPECT_EQ(Light::DIRECTIONAL, sun->getLight()->getLightType());
+  EXPECT_EQ(Vector3(1.0f, 0.5f, 0.25f), sun->getLight()->getColor());
+
+  Node* moon = scene->findNode("moon");
+  ASSERT_TRUE(moon != nullptr && moon->getLight() != nullptr);
+  EXPECT_EQ(Vector3(0.1f, 0.1f, 0.2f), moon->getLight()->getColor());
+
+  Node* lamp = scene->findNode("lamp");
+  ASSERT_TRUE(lamp != nullptr && lamp->getLight() != nullptr);
+  EXPECT_EQ(Light::POINT, lamp->getLight()->getLightType());
+
+  SAFE_RELEASE(scene);
+}
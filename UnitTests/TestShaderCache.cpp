@@ -0,0 +1,178 @@
+#include "pch.h"
+
+#include <cstdio>
+
+#include "framework/Base.h"
+#include "framework/FileSystem.h"
+#include "framework/Stream.h"
+#include "graphics/ShaderCache.h"
+
+using namespace gameplay;
+
+class TestShaderCache : public ::testing::Test {
+protected:
+  void SetUp() override {
+    writeFile(SHADER_PATH, "#include \"TestShaderCacheLighting.glsl\"\nvoid main() {}\n");
+    writeFile(INCLUDE_PATH, "#include \"TestShaderCacheCommon.glsl\"\nvec3 light;\n");
+    writeFile(NESTED_INCLUDE_PATH, "uniform mat4 u_matrix;\n");
+    cache = new ShaderCache(DIRECTORY);
+  }
+
+  void TearDown() override {
+    SAFE_DELETE(cache);
+    remove(SHADER_PATH);
+    remove(INCLUDE_PATH);
+    remove(NESTED_INCLUDE_PATH);
+    remove(entryPath(KEY).c_str());
+    remove(DIRECTORY);
+  }
+
+  static void writeFile(const char* path, const char* contents) {
+    Stream* stream = FileSystem::open(path, FileSystem::WRITE);
+    ASSERT_TRUE(stream != nullptr);
+    EXPECT_EQ(stream->write(contents, 1, strlen(contents)), strlen(contents));
+    SAFE_DELETE(stream);
+  }
+
+  static std::string entryPath(unsigned long long key) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.program", key);
+    return std::string(DIRECTORY) + "/" + name;
+  }
+
+  static ShaderCache::Entry makeEntry() {
+    ShaderCache::Entry entry;
+    entry.vertexSource = VERTEX_SOURCE;
+    entry.fragmentSource = FRAGMENT_SOURCE;
+    entry.binaryFormat = 0x8741;
+    for (int i = 0; i < 256; ++i)
+      entry.binary.push_back((unsigned char)i);
+    return entry;
+  }
+
+  ShaderCache* cache;
+
+  static constexpr const char* DIRECTORY = "TestShaderCache";
+  static constexpr const char* SHADER_PATH = "TestShaderCache.vert";
+  static constexpr const char* INCLUDE_PATH = "TestShaderCacheLighting.glsl";
+  static constexpr const char* NESTED_INCLUDE_PATH = "TestShaderCacheCommon.glsl";
+  static constexpr const char* VERTEX_SOURCE = "#define SKINNING\nvoid main() { gl_Position = vec4(0.0); }\n";
+  static constexpr const char* FRAGMENT_SOURCE = "#define SKINNING\nvoid main() { gl_FragColor = vec4(1.0); }\n";
+  static constexpr const char* DRIVER = "Vendor|Renderer|4.6";
+  static constexpr unsigned long long KEY = 0x0123456789abcdefULL;
+};
+
+// Test that semicolon-delimited defines become one #define line each, global defines first
+TEST_F(TestShaderCache, ExpandDefines) {
+  EXPECT_EQ(ShaderCache::expandDefines(nullptr, nullptr), "");
+  EXPECT_EQ(ShaderCache::expandDefines("", "SKINNING"), "#define SKINNING\n");
+  EXPECT_EQ(ShaderCache::expandDefines("OPENGL_ES;HIGHP", "SKINNING;BONES 4"),
+    "#define OPENGL_ES\n#define HIGHP\n#define SKINNING\n#define BONES 4\n");
+}
+
+// Test that includes are replaced recursively, relative to the including file
+TEST_F(TestShaderCache, ExpandIncludes) {
+  char* source = FileSystem::readAll(SHADER_PATH);
+  ASSERT_TRUE(source != nullptr);
+  std::string out = "#define A\n";
+  EXPECT_TRUE(ShaderCache::expandIncludes(SHADER_PATH, source, out));
+  EXPECT_EQ(out, "#define A\nuniform mat4 u_matrix;\n\nvec3 light;\n\nvoid main() {}\n");
+  SAFE_DELETE_ARRAY(source);
+
+  out.clear();
+  EXPECT_TRUE(ShaderCache::expandIncludes(SHADER_PATH, "void main() {}", out));
+  EXPECT_EQ(out, "void main() {}");
+}
+
+// Test that preprocessing reads each file once, even from several threads
+TEST_F(TestShaderCache, PreprocessSharesFiles) {
+  ShaderCache::SourceFiles files;
+  const std::string* source = files.read(SHADER_PATH);
+  ASSERT_TRUE(source != nullptr);
+  EXPECT_EQ(files.read(SHADER_PATH), source);
+  EXPECT_TRUE(files.read("TestShaderCacheMissing.glsl") == nullptr);
+
+  std::string expected;
+  ASSERT_TRUE(ShaderCache::preprocess(SHADER_PATH, source->c_str(), "#define A\n", expected, &files));
+  EXPECT_EQ(expected, "#define A\nuniform mat4 u_matrix;\n\nvec3 light;\n\nvoid main() {}\n\n");
+
+  // Later reads come from memory, so the includes are no longer needed on disk.
+  remove(INCLUDE_PATH);
+  remove(NESTED_INCLUDE_PATH);
+  std::string results[4];
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i)
+    threads.emplace_back([&, i]() { ShaderCache::preprocess(SHADER_PATH, source->c_str(), "#define A\n", results[i], &files); });
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+  for (int i = 0; i < 4; ++i)
+    EXPECT_EQ(results[i], expected);
+
+  // Sources that were not read from a file are used as they are.
+  std::string out;
+  EXPECT_TRUE(ShaderCache::preprocess(nullptr, "#include \"x\"", "#define A\n", out));
+  EXPECT_EQ(out, "#define A\n#include \"x\"");
+}
+
+// Test that the key changes with the source, the defines and the driver
+TEST_F(TestShaderCache, ComputeKey) {
+  std::string vertex = VERTEX_SOURCE;
+  std::string fragment = FRAGMENT_SOURCE;
+  unsigned long long key = ShaderCache::computeKey(vertex, fragment, DRIVER);
+  EXPECT_EQ(key, ShaderCache::computeKey(vertex, fragment, DRIVER));
+  EXPECT_NE(key, ShaderCache::computeKey(vertex, fragment, "Vendor|Renderer|4.5"));
+  EXPECT_NE(key, ShaderCache::computeKey("#define LIGHTS 2\n" + vertex, fragment, DRIVER));
+  EXPECT_NE(key, ShaderCache::computeKey(vertex + fragment, "", DRIVER));
+  EXPECT_NE(ShaderCache::hash("a", 1), ShaderCache::hash("b", 1));
+}
+
+// Test that an entry reads back exactly as it was written
+TEST_F(TestShaderCache, SaveAndLoad) {
+  EXPECT_FALSE(cache->contains(KEY));
+  ASSERT_TRUE(cache->save(KEY, DRIVER, makeEntry()));
+  EXPECT_TRUE(cache->contains(KEY));
+
+  ShaderCache::Entry entry;
+  ASSERT_TRUE(cache->load(KEY, DRIVER, VERTEX_SOURCE, FRAGMENT_SOURCE, &entry));
+  EXPECT_EQ(entry.vertexSource, VERTEX_SOURCE);
+  EXPECT_EQ(entry.fragmentSource, FRAGMENT_SOURCE);
+  EXPECT_EQ(entry.binaryFormat, 0x8741u);
+  EXPECT_EQ(entry.binary, makeEntry().binary);
+
+  // A source-only entry is valid too.
+  ShaderCache::Entry sourceOnly = makeEntry();
+  sourceOnly.binary.clear();
+  ASSERT_TRUE(cache->save(KEY, DRIVER, sourceOnly));
+  ASSERT_TRUE(cache->load(KEY, DRIVER, VERTEX_SOURCE, FRAGMENT_SOURCE, &entry));
+  EXPECT_TRUE(entry.binary.empty());
+}
+
+// Test that entries for another driver or source, and damaged entries, are rejected
+TEST_F(TestShaderCache, RejectsInvalidEntries) {
+  ASSERT_TRUE(cache->save(KEY, DRIVER, makeEntry()));
+
+  ShaderCache::Entry entry;
+  EXPECT_FALSE(cache->load(KEY, "Vendor|Renderer|4.5", VERTEX_SOURCE, FRAGMENT_SOURCE, &entry));
+  EXPECT_FALSE(cache->load(KEY, DRIVER, "void main() {}", FRAGMENT_SOURCE, &entry));
+  EXPECT_FALSE(cache->load(KEY + 1, DRIVER, VERTEX_SOURCE, FRAGMENT_SOURCE, &entry));
+
+  // Flip one byte of the binary.
+  std::string path = entryPath(KEY);
+  int size = 0;
+  char* data = FileSystem::readAll(path.c_str(), &size);
+  ASSERT_TRUE(data != nullptr);
+  data[size - 20] ^= 0xff;
+  Stream* stream = FileSystem::open(path.c_str(), FileSystem::WRITE);
+  ASSERT_TRUE(stream != nullptr);
+  stream->write(data, 1, size);
+  SAFE_DELETE(stream);
+  EXPECT_FALSE(cache->load(KEY, DRIVER, VERTEX_SOURCE, FRAGMENT_SOURCE, &entry));
+
+  // Truncate it.
+  stream = FileSystem::open(path.c_str(), FileSystem::WRITE);
+  ASSERT_TRUE(stream != nullptr);
+  stream->write(data, 1, size / 2);
+  SAFE_DELETE(stream);
+  EXPECT_FALSE(cache->load(KEY, DRIVER, VERTEX_SOURCE, FRAGMENT_SOURCE, &entry));
+  SAFE_DELETE_ARRAY(data);
+}
@@ -0,0 +1,121 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "scene/SpatialIndex.h"
+#include "math/Matrix.h"
+
+using namespace gameplay;
+
+class TestSpatialIndex : public ::testing::Test {
+protected:
+  static constexpr int nodeCount = 2000;
+
+  // A standalone index never dereferences its nodes, so each node is identified by a fake pointer.
+  static Node* fakeNode(int id) {
+    return reinterpret_cast<Node*>((uintptr_t)(id + 1) * 16);
+  }
+
+  static float random(unsigned int& seed, float min, float max) {
+    seed = seed * 1664525u + 1013904223u;
+    return min + (max - min) * (float)(seed >> 8) / (float)(1u << 24);
+  }
+
+  static BoundingSphere randomSphere(unsigned int& seed) {
+    return BoundingSphere(Vector3(random(seed, -500, 500), random(seed, -50, 50), random(seed, -500, 500)), random(seed, 0, 5));
+  }
+
+  // Sorts a query result so it can be compared with a brute force test of every sphere.
+  static std::vector<Node*> sorted(std::vector<Node*> nodes) {
+    std::sort(nodes.begin(), nodes.end());
+    return nodes;
+  }
+
+  template <class T>
+  static std::vector<Node*> bruteForce(const std::vector<BoundingSphere>& spheres, const std::vector<bool>& present, const T& volume) {
+    std::vector<Node*> nodes;
+    for (int i = 0; i < (int)spheres.size(); ++i) {
+      if (present[i] && spheres[i].intersects(volume))
+        nodes.push_back(fakeNode(i));
+    }
+    return sorted(nodes);
+  }
+
+  // Checks every kind of query against testing each sphere directly.
+  static void checkQueries(SpatialIndex& index, const std::vector<BoundingSphere>& spheres, const std::vector<bool>& present) {
+    Frustum frustum(Matrix::createPerspective(60.0f, 1.5f, 1.0f, 300.0f) * Matrix::createLookAt(Vector3(0, 20, 0), Vector3(100, 0, 100), Vector3::unitY()));
+
+    std::vector<Node*> nodes;
+    index.findNodes(frustum, nodes);
+    EXPECT_EQ(sorted(nodes), bruteForce(spheres, present, frustum));
+    EXPECT_FALSE(nodes.empty());
+
+    nodes.clear();
+    BoundingSphere sphere(Vector3(50, 0, -50), 120);
+    index.findNodes(sphere, nodes);
+    EXPECT_EQ(sorted(nodes), bruteForce(spheres, present, sphere));
+
+    nodes.clear();
+    BoundingBox box(-200, -10, -100, 0, 10, 300);
+    index.findNodes(box, nodes);
+    EXPECT_EQ(sorted(nodes), bruteForce(spheres, present, box));
+
+    // Rays only find spheres in front of their origin.
+    nodes.clear();
+    Ray ray(Vector3(-600, 0, -600), Vector3(1, 0, 1));
+    index.findNodes(ray, nodes);
+    std::vector<Node*> hits;
+    for (int i = 0; i < (int)spheres.size(); ++i) {
+      if (present[i] && spheres[i].intersects(ray) >= 0.0f)
+        hits.push_back(fakeNode(i));
+    }
+    EXPECT_EQ(sorted(nodes), sorted(hits));
+  }
+};
+
+// Test that queries find the same nodes as testing each one, as nodes are inserted, moved and removed
+TEST_F(TestSpatialIndex, Queries) {
+  SpatialIndex index;
+  std::vector<BoundingSphere> spheres;
+  std::vector<bool> present(nodeCount, true);
+  std::vector<int> proxies;
+  unsigned int seed = 7;
+  for (int i = 0; i < nodeCount; ++i) {
+    spheres.push_back(randomSphere(seed));
+    proxies.push_back(index.insert(fakeNode(i), spheres[i]));
+  }
+  EXPECT_EQ(index.getNodeCount(), (unsigned int)nodeCount);
+  checkQueries(index, spheres, present);
+
+  // Small moves stay within the enlarged boxes, large ones reinsert.
+  for (int i = 0; i < nodeCount; i += 2) {
+    spheres[i].center.x += i % 4 ? 0.1f : 300.0f;
+    index.move(proxies[i], spheres[i]);
+  }
+  for (int i = 1; i < nodeCount; i += 3) {
+    index.remove(proxies[i]);
+    present[i] = false;
+  }
+  checkQueries(index, spheres, present);
+
+  // Removed entries are reused.
+  int proxy = index.insert(fakeNode(1), spheres[1]);
+  present[1] = true;
+  EXPECT_EQ(proxy, proxies[1 + 3 * ((nodeCount - 2) / 3)]);
+  checkQueries(index, spheres, present);
+}
+
+// Test that rotations keep the hierarchy balanced when nodes are inserted in sorted order
+TEST_F(TestSpatialIndex, Balance) {
+  SpatialIndex index;
+  EXPECT_EQ(index.getHeight(), 0u);
+  for (int i = 0; i < 1024; ++i)
+    index.insert(fakeNode(i), BoundingSphere(Vector3((float)i, 0, 0), 0.5f));
+
+  // A balanced tree of 1024 leaves has a height of 11; a degenerate one would have a height of 1024.
+  EXPECT_LE(index.getHeight(), 2u * 11u);
+
+  // Queries of an empty index find nothing.
+  SpatialIndex empty;
+  std::vector<Node*> nodes;
+  EXPECT_EQ(empty.findNodes(BoundingSphere(Vector3::zero(), 10), nodes), 0u);
+}
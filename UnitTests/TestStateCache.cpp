@@ -0,0 +1,174 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "renderer/StateCache.h"
+
+using namespace gameplay;
+
+// Records the calls the cache makes instead of calling the graphics device.
+static std::vector<std::string> __calls;
+
+static void record(const char* name, unsigned int a, unsigned int b = 0) {
+  __calls.push_back(std::string(name) + " " + std::to_string(a) + " " + std::to_string(b));
+}
+
+static void mockUseProgram(GLuint program) { record("useProgram", program); }
+static void mockActiveTexture(GLenum texture) { record("activeTexture", texture - GL_TEXTURE0); }
+static void mockBindTexture(GLenum target, GLuint texture) { record("bindTexture", target, texture); }
+static void mockBindBuffer(GLenum target, GLuint buffer) { record("bindBuffer", target, buffer); }
+static void mockBindVertexArray(GLuint array) { record("bindVertexArray", array); }
+static void mockUniform1fv(GLint location, GLsizei count, const GLfloat*) { record("uniform1fv", location, count); }
+static void mockUniform2fv(GLint location, GLsizei count, const GLfloat*) { record("uniform2fv", location, count); }
+static void mockUniform3fv(GLint location, GLsizei count, const GLfloat*) { record("uniform3fv", location, count); }
+static void mockUniform4fv(GLint location, GLsizei count, const GLfloat*) { record("uniform4fv", location, count); }
+static void mockUniform1iv(GLint location, GLsizei count, const GLint*) { record("uniform1iv", location, count); }
+static void mockUniformMatrix4fv(GLint location, GLsizei count, GLboolean, const GLfloat*) { record("uniformMatrix4fv", location, count); }
+
+class TestStateCache : public ::testing::Test {
+protected:
+  void SetUp() override {
+    __calls.clear();
+  }
+
+  static StateCache::Functions mockFunctions() {
+    StateCache::Functions functions = {
+      mockUseProgram, mockActiveTexture, mockBindTexture, mockBindBuffer, mockBindVertexArray,
+      mockUniform1fv, mockUniform2fv, mockUniform3fv, mockUniform4fv, mockUniform1iv, mockUniformMatrix4fv
+    };
+    return functions;
+  }
+};
+
+// Test that binding what is already bound is skipped, per texture unit and per buffer target
+TEST_F(TestStateCache, Binds) {
+  StateCache cache(mockFunctions());
+
+  cache.useProgram(1);
+  cache.useProgram(1);
+  cache.useProgram(2);
+  EXPECT_EQ(2u, cache.getIssuedCount(StateCache::PROGRAM));
+  EXPECT_EQ(1u, cache.getSkippedCount(StateCache::PROGRAM));
+
+  // Each unit keeps its own bindings.
+  cache.activeTexture(GL_TEXTURE0);
+  cache.bindTexture(GL_TEXTURE_2D, 5);
+  cache.activeTexture(GL_TEXTURE1);
+  cache.bindTexture(GL_TEXTURE_2D, 5);
+  cache.bindTexture(GL_TEXTURE_CUBE_MAP, 6);
+  cache.activeTexture(GL_TEXTURE0);
+  cache.bindTexture(GL_TEXTURE_2D, 5);
+  EXPECT_EQ(3u, cache.getIssuedCount(StateCache::TEXTURE));
+  EXPECT_EQ(1u, cache.getSkippedCount(StateCache::TEXTURE));
+  EXPECT_EQ(3u, cache.getIssuedCount(StateCache::ACTIVE_TEXTURE));
+
+  // Deleting a texture unbinds it from every unit.
+  cache.textureDeleted(5);
+  cache.activeTexture(GL_TEXTURE1);
+  cache.bindTexture(GL_TEXTURE_2D, 0);
+  cache.bindTexture(GL_TEXTURE_2D, 5);
+  EXPECT_EQ(4u, cache.getIssuedCount(StateCache::TEXTURE));
+  EXPECT_EQ(2u, cache.getSkippedCount(StateCache::TEXTURE));
+
+  // The element array buffer belongs to the vertex array, so binding another vertex array forgets it.
+  cache.bindBuffer(GL_ARRAY_BUFFER, 7);
+  cache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 8);
+  cache.bindVertexArray(3);
+  cache.bindBuffer(GL_ARRAY_BUFFER, 7);
+  cache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 8);
+  cache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 8);
+  cache.bindVertexArray(3);
+  EXPECT_EQ(3u, cache.getIssuedCount(StateCache::BUFFER));
+  EXPECT_EQ(2u, cache.getSkippedCount(StateCache::BUFFER));
+  EXPECT_EQ(1u, cache.getSkippedCount(StateCache::VERTEX_ARRAY));
+
+  // Everything is bound again after invalidating.
+  __calls.clear();
+  cache.invalidate();
+  cache.useProgram(2);
+  cache.bindVertexArray(3);
+  cache.bindBuffer(GL_ARRAY_BUFFER, 7);
+  std::vector<std::string> expected = {
+    "useProgram 2 0",
+    "bindVertexArray 3 0",
+    "bindBuffer " + std::to_string(GL_ARRAY_BUFFER) + " 7"
+  };
+  EXPECT_EQ(expected, __calls);
+
+  cache.resetStatistics();
+  EXPECT_EQ(0u, cache.getIssuedCount(StateCache::BUFFER));
+  EXPECT_EQ(0u, cache.getSkippedCount(StateCache::BUFFER));
+}
+
+// Test that uniform values are shadowed per program, and that arrays are always set
+TEST_F(TestStateCache, Uniforms) {
+  StateCache cache(mockFunctions());
+  const GLfloat one = 1.0f;
+  const GLfloat two = 2.0f;
+  const GLfloat matrix[16] = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+
+  // Without a known program, nothing is shadowed.
+  cache.uniform1fv(0, 1, &one);
+  cache.uniform1fv(0, 1, &one);
+  EXPECT_EQ(2u, cache.getIssuedCount(StateCache::UNIFORM));
+
+  cache.useProgram(1);
+  cache.uniform1fv(0, 1, &one);
+  cache.uniform1fv(0, 1, &one);
+  cache.uniformMatrix4fv(1, 1, matrix);
+  cache.uniformMatrix4fv(1, 1, matrix);
+  cache.useProgram(2);
+  cache.uniform1fv(0, 1, &one);
+  cache.uniform1fv(0, 1, &two);
+
+  // The values of the first program are kept while another is in use.
+  cache.useProgram(1);
+  cache.uniform1fv(0, 1, &one);
+  cache.uniformMatrix4fv(1, 1, matrix);
+  EXPECT_EQ(6u, cache.getIssuedCount(StateCache::UNIFORM));
+  EXPECT_EQ(4u, cache.getSkippedCount(StateCache::UNIFORM));
+
+  // Setting an array forgets the values of the program.
+  const GLfloat values[2] = { 1.0f, 2.0f };
+  cache.uniform1fv(2, 2, values);
+  cache.uniform1fv(2, 2, values);
+  cache.uniform1fv(0, 1, &one);
+  EXPECT_EQ(9u, cache.getIssuedCount(StateCache::UNIFORM));
+
+  // A program deleted and created again with the same name starts with no values.
+  cache.useProgram(0);
+  cache.programDeleted(1);
+  cache.useProgram(1);
+  cache.uniform1fv(0, 1, &one);
+  EXPECT_EQ(10u, cache.getIssuedCount(StateCache::UNIFORM));
+
+  // Unused uniforms are passed through.
+  GLint unit = 0;
+  cache.uniform1iv(-1, 1, &unit);
+  EXPECT_EQ(11u, cache.getIssuedCount(StateCache::UNIFORM));
+  EXPECT_EQ("uniform1iv " + std::to_string((unsigned int)-1) + " 1", __calls.back());
+}
+
+// Test that invalidating the texture bindings keeps the rest of the shadowed state
+TEST_F(TestStateCache, InvalidateTextures) {
+  StateCache cache(mockFunctions());
+  const GLfloat one = 1.0f;
+
+  cache.useProgram(1);
+  cache.uniform1fv(0, 1, &one);
+  cache.bindBuffer(GL_ARRAY_BUFFER, 7);
+  cache.activeTexture(GL_TEXTURE0);
+  cache.bindTexture(GL_TEXTURE_2D, 5);
+
+  __calls.clear();
+  cache.invalidateTextures();
+  cache.useProgram(1);
+  cache.uniform1fv(0, 1, &one);
+  cache.bindBuffer(GL_ARRAY_BUFFER, 7);
+  cache.activeTexture(GL_TEXTURE0);
+  cache.bindTexture(GL_TEXTURE_2D, 5);
+  std::vector<std::string> expected = {
+    "activeTexture 0 0",
+    "bindTexture " + std::to_string(GL_TEXTURE_2D) + " 5"
+  };
+  EXPECT_EQ(expected, __calls);
+}
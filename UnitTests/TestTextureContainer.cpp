@@ -0,0 +1,225 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "renderer/TextureContainer.h"
+
+using namespace gameplay;
+
+class TestTextureContainer : public ::testing::Test {
+protected:
+  static constexpr unsigned int BC1_RGB = 0x83F0;
+  static constexpr unsigned int BC1_RGBA = 0x83F1;
+  static constexpr unsigned int ETC1 = 0x8D64;
+  static constexpr unsigned int ETC2_RGB = 0x9274;
+  static constexpr unsigned int ETC2_RGB_A1 = 0x9276;
+  static constexpr unsigned int ETC2_RGBA = 0x9278;
+
+  static void appendUInt(std::vector<unsigned char>& data, unsigned int value) {
+    data.insert(data.end(), (unsigned char*)&value, (unsigned char*)&value + sizeof(value));
+  }
+
+  static void appendULongLong(std::vector<unsigned char>& data, unsigned long long value) {
+    data.insert(data.end(), (unsigned char*)&value, (unsigned char*)&value + sizeof(value));
+  }
+
+  // Parses a copy of the data, which the container takes ownership of.
+  static TextureContainer* parse(const std::vector<unsigned char>& data) {
+    unsigned char* copy = new unsigned char[data.size()];
+    memcpy(copy, data.data(), data.size());
+    return TextureContainer::create(copy, data.size());
+  }
+
+  // An 8x4 RGBA8 KTX file with 2 levels and key/value data.
+  static std::vector<unsigned char> createKTX() {
+    const unsigned char identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+    std::vector<unsigned char> data(identifier, identifier + 12);
+    const unsigned int header[13] = { 0x04030201, GL_UNSIGNED_BYTE, 1, GL_RGBA, 0x8058, GL_RGBA, 8, 4, 0, 0, 1, 2, 8 };
+    for (unsigned int value : header)
+      appendUInt(data, value);
+    data.insert(data.end(), 8, 0);
+    appendUInt(data, 8 * 4 * 4);
+    data.insert(data.end(), 8 * 4 * 4, 1);
+    appendUInt(data, 4 * 2 * 4);
+    data.insert(data.end(), 4 * 2 * 4, 2);
+    return data;
+  }
+
+  // A 4x4 BC1 KTX2 cube map with one level, each face filled with its index.
+  static std::vector<unsigned char> createKTX2(unsigned int supercompressionScheme = 0) {
+    const unsigned char identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+    std::vector<unsigned char> data(identifier, identifier + 12);
+    const unsigned int header[9] = { 131, 1, 4, 4, 0, 0, 6, 1, supercompressionScheme };
+    for (unsigned int value : header)
+      appendUInt(data, value);
+    data.insert(data.end(), 32, 0);
+    appendULongLong(data, 104);
+    appendULongLong(data, 48);
+    appendULongLong(data, 48);
+    for (unsigned char face = 0; face < 6; ++face)
+      data.insert(data.end(), 8, face);
+    return data;
+  }
+};
+
+// Test that KTX levels are found after the key/value data
+TEST_F(TestTextureContainer, ParseKTX) {
+  std::vector<unsigned char> data = createKTX();
+  std::unique_ptr<TextureContainer> container(parse(data));
+  ASSERT_TRUE(container != nullptr);
+  EXPECT_EQ(container->getWidth(), 8u);
+  EXPECT_EQ(container->getHeight(), 4u);
+  EXPECT_EQ(container->getLevelCount(), 2u);
+  EXPECT_EQ(container->getFaceCount(), 1u);
+  EXPECT_FALSE(container->getGenerateMipmaps());
+  EXPECT_FALSE(container->isCompressed());
+  EXPECT_EQ(container->getPixelFormat(), (unsigned int)GL_RGBA);
+  EXPECT_EQ(container->getPixelType(), (unsigned int)GL_UNSIGNED_BYTE);
+  EXPECT_EQ(container->getUnpackAlignment(), 4u);
+
+  size_t size;
+  const unsigned char* image = container->getImage(0, 0, &size);
+  EXPECT_EQ(size, 128u);
+  EXPECT_EQ(image[0], 1);
+  EXPECT_EQ(image[127], 1);
+  image = container->getImage(1, 0, &size);
+  EXPECT_EQ(size, 32u);
+  EXPECT_EQ(image[0], 2);
+  EXPECT_EQ(image[31], 2);
+}
+
+// Test that KTX2 cube faces are split out of each level
+TEST_F(TestTextureContainer, ParseKTX2) {
+  std::vector<unsigned char> data = createKTX2();
+  std::unique_ptr<TextureContainer> container(parse(data));
+  ASSERT_TRUE(container != nullptr);
+  EXPECT_EQ(container->getWidth(), 4u);
+  EXPECT_EQ(container->getLevelCount(), 1u);
+  EXPECT_EQ(container->getFaceCount(), 6u);
+  EXPECT_TRUE(container->isCompressed());
+  EXPECT_EQ(container->getInternalFormat(), BC1_RGB);
+  EXPECT_TRUE(TextureContainer::canDecompress(container->getInternalFormat()));
+
+  for (unsigned int face = 0; face < 6; ++face) {
+    size_t size;
+    const unsigned char* image = container->getImage(0, face, &size);
+    EXPECT_EQ(size, 8u);
+    EXPECT_EQ(image[0], face);
+  }
+}
+
+// Test that truncated, supercompressed and unknown files are rejected
+TEST_F(TestTextureContainer, RejectInvalid) {
+  std::vector<unsigned char> data = createKTX();
+  data.resize(data.size() - 1);
+  EXPECT_TRUE(parse(data) == nullptr);
+
+  data = createKTX2();
+  data.resize(data.size() - 8);
+  EXPECT_TRUE(parse(data) == nullptr);
+
+  EXPECT_TRUE(parse(createKTX2(2)) == nullptr);
+
+  data.assign(128, 0);
+  EXPECT_TRUE(parse(data) == nullptr);
+}
+
+// Test that BC1 blocks decode both color modes and clip to the image size
+TEST_F(TestTextureContainer, DecompressBC1) {
+  // Red and blue endpoints; the first row uses indices 0 to 3.
+  const unsigned char block[8] = { 0x00, 0xF8, 0x1F, 0x00, 0xE4, 0, 0, 0 };
+  unsigned char rgba[4 * 4 * 4];
+  ASSERT_TRUE(TextureContainer::decompress(BC1_RGB, block, sizeof(block), 4, 4, rgba));
+  const unsigned char expected[4][4] = { { 255, 0, 0, 255 }, { 0, 0, 255, 255 }, { 170, 0, 85, 255 }, { 85, 0, 170, 255 } };
+  for (int i = 0; i < 4; ++i)
+    EXPECT_EQ(memcmp(&rgba[i * 4], expected[i], 4), 0) << "pixel " << i;
+  EXPECT_EQ(memcmp(&rgba[15 * 4], expected[0], 4), 0);
+
+  // Swapped endpoints select the three color mode, where the last color is transparent black. The first row uses indices 2 and 3.
+  const unsigned char transparent[8] = { 0x1F, 0x00, 0x00, 0xF8, 0x0E, 0, 0, 0 };
+  ASSERT_TRUE(TextureContainer::decompress(BC1_RGBA, transparent, sizeof(transparent), 2, 2, rgba));
+  const unsigned char half[4] = { 127, 0, 127, 255 };
+  const unsigned char black[4] = { 0, 0, 0, 0 };
+  EXPECT_EQ(memcmp(&rgba[0], half, 4), 0);
+  EXPECT_EQ(memcmp(&rgba[4], black, 4), 0);
+
+  EXPECT_FALSE(TextureContainer::decompress(BC1_RGB, block, sizeof(block), 8, 4, rgba));
+}
+
+// Test that ETC1 blocks apply the modifier of each pixel to the base color of its half
+TEST_F(TestTextureContainer, DecompressETC1) {
+  // Individual mode with red 0x8 on the left and 0x0 on the right, and the smallest modifier table.
+  const unsigned char block[8] = { 0x80, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00 };
+  unsigned char rgba[4 * 4 * 4];
+  ASSERT_TRUE(TextureContainer::decompress(ETC1, block, sizeof(block), 4, 4, rgba));
+
+  // Pixel (0, 0) has the most significant index bit set, selecting -2; the others add 2.
+  EXPECT_EQ(rgba[0], 136 - 2);
+  EXPECT_EQ(rgba[1], 0);
+  EXPECT_EQ(rgba[3], 255);
+  EXPECT_EQ(rgba[4 * 4], 136 + 2);
+  EXPECT_EQ(rgba[3 * 4], 0 + 2);
+  EXPECT_EQ(rgba[(3 * 4 + 3) * 4], 0 + 2);
+}
+
+// Test that ETC2 blocks whose differential colors overflow decode in the T, H and planar modes
+TEST_F(TestTextureContainer, DecompressETC2) {
+  // Each row of these blocks uses the index of its row.
+  unsigned char rgba[4 * 4 * 4];
+
+  // T mode: green, then gray 0x88 moved by the smallest distance, 3.
+  const unsigned char t[8] = { 0x04, 0xF0, 0x88, 0x82, 0xCC, 0xCC, 0xAA, 0xAA };
+  ASSERT_TRUE(TextureContainer::decompress(ETC2_RGB, t, sizeof(t), 4, 4, rgba));
+  const unsigned char tColors[4][4] = { { 0, 255, 0, 255 }, { 139, 139, 139, 255 }, { 136, 136, 136, 255 }, { 133, 133, 133, 255 } };
+  for (int y = 0; y < 4; ++y)
+    EXPECT_EQ(memcmp(&rgba[(y * 4 + 3) * 4], tColors[y], 4), 0) << "row " << y;
+
+  // H mode: red and blue, both moved by 6 since red orders first.
+  const unsigned char h[8] = { 0x78, 0x04, 0x00, 0x7A, 0xCC, 0xCC, 0xAA, 0xAA };
+  ASSERT_TRUE(TextureContainer::decompress(ETC2_RGB, h, sizeof(h), 4, 4, rgba));
+  const unsigned char hColors[4][4] = { { 255, 6, 6, 255 }, { 249, 0, 0, 255 }, { 6, 6, 255, 255 }, { 0, 0, 249, 255 } };
+  for (int y = 0; y < 4; ++y)
+    EXPECT_EQ(memcmp(&rgba[(y * 4 + 1) * 4], hColors[y], 4), 0) << "row " << y;
+
+  // Planar mode: black at the origin, red at the horizontal end and green at the vertical end.
+  const unsigned char planar[8] = { 0x00, 0x00, 0x04, 0x7F, 0x00, 0x00, 0x1F, 0xC0 };
+  ASSERT_TRUE(TextureContainer::decompress(ETC2_RGB, planar, sizeof(planar), 4, 4, rgba));
+  const unsigned char ramp[4] = { 0, 64, 128, 191 };
+  for (int y = 0; y < 4; ++y) {
+    for (int x = 0; x < 4; ++x) {
+      const unsigned char expected[4] = { ramp[x], ramp[y], 0, 255 };
+      EXPECT_EQ(memcmp(&rgba[(y * 4 + x) * 4], expected, 4), 0) << "pixel " << x << ", " << y;
+    }
+  }
+}
+
+// Test that ETC2 alpha comes from EAC blocks, or from the punchthrough index when the opaque flag is clear
+TEST_F(TestTextureContainer, DecompressETC2Alpha) {
+  unsigned char rgba[4 * 4 * 4];
+  unsigned char colors[4 * 4 * 4];
+
+  // Base alpha 100 with a multiplier of 2 on modifier table 13, and pixel i using index i % 8, followed by the T mode block.
+  const unsigned char eac[16] = { 100, 0x2D, 0x05, 0x39, 0x77, 0x05, 0x39, 0x77, 0x04, 0xF0, 0x88, 0x82, 0xCC, 0xCC, 0xAA, 0xAA };
+  ASSERT_TRUE(TextureContainer::decompress(ETC2_RGBA, eac, sizeof(eac), 4, 4, rgba));
+  ASSERT_TRUE(TextureContainer::decompress(ETC2_RGB, eac + 8, 8, 4, 4, colors));
+  const unsigned char alphas[8] = { 98, 96, 94, 80, 100, 102, 104, 118 };
+  for (int x = 0; x < 4; ++x) {
+    for (int y = 0; y < 4; ++y) {
+      int pixel = (y * 4 + x) * 4;
+      EXPECT_EQ(rgba[pixel + 3], alphas[(x * 4 + y) % 8]) << "pixel " << x << ", " << y;
+      EXPECT_EQ(memcmp(&rgba[pixel], &colors[pixel], 3), 0) << "pixel " << x << ", " << y;
+    }
+  }
+
+  // Differential gray 132 with the smallest modifiers. Without the opaque flag, index 0 adds nothing and index 2 is transparent.
+  unsigned char block[8] = { 0x80, 0x80, 0x80, 0x00, 0xCC, 0xCC, 0xAA, 0xAA };
+  ASSERT_TRUE(TextureContainer::decompress(ETC2_RGB_A1, block, sizeof(block), 4, 4, rgba));
+  const unsigned char punchthrough[4][4] = { { 132, 132, 132, 255 }, { 140, 140, 140, 255 }, { 0, 0, 0, 0 }, { 124, 124, 124, 255 } };
+  for (int y = 0; y < 4; ++y)
+    EXPECT_EQ(memcmp(&rgba[y * 4 * 4], punchthrough[y], 4), 0) << "row " << y;
+
+  block[3] = 0x02;
+  ASSERT_TRUE(TextureContainer::decompress(ETC2_RGB_A1, block, sizeof(block), 4, 4, rgba));
+  const unsigned char opaque[4][4] = { { 134, 134, 134, 255 }, { 140, 140, 140, 255 }, { 130, 130, 130, 255 }, { 124, 124, 124, 255 } };
+  for (int y = 0; y < 4; ++y)
+    EXPECT_EQ(memcmp(&rgba[y * 4 * 4], opaque[y], 4), 0) << "row " << y;
+}
@@ -0,0 +1,74 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "renderer/TextureDecoder.h"
+
+using namespace gameplay;
+
+class TestTextureDecoder : public ::testing::Test {
+};
+
+// Test that the box filter rounds the average of each 2x2 block, including the vectorized pixel pairs and odd edges
+TEST_F(TestTextureDecoder, BoxDownsample) {
+  static constexpr unsigned int width = 11;
+  static constexpr unsigned int height = 5;
+  std::vector<unsigned char> image(width * height * 4);
+  for (size_t i = 0; i < image.size(); ++i)
+    image[i] = (unsigned char)((i * 97 + 13) % 256);
+
+  std::vector<unsigned char> level(5 * 2 * 4);
+  TextureDecoder::downsample(image.data(), width, height, 4, TextureDecoder::BOX, level.data());
+  for (unsigned int y = 0; y < 2; ++y) {
+    for (unsigned int x = 0; x < 5; ++x) {
+      for (unsigned int c = 0; c < 4; ++c) {
+        unsigned int sum = image[((y * 2) * width + x * 2) * 4 + c] + image[((y * 2) * width + x * 2 + 1) * 4 + c] +
+          image[((y * 2 + 1) * width + x * 2) * 4 + c] + image[((y * 2 + 1) * width + x * 2 + 1) * 4 + c];
+        EXPECT_EQ(level[(y * 5 + x) * 4 + c], (sum + 2) / 4) << x << ", " << y;
+      }
+    }
+  }
+}
+
+// Test that a full chain is generated down to 1x1
+TEST_F(TestTextureDecoder, GenerateLevels) {
+  std::vector<unsigned char> image(16 * 4 * 3, 200);
+  TextureDecoder::Levels levels;
+  TextureDecoder::generateLevels(image.data(), 16, 4, 3, TextureDecoder::KAISER, levels);
+  ASSERT_EQ(levels.size(), 5u);
+  EXPECT_EQ(levels[0], image);
+  EXPECT_EQ(levels[1].size(), 8u * 2u * 3u);
+  EXPECT_EQ(levels[2].size(), 4u * 1u * 3u);
+  EXPECT_EQ(levels[3].size(), 2u * 1u * 3u);
+  EXPECT_EQ(levels[4].size(), 3u);
+
+  // Flat images stay flat, since the filter weights add up to 1.
+  for (const std::vector<unsigned char>& level : levels) {
+    for (unsigned char value : level)
+      EXPECT_EQ(value, 200);
+  }
+}
+
+// Test that the Kaiser filter averages the highest frequency away like the box filter, and keeps a one pixel side
+TEST_F(TestTextureDecoder, KaiserDownsample) {
+  static constexpr unsigned int width = 8;
+  unsigned char stripes[width];
+  for (unsigned int x = 0; x < width; ++x)
+    stripes[x] = x % 2 ? 255 : 0;
+
+  unsigned char box[width / 2];
+  unsigned char kaiser[width / 2];
+  TextureDecoder::downsample(stripes, width, 1, 1, TextureDecoder::BOX, box);
+  TextureDecoder::downsample(stripes, width, 1, 1, TextureDecoder::KAISER, kaiser);
+  for (unsigned int x = 0; x < width / 2; ++x) {
+    EXPECT_EQ(box[x], 128);
+    EXPECT_NEAR(kaiser[x], 128, 1);
+  }
+
+  // A step keeps a sharper edge than the box filter, with values that stay in range.
+  unsigned char step[width] = { 0, 0, 0, 0, 255, 255, 255, 255 };
+  TextureDecoder::downsample(step, width, 1, 1, TextureDecoder::KAISER, kaiser);
+  EXPECT_EQ(kaiser[0], 0);
+  EXPECT_LT(kaiser[1], 64);
+  EXPECT_GT(kaiser[2], 191);
+  EXPECT_EQ(kaiser[3], 255);
+}
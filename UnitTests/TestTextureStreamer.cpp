@@ -0,0 +1,59 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "renderer/TextureStreamer.h"
+
+using namespace gameplay;
+
+class TestTextureStreamer : public ::testing::Test {
+};
+
+// Test that a full chain halves the largest side down to a single pixel
+TEST_F(TestTextureStreamer, LevelCount) {
+  EXPECT_EQ(TextureStreamer::getLevelCount(1, 1), 1u);
+  EXPECT_EQ(TextureStreamer::getLevelCount(256, 256), 9u);
+  EXPECT_EQ(TextureStreamer::getLevelCount(256, 16), 9u);
+  EXPECT_EQ(TextureStreamer::getLevelCount(300, 200), 9u);
+
+  EXPECT_EQ(TextureStreamer::getLevelSize(256, 16, 4, 0), 256u * 16u * 4u);
+  EXPECT_EQ(TextureStreamer::getLevelSize(256, 16, 4, 5), 8u * 1u * 4u);
+  EXPECT_EQ(TextureStreamer::getLevelSize(256, 16, 4, 8), 4u);
+}
+
+// Test that the level needed halves the detail for each halving of the screen size
+TEST_F(TestTextureStreamer, LevelForScreenSize) {
+  EXPECT_EQ(TextureStreamer::getLevelForScreenSize(1024, 1024, 2048.0f), 0u);
+  EXPECT_EQ(TextureStreamer::getLevelForScreenSize(1024, 1024, 1024.0f), 0u);
+  EXPECT_EQ(TextureStreamer::getLevelForScreenSize(1024, 1024, 700.0f), 0u);
+  EXPECT_EQ(TextureStreamer::getLevelForScreenSize(1024, 1024, 512.0f), 1u);
+  EXPECT_EQ(TextureStreamer::getLevelForScreenSize(1024, 1024, 64.0f), 4u);
+  EXPECT_EQ(TextureStreamer::getLevelForScreenSize(1024, 512, 0.0f), 10u);
+  EXPECT_EQ(TextureStreamer::getLevelForScreenSize(1024, 1024, std::numeric_limits<float>::max()), 0u);
+}
+
+// Test that levels are box filtered, with odd sizes repeating their last row and column
+TEST_F(TestTextureStreamer, GenerateLevels) {
+  // A 3x2 single channel image.
+  const unsigned char pixels[] = { 0, 100, 200, 40, 60, 240 };
+  TextureStreamer::Levels levels(TextureStreamer::getLevelCount(3, 2));
+  ASSERT_EQ(levels.size(), 2u);
+  TextureStreamer::generateLevels(pixels, 3, 2, 1, 0, 2, levels);
+  ASSERT_EQ(levels[0].size(), 6u);
+  ASSERT_EQ(levels[1].size(), 1u);
+  EXPECT_EQ(levels[1][0], (0 + 100 + 40 + 60 + 2) / 4);
+
+  // Only the requested levels are kept.
+  std::vector<unsigned char> image(64 * 32 * 4);
+  for (size_t i = 0; i < image.size(); ++i)
+    image[i] = (unsigned char)(i % 4 == 3 ? 255 : 128);
+  levels.assign(TextureStreamer::getLevelCount(64, 32), std::vector<unsigned char>());
+  ASSERT_EQ(levels.size(), 7u);
+  TextureStreamer::generateLevels(image.data(), 64, 32, 4, 2, 7, levels);
+  EXPECT_TRUE(levels[0].empty());
+  EXPECT_TRUE(levels[1].empty());
+  for (unsigned int level = 2; level < 7; ++level) {
+    ASSERT_EQ(levels[level].size(), TextureStreamer::getLevelSize(64, 32, 4, level));
+    EXPECT_EQ(levels[level][0], 128);
+    EXPECT_EQ(levels[level][3], 255);
+  }
+}
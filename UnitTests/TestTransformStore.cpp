@@ -0,0 +1,145 @@
+#include "pch.h"
+
+#include "framework/Base.h"
+#include "scene/Scene.h"
+#include "scene/TransformStore.h"
+
+using namespace gameplay;
+
+class TestTransformStore : public ::testing::Test {
+protected:
+  // Builds the same hierarchy of transformed nodes in a scene, with or without a transform store.
+  //
+  //   root0 -> a -> b -> c
+  //         -> d
+  //   root1 -> e -> f
+  static Scene* createScene(bool store, std::vector<Node*>& nodes) {
+    Scene* scene = Scene::create();
+    scene->setTransformStoreEnabled(store);
+    const char* ids[] = { "root0", "a", "b", "c", "d", "root1", "e", "f" };
+    const int parents[] = { -1, 0, 1, 2, 0, -1, 5, 6 };
+    for (int i = 0; i < 8; ++i) {
+      Node* node = Node::create(ids[i]);
+      node->setTranslation((float)i, (float)(i % 3), -(float)i * 0.5f);
+      node->setRotation(Vector3(0.0f, 1.0f, 0.0f), 0.2f * (float)i);
+      node->setScale(1.0f + 0.1f * (float)(i % 2));
+      if (parents[i] < 0)
+        scene->addNode(node);
+      else
+        nodes[parents[i]]->addChild(node);
+      node->release();
+      nodes.push_back(node);
+    }
+    return scene;
+  }
+
+  // Checks the world matrices of the nodes of a scene against those of the same nodes in a scene without a store.
+  static void expectSameWorld(const std::vector<Node*>& expected, const std::vector<Node*>& actual) {
+    for (size_t i = 0; i < expected.size(); ++i)
+      expectMatrixNear(expected[i]->getWorldMatrix(), actual[i]->getWorldMatrix());
+  }
+
+  static void expectMatrixNear(const Matrix& expected, const Matrix& actual) {
+    for (int i = 0; i < 16; ++i)
+      EXPECT_NEAR(expected.m[i], actual.m[i], 1e-5f);
+  }
+};
+
+// Test that nodes are tracked as they are added and removed
+TEST_F(TestTransformStore, AddRemoveNodes) {
+  std::vector<Node*> stored;
+  std::vector<Node*> plain;
+  Scene* storeScene = createScene(true, stored);
+  Scene* plainScene = createScene(false, plain);
+  TransformStore* store = storeScene->getTransformStore();
+  ASSERT_TRUE(store != nullptr);
+  store->update();
+  EXPECT_EQ(8u, store->getNodeCount());
+
+  // Removing a node stops tracking its whole subtree.
+  Node* a = stored[1];
+  a->addRef();
+  stored[0]->removeChild(a);
+  store->update();
+  EXPECT_EQ(5u, store->getNodeCount());
+
+  // A removed node computes its own world matrix again.
+  plain[1]->addRef();
+  plain[0]->removeChild(plain[1]);
+  a->translateY(1.0f);
+  plain[1]->translateY(1.0f);
+  expectSameWorld(plain, stored);
+
+  // Adding the nodes back tracks them again.
+  stored[6]->addChild(a);
+  plain[6]->addChild(plain[1]);
+  a->release();
+  plain[1]->release();
+  store->update();
+  EXPECT_EQ(8u, store->getNodeCount());
+  expectSameWorld(plain, stored);
+
+  // Disabling the store hands every node its resolved world matrix back.
+  Matrix world = stored[3]->getWorldMatrix();
+  storeScene->setTransformStoreEnabled(false);
+  EXPECT_TRUE(storeScene->getTransformStore() == nullptr);
+  expectMatrixNear(world, stored[3]->getWorldMatrix());
+
+  SAFE_RELEASE(storeScene);
+  SAFE_RELEASE(plainScene);
+}
+
+// Test that a subtree moved under a node added after it still resolves its parents first
+TEST_F(TestTransformStore, ReparentedSubtreeFollowsParent) {
+  std::vector<Node*> stored;
+  std::vector<Node*> plain;
+  Scene* storeScene = createScene(true, stored);
+  Scene* plainScene = createScene(false, plain);
+  TransformStore* store = storeScene->getTransformStore();
+  store->update();
+
+  // Move a deep subtree under a node that was sorted after it.
+  stored[7]->addChild(stored[2]);
+  plain[7]->addChild(plain[2]);
+  expectSameWorld(plain, stored);
+
+  // Changing the new ancestors is resolved before the moved nodes in the same pass.
+  stored[5]->rotateX(0.4f);
+  plain[5]->rotateX(0.4f);
+  stored[7]->translateZ(-3.0f);
+  plain[7]->translateZ(-3.0f);
+  store->update();
+  EXPECT_EQ(5u, store->getUpdatedCount());
+  expectSameWorld(plain, stored);
+
+  SAFE_RELEASE(storeScene);
+  SAFE_RELEASE(plainScene);
+}
+
+// Test that world matrices from the store match those each node computes on its own
+TEST_F(TestTransformStore, WorldMatricesMatchNodes) {
+  std::vector<Node*> stored;
+  std::vector<Node*> plain;
+  Scene* storeScene = createScene(true, stored);
+  Scene* plainScene = createScene(false, plain);
+  TransformStore* store = storeScene->getTransformStore();
+  expectSameWorld(plain, stored);
+
+  // Only the subtree of a changed node is recomputed.
+  stored[1]->translateX(2.0f);
+  plain[1]->translateX(2.0f);
+  store->update();
+  EXPECT_EQ(3u, store->getUpdatedCount());
+  expectSameWorld(plain, stored);
+
+  // Changes to several nodes at different depths are resolved in one pass.
+  stored[2]->rotateZ(0.5f);
+  plain[2]->rotateZ(0.5f);
+  stored[5]->setScale(2.0f);
+  plain[5]->setScale(2.0f);
+  expectSameWorld(plain, stored);
+  EXPECT_EQ(5u, store->getUpdatedCount());
+
+  SAFE_RELEASE(storeScene);
+  SAFE_RELEASE(plainScene);
+}
@@ -34,16 +34,20 @@ attribute vec3 a_color;
 
 ///////////////////////////////////////////////////////////
 // Uniforms
+#if !defined(INSTANCED)
 uniform mat4 u_worldViewProjectionMatrix;
+#endif
 
 #if defined(SKINNING)
 uniform vec4 u_matrixPalette[SKINNING_JOINT_COUNT * 3];
 #endif
 
 #if defined(LIGHTING)
+#if !defined(INSTANCED)
 uniform mat4 u_inverseTransposeWorldViewMatrix;
+#endif
 
-#if (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0) || defined(SPECULAR)
+#if ((POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0) || defined(SPECULAR)) && !defined(INSTANCED)
 uniform mat4 u_worldViewMatrix;
 #endif
 
@@ -67,10 +71,38 @@ uniform vec3 u_cameraPosition;
 #endif
 
 #if defined(CLIP_PLANE)
+#if !defined(INSTANCED)
 uniform mat4 u_worldMatrix;
+#endif
 uniform vec4 u_clipPlane;
 #endif
 
+#if defined(INSTANCED)
+// Each instance supplies its world matrix, and the world-derived matrices are
+// computed from it.
+attribute mat4 a_instanceMatrix;
+uniform mat4 u_viewMatrix;
+uniform mat4 u_viewProjectionMatrix;
+
+// The cofactor matrix of the instance's rotation and scale, which is its inverse
+// transpose scaled by the determinant. Only the sign of the determinant is kept, as
+// normals are normalized, so non-uniformly scaled instances get correct normals.
+mat4 getInstanceNormalMatrix()
+{
+    vec3 x = a_instanceMatrix[0].xyz;
+    vec3 y = a_instanceMatrix[1].xyz;
+    vec3 z = a_instanceMatrix[2].xyz;
+    vec3 yz = cross(y, z);
+    float s = dot(x, yz) < 0.0 ? -1.0 : 1.0;
+    return mat4(vec4(yz * s, 0.0), vec4(cross(z, x) * s, 0.0), vec4(cross(x, y) * s, 0.0), vec4(0.0, 0.0, 0.0, 1.0));
+}
+
+#define u_worldMatrix a_instanceMatrix
+#define u_worldViewMatrix (u_viewMatrix * a_instanceMatrix)
+#define u_worldViewProjectionMatrix (u_viewProjectionMatrix * a_instanceMatrix)
+#define u_inverseTransposeWorldViewMatrix (u_viewMatrix * getInstanceNormalMatrix())
+#endif
+
 ///////////////////////////////////////////////////////////
 // Varyings
 #if defined(LIGHTMAP)
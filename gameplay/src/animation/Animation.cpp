@@ -172,6 +172,23 @@ namespace gameplay
     return _clips ? (unsigned int)_clips->size() : 0;
   }
 
+  AnimationController* Animation::getAnimationController() const
+  {
+    return _controller;
+  }
+
+  void Animation::setAnimationController(AnimationController* controller)
+  {
+    assert(controller);
+    assert(!_defaultClip || !_defaultClip->isPlaying());
+    if (_clips)
+    {
+      for (AnimationClip* clip : *_clips)
+        assert(!clip->isPlaying());
+    }
+    _controller = controller;
+  }
+
   void Animation::play(const char* clipId)
   {
     // If id is nullptr, play the default clip.
@@ -393,6 +410,17 @@ namespace gameplay
     return channel;
   }
 
+  Animation::Channel* Animation::createChannel(AnimationTarget* target, int propertyId, Curve* curve, unsigned long duration)
+  {
+    assert(target);
+    assert(curve);
+    assert(curve->getComponentCount() == target->getAnimationPropertyComponentCount(propertyId));
+
+    Channel* channel = new Channel(this, target, propertyId, curve, duration);
+    addChannel(channel);
+    return channel;
+  }
+
   void Animation::addChannel(Channel* channel)
   {
     assert(channel);
@@ -24,6 +24,7 @@ class AnimationClip;
 class Animation : public Ref
 {
     friend class AnimationClip;
+    friend class AnimationController;
     friend class AnimationTarget;
     friend class Bundle;
 
@@ -111,6 +112,22 @@ public:
      */
     bool targets(AnimationTarget* target) const;
 
+    /**
+     * Gets the AnimationController that the clips of this animation are played on.
+     *
+     * @return The AnimationController, which is the game's controller unless another one was set.
+     */
+    AnimationController* getAnimationController() const;
+
+    /**
+     * Sets the AnimationController that the clips of this animation are played on.
+     *
+     * None of the clips of the animation may be playing when the controller is changed.
+     *
+     * @param controller The AnimationController to play the clips on.
+     */
+    void setAnimationController(AnimationController* controller);
+
 private:
 
     /**
@@ -122,6 +139,7 @@ private:
     class Channel
     {
         friend class AnimationClip;
+        friend class AnimationController;
         friend class Animation;
         friend class AnimationTarget;
 
@@ -201,6 +219,11 @@ private:
      */
     Channel* createChannel(AnimationTarget* target, int propertyId, unsigned int keyCount, unsigned int* keyTimes, float* keyValues, float* keyInValue, float* keyOutValue, unsigned int type);
 
+    /**
+     * Creates a channel within this animation from an existing curve.
+     */
+    Channel* createChannel(AnimationTarget* target, int propertyId, Curve* curve, unsigned long duration);
+
     /**
      * Adds a channel to the animation.
      */
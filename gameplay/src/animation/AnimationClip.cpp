@@ -14,7 +14,7 @@ namespace gameplay
   AnimationClip::AnimationClip(const char* id, Animation* animation, unsigned long startTime, unsigned long endTime)
     : _id(id), _animation(animation), _startTime(startTime), _endTime(endTime), _duration(_endTime - _startTime),
     _stateBits(0x00), _repeatCount(1.0f), _loopBlendTime(0), _activeDuration(_duration* _repeatCount), _speed(1.0f), _timeStarted(0),
-    _elapsedTime(0), _crossFadeToClip(nullptr), _crossFadeOutElapsed(0), _crossFadeOutDuration(0), _blendWeight(1.0f),
+    _elapsedTime(0), _crossFadeToClip(nullptr), _crossFadeOutElapsed(0), _crossFadeOutDuration(0), _blendWeight(1.0f), _percentComplete(0),
     _beginListeners(nullptr), _endListeners(nullptr), _listeners(nullptr), _listenerItr(nullptr)
   {
     GP_REGISTER_SCRIPT_EVENTS();
@@ -28,6 +28,7 @@ namespace gameplay
       // Construct AnimationValue and add it to the values vector
       _values.emplace_back(new AnimationValue(channel->getCurve()->getComponentCount()));
       });
+    _cursors.resize(_values.size());
   }
 
   AnimationClip::~AnimationClip()
@@ -395,20 +396,19 @@ namespace gameplay
     }
   }
 
-  bool AnimationClip::update(float elapsedTime)
+  AnimationClip::AdvanceResult AnimationClip::advance(float elapsedTime)
   {
     if (isClipStateBitSet(CLIP_IS_PAUSED_BIT))
     {
-      return false;
+      return IDLE;
     }
 
     if (isClipStateBitSet(CLIP_IS_MARKED_FOR_REMOVAL_BIT))
     {
       // If the marked for removal bit is set, it means stop() was called on the AnimationClip at some point
-      // after the last update call. Reset the flag, and return true so the AnimationClip is removed from the 
-      // running clips on the AnimationController.
-      onEnd();
-      return true;
+      // after the last update call. Report it as ended so the AnimationController removes it from the 
+      // running clips.
+      return ENDED;
     }
 
     if (!isClipStateBitSet(CLIP_IS_STARTED_BIT))
@@ -496,10 +496,10 @@ namespace gameplay
     // Compute percentage complete for the current loop (prevent a divide by zero if _duration==0).
     // Note that we don't use (currentTime/(_duration+_loopBlendTime)). That's because we want a
     // % value that is outside the 0-1 range for loop smoothing/blending purposes.
-    float percentComplete = _duration == 0 ? 1 : currentTime / (float)_duration;
+    _percentComplete = _duration == 0 ? 1 : currentTime / (float)_duration;
 
     if (_loopBlendTime == 0.0f)
-      percentComplete = MATH_CLAMP(percentComplete, 0.0f, 1.0f);
+      _percentComplete = MATH_CLAMP(_percentComplete, 0.0f, 1.0f);
 
     // If we're cross fading, compute blend weights
     if (isClipStateBitSet(CLIP_IS_FADING_OUT_BIT))
@@ -549,39 +549,28 @@ namespace gameplay
       }
     }
 
-    // Evaluate this clip.
-    Animation::Channel* channel = nullptr;
-    AnimationValue* value = nullptr;
-    AnimationTarget* target = nullptr;
+    return isClipStateBitSet(CLIP_IS_STARTED_BIT) ? ADVANCED : ENDED;
+  }
+
+  void AnimationClip::evaluate()
+  {
+    assert(_animation);
+
     size_t channelCount = _animation->_channels.size();
     float percentageStart = (float)_startTime / (float)_animation->_duration;
     float percentageEnd = (float)_endTime / (float)_animation->_duration;
     float percentageBlend = (float)_loopBlendTime / (float)_animation->_duration;
     for (size_t i = 0; i < channelCount; i++)
     {
-      channel = _animation->_channels[i];
+      Animation::Channel* channel = _animation->_channels[i];
       assert(channel);
-      target = channel->_target;
-      assert(target);
-      value = _values[i];
+      assert(channel->getCurve());
+      AnimationValue* value = _values[i];
       assert(value);
 
       // Evaluate the point on Curve
-      assert(channel->getCurve());
-      channel->getCurve()->evaluate(percentComplete, percentageStart, percentageEnd, percentageBlend, value->_value);
-
-      // Set the animation value on the target property.
-      target->setAnimationPropertyValue(channel->_propertyId, value, _blendWeight);
-    }
-
-    // When ended. Probably should move to it's own method so we can call it when the clip is ended early.
-    if (isClipStateBitSet(CLIP_IS_MARKED_FOR_REMOVAL_BIT) || !isClipStateBitSet(CLIP_IS_STARTED_BIT))
-    {
-      onEnd();
-      return true;
+      channel->getCurve()->evaluate(_percentComplete, percentageStart, percentageEnd, percentageBlend, value->_value, &_cursors[i]);
     }
-
-    return false;
   }
 
   void AnimationClip::onBegin()
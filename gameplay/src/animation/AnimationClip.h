@@ -348,9 +348,30 @@ namespace gameplay
     AnimationClip& operator=(const AnimationClip&);
 
     /**
-     * Updates the animation with the elapsed time.
+     * The result of advancing a clip.
      */
-    bool update(float elapsedTime);
+    enum AdvanceResult
+    {
+      ADVANCED,   // The clip is running and should be evaluated this frame.
+      ENDED,      // The clip reached its end or was stopped, and should be removed from the controller.
+      IDLE        // The clip is paused and is left as it is.
+    };
+
+    /**
+     * Advances the clip by the elapsed time, fires its events and updates its blend weight.
+     *
+     * A clip that reached its end is positioned on its end value, but onEnd() is left to the caller.
+     *
+     * @return What the caller should do with the clip this frame.
+     */
+    AdvanceResult advance(float elapsedTime);
+
+    /**
+     * Evaluates the clip's curves at the position computed by advance() into its values.
+     *
+     * Only the clip's own values are written, so different clips can be evaluated concurrently.
+     */
+    void evaluate();
 
     /**
      * Handles when the AnimationClip begins.
@@ -402,7 +423,9 @@ namespace gameplay
     float _crossFadeOutElapsed;                         // The amount of time that has elapsed for the crossfade.
     unsigned long _crossFadeOutDuration;                // The duration of the cross fade.
     float _blendWeight;                                 // The clip's blendweight.
+    float _percentComplete;                             // The position within the current loop, computed by advance().
     std::vector<AnimationValue*> _values;               // AnimationValue holder.
+    std::vector<Curve::Cursor> _cursors;                // The keyframe cursor of each channel's curve.
     std::vector<Listener*>* _beginListeners;            // Collection of begin listeners on the clip.
     std::vector<Listener*>* _endListeners;              // Collection of end listeners on the clip.
     std::list<ListenerEvent*>* _listeners;              // Ordered collection of listeners on the clip.
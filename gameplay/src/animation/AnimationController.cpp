@@ -99,7 +99,7 @@ namespace gameplay
 
     Transform::suspendTransformChanged();
 
-    // Loop through running clips and call update() on them.
+    // Loop through running clips and advance them. Clips to evaluate are collected and evaluated together.
     std::list<AnimationClip*>::iterator clipIter = _runningClips.begin();
     while (clipIter != _runningClips.end())
     {
@@ -114,17 +114,33 @@ namespace gameplay
         _runningClips.push_back(clip);
         clipIter = _runningClips.erase(clipIter);
       }
-      else if (clip->update(elapsedTime))
-      {
-        clip->release();
-        clipIter = _runningClips.erase(clipIter);
-      }
       else
       {
-        clipIter++;
+        AnimationClip::AdvanceResult result = clip->advance(elapsedTime);
+        if (result != AnimationClip::IDLE && !clip->isClipStateBitSet(AnimationClip::CLIP_IS_MARKED_FOR_REMOVAL_BIT))
+        {
+          // A clip that reached its end is evaluated one last time, on its end value. A stopped clip is not.
+          clip->addRef();
+          _evaluatedClips.push_back(clip);
+        }
+
+        if (result == AnimationClip::ENDED)
+        {
+          // Apply the clips collected so far before ending this one, so the end listeners see the same 
+          // values as if every clip had been applied as it was advanced.
+          applyEvaluatedClips();
+          clip->onEnd();
+          clip->release();
+          clipIter = _runningClips.erase(clipIter);
+        }
+        else
+        {
+          clipIter++;
+        }
       }
       clip->release();
     }
+    applyEvaluatedClips();
 
     Transform::resumeTransformChanged();
 
@@ -132,4 +148,89 @@ namespace gameplay
       _state = IDLE;
   }
 
+  void AnimationController::applyEvaluatedClips()
+  {
+    if (_evaluatedClips.empty())
+      return;
+
+    // Evaluating only writes to each clip's own values, so clips can be evaluated concurrently.
+    AnimationClip** clips = _evaluatedClips.data();
+    unsigned int clipCount = (unsigned int)_evaluatedClips.size();
+    JobSystem* jobSystem = Game::getInstance()->getJobSystem();
+    if (jobSystem)
+    {
+      jobSystem->parallelFor(clipCount, [clips](unsigned int i)
+      {
+        clips[i]->evaluate();
+      });
+    }
+    else
+    {
+      for (unsigned int i = 0; i < clipCount; ++i)
+      {
+        clips[i]->evaluate();
+      }
+    }
+
+    applyPose();
+
+    for (unsigned int i = 0; i < clipCount; ++i)
+    {
+      clips[i]->release();
+    }
+    _evaluatedClips.clear();
+  }
+
+  void AnimationController::applyPose()
+  {
+    for (size_t i = 0, clipCount = _evaluatedClips.size(); i < clipCount; ++i)
+    {
+      AnimationClip* clip = _evaluatedClips[i];
+      Animation* animation = clip->_animation;
+      assert(animation);
+      for (size_t j = 0, channelCount = animation->_channels.size(); j < channelCount; ++j)
+      {
+        Animation::Channel* channel = animation->_channels[j];
+        assert(channel && channel->_target);
+        PoseValue poseValue = { channel->_target, channel->_propertyId, clip->_values[j], clip->_blendWeight, (unsigned int)_pose.size() };
+        _pose.push_back(poseValue);
+      }
+    }
+
+    // Group the values by target, keeping the clip order within each target.
+    std::sort(_pose.begin(), _pose.end(), [](const PoseValue& a, const PoseValue& b)
+    {
+      if (a.target != b.target)
+        return std::less<AnimationTarget*>()(a.target, b.target);
+      return a.order < b.order;
+    });
+
+    size_t count = _pose.size();
+    size_t i = 0;
+    while (i < count)
+    {
+      AnimationTarget* target = _pose[i].target;
+      if (target->_targetType == AnimationTarget::TRANSFORM)
+      {
+        // Blend all values into the transform before marking it dirty.
+        Transform* transform = static_cast<Transform*>(target);
+        char dirtyBits = 0;
+        for (; i < count && _pose[i].target == target; ++i)
+        {
+          dirtyBits |= transform->blendAnimationPropertyValue(_pose[i].propertyId, _pose[i].value, _pose[i].blendWeight);
+        }
+        if (dirtyBits)
+          transform->dirty(dirtyBits);
+      }
+      else
+      {
+        for (; i < count && _pose[i].target == target; ++i)
+        {
+          target->setAnimationPropertyValue(_pose[i].propertyId, _pose[i].value, _pose[i].blendWeight);
+        }
+      }
+    }
+    _pose.clear();
+  }
+
 }
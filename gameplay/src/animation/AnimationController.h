@@ -35,6 +35,18 @@ namespace gameplay
      */
     void stopAllAnimations();
 
+    /**
+     * Callback for when the controller receives a frame update event.
+     *
+     * Clips are advanced (and their events fired) one after the other on the calling thread,
+     * then their curves are evaluated in parallel on the game's job system and finally the
+     * evaluated values are applied to their targets by applyPose(). When a clip ends, the clips
+     * advanced so far are applied first, so its end listeners run at the same point as before.
+     *
+     * @param elapsedTime The elapsed game time, in milliseconds.
+     */
+    void update(float elapsedTime);
+
   private:
 
     /**
@@ -91,12 +103,36 @@ namespace gameplay
     void unschedule(AnimationClip* clip);
 
     /**
-     * Callback for when the controller receives a frame update event.
+     * A value evaluated by a clip, waiting to be applied to its target.
      */
-    void update(float elapsedTime);
+    struct PoseValue
+    {
+      AnimationTarget* target;
+      int propertyId;
+      AnimationValue* value;
+      float blendWeight;
+      unsigned int order;
+    };
+
+    /**
+     * Evaluates the collected clips in parallel on the game's job system, applies their values
+     * with applyPose() and clears them.
+     */
+    void applyEvaluatedClips();
+
+    /**
+     * Applies the values of all evaluated clips to their targets.
+     *
+     * Values are grouped by target and applied in clip order, so blending between clips gives
+     * the same result as applying them one after the other, while each transform is only
+     * marked dirty once.
+     */
+    void applyPose();
 
     State _state;                                 // The current state of the AnimationController.
     std::list<AnimationClip*> _runningClips;      // A list of running AnimationClips.
+    std::vector<AnimationClip*> _evaluatedClips;  // The clips evaluated during the current update.
+    std::vector<PoseValue> _pose;                 // The values of the evaluated clips, ordered by target.
   };
 
 }
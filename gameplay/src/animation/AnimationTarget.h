@@ -18,6 +18,7 @@ namespace gameplay
   {
     friend class Animation;
     friend class AnimationClip;
+    friend class AnimationController;
 
   public:
 
@@ -7,7 +7,7 @@ namespace gameplay
 {
 
   Joint::Joint(const char* id)
-    : Node(id), _jointMatrixDirty(true)
+    : Node(id)
   {
   }
 
@@ -64,27 +64,10 @@ namespace gameplay
   void Joint::transformChanged()
   {
     Node::transformChanged();
-    _jointMatrixDirty = true;
-  }
 
-  void Joint::updateJointMatrix(const Matrix& bindShape, Vector4* matrixPalette)
-  {
-    // Note: If more than one MeshSkin influences this Joint, we need to skip
-    // the _jointMatrixDirty optimization since updateJointMatrix() may be
-    // called multiple times a frame with different bindShape matrices (and
-    // different matrixPallete pointers).
-    if (_skin.next || _jointMatrixDirty)
+    for (SkinReference* itr = &_skin; itr && itr->skin; itr = itr->next)
     {
-      _jointMatrixDirty = false;
-
-      static Matrix t;
-      Matrix::multiply(Node::getWorldMatrix(), getInverseBindPose(), &t);
-      Matrix::multiply(t, bindShape, &t);
-
-      assert(matrixPalette);
-      matrixPalette[0].set(t.m[0], t.m[4], t.m[8], t.m[12]);
-      matrixPalette[1].set(t.m[1], t.m[5], t.m[9], t.m[13]);
-      matrixPalette[2].set(t.m[2], t.m[6], t.m[10], t.m[14]);
+      itr->skin->_paletteDirty = true;
     }
   }
 
@@ -96,7 +79,12 @@ namespace gameplay
   void Joint::setInverseBindPose(const Matrix& m)
   {
     _bindPose = m;
-    _jointMatrixDirty = true;
+
+    for (SkinReference* itr = &_skin; itr && itr->skin; itr = itr->next)
+    {
+      itr->skin->_skinMatricesDirty = true;
+      itr->skin->_paletteDirty = true;
+    }
   }
 
   void Joint::addSkin(MeshSkin* skin)
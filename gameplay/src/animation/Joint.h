@@ -86,14 +86,6 @@ namespace gameplay
      */
     void setInverseBindPose(const Matrix& m);
 
-    /**
-     * Updates the joint matrix.
-     *
-     * @param bindShape The bind shape matrix.
-     * @param matrixPalette The matrix palette to update.
-     */
-    void updateJointMatrix(const Matrix& bindShape, Vector4* matrixPalette);
-
     /**
      * Called when this Joint's transform changes.
      */
@@ -132,11 +124,6 @@ namespace gameplay
      */
     Matrix _bindPose;
 
-    /**
-     * Flag used to mark if the Joint's matrix is dirty.
-     */
-    bool _jointMatrixDirty;
-
     /**
      * Linked list of mesh skins that are referenced by this joint.
      */
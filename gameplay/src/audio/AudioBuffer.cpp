@@ -1,12 +1,13 @@
 #include "framework/Base.h"
 #include "audio/AudioBuffer.h"
 #include "framework/FileSystem.h"
+#include "utils/ResourceRegistry.h"
 
 namespace gameplay
 {
 
   // Audio buffer cache
-  static std::vector<AudioBuffer*> __buffers;
+  static ResourceCache<AudioBuffer> __buffers("audio");
 
   // Callbacks for loading an ogg file using Stream
   static size_t readStream(void* ptr, size_t size, size_t nmemb, void* datasource)
@@ -47,22 +48,9 @@ namespace gameplay
   AudioBuffer::~AudioBuffer()
   {
     // Remove the buffer from the cache.
-    unsigned int bufferCount = (unsigned int)__buffers.size();
-
     if (!_streamed)
     {
-      //unsigned int bufferCount = (unsigned int)__buffers.size();
-      //for (unsigned int i = 0; i < bufferCount; i++)
-      //{
-      //  if (this == __buffers[i])
-      //  {
-      //    __buffers.erase(__buffers.begin() + i);
-      //    break;
-      //  }
-      //}
-
-      // Use this instead
-      std::erase_if(__buffers, [this](const auto& buffer) { return this == buffer; });
+      __buffers.remove(_filePath, this);
     }
     else if (_streamStateOgg.get())
     {
@@ -79,108 +67,146 @@ namespace gameplay
     }
   }
 
+  AudioBuffer::Data::Data() : streamed(false), format(0), frequency(0)
+  {
+  }
+
+  AudioBuffer::Data::~Data()
+  {
+    // A streamed ogg file is left open for streaming; close it if it was never handed to a buffer.
+    if (streamed && streamStateOgg.get())
+      ov_clear(&streamStateOgg->oggFile);
+  }
+
   AudioBuffer* AudioBuffer::create(const char* path, bool streamed)
   {
     assert(path);
 
-    AudioBuffer* buffer = nullptr;
     if (!streamed)
     {
-      auto buff = std::ranges::find_if(__buffers, [path](AudioBuffer* buffer) {
-        assert(buffer);
-        return buffer->_filePath.compare(path) == 0;
-        });
-      if (buff != __buffers.end()) return *buff;
+      AudioBuffer* buffer = findCached(path);
+      if (buffer)
+        return buffer;
     }
 
-    ALuint alBuffer[STREAMING_BUFFER_QUEUE_SIZE];
-    memset(alBuffer, 0, sizeof(alBuffer));
+    Data* data = decode(path, streamed);
+    if (!data)
+      return nullptr;
 
-    // Create 1 buffer for non-streamed sounds or full queue for streamed ones.
-    unsigned int queueSize = streamed ? STREAMING_BUFFER_QUEUE_SIZE : 1;
-    for (unsigned int i = 0; i < queueSize; i++)
-    {
-      // Load audio data into a buffer.
-      AL_CHECK(alGenBuffers(1, &alBuffer[i]));
-      if (AL_LAST_ERROR())
-      {
-        GP_ERROR("Failed to create OpenAL buffer; alGenBuffers error: %d", AL_LAST_ERROR());
-        AL_CHECK(alDeleteBuffers(1, &alBuffer[i]));
-        return nullptr;
-      }
-    }
+    AudioBuffer* buffer = create(data);
+    SAFE_DELETE(data);
+    return buffer;
+  }
+
+  AudioBuffer* AudioBuffer::findCached(const char* path)
+  {
+    assert(path);
+
+    AudioBuffer* buffer = __buffers.find(path);
+    if (buffer)
+      buffer->addRef();
+    return buffer;
+  }
+
+  AudioBuffer::Data* AudioBuffer::decode(const char* path, bool streamed)
+  {
+    assert(path);
 
-    std::unique_ptr<AudioStreamStateWav> streamStateWav;
-    std::unique_ptr<AudioStreamStateOgg> streamStateOgg;
+    std::unique_ptr<Data> data(new Data());
+    data->path = path;
+    data->streamed = streamed;
 
     // Load sound file.
-    std::unique_ptr<Stream> stream(FileSystem::open(path));
-    if (stream.get() == nullptr || !stream->canRead())
+    data->stream.reset(FileSystem::open(path));
+    if (data->stream.get() == nullptr || !data->stream->canRead())
     {
       GP_ERROR("Failed to load audio file %s.", path);
-      goto cleanup;
+      return nullptr;
     }
 
     // Read the file header
     char header[12];
-    if (stream->read(header, 1, 12) != 12)
+    if (data->stream->read(header, 1, 12) != 12)
     {
       GP_ERROR("Invalid header for audio file %s.", path);
-      goto cleanup;
+      return nullptr;
     }
 
     // Check the file format
     if (memcmp(header, "RIFF", 4) == 0)
     {
-      // Fill at least one buffer with sound data.
-      streamStateWav.reset(new AudioStreamStateWav());
-      if (!AudioBuffer::loadWav(stream.get(), alBuffer[0], streamed, streamStateWav.get()))
+      // Read at least one buffer worth of sound data.
+      data->streamStateWav.reset(new AudioStreamStateWav());
+      if (!AudioBuffer::loadWav(data->stream.get(), streamed, data->streamStateWav.get(), data.get()))
       {
         GP_ERROR("Invalid wave file: %s", path);
-        goto cleanup;
+        return nullptr;
       }
     }
     else if (memcmp(header, "OggS", 4) == 0)
     {
-      // Fill at least one buffer with sound data.
-      streamStateOgg.reset(new AudioStreamStateOgg());
-      if (!AudioBuffer::loadOgg(stream.get(), alBuffer[0], streamed, streamStateOgg.get()))
+      // Read at least one buffer worth of sound data.
+      data->streamStateOgg.reset(new AudioStreamStateOgg());
+      if (!AudioBuffer::loadOgg(data->stream.get(), streamed, data->streamStateOgg.get(), data.get()))
       {
         GP_ERROR("Invalid ogg file: %s", path);
-        goto cleanup;
+        data->streamStateOgg.reset();
+        return nullptr;
       }
     }
     else
     {
       GP_ERROR("Unsupported audio file: %s", path);
-      goto cleanup;
+      return nullptr;
+    }
+
+    return data.release();
+  }
+
+  AudioBuffer* AudioBuffer::create(Data* data)
+  {
+    assert(data);
+
+    ALuint alBuffer[STREAMING_BUFFER_QUEUE_SIZE];
+    memset(alBuffer, 0, sizeof(alBuffer));
+
+    // Create 1 buffer for non-streamed sounds or full queue for streamed ones.
+    unsigned int queueSize = data->streamed ? STREAMING_BUFFER_QUEUE_SIZE : 1;
+    for (unsigned int i = 0; i < queueSize; i++)
+    {
+      AL_CHECK(alGenBuffers(1, &alBuffer[i]));
+      if (AL_LAST_ERROR())
+      {
+        GP_ERROR("Failed to create OpenAL buffer; alGenBuffers error: %d", AL_LAST_ERROR());
+        for (unsigned int j = 0; j <= i; j++)
+        {
+          if (alBuffer[j])
+            AL_CHECK(alDeleteBuffers(1, &alBuffer[j]));
+        }
+        return nullptr;
+      }
     }
 
-    buffer = new AudioBuffer(path, alBuffer, streamed);
+    // Fill the first buffer with the decoded sound data.
+    AL_CHECK(alBufferData(alBuffer[0], data->format, data->samples.data(), (ALsizei)data->samples.size(), data->frequency));
+
+    AudioBuffer* buffer = new AudioBuffer(data->path.c_str(), alBuffer, data->streamed);
 
-    buffer->_fileStream.reset(stream.release());
-    buffer->_streamStateWav.reset(streamStateWav.release());
-    buffer->_streamStateOgg.reset(streamStateOgg.release());
+    buffer->_fileStream.reset(data->stream.release());
+    buffer->_streamStateWav.reset(data->streamStateWav.release());
+    buffer->_streamStateOgg.reset(data->streamStateOgg.release());
     if (buffer->_streamStateWav.get())
       buffer->_buffersNeededCount = (buffer->_streamStateWav->dataSize + STREAMING_BUFFER_SIZE - 1) / STREAMING_BUFFER_SIZE;
     else if (buffer->_streamStateOgg.get())
       buffer->_buffersNeededCount = (buffer->_streamStateOgg->dataSize + STREAMING_BUFFER_SIZE - 1) / STREAMING_BUFFER_SIZE;
 
-    if (!streamed)
-      __buffers.push_back(buffer);
+    if (!data->streamed)
+      __buffers.add(buffer->_filePath, buffer, data->samples.size());
 
     return buffer;
-
-  cleanup:
-    for (unsigned int i = 0; i < STREAMING_BUFFER_QUEUE_SIZE; i++)
-    {
-      if (alBuffer[i])
-        AL_CHECK(alDeleteBuffers(1, &alBuffer[i]));
-    }
-    return nullptr;
   }
 
-  bool AudioBuffer::loadWav(Stream* stream, ALuint buffer, bool streamed, AudioStreamStateWav* streamState)
+  bool AudioBuffer::loadWav(Stream* stream, bool streamed, AudioStreamStateWav* streamState, Data* decoded)
   {
     assert(stream);
 
@@ -324,16 +350,14 @@ namespace gameplay
             dataSize = STREAMING_BUFFER_SIZE;
         }
 
-        char* data = new char[dataSize];
-        if (stream->read(data, sizeof(char), dataSize) != dataSize)
+        decoded->samples.resize(dataSize);
+        if (stream->read(decoded->samples.data(), sizeof(char), dataSize) != dataSize)
         {
           GP_ERROR("Failed to load wave file; file is missing data.");
-          SAFE_DELETE_ARRAY(data);
           return false;
         }
-
-        AL_CHECK(alBufferData(buffer, format, data, dataSize, frequency));
-        SAFE_DELETE_ARRAY(data);
+        decoded->format = format;
+        decoded->frequency = frequency;
 
         // We've read the data, so return now.
         return true;
@@ -379,7 +403,7 @@ namespace gameplay
     return false;
   }
 
-  bool AudioBuffer::loadOgg(Stream* stream, ALuint buffer, bool streamed, AudioStreamStateOgg* streamState)
+  bool AudioBuffer::loadOgg(Stream* stream, bool streamed, AudioStreamStateOgg* streamState, Data* decoded)
   {
     assert(stream);
 
@@ -426,18 +450,19 @@ namespace gameplay
         data_size = STREAMING_BUFFER_SIZE;
     }
 
-    char* data = new char[data_size];
+    std::vector<char>& data = decoded->samples;
+    data.resize(data_size);
 
     while (size < data_size)
     {
-      result = ov_read(&streamState->oggFile, data + size, data_size - size, 0, 2, 1, &section);
+      result = ov_read(&streamState->oggFile, data.data() + size, data_size - size, 0, 2, 1, &section);
       if (result > 0)
       {
         size += result;
       }
       else if (result < 0)
       {
-        SAFE_DELETE_ARRAY(data);
+        ov_clear(&streamState->oggFile);
         GP_ERROR("Failed to read ogg file; file is missing data.");
         return false;
       }
@@ -449,14 +474,14 @@ namespace gameplay
 
     if (size == 0)
     {
-      SAFE_DELETE_ARRAY(data);
+      ov_clear(&streamState->oggFile);
       GP_ERROR("Filed to read ogg file; unable to read any data.");
       return false;
     }
 
-    AL_CHECK(alBufferData(buffer, format, data, size, info->rate));
-
-    SAFE_DELETE_ARRAY(data);
+    data.resize(size);
+    decoded->format = format;
+    decoded->frequency = info->rate;
 
     if (!streamed)
       ov_clear(&streamState->oggFile);
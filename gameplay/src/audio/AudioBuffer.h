@@ -16,6 +16,7 @@ namespace gameplay
   class AudioBuffer : public Ref
   {
     friend class AudioSource;
+    friend class AssetLoader;
   public:
     /**
      * Constructor.
@@ -43,6 +44,11 @@ namespace gameplay
      */
     static AudioBuffer* create(const char* path, bool streamed);
 
+    /**
+     * Returns a new reference to the cached (non-streamed) buffer for the given path, or nullptr if it is not cached.
+     */
+    static AudioBuffer* findCached(const char* path);
+
     struct AudioStreamStateWav
     {
       long dataStart;
@@ -60,12 +66,44 @@ namespace gameplay
       OggVorbis_File oggFile;
     };
 
+    /**
+     * Sound data decoded from a file, ready to be uploaded to OpenAL.
+     */
+    struct Data
+    {
+      Data();
+      ~Data();
+
+      std::string path;
+      bool streamed;
+      ALuint format;
+      ALuint frequency;
+      std::vector<char> samples;                                // The samples for the first buffer.
+      std::unique_ptr<Stream> stream;
+      std::unique_ptr<AudioStreamStateWav> streamStateWav;
+      std::unique_ptr<AudioStreamStateOgg> streamStateOgg;
+    };
+
     enum { STREAMING_BUFFER_QUEUE_SIZE = 3 };
     enum { STREAMING_BUFFER_SIZE = 48000 };
 
-    static bool loadWav(Stream* stream, ALuint buffer, bool streamed, AudioStreamStateWav* streamState);
+    /**
+     * Reads and decodes the sound data of a file without making any OpenAL calls,
+     * so it may be called from a background thread.
+     *
+     * @return The decoded data, or nullptr if the file could not be read.
+     */
+    static Data* decode(const char* path, bool streamed);
+
+    /**
+     * Creates an audio buffer from decoded sound data. The buffer takes over the
+     * data's stream and streaming state.
+     */
+    static AudioBuffer* create(Data* data);
+
+    static bool loadWav(Stream* stream, bool streamed, AudioStreamStateWav* streamState, Data* decoded);
 
-    static bool loadOgg(Stream* stream, ALuint buffer, bool streamed, AudioStreamStateOgg* streamState);
+    static bool loadOgg(Stream* stream, bool streamed, AudioStreamStateOgg* streamState, Data* decoded);
 
     bool streamData(ALuint buffer, bool looped);
 
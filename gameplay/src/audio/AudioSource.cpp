@@ -69,6 +69,13 @@ namespace gameplay
     if (buffer == nullptr)
       return nullptr;
 
+    return create(buffer);
+  }
+
+  AudioSource* AudioSource::create(AudioBuffer* buffer)
+  {
+    assert(buffer);
+
     // Load the audio source.
     ALuint alSource = 0;
 
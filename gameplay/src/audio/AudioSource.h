@@ -24,6 +24,7 @@ namespace gameplay
 
     friend class Node;
     friend class AudioController;
+    friend class AssetLoader;
 
     /**
      * The audio source's audio state.
@@ -185,6 +186,14 @@ namespace gameplay
      */
     AudioSource& operator=(const AudioSource&);
 
+    /**
+     * Creates an audio source playing the given buffer, taking over the caller's reference to it.
+     *
+     * @param buffer The audio buffer to play.
+     * @return The newly created audio source, or nullptr if the source could not be generated.
+     */
+    static AudioSource* create(AudioBuffer* buffer);
+
     /**
      * Sets the node for this audio source.
      */
@@ -0,0 +1,589 @@
+#include "framework/Base.h"
+#include "framework/AssetLoader.h"
+#include "framework/FileSystem.h"
+#include "framework/Game.h"
+#include "audio/AudioBuffer.h"
+#include "audio/AudioSource.h"
+#include "renderer/Texture.h"
+#include "renderer/TextureContainer.h"
+#include "renderer/TextureDecoder.h"
+#include "scene/Bundle.h"
+#include "scene/Properties.h"
+#include "scene/SceneLoader.h"
+#include "ui/Image.h"
+
+namespace gameplay
+{
+
+  AssetLoader::Request::Request(const char* path, int priority, unsigned int sequence)
+    : _path(path ? path : ""), _priority(priority), _sequence(sequence), _state(QUEUED), _cancelled(false), _loaded(false)
+  {
+  }
+
+  AssetLoader::Request::~Request()
+  {
+  }
+
+  AssetLoader::Request::State AssetLoader::Request::getState() const
+  {
+    return (State)_state.load();
+  }
+
+  const char* AssetLoader::Request::getPath() const
+  {
+    return _path.c_str();
+  }
+
+  int AssetLoader::Request::getPriority() const
+  {
+    return _priority;
+  }
+
+  bool AssetLoader::Request::isDone() const
+  {
+    State state = getState();
+    return state == COMPLETE || state == FAILED || state == CANCELLED;
+  }
+
+  AssetLoader::AssetLoader(unsigned int threadCount)
+    : _requestCount(0), _sequence(0), _quit(false)
+  {
+    _threads.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+      _threads.push_back(std::thread(&AssetLoader::threadProc, this));
+    }
+  }
+
+  AssetLoader::~AssetLoader()
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _quit = true;
+    }
+    _wake.notify_all();
+    for (size_t i = 0, count = _threads.size(); i < count; ++i)
+    {
+      _threads[i].join();
+    }
+
+    // Every request in flight has been moved to the loaded list by now.
+    for (size_t i = 0, count = _queued.size(); i < count; ++i)
+    {
+      discard(_queued[i]);
+    }
+    _queued.clear();
+    for (size_t i = 0, count = _loaded.size(); i < count; ++i)
+    {
+      discard(_loaded[i]);
+    }
+    _loaded.clear();
+  }
+
+  unsigned int AssetLoader::getThreadCount() const
+  {
+    return (unsigned int)_threads.size();
+  }
+
+  AssetLoader::Request* AssetLoader::load(const char* path, const std::function<bool()>& load, const std::function<bool(bool)>& finalize, int priority)
+  {
+    Request* request = new Request(path, priority, _sequence++);
+    request->_load = load;
+    request->_finalize = finalize;
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _queued.push_back(request);
+      std::push_heap(_queued.begin(), _queued.end(), comparePriority);
+      ++_requestCount;
+    }
+    _wake.notify_one();
+
+    return request;
+  }
+
+  AssetLoader::Request* AssetLoader::loadTexture(const char* path, bool generateMipmaps, const std::function<void(Texture*)>& callback, int priority)
+  {
+    assert(path);
+
+    struct Result
+    {
+      Result() : image(nullptr), texture(nullptr) {}
+      ~Result() { SAFE_RELEASE(image); SAFE_RELEASE(texture); }
+      Image* image;
+      TextureDecoder::Result decoded;
+      std::unique_ptr<TextureContainer> container;
+      Texture* texture;
+    };
+    std::shared_ptr<Result> result(new Result());
+    std::string file = path;
+
+    // Skip the load entirely if the texture is already resident.
+    result->texture = Texture::findCached(path, generateMipmaps);
+
+    const char* ext = strrchr(FileSystem::resolvePath(path), '.');
+    bool png = !result->texture && ext && strlen(ext) == 4 &&
+      tolower(ext[1]) == 'p' && tolower(ext[2]) == 'n' && tolower(ext[3]) == 'g';
+    bool ktx = !result->texture && ext && (strlen(ext) == 4 || (strlen(ext) == 5 && ext[4] == '2')) &&
+      tolower(ext[1]) == 'k' && tolower(ext[2]) == 't' && tolower(ext[3]) == 'x';
+
+    std::function<bool()> loadFunction;
+    if (png && generateMipmaps && !Game::getInstance()->getTextureStreamer())
+    {
+      // Generate the mip chain here too, so that finalizing only uploads it.
+      TextureDecoder::Filter filter = TextureDecoder::getFilter();
+      loadFunction = [result, file, filter]()
+      {
+        return TextureDecoder::decode(file.c_str(), true, filter, &result->decoded);
+      };
+    }
+    else if (png)
+    {
+      loadFunction = [result, file]()
+      {
+        result->image = Image::create(file.c_str());
+        return result->image != nullptr;
+      };
+    }
+    else if (ktx)
+    {
+      // Containers are read and parsed here; only the upload is left for the main thread.
+      loadFunction = [result, file]()
+      {
+        result->container.reset(TextureContainer::create(file.c_str()));
+        return result->container != nullptr;
+      };
+    }
+
+    return load(path, loadFunction, [result, file, generateMipmaps, callback](bool loaded)
+    {
+      Texture* texture = result->texture;
+      result->texture = nullptr;
+      if (loaded && !texture)
+      {
+        // Another request may have created the texture while this one was loading.
+        texture = Texture::findCached(file.c_str(), generateMipmaps);
+        if (!texture && !result->decoded.levels.empty())
+        {
+          texture = TextureDecoder::createTexture(result->decoded);
+          if (texture)
+            texture->addToCache(file.c_str());
+        }
+        else if (!texture && result->image)
+        {
+          texture = Texture::createFromImage(file.c_str(), result->image, generateMipmaps);
+          if (texture)
+            texture->addToCache(file.c_str());
+        }
+        else if (!texture && result->container)
+        {
+          texture = Texture::createFromContainer(file.c_str(), result->container.get(), generateMipmaps);
+          if (texture)
+            texture->addToCache(file.c_str());
+        }
+        else if (!texture)
+        {
+          texture = Texture::create(file.c_str(), generateMipmaps);
+        }
+      }
+
+      bool created = texture != nullptr;
+      if (callback)
+        callback(texture);
+      else
+        SAFE_RELEASE(texture);
+      return created;
+    }, priority);
+  }
+
+  AssetLoader::Request* AssetLoader::loadBundle(const char* path, const std::function<void(Bundle*)>& callback, int priority)
+  {
+    assert(path);
+
+    struct Result
+    {
+      Result() : bundle(nullptr) {}
+      ~Result() { SAFE_RELEASE(bundle); }
+      Bundle* bundle;
+    };
+    std::shared_ptr<Result> result(new Result());
+    std::string file = path;
+
+    return load(path, [result, file]()
+    {
+      result->bundle = Bundle::open(file.c_str());
+      return result->bundle != nullptr;
+    },
+    [result, file, callback](bool loaded)
+    {
+      Bundle* bundle = Bundle::findCached(file.c_str());
+      if (!bundle)
+      {
+        bundle = result->bundle;
+        result->bundle = nullptr;
+      }
+
+      bool created = bundle != nullptr;
+      if (callback)
+        callback(bundle);
+      else
+        SAFE_RELEASE(bundle);
+      return created;
+    }, priority);
+  }
+
+  AssetLoader::Request* AssetLoader::loadProperties(const char* url, const std::function<void(Properties*)>& callback, int priority)
+  {
+    assert(url);
+
+    struct Result
+    {
+      Result() : properties(nullptr) {}
+      ~Result() { SAFE_DELETE(properties); }
+      Properties* properties;
+    };
+    std::shared_ptr<Result> result(new Result());
+    std::string file = url;
+
+    return load(url, [result, file]()
+    {
+      result->properties = Properties::create(file.c_str());
+      return result->properties != nullptr;
+    },
+    [result, callback](bool loaded)
+    {
+      Properties* properties = result->properties;
+      result->properties = nullptr;
+
+      bool created = properties != nullptr;
+      if (callback)
+        callback(properties);
+      else
+        SAFE_DELETE(properties);
+      return created;
+    }, priority);
+  }
+
+  AssetLoader::Request* AssetLoader::loadAudioSource(const char* url, bool streamed, const std::function<void(AudioSource*)>& callback, int priority)
+  {
+    assert(url);
+
+    struct Result
+    {
+      Result() : data(nullptr), buffer(nullptr) {}
+      ~Result() { SAFE_DELETE(data); SAFE_RELEASE(buffer); }
+      AudioBuffer::Data* data;
+      AudioBuffer* buffer;
+    };
+    std::shared_ptr<Result> result(new Result());
+    std::string file = url;
+
+    // .audio files only hold a reference to the sound file, so they are loaded in one go when finalized.
+    bool properties = file.find(".audio") != std::string::npos;
+    if (!properties && !streamed)
+      result->buffer = AudioBuffer::findCached(url);
+
+    std::function<bool()> loadFunction;
+    if (!properties && !result->buffer)
+    {
+      loadFunction = [result, file, streamed]()
+      {
+        result->data = AudioBuffer::decode(file.c_str(), streamed);
+        return result->data != nullptr;
+      };
+    }
+
+    return load(url, loadFunction, [result, file, streamed, properties, callback](bool loaded)
+    {
+      AudioSource* source = nullptr;
+      if (properties)
+      {
+        source = AudioSource::create(file.c_str(), streamed);
+      }
+      else if (loaded)
+      {
+        AudioBuffer* buffer = result->buffer;
+        result->buffer = nullptr;
+        if (!buffer && !streamed)
+          buffer = AudioBuffer::findCached(file.c_str());
+        if (!buffer && result->data)
+          buffer = AudioBuffer::create(result->data);
+        if (buffer)
+          source = AudioSource::create(buffer);
+      }
+
+      bool created = source != nullptr;
+      if (callback)
+        callback(source);
+      else
+        SAFE_RELEASE(source);
+      return created;
+    }, priority);
+  }
+
+  AssetLoader::Request* AssetLoader::loadScene(const char* url, const std::function<void(Scene*)>& callback, int priority)
+  {
+    assert(url);
+
+    struct Result
+    {
+      Result() : properties(nullptr), bundle(nullptr) {}
+      ~Result() { SAFE_DELETE(properties); SAFE_RELEASE(bundle); }
+      Properties* properties;
+      Bundle* bundle;
+    };
+    std::shared_ptr<Result> result(new Result());
+    std::string file = url;
+
+    return load(url, [result, file]()
+    {
+      result->properties = Properties::create(file.c_str());
+      if (!result->properties)
+        return false;
+
+      // Open the main bundle of the scene so that the main thread only has to read its contents.
+      Properties* sceneProperties = (strlen(result->properties->getNamespace()) > 0) ? result->properties : result->properties->getNextNamespace();
+      std::string path;
+      if (sceneProperties && sceneProperties->getPath("path", &path))
+        result->bundle = Bundle::open(path.c_str());
+      return true;
+    },
+    [result, file, callback](bool loaded)
+    {
+      Scene* scene = nullptr;
+      if (loaded)
+      {
+        Properties* properties = result->properties;
+        result->properties = nullptr;
+        scene = SceneLoader::load(file.c_str(), properties, result->bundle);
+      }
+
+      bool created = scene != nullptr;
+      if (callback)
+        callback(scene);
+      else
+        SAFE_RELEASE(scene);
+      return created;
+    }, priority);
+  }
+
+  void AssetLoader::setPriority(Request* request, int priority)
+  {
+    assert(request);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    request->_priority = priority;
+    if (request->getState() == Request::QUEUED)
+      std::make_heap(_queued.begin(), _queued.end(), comparePriority);
+  }
+
+  void AssetLoader::cancel(Request* request)
+  {
+    assert(request);
+
+    if (request->isDone())
+      return;
+    request->_cancelled = true;
+
+    // Requests that are not being loaded can be discarded right away; the
+    // others are discarded once their I/O thread hands them back.
+    bool removed;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      removed = remove(_queued, request);
+      if (removed)
+        std::make_heap(_queued.begin(), _queued.end(), comparePriority);
+      else
+        removed = remove(_loaded, request);
+    }
+    if (removed)
+      discard(request);
+  }
+
+  bool AssetLoader::finish(Request* request)
+  {
+    assert(request);
+
+    if (request->isDone())
+      return request->getState() == Request::COMPLETE;
+
+    // Keep the request alive past finalization so its state can be returned.
+    request->addRef();
+
+    bool load;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      load = remove(_queued, request);
+      if (load)
+      {
+        std::make_heap(_queued.begin(), _queued.end(), comparePriority);
+        request->_state = Request::LOADING;
+      }
+      else
+      {
+        _done.wait(lock, [request]() { return request->getState() != Request::LOADING; });
+        remove(_loaded, request);
+      }
+    }
+    if (load)
+    {
+      execute(request);
+      request->_state = Request::LOADED;
+    }
+
+    finalize(request);
+
+    bool complete = request->getState() == Request::COMPLETE;
+    request->release();
+    return complete;
+  }
+
+  void AssetLoader::update(float budget)
+  {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::duration<float, std::milli> limit(budget);
+
+    while (true)
+    {
+      Request* request = nullptr;
+      bool load = false;
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_loaded.empty())
+        {
+          // Finalize the most important loaded request first.
+          std::vector<Request*>::iterator itr = std::min_element(_loaded.begin(), _loaded.end(), [](const Request* a, const Request* b)
+          {
+            return comparePriority(b, a);
+          });
+          request = *itr;
+          _loaded.erase(itr);
+        }
+        else if (_threads.empty() && !_queued.empty())
+        {
+          // Without I/O threads, requests are loaded here too.
+          std::pop_heap(_queued.begin(), _queued.end(), comparePriority);
+          request = _queued.back();
+          _queued.pop_back();
+          request->_state = Request::LOADING;
+          load = true;
+        }
+      }
+      if (!request)
+        break;
+
+      if (load)
+      {
+        execute(request);
+        request->_state = Request::LOADED;
+      }
+      finalize(request);
+
+      if (std::chrono::steady_clock::now() - start >= limit)
+        break;
+    }
+  }
+
+  unsigned int AssetLoader::getPendingCount() const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _requestCount;
+  }
+
+  bool AssetLoader::comparePriority(const Request* a, const Request* b)
+  {
+    // Heap order: the "largest" request is loaded first.
+    if (a->_priority != b->_priority)
+      return a->_priority < b->_priority;
+    return a->_sequence > b->_sequence;
+  }
+
+  void AssetLoader::threadProc()
+  {
+    while (true)
+    {
+      Request* request;
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _wake.wait(lock, [this]() { return _quit || !_queued.empty(); });
+        if (_quit)
+          break;
+
+        std::pop_heap(_queued.begin(), _queued.end(), comparePriority);
+        request = _queued.back();
+        _queued.pop_back();
+        request->_state = Request::LOADING;
+      }
+
+      execute(request);
+
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        request->_state = Request::LOADED;
+        _loaded.push_back(request);
+      }
+      _done.notify_all();
+    }
+  }
+
+  void AssetLoader::execute(Request* request)
+  {
+    assert(request);
+
+    bool loaded = true;
+    if (!request->_cancelled && request->_load)
+      loaded = request->_load();
+    request->_loaded = loaded;
+  }
+
+  void AssetLoader::finalize(Request* request)
+  {
+    assert(request);
+
+    if (request->_cancelled)
+    {
+      discard(request);
+      return;
+    }
+
+    bool complete = request->_loaded;
+    if (request->_finalize)
+      complete = request->_finalize(request->_loaded);
+    if (!complete)
+      GP_WARN("Failed to load asset '%s'.", request->_path.c_str());
+
+    request->_load = nullptr;
+    request->_finalize = nullptr;
+    request->_state = complete ? Request::COMPLETE : Request::FAILED;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      --_requestCount;
+    }
+    request->release();
+  }
+
+  void AssetLoader::discard(Request* request)
+  {
+    assert(request);
+
+    // Dropping the functions releases whatever they had loaded.
+    request->_load = nullptr;
+    request->_finalize = nullptr;
+    request->_state = Request::CANCELLED;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      --_requestCount;
+    }
+    request->release();
+  }
+
+  bool AssetLoader::remove(std::vector<Request*>& requests, Request* request)
+  {
+    std::vector<Request*>::iterator itr = std::find(requests.begin(), requests.end(), request);
+    if (itr == requests.end())
+      return false;
+    requests.erase(itr);
+    return true;
+  }
+
+}
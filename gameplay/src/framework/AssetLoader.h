@@ -0,0 +1,293 @@
+#pragma once
+
+#include "utils/Ref.h"
+
+namespace gameplay
+{
+
+  class AudioSource;
+  class Bundle;
+  class Properties;
+  class Scene;
+  class Texture;
+
+  /**
+   * Defines an asynchronous, prioritized asset loader.
+   *
+   * Loading an asset is split into two steps. The load step reads and decodes
+   * the file (for example decompressing a PNG into an image or decoding a
+   * sound) on one of the loader's own I/O threads, so that waiting on the disk
+   * never stalls the game or the job system's workers. The finalize step
+   * creates the graphics or audio objects from the decoded data on the main
+   * thread, where the graphics and audio contexts are current.
+   *
+   * Pending requests are loaded highest priority first, and requests of equal
+   * priority in the order they were made. Loaded requests are finalized by
+   * update(), which the game calls once per frame with a time budget so that
+   * finalization work is spread over several frames instead of causing a
+   * hitch. finish() loads and finalizes a single request right away, for
+   * assets that are needed immediately.
+   *
+   * A request may be cancelled at any point before it is finalized. A
+   * cancelled request never invokes its callback and any data it had already
+   * loaded is discarded.
+   *
+   * All methods must be called from the main thread.
+   *
+   * The game owns an asset loader (see Game::getAssetLoader()). Its thread
+   * count and per-frame budget are read from the "threads" and "budget"
+   * (in milliseconds) properties of the "loader" namespace in game.config.
+   */
+  class AssetLoader
+  {
+  public:
+
+    /**
+     * A single asset load.
+     *
+     * Requests are owned by the loader until they are done. Call addRef()
+     * to keep one valid after that.
+     */
+    class Request : public Ref
+    {
+      friend class AssetLoader;
+
+    public:
+
+      /**
+       * The state of a request.
+       */
+      enum State
+      {
+        QUEUED,
+        LOADING,
+        LOADED,
+        COMPLETE,
+        FAILED,
+        CANCELLED
+      };
+
+      /**
+       * Gets the state of the request.
+       *
+       * @return The state of the request.
+       */
+      State getState() const;
+
+      /**
+       * Gets the path of the asset being loaded.
+       *
+       * @return The path of the asset.
+       */
+      const char* getPath() const;
+
+      /**
+       * Gets the priority of the request.
+       *
+       * @return The priority of the request.
+       */
+      int getPriority() const;
+
+      /**
+       * Determines whether the request has completed, failed or been cancelled.
+       *
+       * @return true if the request is done.
+       */
+      bool isDone() const;
+
+    private:
+
+      /**
+       * Constructor.
+       */
+      Request(const char* path, int priority, unsigned int sequence);
+
+      /**
+       * Destructor.
+       */
+      ~Request();
+
+      /**
+       * Hidden copy constructor.
+       */
+      Request(const Request& copy);
+
+      /**
+       * Hidden copy assignment operator.
+       */
+      Request& operator=(const Request&);
+
+      std::string _path;
+      int _priority;
+      unsigned int _sequence;
+      std::atomic<int> _state;
+      std::atomic<bool> _cancelled;
+      bool _loaded;
+      std::function<bool()> _load;
+      std::function<bool(bool)> _finalize;
+    };
+
+    /**
+     * Constructor. Must be called on the main thread.
+     *
+     * @param threadCount The number of I/O threads to start. With no threads
+     *        requests are loaded on the main thread by update() and finish().
+     */
+    AssetLoader(unsigned int threadCount);
+
+    /**
+     * Destructor. Cancels all requests that have not been finalized and joins the I/O threads.
+     */
+    ~AssetLoader();
+
+    /**
+     * Gets the number of I/O threads.
+     *
+     * @return The number of I/O threads.
+     */
+    unsigned int getThreadCount() const;
+
+    /**
+     * Requests an asset load with custom load and finalize steps.
+     *
+     * The load function is called on an I/O thread and must not touch the
+     * graphics or audio contexts. The finalize function is called on the main
+     * thread with the result of the load function, and returns whether the
+     * asset was created. Data shared between the two functions should be held
+     * by the functions themselves (for example through a std::shared_ptr), so
+     * that it is released when a request is discarded.
+     *
+     * @param path The path of the asset, for diagnostics.
+     * @param load The function that loads the asset, or an empty function if there is nothing to load.
+     * @param finalize The function that finalizes the asset, or an empty function if there is nothing to finalize.
+     * @param priority The priority of the request. Higher priorities are loaded first.
+     * @return The request.
+     */
+    Request* load(const char* path, const std::function<bool()>& load, const std::function<bool(bool)>& finalize, int priority = 0);
+
+    /**
+     * Loads a texture. PNG images are decoded, along with their mip chains unless streamed, and KTX containers are read on an I/O thread; other formats are loaded when finalized.
+     *
+     * @param path The path of the texture.
+     * @param generateMipmaps true to generate a full mipmap chain for the texture.
+     * @param callback Called with the texture (or nullptr if it failed to load); the callback owns the reference.
+     * @param priority The priority of the request.
+     * @return The request.
+     */
+    Request* loadTexture(const char* path, bool generateMipmaps, const std::function<void(Texture*)>& callback, int priority = 0);
+
+    /**
+     * Loads a bundle, reading its header and reference table on an I/O thread.
+     *
+     * @param path The path of the bundle.
+     * @param callback Called with the bundle (or nullptr if it failed to load); the callback owns the reference.
+     * @param priority The priority of the request.
+     * @return The request.
+     */
+    Request* loadBundle(const char* path, const std::function<void(Bundle*)>& callback, int priority = 0);
+
+    /**
+     * Loads a properties file entirely on an I/O thread.
+     *
+     * @param url The URL of the properties.
+     * @param callback Called with the properties (or nullptr if they failed to load); the callback must delete them.
+     * @param priority The priority of the request.
+     * @return The request.
+     */
+    Request* loadProperties(const char* url, const std::function<void(Properties*)>& callback, int priority = 0);
+
+    /**
+     * Loads an audio source. Sound files are decoded on an I/O thread; .audio files are loaded when finalized.
+     *
+     * @param url The URL of the sound or .audio file.
+     * @param streamed true if the audio source should be streamed.
+     * @param callback Called with the audio source (or nullptr if it failed to load); the callback owns the reference.
+     * @param priority The priority of the request.
+     * @return The request.
+     */
+    Request* loadAudioSource(const char* url, bool streamed, const std::function<void(AudioSource*)>& callback, int priority = 0);
+
+    /**
+     * Loads a scene. The .scene file is parsed and its main bundle opened on an I/O thread.
+     *
+     * @param url The URL of the .scene file.
+     * @param callback Called with the scene (or nullptr if it failed to load); the callback owns the reference.
+     * @param priority The priority of the request.
+     * @return The request.
+     */
+    Request* loadScene(const char* url, const std::function<void(Scene*)>& callback, int priority = 0);
+
+    /**
+     * Changes the priority of a request that has not been loaded yet.
+     *
+     * @param request The request.
+     * @param priority The new priority.
+     */
+    void setPriority(Request* request, int priority);
+
+    /**
+     * Cancels a request. Nothing happens if the request is already done.
+     *
+     * @param request The request to cancel.
+     */
+    void cancel(Request* request);
+
+    /**
+     * Loads and finalizes a request right away, blocking until it is done.
+     *
+     * @param request The request to finish.
+     * @return true if the request completed.
+     */
+    bool finish(Request* request);
+
+    /**
+     * Finalizes loaded requests, highest priority first, until the time
+     * budget is spent. At least one loaded request is finalized per call.
+     *
+     * @param budget The time budget in milliseconds.
+     */
+    void update(float budget);
+
+    /**
+     * Gets the number of requests that have not been finalized yet.
+     *
+     * @return The number of pending requests.
+     */
+    unsigned int getPendingCount() const;
+
+  private:
+
+    /**
+     * Hidden copy constructor.
+     */
+    AssetLoader(const AssetLoader& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    AssetLoader& operator=(const AssetLoader&);
+
+    static bool comparePriority(const Request* a, const Request* b);
+
+    void threadProc();
+
+    void execute(Request* request);
+
+    void finalize(Request* request);
+
+    void discard(Request* request);
+
+    bool remove(std::vector<Request*>& requests, Request* request);
+
+    std::vector<std::thread> _threads;
+    std::vector<Request*> _queued;              // Heap of requests waiting to be loaded.
+    std::vector<Request*> _loaded;              // Requests waiting to be finalized.
+    unsigned int _requestCount;                 // Requests that have not been finalized.
+    unsigned int _sequence;
+    mutable std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    bool _quit;
+  };
+
+}
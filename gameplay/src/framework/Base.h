@@ -15,6 +15,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <cstring>
 #include <vector>
 #include <list>
@@ -22,6 +23,7 @@
 #include <stack>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 #include <queue>
 #include <algorithm>
 #include <limits>
@@ -30,6 +32,8 @@
 #include <typeinfo>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <chrono>
 #include "utils/Logger.h"
 
@@ -222,10 +226,12 @@ extern PFNGLUNMAPBUFFEROESPROC glUnmapBuffer;
 #define GLEW_STATIC
 #include <GL/glew.h>
 #define GP_USE_VAO
+#define GP_USE_INSTANCING
 #elif __linux__
 #define GLEW_STATIC
 #include <GL/glew.h>
 #define GP_USE_VAO
+#define GP_USE_INSTANCING
 #elif __APPLE__
 #include "TargetConditionals.h"
 #if TARGET_OS_IPHONE || TARGET_IPHONE_SIMULATOR
@@ -264,6 +270,7 @@ extern PFNGLUNMAPBUFFEROESPROC glUnmapBuffer;
 #define VERTEX_ATTRIBUTE_BLENDWEIGHTS_NAME          "a_blendWeights"
 #define VERTEX_ATTRIBUTE_BLENDINDICES_NAME          "a_blendIndices"
 #define VERTEX_ATTRIBUTE_TEXCOORD_PREFIX_NAME       "a_texCoord"
+#define VERTEX_ATTRIBUTE_INSTANCE_MATRIX_NAME       "a_instanceMatrix"
 
 // Hardware buffer
 namespace gameplay
@@ -18,6 +18,9 @@
 #define __EXT_POSIX2
 #include <libgen.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #define gp_stat stat
 #define gp_stat_struct struct stat
 #endif
@@ -145,6 +148,42 @@ namespace gameplay
     bool _canWrite;
   };
 
+  /**
+   * A read-only stream over a file mapped into memory.
+   *
+   * @script{ignore}
+   */
+  class MappedFileStream : public Stream
+  {
+  public:
+    friend class FileSystem;
+
+    ~MappedFileStream();
+    virtual bool canRead();
+    virtual bool canWrite();
+    virtual bool canSeek();
+    virtual void close();
+    virtual size_t read(void* ptr, size_t size, size_t count);
+    virtual char* readLine(char* str, int num);
+    virtual size_t write(const void* ptr, size_t size, size_t count);
+    virtual bool eof();
+    virtual size_t length();
+    virtual long int position();
+    virtual bool seek(long int offset, int origin);
+    virtual bool rewind();
+    virtual const void* data();
+
+    static MappedFileStream* create(const char* filePath);
+
+  private:
+    MappedFileStream(const unsigned char* data, size_t length);
+
+  private:
+    const unsigned char* _data;
+    size_t _length;
+    size_t _position;
+  };
+
 #ifdef __ANDROID__
 
   /**
@@ -363,6 +402,35 @@ namespace gameplay
 
   }
 
+  bool FileSystem::createDirectory(const char* dirPath)
+  {
+    assert(dirPath);
+
+    std::string fullPath;
+    getFullPath(dirPath, fullPath);
+
+    // Create each missing directory along the path, starting from the root.
+    gp_stat_struct s;
+    size_t pos = 0;
+    while (pos != std::string::npos)
+    {
+      pos = fullPath.find_first_of("/\\", pos + 1);
+      std::string path = fullPath.substr(0, pos);
+      if (path.empty() || gp_stat(path.c_str(), &s) == 0)
+        continue;
+#ifdef WIN32
+      if (_mkdir(path.c_str()) != 0)
+#else
+      if (mkdir(path.c_str(), 0777) != 0)
+#endif
+      {
+        GP_WARN("Failed to create directory '%s'.", path.c_str());
+        return false;
+      }
+    }
+    return true;
+  }
+
   Stream* FileSystem::open(const char* path, size_t streamMode)
   {
     char modeStr[] = "rb";
@@ -388,7 +456,11 @@ namespace gameplay
     else
     {
       // First try the SD card
-      Stream* stream = FileStream::create(fullPath.c_str(), modeStr);
+      Stream* stream = nullptr;
+      if ((streamMode & MAPPED) != 0)
+        stream = MappedFileStream::create(fullPath.c_str());
+      if (!stream)
+        stream = FileStream::create(fullPath.c_str(), modeStr);
 
       if (!stream)
       {
@@ -404,6 +476,12 @@ namespace gameplay
 #else
     std::string fullPath;
     getFullPath(path, fullPath);
+    if ((streamMode & MAPPED) != 0 && (streamMode & WRITE) == 0)
+    {
+      // Empty files cannot be mapped, so fall back to a regular stream.
+      if (MappedFileStream* stream = MappedFileStream::create(fullPath.c_str()))
+        return stream;
+    }
     FileStream* stream = FileStream::create(fullPath.c_str(), modeStr);
     return stream;
 #endif
@@ -717,6 +795,183 @@ namespace gameplay
 
   ////////////////////////////////
 
+  MappedFileStream::MappedFileStream(const unsigned char* data, size_t length)
+    : _data(data), _length(length), _position(0)
+  {
+  }
+
+  MappedFileStream::~MappedFileStream()
+  {
+    if (_data)
+    {
+      close();
+    }
+  }
+
+  MappedFileStream* MappedFileStream::create(const char* filePath)
+  {
+    void* data = nullptr;
+    size_t length = 0;
+#ifdef WIN32
+    HANDLE file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+      return nullptr;
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0 && (unsigned long long)size.QuadPart <= SIZE_MAX)
+    {
+      // The view keeps the mapping alive, so neither handle is needed afterwards.
+      HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (mapping)
+      {
+        data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        length = (size_t)size.QuadPart;
+        CloseHandle(mapping);
+      }
+    }
+    CloseHandle(file);
+#else
+    int file = ::open(filePath, O_RDONLY);
+    if (file < 0)
+      return nullptr;
+    gp_stat_struct s;
+    if (fstat(file, &s) == 0 && s.st_size > 0)
+    {
+      // The mapping stays valid after the descriptor is closed.
+      data = mmap(nullptr, (size_t)s.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+      length = (size_t)s.st_size;
+      if (data == MAP_FAILED)
+        data = nullptr;
+    }
+    ::close(file);
+#endif
+    if (!data)
+      return nullptr;
+    return new MappedFileStream((const unsigned char*)data, length);
+  }
+
+  bool MappedFileStream::canRead()
+  {
+    return _data != nullptr;
+  }
+
+  bool MappedFileStream::canWrite()
+  {
+    return false;
+  }
+
+  bool MappedFileStream::canSeek()
+  {
+    return _data != nullptr;
+  }
+
+  void MappedFileStream::close()
+  {
+    if (_data)
+    {
+#ifdef WIN32
+      UnmapViewOfFile(_data);
+#else
+      munmap((void*)_data, _length);
+#endif
+    }
+    _data = nullptr;
+    _length = 0;
+    _position = 0;
+  }
+
+  size_t MappedFileStream::read(void* ptr, size_t size, size_t count)
+  {
+    if (!_data || size == 0)
+      return 0;
+    // Like fread, a trailing partial element is consumed but not counted.
+    size_t bytes = std::min(size * count, _length - _position);
+    memcpy(ptr, _data + _position, bytes);
+    _position += bytes;
+    return bytes / size;
+  }
+
+  char* MappedFileStream::readLine(char* str, int num)
+  {
+    if (!_data || num <= 0 || _position >= _length)
+      return nullptr;
+    // Like fgets, stop after a newline or num - 1 characters.
+    int i = 0;
+    while (i < num - 1 && _position < _length)
+    {
+      char c = (char)_data[_position++];
+      str[i++] = c;
+      if (c == '\n')
+        break;
+    }
+    str[i] = '\0';
+    return str;
+  }
+
+  size_t MappedFileStream::write(const void* ptr, size_t size, size_t count)
+  {
+    return 0;
+  }
+
+  bool MappedFileStream::eof()
+  {
+    return _position >= _length;
+  }
+
+  size_t MappedFileStream::length()
+  {
+    return _length;
+  }
+
+  long int MappedFileStream::position()
+  {
+    if (!_data)
+      return -1;
+    return (long int)_position;
+  }
+
+  bool MappedFileStream::seek(long int offset, int origin)
+  {
+    if (!_data)
+      return false;
+
+    long long target;
+    switch (origin)
+    {
+    case SEEK_SET:
+      target = offset;
+      break;
+    case SEEK_CUR:
+      target = (long long)_position + offset;
+      break;
+    case SEEK_END:
+      target = (long long)_length + offset;
+      break;
+    default:
+      return false;
+    }
+
+    // Unlike files, the mapping cannot be positioned past its end.
+    if (target < 0 || (unsigned long long)target > _length)
+      return false;
+    _position = (size_t)target;
+    return true;
+  }
+
+  bool MappedFileStream::rewind()
+  {
+    if (!_data)
+      return false;
+    _position = 0;
+    return true;
+  }
+
+  const void* MappedFileStream::data()
+  {
+    return _data;
+  }
+
+  ////////////////////////////////
+
 #ifdef __ANDROID__
 
   FileStreamAndroid::FileStreamAndroid(AAsset* asset)
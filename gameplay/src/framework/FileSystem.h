@@ -23,7 +23,13 @@ namespace gameplay
     enum StreamMode
     {
       READ = 1,
-      WRITE = 2
+      WRITE = 2,
+      /**
+       * Maps a file opened for reading into memory so that Stream::data() can
+       * return a pointer to its contents. Opens a regular stream instead when
+       * the file cannot be mapped.
+       */
+      MAPPED = 4
     };
 
     /**
@@ -145,6 +151,15 @@ namespace gameplay
      */
     static bool fileExists(const char* filePath);
 
+    /**
+     * Creates a directory, along with any parent directories that do not exist.
+     *
+     * @param dirPath The path of the directory, relative to the path set in <code>setResourcePath(const char*)</code>.
+     *
+     * @return <code>true</code> if the directory exists or was created; <code>false</code> otherwise.
+     */
+    static bool createDirectory(const char* dirPath);
+
     /**
      * Opens a byte stream for the given resource path.
      *
@@ -152,7 +167,7 @@ namespace gameplay
      * resource path.
      *
      * @param path The path to the resource to be opened, relative to the currently set resource path.
-     * @param streamMode The stream mode used to open the file.
+     * @param streamMode The stream mode flags used to open the file (see StreamMode).
      *
      * @return A stream that can be used to read or write to the file depending on the mode.
      *         Returns nullptr if there was an error. (Request mode not supported).
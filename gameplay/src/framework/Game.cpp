@@ -1,9 +1,15 @@
 #include "framework/Base.h"
 #include "framework/Game.h"
+#include "framework/AssetLoader.h"
 #include "framework/Platform.h"
 #include "renderer/RenderState.h"
 #include "framework/FileSystem.h"
+#include "graphics/ShaderCache.h"
+#include "graphics/EffectManifest.h"
+#include "renderer/TextureDecoder.h"
+#include "renderer/TextureStreamer.h"
 #include "renderer/FrameBuffer.h"
+#include "renderer/Instancer.h"
 #include "scene/SceneLoader.h"
 #include "ui/ControlFactory.h"
 #include "ui/Theme.h"
@@ -63,7 +69,10 @@ namespace gameplay
   Game::Game()
     : _initialized(false), _state(UNINITIALIZED), _pausedCount(0),
     _frameLastFPS(0), _frameCount(0), _frameRate(0), _width(0), _height(0),
-    _clearDepth(1.0f), _clearStencil(0), _timeEvents(nullptr)
+    _clearDepth(1.0f), _clearStencil(0), _properties(nullptr),
+    _animationController(nullptr), _audioController(nullptr), _physicsController(nullptr), _aiController(nullptr), _audioListener(nullptr),
+    _timeEvents(nullptr), _scriptController(nullptr), _scriptTarget(nullptr),
+    _jobSystem(nullptr), _frameGraph(nullptr), _assetLoader(nullptr), _assetLoaderBudget(0.0f), _shaderCache(nullptr), _effectManifest(nullptr), _textureStreamer(nullptr), _frameElapsedTime(0.0f)
   {
     assert(__gameInstance == NULL);
     _timeEvents = new std::priority_queue<TimeEvent, std::vector<TimeEvent>, std::less<TimeEvent> >();
@@ -161,6 +170,58 @@ namespace gameplay
     setViewport(Rectangle(0.0f, 0.0f, (float)_width, (float)_height));
     RenderState::initialize();
     FrameBuffer::initialize();
+    Instancer::initialize();
+
+    // Start the worker threads before the subsystems that use them.
+    unsigned int workerCount = JobSystem::getDefaultWorkerCount();
+    Properties* jobs = _properties ? _properties->getNamespace("jobs", true) : nullptr;
+    if (jobs && jobs->exists("workers"))
+    {
+      workerCount = (unsigned int)std::max(jobs->getInt("workers"), 0);
+    }
+    _jobSystem = new JobSystem(workerCount);
+
+    unsigned int loaderThreadCount = 2;
+    _assetLoaderBudget = 4.0f;
+    Properties* loader = _properties ? _properties->getNamespace("loader", true) : nullptr;
+    if (loader)
+    {
+      if (loader->exists("threads"))
+        loaderThreadCount = (unsigned int)std::max(loader->getInt("threads"), 0);
+      if (loader->exists("budget"))
+        _assetLoaderBudget = std::max(loader->getFloat("budget"), 0.0f);
+    }
+    _assetLoader = new AssetLoader(loaderThreadCount);
+
+    // Keep compiled shader programs between runs, when a cache directory is set.
+    Properties* graphics = _properties ? _properties->getNamespace("graphics", true) : nullptr;
+    const char* shaderCachePath = graphics ? graphics->getString("shaderCache") : nullptr;
+    if (shaderCachePath && strlen(shaderCachePath) > 0)
+      _shaderCache = new ShaderCache(shaderCachePath);
+
+    // Stream texture mip levels within a memory budget, when one is set.
+    if (graphics && graphics->exists("textureBudget") && TextureStreamer::isSupported())
+    {
+      size_t textureBudget = (size_t)(std::max(graphics->getFloat("textureBudget"), 0.0f) * 1024.0f * 1024.0f);
+      unsigned int textureMinSize = graphics->exists("textureMinSize") ? (unsigned int)std::max(graphics->getInt("textureMinSize"), 1) : 64;
+      _textureStreamer = new TextureStreamer(_assetLoader, textureBudget, textureMinSize);
+    }
+
+    // Pick the filter that texture mip levels are generated with.
+    const char* mipmapFilter = graphics ? graphics->getString("mipmapFilter") : nullptr;
+    TextureDecoder::setFilter(mipmapFilter && strcmp(mipmapFilter, "KAISER") == 0 ? TextureDecoder::KAISER : TextureDecoder::BOX);
+
+    // Build the effects listed in the manifest now, so that they are not compiled during gameplay.
+    const char* effectManifestPath = graphics ? graphics->getString("effectManifest") : nullptr;
+    if (effectManifestPath && strlen(effectManifestPath) > 0)
+    {
+      _effectManifest = new EffectManifest();
+      if (_effectManifest->load(effectManifestPath))
+        _effectManifest->build(_jobSystem);
+    }
+
+    _frameGraph = new TaskGraph();
+    buildFrameGraph();
 
     _animationController = new AnimationController();
     _animationController->initialize();
@@ -247,6 +308,12 @@ namespace gameplay
       // Destroy script target so no more script events are fired
       SAFE_DELETE(_scriptTarget);
 
+      // Discard pending loads while the graphics and audio objects they hold can still be released
+      SAFE_DELETE(_textureStreamer);
+      SAFE_DELETE(_assetLoader);
+      SAFE_DELETE(_effectManifest);
+      SAFE_DELETE(_shaderCache);
+
       // Shutdown scripting system first so that any objects allocated in script are released before our subsystems are released
       _scriptController->finalize();
 
@@ -275,11 +342,15 @@ namespace gameplay
       // Note: we do not clean up the script controller here
       // because users can call Game::exit() from a script.
 
+      SAFE_DELETE(_frameGraph);
+      SAFE_DELETE(_jobSystem);
+
       SAFE_DELETE(_audioListener);
       FrameBuffer::finalize();
       RenderState::finalize();
 
       SAFE_DELETE(_properties);
+      Properties::clearCache();
 
       _state = UNINITIALIZED;
     }
@@ -382,37 +453,10 @@ namespace gameplay
       float elapsedTime = (frameTime - lastFrameTime);
       lastFrameTime = frameTime;
 
-      // Update the scheduled and running animations.
-      _animationController->update(elapsedTime);
-
-      // Update the physics.
-      _physicsController->update(elapsedTime);
-
-      // Update AI.
-      _aiController->update(elapsedTime);
-
-      // Update gamepads.
-      Gamepad::updateInternal(elapsedTime);
-
-      // Application Update.
-      update(elapsedTime);
-
-      // Update forms.
-      Form::updateInternal(elapsedTime);
-
-      // Run script update.
-      if (_scriptTarget)
-        _scriptTarget->fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(GameScriptTarget, update), elapsedTime);
-
-      // Audio Rendering.
-      _audioController->update(elapsedTime);
-
-      // Graphics Rendering.
-      render(elapsedTime);
-
-      // Run script render.
-      if (_scriptTarget)
-        _scriptTarget->fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(GameScriptTarget, render), elapsedTime);
+      // Update and render through the frame graph.
+      assert(_jobSystem && _frameGraph);
+      _frameElapsedTime = elapsedTime;
+      _jobSystem->run(*_frameGraph);
 
       // Update FPS.
       ++_frameCount;
@@ -425,6 +469,11 @@ namespace gameplay
     }
     else if (_state == Game::PAUSED)
     {
+      // Finalize loaded assets.
+      if (_textureStreamer)
+        _textureStreamer->update();
+      _assetLoader->update(_assetLoaderBudget);
+
       // Update gamepads.
       Gamepad::updateInternal(0);
 
@@ -447,6 +496,69 @@ namespace gameplay
     }
   }
 
+  void Game::buildFrameGraph()
+  {
+    assert(_frameGraph);
+
+    // These all touch shared engine state, so they stay on the main thread and
+    // in their original order: AI agents and the update hooks run listeners and
+    // scripts, physics, animation and audio read or write node transforms whose
+    // world matrices are computed lazily, and rendering needs the graphics context.
+    TaskGraph::Task tasks[] =
+    {
+      // Finalize loaded assets.
+      _frameGraph->addTask("assets", [this]()
+      {
+        if (_textureStreamer)
+          _textureStreamer->update();
+        _assetLoader->update(_assetLoaderBudget);
+      }, true),
+
+      // Update the scheduled and running animations.
+      _frameGraph->addTask("animation", [this]() { _animationController->update(_frameElapsedTime); }, true),
+
+      // Update the physics.
+      _frameGraph->addTask("physics", [this]() { _physicsController->update(_frameElapsedTime); }, true),
+
+      // Update AI.
+      _frameGraph->addTask("ai", [this]() { _aiController->update(_frameElapsedTime); }, true),
+
+      // Update gamepads.
+      _frameGraph->addTask("gamepads", [this]() { Gamepad::updateInternal(_frameElapsedTime); }, true),
+
+      // Application Update.
+      _frameGraph->addTask("update", [this]() { update(_frameElapsedTime); }, true),
+
+      // Update forms.
+      _frameGraph->addTask("forms", [this]() { Form::updateInternal(_frameElapsedTime); }, true),
+
+      // Run script update.
+      _frameGraph->addTask("scriptUpdate", [this]()
+      {
+        if (_scriptTarget)
+          _scriptTarget->fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(GameScriptTarget, update), _frameElapsedTime);
+      }, true),
+
+      // Audio Rendering.
+      _frameGraph->addTask("audio", [this]() { _audioController->update(_frameElapsedTime); }, true),
+
+      // Graphics Rendering.
+      _frameGraph->addTask("render", [this]() { render(_frameElapsedTime); }, true),
+
+      // Run script render.
+      _frameGraph->addTask("scriptRender", [this]()
+      {
+        if (_scriptTarget)
+          _scriptTarget->fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(GameScriptTarget, render), _frameElapsedTime);
+      }, true)
+    };
+
+    for (size_t i = 1; i < sizeof(tasks) / sizeof(tasks[0]); ++i)
+    {
+      _frameGraph->addDependency(tasks[i - 1], tasks[i]);
+    }
+  }
+
   void Game::renderOnce(const char* function)
   {
     _scriptController->executeFunction<void>(function, NULL);
@@ -12,6 +12,7 @@
 #include "animation/AnimationController.h"
 #include "physics/PhysicsController.h"
 #include "ai/AIController.h"
+#include "framework/JobSystem.h"
 #include "graphics/Rectangle.h"
 #include "math/Vector4.h"
 #include "utils/TimeListener.h"
@@ -19,7 +20,11 @@
 namespace gameplay
 {
 
+  class AssetLoader;
   class ScriptController;
+  class EffectManifest;
+  class ShaderCache;
+  class TextureStreamer;
 
   /**
    * Defines the base class your game will extend for game initialization, logic and platform delegates.
@@ -270,6 +275,78 @@ namespace gameplay
      */
     inline ScriptController* getScriptController() const;
 
+    /**
+     * Gets the job system shared by the game and the engine subsystems
+     * for running work on multiple threads.
+     *
+     * @return The job system for this game.
+     */
+    inline JobSystem* getJobSystem() const;
+
+    /**
+     * Gets the asset loader for loading assets in the background.
+     *
+     * Loaded assets are finalized at the start of every frame, within the
+     * time budget set by the "budget" property of the "loader" namespace
+     * in game.config.
+     *
+     * @return The asset loader for this game.
+     */
+    inline AssetLoader* getAssetLoader() const;
+
+    /**
+     * Gets the cache of compiled shader programs kept between runs.
+     *
+     * The cache is only created when the "shaderCache" property of the
+     * "graphics" namespace in game.config sets its directory.
+     *
+     * @return The shader cache, or nullptr if none is set.
+     * @script{ignore}
+     */
+    inline ShaderCache* getShaderCache() const;
+
+    /**
+     * Gets the manifest of effects built when the game started.
+     *
+     * The manifest is read from the file set by the "effectManifest" property
+     * of the "graphics" namespace in game.config. Calling addLoaded() and save()
+     * on it before exiting records the effects used during a run for the next.
+     *
+     * @return The effect manifest, or nullptr if none is set.
+     */
+    inline EffectManifest* getEffectManifest() const;
+
+    /**
+     * Gets the texture streamer, which loads the mip levels of textures as they are needed on screen.
+     *
+     * Streaming is enabled by setting the "textureBudget" property (in megabytes)
+     * of the "graphics" namespace in game.config.
+     *
+     * @return The texture streamer, or nullptr if streaming is disabled.
+     */
+    inline TextureStreamer* getTextureStreamer() const;
+
+    /**
+     * Gets the task graph that is run once per frame while the game is running.
+     *
+     * By default the graph runs the following main-thread tasks one after the
+     * other: "assets", "animation", "physics", "ai", "gamepads", "update", "forms",
+     * "scriptUpdate", "audio", "render" and "scriptRender". Tasks can be looked
+     * up by name with TaskGraph::findTask() in order to disable them or to add
+     * new tasks that depend on (or must finish before) them. Tasks added
+     * without the main-thread flag run on worker threads, concurrently with
+     * any task they are not ordered with.
+     *
+     * The built-in tasks never run concurrently with each other, since each of
+     * them touches nodes, scripts or the graphics context. Work is spread over
+     * the worker threads within them instead: the animation task evaluates
+     * clips with JobSystem::parallelFor(), and a ParticleSystemManager updated
+     * from the "update" task simulates its emitters the same way.
+     *
+     * @return The per-frame task graph.
+     */
+    inline TaskGraph* getFrameGraph() const;
+
     /**
      * Gets the audio listener for 3D audio.
      *
@@ -732,6 +809,11 @@ namespace gameplay
      */
     void loadGamepads();
 
+    /**
+     * Adds the built-in per-frame tasks to the frame graph.
+     */
+    void buildFrameGraph();
+
     void keyEventInternal(Keyboard::KeyEvent evt, int key);
     void touchEventInternal(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex);
     bool mouseEventInternal(Mouse::MouseEvent evt, int x, int y, int wheelDelta);
@@ -767,6 +849,14 @@ namespace gameplay
     std::priority_queue<TimeEvent, std::vector<TimeEvent>, std::less<TimeEvent> >* _timeEvents;     // Contains the scheduled time events.
     ScriptController* _scriptController;            // Controls the scripting engine.
     ScriptTarget* _scriptTarget;                // Script target for the game
+    JobSystem* _jobSystem;                      // Runs work on the worker threads.
+    TaskGraph* _frameGraph;                     // The tasks run each frame.
+    AssetLoader* _assetLoader;                  // Loads assets in the background.
+    float _assetLoaderBudget;                   // Milliseconds spent finalizing loaded assets each frame.
+    ShaderCache* _shaderCache;                  // Compiled shader programs kept between runs.
+    EffectManifest* _effectManifest;            // Effects built at startup.
+    TextureStreamer* _textureStreamer;          // Streams texture mip levels within a memory budget.
+    float _frameElapsedTime;                    // The elapsed time of the frame being run.
 
     // Note: Do not add STL object member variables on the stack; this will cause false memory leaks to be reported.
 
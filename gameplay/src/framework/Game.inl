@@ -58,6 +58,36 @@ namespace gameplay
   {
     return _scriptController;
   }
+  inline JobSystem* Game::getJobSystem() const
+  {
+    return _jobSystem;
+  }
+
+  inline AssetLoader* Game::getAssetLoader() const
+  {
+    return _assetLoader;
+  }
+
+  inline ShaderCache* Game::getShaderCache() const
+  {
+    return _shaderCache;
+  }
+
+  inline EffectManifest* Game::getEffectManifest() const
+  {
+    return _effectManifest;
+  }
+
+  inline TextureStreamer* Game::getTextureStreamer() const
+  {
+    return _textureStreamer;
+  }
+
+  inline TaskGraph* Game::getFrameGraph() const
+  {
+    return _frameGraph;
+  }
+
   inline AIController* Game::getAIController() const
   {
     return _aiController;
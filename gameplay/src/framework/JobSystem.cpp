@@ -0,0 +1,274 @@
+#include "framework/Base.h"
+#include "framework/JobSystem.h"
+
+namespace gameplay
+{
+
+  // The job system and queue owned by the current worker thread. Any other
+  // thread (including the main thread) uses queue 0.
+  static thread_local const JobSystem* __jobSystem = nullptr;
+  static thread_local unsigned int __queueIndex = 0;
+
+  // The number of jobs the current thread is executing, counting nested ones.
+  static thread_local unsigned int __jobDepth = 0;
+
+  JobSystem::JobSystem(unsigned int workerCount)
+    : _queueCount(workerCount + 1), _mainThread(std::this_thread::get_id()), _queuedJobs(0), _quit(false)
+  {
+    _queues.reset(new Queue[_queueCount]);
+    _workers.reserve(workerCount);
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+      _workers.push_back(std::thread(&JobSystem::workerProc, this, i + 1));
+    }
+  }
+
+  JobSystem::~JobSystem()
+  {
+    {
+      std::lock_guard<std::mutex> lock(_sleepMutex);
+      _quit = true;
+    }
+    _wake.notify_all();
+    for (size_t i = 0, count = _workers.size(); i < count; ++i)
+    {
+      _workers[i].join();
+    }
+  }
+
+  unsigned int JobSystem::getWorkerCount() const
+  {
+    return (unsigned int)_workers.size();
+  }
+
+  unsigned int JobSystem::getDefaultWorkerCount()
+  {
+    unsigned int threads = std::thread::hardware_concurrency();
+    return threads > 1 ? threads - 1 : 0;
+  }
+
+  void JobSystem::run(TaskGraph& graph)
+  {
+    unsigned int count = graph.getTaskCount();
+    if (count == 0)
+      return;
+
+    assert(graph._remaining == 0);
+
+    // Only the main thread runs main-thread tasks, and only outside of any job, so that
+    // they never run in the middle of another task or on a thread that would wait forever.
+    bool mainThreadTasks = false;
+    for (unsigned int i = 0; i < count && !mainThreadTasks; ++i)
+    {
+      mainThreadTasks = graph._tasks[i].mainThread;
+    }
+    if (mainThreadTasks && (std::this_thread::get_id() != _mainThread || __jobDepth > 0))
+    {
+      GP_ERROR("Task graph with main-thread tasks must be run from the main thread, outside of any job.");
+      return;
+    }
+
+    if (!graph._pending)
+    {
+      if (!graph.isAcyclic())
+      {
+        GP_ERROR("Task graph contains a dependency cycle.");
+        return;
+      }
+      graph._pending.reset(new std::atomic<unsigned int>[count]);
+    }
+
+    graph._remaining = count;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      graph._pending[i] = graph._tasks[i].predecessorCount;
+    }
+
+    // Every task without predecessors can start right away.
+    Job job = { nullptr, 0, 0, &graph, 0, &graph._remaining };
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      if (graph._tasks[i].predecessorCount == 0)
+      {
+        job.task = i;
+        push(job);
+      }
+    }
+
+    waitFor(graph._remaining, mainThreadTasks);
+  }
+
+  void JobSystem::parallelFor(unsigned int count, const std::function<void(unsigned int)>& function, unsigned int grainSize)
+  {
+    if (count == 0)
+      return;
+
+    // Split the range into a few jobs per thread so that idle threads have something to steal.
+    unsigned int jobSize = std::max(grainSize, (count + _queueCount * 4 - 1) / (_queueCount * 4));
+    if (jobSize >= count || _queueCount == 1)
+    {
+      for (unsigned int i = 0; i < count; ++i)
+      {
+        function(i);
+      }
+      return;
+    }
+
+    unsigned int jobCount = (count + jobSize - 1) / jobSize;
+    std::atomic<unsigned int> remaining(jobCount);
+    Job job = { &function, 0, 0, nullptr, 0, &remaining };
+    for (unsigned int begin = 0; begin < count; begin += jobSize)
+    {
+      job.begin = begin;
+      job.end = std::min(begin + jobSize, count);
+      push(job);
+    }
+
+    waitFor(remaining, false);
+  }
+
+  void JobSystem::workerProc(unsigned int index)
+  {
+    __jobSystem = this;
+    __queueIndex = index;
+
+    Job job;
+    while (true)
+    {
+      if (pop(&job, false))
+      {
+        execute(job);
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(_sleepMutex);
+      _wake.wait(lock, [this]() { return _quit || _queuedJobs > 0; });
+      if (_quit)
+        return;
+    }
+  }
+
+  unsigned int JobSystem::getQueueIndex() const
+  {
+    return __jobSystem == this ? __queueIndex : 0;
+  }
+
+  void JobSystem::push(const Job& job)
+  {
+    if (job.graph && job.graph->_tasks[job.task].mainThread)
+    {
+      // Workers cannot run these, so there is no point in waking them.
+      std::lock_guard<std::mutex> lock(_mainQueue.mutex);
+      _mainQueue.jobs.push_back(job);
+      return;
+    }
+
+    Queue& queue = _queues[getQueueIndex()];
+    {
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      queue.jobs.push_back(job);
+    }
+    ++_queuedJobs;
+
+    // Taking the lock orders this with a worker checking _queuedJobs before it sleeps.
+    {
+      std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _wake.notify_one();
+  }
+
+  bool JobSystem::pop(Job* job, bool mainQueue)
+  {
+    unsigned int index = getQueueIndex();
+
+    // Main-thread tasks come first since nobody else can run them.
+    if (mainQueue)
+    {
+      assert(std::this_thread::get_id() == _mainThread);
+      std::lock_guard<std::mutex> lock(_mainQueue.mutex);
+      if (!_mainQueue.jobs.empty())
+      {
+        *job = _mainQueue.jobs.back();
+        _mainQueue.jobs.pop_back();
+        return true;
+      }
+    }
+
+    // Newest job from our own queue, then the oldest job from any other queue.
+    for (unsigned int i = 0; i < _queueCount; ++i)
+    {
+      Queue& queue = _queues[(index + i) % _queueCount];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (!queue.jobs.empty())
+      {
+        if (i == 0)
+        {
+          *job = queue.jobs.back();
+          queue.jobs.pop_back();
+        }
+        else
+        {
+          *job = queue.jobs.front();
+          queue.jobs.pop_front();
+        }
+        --_queuedJobs;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void JobSystem::execute(const Job& job)
+  {
+    ++__jobDepth;
+    if (job.graph)
+    {
+      TaskGraph* graph = job.graph;
+      const TaskGraph::TaskEntry& entry = graph->_tasks[job.task];
+      if (entry.enabled && entry.function)
+      {
+        entry.function();
+      }
+
+      // Start the successors this task was the last dependency of.
+      Job successor = job;
+      for (size_t i = 0, count = entry.successors.size(); i < count; ++i)
+      {
+        successor.task = entry.successors[i];
+        if (--graph->_pending[successor.task] == 0)
+        {
+          push(successor);
+        }
+      }
+    }
+    else
+    {
+      const std::function<void(unsigned int)>& function = *job.function;
+      for (unsigned int i = job.begin; i < job.end; ++i)
+      {
+        function(i);
+      }
+    }
+
+    --__jobDepth;
+    --(*job.remaining);
+  }
+
+  void JobSystem::waitFor(const std::atomic<unsigned int>& remaining, bool mainQueue)
+  {
+    // Help out instead of blocking, which also keeps nested waits from deadlocking.
+    Job job;
+    while (remaining > 0)
+    {
+      if (pop(&job, mainQueue))
+      {
+        execute(job);
+      }
+      else
+      {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+}
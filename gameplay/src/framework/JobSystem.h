@@ -0,0 +1,143 @@
+#pragma once
+
+#include "framework/TaskGraph.h"
+
+namespace gameplay
+{
+
+  /**
+   * Defines a work-stealing job scheduler.
+   *
+   * The job system owns a fixed set of worker threads, each with its own queue
+   * of jobs. Threads push the jobs they create onto their own queue and take
+   * them back in last-in first-out order, which keeps related work on the same
+   * core. A thread that runs out of work steals the oldest job from another
+   * thread's queue.
+   *
+   * Threads that wait on work (in run() or parallelFor()) execute pending jobs
+   * while they wait instead of blocking, so both calls may be nested inside
+   * jobs. The thread that created the job system is its main thread and is the
+   * only one that executes tasks flagged to run on the main thread. It only
+   * does so while waiting in a run() that it called outside of any job, so a
+   * main-thread task never runs in the middle of another job.
+   *
+   * The game owns a job system that engine subsystems share (see
+   * Game::getJobSystem()). Its worker count is read from the "workers"
+   * property of the "jobs" namespace in game.config. The AnimationController,
+   * ParticleSystemManager, EffectManifest and TextureDecoder split their work
+   * over it, and the game runs its frame graph with it.
+   */
+  class JobSystem
+  {
+  public:
+
+    /**
+     * Constructor. Must be called on the thread that runs main-thread tasks.
+     *
+     * @param workerCount The number of worker threads to start, in addition to the main thread.
+     */
+    JobSystem(unsigned int workerCount);
+
+    /**
+     * Destructor. Stops and joins all worker threads.
+     */
+    ~JobSystem();
+
+    /**
+     * Gets the number of worker threads.
+     *
+     * @return The number of worker threads.
+     */
+    unsigned int getWorkerCount() const;
+
+    /**
+     * Gets the recommended number of worker threads for this machine,
+     * which is one less than the number of hardware threads.
+     *
+     * @return The recommended number of worker threads.
+     */
+    static unsigned int getDefaultWorkerCount();
+
+    /**
+     * Runs all tasks of a graph, respecting their dependencies, and blocks
+     * until they have finished.
+     *
+     * Graphs containing main-thread tasks must be run from the main thread,
+     * and not from inside a job or task.
+     *
+     * @param graph The graph to run.
+     */
+    void run(TaskGraph& graph);
+
+    /**
+     * Calls the specified function once for every index in [0, count),
+     * distributing the calls over the available threads, and blocks until
+     * every call has returned.
+     *
+     * Iterations may run in any order and concurrently, so they must not
+     * depend on each other.
+     *
+     * @param count The number of iterations.
+     * @param function The function to call for each iteration.
+     * @param grainSize The minimum number of consecutive iterations run as a single job.
+     */
+    void parallelFor(unsigned int count, const std::function<void(unsigned int)>& function, unsigned int grainSize = 1);
+
+  private:
+
+    /**
+     * A unit of work: either a range of a parallel loop or a task of a graph.
+     */
+    struct Job
+    {
+      const std::function<void(unsigned int)>* function;
+      unsigned int begin;
+      unsigned int end;
+      TaskGraph* graph;
+      TaskGraph::Task task;
+      std::atomic<unsigned int>* remaining;
+    };
+
+    /**
+     * A queue of jobs owned by one thread.
+     */
+    struct Queue
+    {
+      std::mutex mutex;
+      std::deque<Job> jobs;
+    };
+
+    /**
+     * Hidden copy constructor.
+     */
+    JobSystem(const JobSystem& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    JobSystem& operator=(const JobSystem&);
+
+    void workerProc(unsigned int index);
+
+    unsigned int getQueueIndex() const;
+
+    void push(const Job& job);
+
+    bool pop(Job* job, bool mainQueue);
+
+    void execute(const Job& job);
+
+    void waitFor(const std::atomic<unsigned int>& remaining, bool mainQueue);
+
+    std::vector<std::thread> _workers;
+    std::unique_ptr<Queue[]> _queues;
+    unsigned int _queueCount;
+    Queue _mainQueue;
+    std::thread::id _mainThread;
+    std::atomic<unsigned int> _queuedJobs;
+    std::mutex _sleepMutex;
+    std::condition_variable _wake;
+    bool _quit;
+  };
+
+}
@@ -8,6 +8,7 @@
 #include "ui/Form.h"
 #include "math/Vector2.h"
 #include "scripting/ScriptController.h"
+#include "renderer/StateCache.h"
 #include <GL/wglew.h>
 #include <windowsx.h>
 #include <Commdlg.h>
@@ -793,6 +794,9 @@ namespace gameplay
       glRenderbufferStorageMultisample = glRenderbufferStorageMultisampleEXT;
     }
 
+    // Nothing the cache shadows is bound in a new context.
+    StateCache::getCurrent()->invalidate();
+
     return true;
   }
 
@@ -154,6 +154,19 @@ namespace gameplay
      */
     virtual bool rewind() = 0;
 
+    /**
+     * Gets a pointer to the contents of the stream if they are mapped in memory.
+     *
+     * The pointer addresses the first byte of the stream (not the current
+     * position) and stays valid until the stream is closed, which lets readers
+     * consume large blocks of data without copying them.
+     *
+     * @return A pointer to the stream contents, or nullptr if the stream is not memory mapped.
+     *
+     * @see FileSystem::MAPPED
+     */
+    virtual const void* data() { return nullptr; }
+
   protected:
     Stream() {};
   private:
@@ -0,0 +1,121 @@
+#include "framework/Base.h"
+#include "framework/TaskGraph.h"
+
+namespace gameplay
+{
+
+  const TaskGraph::Task TaskGraph::INVALID_TASK;
+
+  TaskGraph::TaskGraph()
+    : _remaining(0)
+  {
+  }
+
+  TaskGraph::~TaskGraph()
+  {
+  }
+
+  TaskGraph::Task TaskGraph::addTask(const char* name, const std::function<void()>& function, bool mainThread)
+  {
+    assert(name);
+    assert(_remaining == 0);
+
+    TaskEntry entry;
+    entry.name = name;
+    entry.function = function;
+    entry.predecessorCount = 0;
+    entry.mainThread = mainThread;
+    entry.enabled = true;
+    _tasks.push_back(entry);
+    _pending.reset();
+    return (Task)(_tasks.size() - 1);
+  }
+
+  void TaskGraph::addDependency(Task before, Task after)
+  {
+    assert(before < _tasks.size());
+    assert(after < _tasks.size());
+    assert(before != after);
+    assert(_remaining == 0);
+
+    std::vector<Task>& successors = _tasks[before].successors;
+    if (std::find(successors.begin(), successors.end(), after) == successors.end())
+    {
+      successors.push_back(after);
+      ++_tasks[after].predecessorCount;
+      _pending.reset();
+    }
+  }
+
+  TaskGraph::Task TaskGraph::findTask(const char* name) const
+  {
+    assert(name);
+
+    for (size_t i = 0, count = _tasks.size(); i < count; ++i)
+    {
+      if (_tasks[i].name == name)
+        return (Task)i;
+    }
+    return INVALID_TASK;
+  }
+
+  unsigned int TaskGraph::getTaskCount() const
+  {
+    return (unsigned int)_tasks.size();
+  }
+
+  const char* TaskGraph::getTaskName(Task task) const
+  {
+    assert(task < _tasks.size());
+    return _tasks[task].name.c_str();
+  }
+
+  void TaskGraph::setTaskEnabled(Task task, bool enabled)
+  {
+    assert(task < _tasks.size());
+    _tasks[task].enabled = enabled;
+  }
+
+  bool TaskGraph::isTaskEnabled(Task task) const
+  {
+    assert(task < _tasks.size());
+    return _tasks[task].enabled;
+  }
+
+  void TaskGraph::clear()
+  {
+    assert(_remaining == 0);
+    _tasks.clear();
+    _pending.reset();
+  }
+
+  bool TaskGraph::isAcyclic() const
+  {
+    // Kahn's algorithm: every task must be reachable once its predecessors are removed.
+    size_t count = _tasks.size();
+    std::vector<unsigned int> predecessors(count);
+    std::vector<Task> ready;
+    for (size_t i = 0; i < count; ++i)
+    {
+      predecessors[i] = _tasks[i].predecessorCount;
+      if (predecessors[i] == 0)
+        ready.push_back((Task)i);
+    }
+
+    size_t visited = 0;
+    while (!ready.empty())
+    {
+      Task task = ready.back();
+      ready.pop_back();
+      ++visited;
+      const std::vector<Task>& successors = _tasks[task].successors;
+      for (size_t i = 0; i < successors.size(); ++i)
+      {
+        if (--predecessors[successors[i]] == 0)
+          ready.push_back(successors[i]);
+      }
+    }
+    return visited == count;
+  }
+
+}
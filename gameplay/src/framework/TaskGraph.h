@@ -0,0 +1,144 @@
+#pragma once
+
+namespace gameplay
+{
+
+  /**
+   * Defines a set of tasks and the dependencies between them.
+   *
+   * A task graph is executed by JobSystem::run(), which starts every task as
+   * soon as all of the tasks it depends on have finished. Tasks that do not
+   * depend on each other may run concurrently on different worker threads.
+   *
+   * Tasks that must run on the main thread (for example anything that calls
+   * into the graphics API or the script engine) are flagged as such when they
+   * are added, and are only ever executed by the thread that runs the graph.
+   *
+   * A graph can be run any number of times. Tasks may be disabled, in which
+   * case they are skipped but their dependents still run in order.
+   *
+   * @see JobSystem
+   */
+  class TaskGraph
+  {
+    friend class JobSystem;
+
+  public:
+
+    /**
+     * Identifies a task within a graph.
+     */
+    typedef unsigned int Task;
+
+    /**
+     * Value returned by findTask() when no task has the given name.
+     */
+    static const Task INVALID_TASK = 0xFFFFFFFF;
+
+    /**
+     * Constructor.
+     */
+    TaskGraph();
+
+    /**
+     * Destructor.
+     */
+    ~TaskGraph();
+
+    /**
+     * Adds a task to the graph.
+     *
+     * @param name The name of the task, used to look it up with findTask().
+     * @param function The function to call when the task runs.
+     * @param mainThread True if the task must run on the main thread of the job system.
+     * @return The new task.
+     */
+    Task addTask(const char* name, const std::function<void()>& function, bool mainThread = false);
+
+    /**
+     * Makes a task wait for another task to finish before it starts.
+     *
+     * @param before The task that must finish first.
+     * @param after The task that depends on before.
+     */
+    void addDependency(Task before, Task after);
+
+    /**
+     * Finds the task with the given name.
+     *
+     * @param name The name of the task to find.
+     * @return The task, or INVALID_TASK if no task has that name.
+     */
+    Task findTask(const char* name) const;
+
+    /**
+     * Gets the number of tasks in the graph.
+     *
+     * @return The number of tasks.
+     */
+    unsigned int getTaskCount() const;
+
+    /**
+     * Gets the name of a task.
+     *
+     * @param task The task.
+     * @return The name of the task.
+     */
+    const char* getTaskName(Task task) const;
+
+    /**
+     * Sets whether a task is run when the graph runs.
+     *
+     * @param task The task.
+     * @param enabled False to skip the task.
+     */
+    void setTaskEnabled(Task task, bool enabled);
+
+    /**
+     * Gets whether a task is run when the graph runs.
+     *
+     * @param task The task.
+     * @return True if the task is run.
+     */
+    bool isTaskEnabled(Task task) const;
+
+    /**
+     * Removes all tasks from the graph.
+     */
+    void clear();
+
+  private:
+
+    /**
+     * Hidden copy constructor.
+     */
+    TaskGraph(const TaskGraph& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    TaskGraph& operator=(const TaskGraph&);
+
+    /**
+     * Checks that the dependencies do not contain a cycle.
+     */
+    bool isAcyclic() const;
+
+    struct TaskEntry
+    {
+      std::string name;
+      std::function<void()> function;
+      std::vector<Task> successors;
+      unsigned int predecessorCount;
+      bool mainThread;
+      bool enabled;
+    };
+
+    std::vector<TaskEntry> _tasks;
+    // Per-task count of unfinished predecessors while running. Released
+    // whenever the graph changes so that it gets validated again.
+    std::unique_ptr<std::atomic<unsigned int>[]> _pending;
+    std::atomic<unsigned int> _remaining;
+  };
+
+}
@@ -1,10 +1,13 @@
 // Framework
 #include "framework/Base.h"
+#include "framework/AssetLoader.h"
 #include "framework/FileSystem.h"
 #include "framework/Game.h"
+#include "framework/JobSystem.h"
 #include "framework/Platform.h"
 #include "framework/ScreenDisplayer.h"
 #include "framework/Stream.h"
+#include "framework/TaskGraph.h"
 
 // AI
 #include "ai/AIAgent.h"
@@ -32,6 +35,7 @@
 #include "graphics/Curve.h"
 #include "graphics/Drawable.h"
 #include "graphics/Effect.h"
+#include "graphics/EffectManifest.h"
 #include "graphics/Frustum.h"
 #include "graphics/HeightField.h"
 #include "graphics/Light.h"
@@ -41,9 +45,11 @@
 #include "graphics/MeshSkin.h"
 #include "graphics/Model.h"
 #include "graphics/ParticleEmitter.h"
+#include "graphics/ParticleSystemManager.h"
 #include "graphics/Plane.h"
 #include "graphics/Ray.h"
 #include "graphics/Rectangle.h"
+#include "graphics/ShaderCache.h"
 #include "graphics/Sprite.h"
 #include "graphics/SpriteBatch.h"
 #include "graphics/Terrain.h"
@@ -89,12 +95,18 @@
 #include "renderer/DepthStencilTarget.h"
 #include "renderer/Font.h"
 #include "renderer/FrameBuffer.h"
+#include "renderer/Instancer.h"
 #include "renderer/Material.h"
 #include "renderer/Pass.h"
+#include "renderer/RenderQueue.h"
 #include "renderer/RenderState.h"
 #include "renderer/RenderTarget.h"
+#include "renderer/StateCache.h"
 #include "renderer/Text.h"
 #include "renderer/Texture.h"
+#include "renderer/TextureContainer.h"
+#include "renderer/TextureDecoder.h"
+#include "renderer/TextureStreamer.h"
 #include "renderer/VertexAttributeBinding.h"
 #include "renderer/VertexFormat.h"
 
@@ -104,6 +116,8 @@
 #include "scene/Properties.h"
 #include "scene/Scene.h"
 #include "scene/SceneLoader.h"
+#include "scene/SpatialIndex.h"
+#include "scene/TransformStore.h"
 
 // Scripting
 #include "scripting/Script.h"
@@ -132,4 +146,5 @@
 #include "utils/DebugNew.h"
 #include "utils/Logger.h"
 #include "utils/Ref.h"
+#include "utils/ResourceRegistry.h"
 #include "utils/TimeListener.h"
@@ -7,6 +7,7 @@
 #include <memory>
 
 using std::memcpy;
+using std::memset;
 using std::fabs;
 using std::sqrt;
 using std::cos;
@@ -30,6 +31,15 @@ using std::strcmp;
 #define MATH_PIX2 6.28318530717958647693f
 #endif
 
+// The number of points a Curve::Cursor steps over before searching
+#define CURSOR_SCAN_LIMIT 8
+
+// The largest number of components a compressed curve supports
+#define PACKED_MAX_COMPONENTS 16
+
+// Scale of the three smallest quaternion components, which lie in [-1/sqrt(2), 1/sqrt(2)]
+#define PACKED_QUATERNION_RANGE 0.707106781186547524401f
+
 // Object deletion macro
 #ifndef SAFE_DELETE
 #define SAFE_DELETE(x) \
@@ -80,6 +90,55 @@ static inline float lerpInl(float s, float from, float to)
   return from + (to - from) * s;
 }
 
+// Packs a unit quaternion into 48 bits: the index of its largest component followed by the
+// other three components, quantized to 15 bits each. The largest component is rebuilt from
+// the unit length, with the sign of the quaternion flipped so that it is positive.
+static void packQuaternion(const float* q, unsigned short* dst)
+{
+  unsigned int largest = 0;
+  for (unsigned int i = 1; i < 4; ++i)
+  {
+    if (fabs(q[i]) > fabs(q[largest]))
+      largest = i;
+  }
+  float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+  float length = sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+  float scale = length > 0.0f ? sign / length : 0.0f;
+
+  unsigned long long bits = largest;
+  unsigned int shift = 2;
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    if (i == largest)
+      continue;
+    float v = (q[i] * scale + PACKED_QUATERNION_RANGE) * (32767.0f / (2.0f * PACKED_QUATERNION_RANGE));
+    v = v < 0.0f ? 0.0f : (v > 32767.0f ? 32767.0f : v);
+    bits |= (unsigned long long)(v + 0.5f) << shift;
+    shift += 15;
+  }
+  dst[0] = (unsigned short)bits;
+  dst[1] = (unsigned short)(bits >> 16);
+  dst[2] = (unsigned short)(bits >> 32);
+}
+
+static void unpackQuaternion(const unsigned short* src, float* dst)
+{
+  unsigned long long bits = (unsigned long long)src[0] | ((unsigned long long)src[1] << 16) | ((unsigned long long)src[2] << 32);
+  unsigned int largest = (unsigned int)(bits & 3);
+  unsigned int shift = 2;
+  float sum = 0.0f;
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    if (i == largest)
+      continue;
+    float v = (float)((bits >> shift) & 0x7FFF) * ((2.0f * PACKED_QUATERNION_RANGE) / 32767.0f) - PACKED_QUATERNION_RANGE;
+    dst[i] = v;
+    sum += v * v;
+    shift += 15;
+  }
+  dst[largest] = sum < 1.0f ? sqrt(1.0f - sum) : 0.0f;
+}
+
 namespace gameplay
 {
 
@@ -88,8 +147,17 @@ namespace gameplay
     return new Curve(pointCount, componentCount);
   }
 
+  Curve::Curve()
+    : _pointCount(0), _componentCount(0), _componentSize(0), _quaternionOffset(nullptr), _points(nullptr),
+    _packedTimes(nullptr), _packedRanges(nullptr), _packedValues(nullptr), _packedStride(0),
+    _bakedValues(nullptr), _bakedSampleCount(0)
+  {
+  }
+
   Curve::Curve(unsigned int pointCount, unsigned int componentCount)
-    : _pointCount(pointCount), _componentCount(componentCount), _componentSize(sizeof(float)* componentCount), _quaternionOffset(nullptr), _points(nullptr)
+    : _pointCount(pointCount), _componentCount(componentCount), _componentSize(sizeof(float)* componentCount), _quaternionOffset(nullptr), _points(nullptr),
+    _packedTimes(nullptr), _packedRanges(nullptr), _packedValues(nullptr), _packedStride(0),
+    _bakedValues(nullptr), _bakedSampleCount(0)
   {
     _points = new Point[_pointCount];
     for (unsigned int i = 0; i < _pointCount; i++)
@@ -107,6 +175,44 @@ namespace gameplay
   {
     SAFE_DELETE_ARRAY(_points);
     SAFE_DELETE_ARRAY(_quaternionOffset);
+    SAFE_DELETE_ARRAY(_packedTimes);
+    SAFE_DELETE_ARRAY(_packedRanges);
+    SAFE_DELETE_ARRAY(_packedValues);
+    SAFE_DELETE_ARRAY(_bakedValues);
+  }
+
+  Curve* Curve::createPacked(unsigned int pointCount, unsigned int componentCount, int quaternionOffset,
+    const float* times, const float* ranges, const unsigned short* values)
+  {
+    assert(pointCount > 0 && componentCount > 0 && componentCount <= PACKED_MAX_COMPONENTS);
+    assert(quaternionOffset < 0 || (unsigned int)quaternionOffset + 4 <= componentCount);
+
+    Curve* curve = new Curve();
+    curve->_pointCount = pointCount;
+    curve->_componentCount = componentCount;
+    curve->_componentSize = sizeof(float) * componentCount;
+    curve->_packedStride = quaternionOffset < 0 ? componentCount : componentCount - 1;
+    if (quaternionOffset >= 0)
+    {
+      curve->_quaternionOffset = new unsigned int[1];
+      *curve->_quaternionOffset = (unsigned int)quaternionOffset;
+    }
+
+    curve->_packedTimes = new float[pointCount];
+    curve->_packedRanges = new float[componentCount * 2];
+    curve->_packedValues = new unsigned short[pointCount * curve->_packedStride];
+    if (times)
+      memcpy(curve->_packedTimes, times, sizeof(float) * pointCount);
+    if (ranges)
+      memcpy(curve->_packedRanges, ranges, sizeof(float) * componentCount * 2);
+    if (values)
+      memcpy(curve->_packedValues, values, sizeof(unsigned short) * pointCount * curve->_packedStride);
+    return curve;
+  }
+
+  Curve::Cursor::Cursor()
+    : _curve(nullptr), _startTime(0.0f), _endTime(0.0f), _min(0), _max(0), _index(0)
+  {
   }
 
   Curve::Point::Point()
@@ -133,31 +239,43 @@ namespace gameplay
 
   float Curve::getStartTime() const
   {
-    return _points[0].time;
+    return getKeyTime(0);
   }
 
   float Curve::getEndTime() const
   {
-    return _points[_pointCount - 1].time;
+    return getKeyTime(_pointCount - 1);
   }
 
   float Curve::getPointTime(unsigned int index) const
   {
     assert(index < _pointCount);
-    return _points[index].time;
+    return getKeyTime(index);
   }
 
 
   Curve::InterpolationType Curve::getPointInterpolation(unsigned int index) const
   {
     assert(index < _pointCount);
-    return _points[index].type;;
+    return _packedValues ? LINEAR : _points[index].type;
   }
 
   void Curve::getPointValues(unsigned int index, float* value, float* inValue, float* outValue) const
   {
     assert(index < _pointCount);
 
+    if (_packedValues)
+    {
+      // Compressed curves only interpolate linearly, so they have no tangents.
+      if (value)
+        unpackValue(index, value);
+      if (inValue)
+        memset(inValue, 0, _componentSize);
+      if (outValue)
+        memset(outValue, 0, _componentSize);
+      return;
+    }
+
     if (value)
       memcpy(value, _points[index].value, _componentSize);
 
@@ -177,6 +295,9 @@ namespace gameplay
   {
     assert(index < _pointCount && time >= 0.0f && time <= 1.0f && !(_pointCount > 1 && index == 0 && time != 0.0f) && !(_pointCount != 1 && index == _pointCount - 1 && time != 1.0f));
 
+    assert(!_packedValues);
+    bake(0);
+
     _points[index].time = time;
     _points[index].type = type;
 
@@ -192,7 +313,9 @@ namespace gameplay
 
   void Curve::setTangent(unsigned int index, InterpolationType type, float* inValue, float* outValue)
   {
-    assert(index < _pointCount);
+    assert(index < _pointCount && !_packedValues);
+
+    bake(0);
 
     _points[index].type = type;
 
@@ -211,13 +334,18 @@ namespace gameplay
   }
 
   void Curve::evaluate(float time, float startTime, float endTime, float loopBlendTime, float* dst) const
+  {
+    evaluate(time, startTime, endTime, loopBlendTime, dst, nullptr);
+  }
+
+  void Curve::evaluate(float time, float startTime, float endTime, float loopBlendTime, float* dst, Cursor* cursor) const
   {
     assert(dst && startTime >= 0.0f && startTime <= endTime && endTime <= 1.0f && loopBlendTime >= 0.0f);
 
     // If there's only one point on the curve, return its value.
     if (_pointCount == 1)
     {
-      memcpy(dst, _points[0].value, _componentSize);
+      getKeyValue(0, dst);
       return;
     }
 
@@ -227,72 +355,99 @@ namespace gameplay
     if (startTime > 0.0f || endTime < 1.0f)
     {
       // Evaluating a sub section of the curve
-      min = determineIndex(startTime, 0, max);
-      max = determineIndex(endTime, min, max);
+      if (cursor && cursor->_curve == this && cursor->_startTime == startTime && cursor->_endTime == endTime)
+      {
+        min = cursor->_min;
+        max = cursor->_max;
+      }
+      else
+      {
+        min = determineIndex(startTime, 0, max);
+        max = determineIndex(endTime, min, max);
+        if (cursor)
+        {
+          cursor->_curve = this;
+          cursor->_startTime = startTime;
+          cursor->_endTime = endTime;
+          cursor->_min = min;
+          cursor->_max = max;
+        }
+      }
 
       // Convert time to fall within the subregion
-      localTime = _points[min].time + (_points[max].time - _points[min].time) * time;
+      localTime = getKeyTime(min) + (getKeyTime(max) - getKeyTime(min)) * time;
     }
 
+    float minTime = getKeyTime(min);
+    float maxTime = getKeyTime(max);
     if (loopBlendTime == 0.0f)
     {
       // If no loop blend time is specified, clamp time to end points
-      if (localTime < _points[min].time)
-        localTime = _points[min].time;
-      else if (localTime > _points[max].time)
-        localTime = _points[max].time;
+      if (localTime < minTime)
+        localTime = minTime;
+      else if (localTime > maxTime)
+        localTime = maxTime;
     }
 
     // If an exact endpoint was specified, skip interpolation and return the value directly
-    if (localTime == _points[min].time)
+    if (localTime == minTime)
     {
-      memcpy(dst, _points[min].value, _componentSize);
+      getKeyValue(min, dst);
       return;
     }
-    if (localTime == _points[max].time)
+    if (localTime == maxTime)
     {
-      memcpy(dst, _points[max].value, _componentSize);
+      getKeyValue(max, dst);
       return;
     }
 
-    Point* from;
-    Point* to;
-    float scale;
     float t;
     unsigned int index;
+    unsigned int toIndex;
 
-    if (localTime > _points[max].time)
+    if (localTime > maxTime)
     {
       // Looping forward
       index = max;
-      from = &_points[max];
-      to = &_points[min];
+      toIndex = min;
 
       // Calculate the fractional time between the two points.
-      t = (localTime - from->time) / loopBlendTime;
+      t = (localTime - maxTime) / loopBlendTime;
     }
-    else if (localTime < _points[min].time)
+    else if (localTime < minTime)
     {
       // Looping in reverse
       index = min;
-      from = &_points[min];
-      to = &_points[max];
+      toIndex = max;
 
       // Calculate the fractional time between the two points.
-      t = (from->time - localTime) / loopBlendTime;
+      t = (minTime - localTime) / loopBlendTime;
+    }
+    else if (_bakedValues)
+    {
+      evaluateBaked(localTime, dst);
+      return;
     }
     else
     {
-      // Locate the points we are interpolating between using a binary search.
-      index = determineIndex(localTime, min, max);
-      from = &_points[index];
-      to = &_points[index == max ? index : index + 1];
+      // Locate the points we are interpolating between.
+      index = determineIndex(localTime, min, max, cursor);
+      toIndex = index == max ? index : index + 1;
 
       // Calculate the fractional time between the two points.
-      scale = (to->time - from->time);
-      t = (localTime - from->time) / scale;
+      float fromTime = getKeyTime(index);
+      t = (localTime - fromTime) / (getKeyTime(toIndex) - fromTime);
     }
 
+    if (_packedValues)
+    {
+      interpolatePacked(t, index, toIndex, dst);
+      return;
+    }
+
+    Point* from = &_points[index];
+    Point* to = &_points[toIndex];
+
     // Calculate the value of the curve discretely if appropriate.
     switch (from->type)
     {
@@ -835,7 +990,9 @@ namespace gameplay
 
   void Curve::setQuaternionOffset(unsigned int offset)
   {
-    assert(offset <= (_componentCount - 4));
+    assert(offset <= (_componentCount - 4) && !_packedValues);
+
+    bake(0);
 
     if (!_quaternionOffset)
       _quaternionOffset = new unsigned int[1];
@@ -1256,9 +1413,9 @@ namespace gameplay
     {
       mid = (min + max) >> 1;
 
-      if (time >= _points[mid].time && time < _points[mid + 1].time)
+      if (time >= getKeyTime(mid) && time < getKeyTime(mid + 1))
         return mid;
-      else if (time < _points[mid].time)
+      else if (time < getKeyTime(mid))
         max = mid - 1;
       else
         min = mid + 1;
@@ -1267,6 +1424,218 @@ namespace gameplay
     return max;
   }
 
+  unsigned int Curve::determineIndex(float time, unsigned int min, unsigned int max, Cursor* cursor) const
+  {
+    if (!cursor)
+      return determineIndex(time, min, max);
+
+    // Playback usually stays between the same points or moves on by a few points, so
+    // scan a short distance from the previous result before falling back to a search.
+    unsigned int index = cursor->_index;
+    if (index >= min && index < max)
+    {
+      for (unsigned int step = 0; step < CURSOR_SCAN_LIMIT; ++step)
+      {
+        if (time < getKeyTime(index))
+        {
+          if (index == min)
+            break;
+          --index;
+        }
+        else if (time >= getKeyTime(index + 1))
+        {
+          if (index + 1 == max)
+            break;
+          ++index;
+        }
+        else
+        {
+          cursor->_index = index;
+          return index;
+        }
+      }
+    }
+
+    index = determineIndex(time, min, max);
+    cursor->_index = index;
+    return index;
+  }
+
+  void Curve::bake(unsigned int sampleCount)
+  {
+    assert(sampleCount != 1);
+
+    SAFE_DELETE_ARRAY(_bakedValues);
+    _bakedSampleCount = 0;
+    if (sampleCount < 2 || _pointCount < 2)
+      return;
+
+    // Sample the keyframes before storing the samples, so that evaluate() uses them.
+    float* values = new float[sampleCount * _componentCount];
+    float step = 1.0f / (float)(sampleCount - 1);
+    Cursor cursor;
+    for (unsigned int i = 0; i < sampleCount; ++i)
+    {
+      evaluate(std::fmin((float)i * step, 1.0f), 0.0f, 1.0f, 0.0f, values + i * _componentCount, &cursor);
+    }
+    _bakedValues = values;
+    _bakedSampleCount = sampleCount;
+  }
+
+  unsigned int Curve::getBakedSampleCount() const
+  {
+    return _bakedSampleCount;
+  }
+
+  void Curve::evaluateBaked(float time, float* dst) const
+  {
+    float position = time * (float)(_bakedSampleCount - 1);
+    unsigned int index = (unsigned int)position;
+    if (index >= _bakedSampleCount - 1)
+    {
+      memcpy(dst, _bakedValues + (_bakedSampleCount - 1) * _componentCount, _componentSize);
+      return;
+    }
+
+    float s = position - (float)index;
+    float* from = _bakedValues + index * _componentCount;
+    float* to = from + _componentCount;
+    unsigned int quaternionOffset = _quaternionOffset ? *_quaternionOffset : _componentCount;
+    for (unsigned int i = 0; i < _componentCount; ++i)
+    {
+      if (i == quaternionOffset)
+      {
+        interpolateQuaternion(s, from + i, to + i, dst + i);
+        i += 3;
+      }
+      else
+      {
+        dst[i] = lerpInl(s, from[i], to[i]);
+      }
+    }
+  }
+
+  Curve* Curve::compress() const
+  {
+    if (_packedValues || _componentCount > PACKED_MAX_COMPONENTS)
+      return nullptr;
+    for (unsigned int i = 0; i < _pointCount; ++i)
+    {
+      if (_points[i].type != LINEAR)
+        return nullptr;
+    }
+
+    int quaternionOffset = _quaternionOffset ? (int)*_quaternionOffset : -1;
+    Curve* curve = createPacked(_pointCount, _componentCount, quaternionOffset, nullptr, nullptr, nullptr);
+
+    // Quantize each scalar component relative to its range over the whole curve.
+    for (unsigned int c = 0; c < _componentCount; ++c)
+    {
+      float minValue = _points[0].value[c];
+      float maxValue = minValue;
+      for (unsigned int i = 1; i < _pointCount; ++i)
+      {
+        float v = _points[i].value[c];
+        minValue = v < minValue ? v : minValue;
+        maxValue = v > maxValue ? v : maxValue;
+      }
+      curve->_packedRanges[c * 2] = minValue;
+      curve->_packedRanges[c * 2 + 1] = maxValue - minValue;
+    }
+
+    for (unsigned int i = 0; i < _pointCount; ++i)
+    {
+      curve->_packedTimes[i] = _points[i].time;
+      const float* value = _points[i].value;
+      unsigned short* dst = curve->_packedValues + i * curve->_packedStride;
+      for (unsigned int c = 0; c < _componentCount; ++c)
+      {
+        if ((int)c == quaternionOffset)
+        {
+          packQuaternion(value + c, dst);
+          dst += 3;
+          c += 3;
+        }
+        else
+        {
+          float extent = curve->_packedRanges[c * 2 + 1];
+          float v = extent > 0.0f ? (value[c] - curve->_packedRanges[c * 2]) / extent * 65535.0f : 0.0f;
+          *dst++ = (unsigned short)(v + 0.5f);
+        }
+      }
+    }
+    return curve;
+  }
+
+  bool Curve::isCompressed() const
+  {
+    return _packedValues != nullptr;
+  }
+
+  unsigned int Curve::getDataSize() const
+  {
+    unsigned int size;
+    if (_packedValues)
+      size = _pointCount * (sizeof(float) + _packedStride * sizeof(unsigned short)) + _componentCount * 2 * sizeof(float);
+    else
+      size = _pointCount * (sizeof(Point) + 3 * _componentSize);
+    return size + _bakedSampleCount * _componentSize;
+  }
+
+  float Curve::getKeyTime(unsigned int index) const
+  {
+    return _points ? _points[index].time : _packedTimes[index];
+  }
+
+  void Curve::getKeyValue(unsigned int index, float* dst) const
+  {
+    if (_packedValues)
+      unpackValue(index, dst);
+    else
+      memcpy(dst, _points[index].value, _componentSize);
+  }
+
+  void Curve::unpackValue(unsigned int index, float* dst) const
+  {
+    const unsigned short* src = _packedValues + index * _packedStride;
+    unsigned int quaternionOffset = _quaternionOffset ? *_quaternionOffset : _componentCount;
+    for (unsigned int c = 0; c < _componentCount; ++c)
+    {
+      if (c == quaternionOffset)
+      {
+        unpackQuaternion(src, dst + c);
+        src += 3;
+        c += 3;
+      }
+      else
+      {
+        dst[c] = _packedRanges[c * 2] + _packedRanges[c * 2 + 1] * ((float)*src++ * (1.0f / 65535.0f));
+      }
+    }
+  }
+
+  void Curve::interpolatePacked(float s, unsigned int fromIndex, unsigned int toIndex, float* dst) const
+  {
+    float from[PACKED_MAX_COMPONENTS];
+    float to[PACKED_MAX_COMPONENTS];
+    unpackValue(fromIndex, from);
+    unpackValue(toIndex, to);
+
+    unsigned int quaternionOffset = _quaternionOffset ? *_quaternionOffset : _componentCount;
+    for (unsigned int c = 0; c < _componentCount; ++c)
+    {
+      if (c == quaternionOffset)
+      {
+        interpolateQuaternion(s, from + c, to + c, dst + c);
+        c += 3;
+      }
+      else
+      {
+        dst[c] = lerpInl(s, from[c], to[c]);
+      }
+    }
+  }
+
   int Curve::getInterpolationType(const char* curveId)
   {
     if (strcmp(curveId, "BEZIER") == 0)
@@ -15,6 +15,7 @@ namespace gameplay
     friend class AnimationClip;
     friend class AnimationController;
     friend class MeshSkin;
+    friend class Bundle;
 
   public:
 
@@ -274,6 +275,40 @@ namespace gameplay
       BOUNCE_OUT_IN
     };
 
+    /**
+     * Remembers where the previous evaluation of a curve found its keyframes.
+     *
+     * Animations usually evaluate a curve at steadily increasing (or decreasing)
+     * times, so the keyframes needed next are almost always the same ones or
+     * their neighbours. Passing a cursor to evaluate() checks those first and
+     * only falls back to a binary search when playback jumps, which makes
+     * consecutive evaluations constant time on average.
+     *
+     * A cursor may be used with any curve but is only useful when it is kept
+     * for the same curve. Cursors are not shared between threads; evaluating
+     * one curve concurrently requires one cursor per thread.
+     */
+    class Cursor
+    {
+      friend class Curve;
+
+    public:
+
+      /**
+       * Constructor.
+       */
+      Cursor();
+
+    private:
+
+      const Curve* _curve;      // The curve the cached subregion belongs to.
+      float _startTime;         // The subregion start time the cached range was found for.
+      float _endTime;           // The subregion end time the cached range was found for.
+      unsigned int _min;        // The first point of the subregion.
+      unsigned int _max;        // The last point of the subregion.
+      unsigned int _index;      // The point the last evaluation interpolated from.
+    };
+
     /**
      * Creates a new curve.
      *
@@ -413,6 +448,79 @@ namespace gameplay
      */
     void evaluate(float time, float startTime, float endTime, float loopBlendTime, float* dst) const;
 
+    /**
+     * Evaluates the curve within the specified subregion, using a cursor to
+     * speed up locating the keyframes around the given time.
+     *
+     * @param time The position within the subregion of the curve to evaluate the curve at.
+     * @param startTime Start time for the subregion (between 0.0 - 1.0).
+     * @param endTime End time for the subregion (between 0.0 - 1.0).
+     * @param loopBlendTime Time (in milliseconds) to blend between the end points of the curve
+     *      for looping purposes when time is outside the range 0-1.
+     * @param dst The evaluated value of the curve at the given time.
+     * @param cursor The cursor holding the result of the previous evaluation, updated on return.
+     *      Ignored if nullptr.
+     *
+     * @see evaluate(float, float, float, float, float*)
+     */
+    void evaluate(float time, float startTime, float endTime, float loopBlendTime, float* dst, Cursor* cursor) const;
+
+    /**
+     * Resamples the curve at regular intervals so that evaluating it becomes a direct lookup.
+     *
+     * Baking is meant for long curves with many keyframes, such as motion capture data,
+     * where locating the keyframes dominates the cost of an evaluation. Values between
+     * samples are interpolated linearly (spherically for the quaternion component), so
+     * detail finer than the sample spacing is lost. The exact keyframe evaluation is
+     * still used outside the curve's points, when looping between its end points.
+     *
+     * Changing a point of the curve discards the baked samples.
+     *
+     * @param sampleCount The number of samples over the whole curve (at least 2), or 0 to
+     *      discard the baked samples.
+     */
+    void bake(unsigned int sampleCount);
+
+    /**
+     * Creates a compressed copy of this curve.
+     *
+     * Each key of a compressed curve takes a fraction of the memory of a regular
+     * point and is decoded when the curve is evaluated. Scalar components are
+     * quantized to 16 bits relative to their range over the curve, and the
+     * quaternion component (if any) is stored as its three smallest components
+     * with 15 bits each. Compressed curves always interpolate linearly and cannot
+     * be modified.
+     *
+     * Bundles produced by the encoder with animation optimization enabled load
+     * their animation curves compressed, with redundant keys already removed.
+     *
+     * @return The compressed curve, or nullptr if the curve is already compressed,
+     *      uses an interpolation other than LINEAR or has more than 16 components.
+     * @script{create}
+     */
+    Curve* compress() const;
+
+    /**
+     * Determines whether the curve stores its points compressed.
+     *
+     * @return True if the curve is compressed, false otherwise.
+     */
+    bool isCompressed() const;
+
+    /**
+     * Gets the number of bytes used to store the points of the curve, including baked samples.
+     *
+     * @return The size of the curve's data, in bytes.
+     */
+    unsigned int getDataSize() const;
+
+    /**
+     * Gets the number of baked samples of the curve.
+     *
+     * @return The number of baked samples, or 0 if the curve is not baked.
+     */
+    unsigned int getBakedSampleCount() const;
+
     /**
      * Linear interpolation function.
      */
@@ -459,6 +567,19 @@ namespace gameplay
      */
     Curve();
 
+    /**
+     * Creates a compressed curve from quantized data, in the format written by the encoder.
+     *
+     * @param pointCount The number of points in the curve.
+     * @param componentCount The number of float component values per key value.
+     * @param quaternionOffset The index of the quaternion component, or -1 if there is none.
+     * @param times The normalized time of each point, or nullptr to leave uninitialized.
+     * @param ranges The minimum and extent of each component, or nullptr to leave uninitialized.
+     * @param values The quantized values of each point, or nullptr to leave uninitialized.
+     */
+    static Curve* createPacked(unsigned int pointCount, unsigned int componentCount, int quaternionOffset,
+      const float* times, const float* ranges, const unsigned short* values);
+
     /**
      * Constructs a new curve and the specified parameters.
      *
@@ -522,6 +643,37 @@ namespace gameplay
      */
     int determineIndex(float time, unsigned int min, unsigned int max) const;
 
+    /**
+     * Determines the current keyframe like determineIndex(), trying the keyframes
+     * around the cursor's previous result before searching.
+     */
+    unsigned int determineIndex(float time, unsigned int min, unsigned int max, Cursor* cursor) const;
+
+    /**
+     * Evaluates the baked samples at the given time.
+     */
+    void evaluateBaked(float time, float* dst) const;
+
+    /**
+     * Gets the time of the point at the specified index.
+     */
+    float getKeyTime(unsigned int index) const;
+
+    /**
+     * Gets the value of the point at the specified index.
+     */
+    void getKeyValue(unsigned int index, float* dst) const;
+
+    /**
+     * Decodes the value of a point of a compressed curve.
+     */
+    void unpackValue(unsigned int index, float* dst) const;
+
+    /**
+     * Linear interpolation function for compressed curves.
+     */
+    void interpolatePacked(float s, unsigned int fromIndex, unsigned int toIndex, float* dst) const;
+
     /**
      * Sets the offset for the beginning of a Quaternion piece of data within the curve's value span at the specified
      * index. The next four components of data starting at the given index will be interpolated as a Quaternion.
@@ -545,6 +697,12 @@ namespace gameplay
     unsigned int _componentSize;        // The component size (in bytes).
     unsigned int* _quaternionOffset;    // Offset for the rotation component.
     Point* _points;                     // The points on the curve.
+    float* _packedTimes;                // The point times of a compressed curve.
+    float* _packedRanges;               // The minimum and extent of each component of a compressed curve.
+    unsigned short* _packedValues;      // The quantized point values, or nullptr if the curve is not compressed.
+    unsigned int _packedStride;         // The number of quantized values per point.
+    float* _bakedValues;                // Uniformly resampled values of the curve, or nullptr if not baked.
+    unsigned int _bakedSampleCount;     // The number of baked samples.
   };
 
 }
@@ -1,8 +1,8 @@
 #include "framework/Base.h"
 #include "graphics/Drawable.h"
+#include "renderer/RenderQueue.h"
 #include "scene/Node.h"
 
-
 namespace gameplay
 {
 
@@ -20,6 +20,12 @@ namespace gameplay
     return _node;
   }
 
+  void Drawable::enqueue(RenderQueue* queue)
+  {
+    assert(queue);
+    queue->add(nullptr, this, -1);
+  }
+
   void Drawable::setNode(Node* node)
   {
     _node = node;
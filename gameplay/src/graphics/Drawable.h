@@ -5,6 +5,7 @@ namespace gameplay
 
   class Node;
   class NodeCloneContext;
+  class RenderQueue;
 
   /**
    * Defines a drawable object that can be attached to a Node.
@@ -34,6 +35,15 @@ namespace gameplay
 
     virtual unsigned int draw(bool wireframe = false) = 0;
 
+    /**
+     * Adds the draw items of the object to a render queue.
+     *
+     * By default a single item is added, which calls draw() when the queue is submitted.
+     *
+     * @param queue The render queue.
+     */
+    virtual void enqueue(RenderQueue* queue);
+
     /**
      * Gets the node this drawable is attached to.
      *
@@ -2,6 +2,8 @@
 #include "graphics/Effect.h"
 #include "framework/FileSystem.h"
 #include "framework/Game.h"
+#include "graphics/ShaderCache.h"
+#include "renderer/StateCache.h"
 
 #define OPENGL_ES_DEFINE  "OPENGL_ES"
 
@@ -30,11 +32,12 @@ namespace gameplay
       // If our program object is currently bound, unbind it before we're destroyed.
       if (__currentEffect == this)
       {
-        GL_ASSERT(glUseProgram(0));
+        StateCache::getCurrent()->useProgram(0);
         __currentEffect = nullptr;
       }
 
       GL_ASSERT(glDeleteProgram(_program));
+      StateCache::getCurrent()->programDeleted(_program);
       _program = 0;
     }
   }
@@ -45,21 +48,11 @@ namespace gameplay
     assert(fshPath);
 
     // Search the effect cache for an identical effect that is already loaded.
-    std::string uniqueId = vshPath;
-    uniqueId += ';';
-    uniqueId += fshPath;
-    uniqueId += ';';
-    if (defines)
+    std::string uniqueId = getUniqueId(vshPath, fshPath, defines);
+    Effect* cached = findCached(uniqueId);
+    if (cached)
     {
-      uniqueId += defines;
-    }
-    const auto itr = __effectCache.find(uniqueId);
-    if (itr != __effectCache.end())
-    {
-      // Found an exiting effect with this id, so increase its ref count and return it.
-      assert(itr->second);
-      itr->second->addRef();
-      return itr->second;
+      return cached;
     }
 
     // Read source from file.
@@ -88,178 +81,192 @@ namespace gameplay
     }
     else
     {
-      // Store this effect in the cache.
-      effect->_id = uniqueId;
-      __effectCache[uniqueId] = effect;
+      addToCache(effect, uniqueId);
     }
 
     return effect;
   }
 
+  std::string Effect::getUniqueId(const char* vshPath, const char* fshPath, const char* defines)
+  {
+    std::string uniqueId = vshPath;
+    uniqueId += ';';
+    uniqueId += fshPath;
+    uniqueId += ';';
+    if (defines)
+    {
+      uniqueId += defines;
+    }
+    return uniqueId;
+  }
+
+  Effect* Effect::findCached(const std::string& uniqueId)
+  {
+    const auto itr = __effectCache.find(uniqueId);
+    if (itr == __effectCache.end())
+      return nullptr;
+
+    // Found an exiting effect with this id, so increase its ref count and return it.
+    assert(itr->second);
+    itr->second->addRef();
+    return itr->second;
+  }
+
+  void Effect::addToCache(Effect* effect, const std::string& uniqueId)
+  {
+    assert(effect);
+
+    // Store this effect in the cache.
+    effect->_id = uniqueId;
+    __effectCache[uniqueId] = effect;
+  }
+
+  void Effect::getCachedIds(std::vector<std::string>& ids)
+  {
+    for (const auto& pair : __effectCache)
+    {
+      ids.push_back(pair.first);
+    }
+  }
+
   Effect* Effect::createFromSource(const char* vshSource, const char* fshSource, const char* defines)
   {
     return createFromSource(nullptr, vshSource, nullptr, fshSource, defines);
   }
 
-  static void replaceDefines(const char* defines, std::string& out)
+  std::string Effect::getGlobalDefines()
   {
     Properties* graphicsConfig = Game::getInstance()->getConfig()->getNamespace("graphics", true);
-    const char* globalDefines = graphicsConfig ? graphicsConfig->getString("shaderDefines") : nullptr;
+    const char* configDefines = graphicsConfig ? graphicsConfig->getString("shaderDefines") : nullptr;
 
-    // Build full semicolon delimited list of defines
+    // Platform defines come first, followed by the global defines from game.config.
 #ifdef OPENGL_ES
-    out = OPENGL_ES_DEFINE;
+    std::string globalDefines = OPENGL_ES_DEFINE;
 #else
-    out = "";
+    std::string globalDefines;
 #endif
-    if (globalDefines && strlen(globalDefines) > 0)
+    if (configDefines && strlen(configDefines) > 0)
     {
-      if (out.length() > 0)
-        out += ';';
-      out += globalDefines;
+      if (globalDefines.length() > 0)
+        globalDefines += ';';
+      globalDefines += configDefines;
     }
-    if (defines && strlen(defines) > 0)
+    return globalDefines;
+  }
+
+  static void writeShaderToErrorFile(const char* filePath, const char* source)
+  {
+    std::string path = filePath;
+    path += ".err";
+    std::unique_ptr<Stream> stream(FileSystem::open(path.c_str(), FileSystem::WRITE));
+    if (stream.get() != nullptr && stream->canWrite())
     {
-      if (out.length() > 0)
-        out += ';';
-      out += defines;
+      stream->write(source, 1, strlen(source));
     }
+  }
 
-    // Replace semicolons
-    if (out.length() > 0)
+  /**
+   * Returns a string identifying the graphics driver. Program binaries are only valid for the driver that created them.
+   */
+  static const char* getDriverString()
+  {
+    static std::string driver;
+    if (driver.empty())
     {
-      size_t pos;
-      out.insert(0, "#define ");
-      while ((pos = out.find(';')) != std::string::npos)
+      const GLenum names[3] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+      for (size_t i = 0; i < 3; ++i)
       {
-        out.replace(pos, 1, "\n#define ");
+        const char* str = (const char*)glGetString(names[i]);
+        if (i > 0)
+          driver += '|';
+        driver += str ? str : "";
       }
-      out += "\n";
     }
+    return driver.c_str();
   }
 
-  static void replaceIncludes(const char* filepath, const char* source, std::string& out)
+  static bool isProgramBinarySupported()
   {
-    // Replace the #include "xxxx.xxx" with the sourced file contents of "filepath/xxxx.xxx"
-    std::string str = source;
-    size_t lastPos = 0;
-    size_t headPos = 0;
-    size_t fileLen = str.length();
-    size_t tailPos = fileLen;
-    while (headPos < fileLen)
+#ifdef OPENGL_ES
+    // OpenGL ES 2.0 only has program binaries through an extension that is not loaded.
+    return false;
+#else
+    static int supported = -1;
+    if (supported < 0)
     {
-      lastPos = headPos;
-      if (headPos == 0)
-      {
-        // find the first "#include"
-        headPos = str.find("#include");
-      }
-      else
-      {
-        // find the next "#include"
-        headPos = str.find("#include", headPos + 1);
-      }
-
-      // If "#include" is found
-      if (headPos != std::string::npos)
-      {
-        // append from our last position for the legth (head - last position) 
-        out.append(str.substr(lastPos, headPos - lastPos));
-
-        // find the start quote "
-        size_t startQuote = str.find("\"", headPos) + 1;
-        if (startQuote == std::string::npos)
-        {
-          // We have started an "#include" but missing the leading quote "
-          GP_ERROR("Compile failed for shader '%s' missing leading \".", filepath);
-          return;
-        }
-        // find the end quote "
-        size_t endQuote = str.find("\"", startQuote);
-        if (endQuote == std::string::npos)
-        {
-          // We have a start quote but missing the trailing quote "
-          GP_ERROR("Compile failed for shader '%s' missing trailing \".", filepath);
-          return;
-        }
-
-        // jump the head position past the end quote
-        headPos = endQuote + 1;
-
-        // File path to include and 'stitch' in the value in the quotes to the file path and source it.
-        std::string filepathStr = filepath;
-        std::string directoryPath = filepathStr.substr(0, filepathStr.rfind('/') + 1);
-        size_t len = endQuote - (startQuote);
-        std::string includeStr = str.substr(startQuote, len);
-        directoryPath.append(includeStr);
-        const char* includedSource = FileSystem::readAll(directoryPath.c_str());
-        if (includedSource == nullptr)
-        {
-          GP_ERROR("Compile failed for shader '%s' invalid filepath.", filepathStr.c_str());
-          return;
-        }
-        else
-        {
-          // Valid file so lets attempt to see if we need to append anything to it too (recurse...)
-          replaceIncludes(directoryPath.c_str(), includedSource, out);
-          SAFE_DELETE_ARRAY(includedSource);
-        }
-      }
-      else
-      {
-        // Append the remaining
-        out.append(str.c_str(), lastPos, tailPos);
-      }
+      // Program binaries are core in OpenGL 4.1 and otherwise need ARB_get_program_binary.
+      GLint formatCount = 0;
+      if (glGetProgramBinary != nullptr && glProgramBinary != nullptr)
+        GL_ASSERT(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount));
+      supported = formatCount > 0 ? 1 : 0;
     }
+    return supported == 1;
+#endif
   }
 
-  static void writeShaderToErrorFile(const char* filePath, const char* source)
+  /**
+   * Creates a program from a cached binary. Returns 0 if the driver rejects the binary.
+   */
+  static GLuint loadProgramBinary(const ShaderCache::Entry& entry)
   {
-    std::string path = filePath;
-    path += ".err";
-    std::unique_ptr<Stream> stream(FileSystem::open(path.c_str(), FileSystem::WRITE));
-    if (stream.get() != nullptr && stream->canWrite())
+#ifdef OPENGL_ES
+    return 0;
+#else
+    GLuint program;
+    GLint success = GL_FALSE;
+    GL_ASSERT(program = glCreateProgram());
+
+    // The driver is allowed to reject any binary, so errors here are expected and not asserted.
+    glProgramBinary(program, entry.binaryFormat, entry.binary.data(), (GLsizei)entry.binary.size());
+    if (glGetError() == GL_NO_ERROR)
+      GL_ASSERT(glGetProgramiv(program, GL_LINK_STATUS, &success));
+    if (success != GL_TRUE)
     {
-      stream->write(source, 1, strlen(source));
+      GL_ASSERT(glDeleteProgram(program));
+      return 0;
     }
+    return program;
+#endif
   }
 
-  Effect* Effect::createFromSource(const char* vshPath, const char* vshSource, const char* fshPath, const char* fshSource, const char* defines)
+  /**
+   * Stores the binary of a linked program in the cache entry, if the driver provides one.
+   */
+  static bool getProgramBinary(GLuint program, ShaderCache::Entry* entry)
   {
-    assert(vshSource);
-    assert(fshSource);
+#ifdef OPENGL_ES
+    return false;
+#else
+    GLint length = 0;
+    GL_ASSERT(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0)
+      return false;
+    GLenum format = 0;
+    entry->binary.resize(length);
+    GL_ASSERT(glGetProgramBinary(program, length, &length, &format, entry->binary.data()));
+    entry->binary.resize(length);
+    entry->binaryFormat = format;
+    return length > 0;
+#endif
+  }
 
-    const unsigned int SHADER_SOURCE_LENGTH = 3;
-    const GLchar* shaderSource[SHADER_SOURCE_LENGTH];
-    char* infoLog = nullptr;
-    GLuint vertexShader;
-    GLuint fragmentShader;
-    GLuint program;
+  /**
+   * Compiles one shader of a program. Returns 0 and logs the error if it fails to compile.
+   */
+  static GLuint compileShader(GLenum type, const char* path, const std::string& source, size_t bodyOffset)
+  {
+    const GLchar* shaderSource = source.c_str();
+    GLuint shader;
     GLint length;
     GLint success;
-
-    // Replace all comma separated definitions with #define prefix and \n suffix
-    std::string definesStr = "";
-    replaceDefines(defines, definesStr);
-
-    shaderSource[0] = definesStr.c_str();
-    shaderSource[1] = "\n";
-    std::string vshSourceStr = "";
-    if (vshPath)
-    {
-      // Replace the #include "xxxxx.xxx" with the sources that come from file paths
-      replaceIncludes(vshPath, vshSource, vshSourceStr);
-      if (vshSource && strlen(vshSource) != 0)
-        vshSourceStr += "\n";
-    }
-    shaderSource[2] = vshPath ? vshSourceStr.c_str() : vshSource;
-    GL_ASSERT(vertexShader = glCreateShader(GL_VERTEX_SHADER));
-    GL_ASSERT(glShaderSource(vertexShader, SHADER_SOURCE_LENGTH, shaderSource, nullptr));
-    GL_ASSERT(glCompileShader(vertexShader));
-    GL_ASSERT(glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success));
+    GL_ASSERT(shader = glCreateShader(type));
+    GL_ASSERT(glShaderSource(shader, 1, &shaderSource, nullptr));
+    GL_ASSERT(glCompileShader(shader));
+    GL_ASSERT(glGetShaderiv(shader, GL_COMPILE_STATUS, &success));
     if (success != GL_TRUE)
     {
-      GL_ASSERT(glGetShaderiv(vertexShader, GL_INFO_LOG_LENGTH, &length));
+      char* infoLog = nullptr;
+      GL_ASSERT(glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length));
       if (length == 0)
       {
         length = 4096;
@@ -267,97 +274,138 @@ namespace gameplay
       if (length > 0)
       {
         infoLog = new char[length];
-        GL_ASSERT(glGetShaderInfoLog(vertexShader, length, nullptr, infoLog));
+        GL_ASSERT(glGetShaderInfoLog(shader, length, nullptr, infoLog));
         infoLog[length - 1] = '\0';
       }
 
       // Write out the expanded shader file.
-      if (vshPath)
-        writeShaderToErrorFile(vshPath, shaderSource[2]);
+      if (path)
+        writeShaderToErrorFile(path, source.c_str() + bodyOffset);
 
-      GP_ERROR("Compile failed for vertex shader '%s' with error '%s'.", vshPath == nullptr ? vshSource : vshPath, infoLog == nullptr ? "" : infoLog);
+      GP_ERROR("Compile failed for %s shader '%s' with error '%s'.", type == GL_VERTEX_SHADER ? "vertex" : "fragment",
+        path == nullptr ? source.c_str() + bodyOffset : path, infoLog == nullptr ? "" : infoLog);
       SAFE_DELETE_ARRAY(infoLog);
 
       // Clean up.
-      GL_ASSERT(glDeleteShader(vertexShader));
+      GL_ASSERT(glDeleteShader(shader));
+      return 0;
+    }
+    return shader;
+  }
+
+  Effect* Effect::createFromSource(const char* vshPath, const char* vshSource, const char* fshPath, const char* fshSource, const char* defines)
+  {
+    assert(vshSource);
+    assert(fshSource);
 
+    // Replace all comma separated definitions with #define prefix and \n suffix
+    std::string definesStr = ShaderCache::expandDefines(getGlobalDefines().c_str(), defines);
+    definesStr += "\n";
+
+    // Each shader is its defines followed by its source, with any #include "xxxxx.xxx" replaced by the file's contents.
+    std::string vertexSource;
+    std::string fragmentSource;
+    if (!ShaderCache::preprocess(vshPath, vshSource, definesStr, vertexSource) ||
+      !ShaderCache::preprocess(fshPath, fshSource, definesStr, fragmentSource))
       return nullptr;
-    }
 
-    // Compile the fragment shader.
-    std::string fshSourceStr;
-    if (fshPath)
-    {
-      // Replace the #include "xxxxx.xxx" with the sources that come from file paths
-      replaceIncludes(fshPath, fshSource, fshSourceStr);
-      if (fshSource && strlen(fshSource) != 0)
-        fshSourceStr += "\n";
-    }
-    shaderSource[2] = fshPath ? fshSourceStr.c_str() : fshSource;
-    GL_ASSERT(fragmentShader = glCreateShader(GL_FRAGMENT_SHADER));
-    GL_ASSERT(glShaderSource(fragmentShader, SHADER_SOURCE_LENGTH, shaderSource, nullptr));
-    GL_ASSERT(glCompileShader(fragmentShader));
-    GL_ASSERT(glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success));
-    if (success != GL_TRUE)
+    return createFromPreprocessed(vshPath, fshPath, vertexSource, fragmentSource, definesStr.length());
+  }
+
+  Effect* Effect::createFromPreprocessed(const char* vshPath, const char* fshPath, const std::string& vertexSource, const std::string& fragmentSource, size_t definesLength)
+  {
+    char* infoLog = nullptr;
+    GLuint program = 0;
+    GLint length;
+    GLint success;
+
+    // Look for a program binary cached by an earlier run.
+    ShaderCache* cache = Game::getInstance()->getShaderCache();
+    const char* driver = nullptr;
+    unsigned long long key = 0;
+    bool binarySupported = false;
+    if (cache)
     {
-      GL_ASSERT(glGetShaderiv(fragmentShader, GL_INFO_LOG_LENGTH, &length));
-      if (length == 0)
+      driver = getDriverString();
+      key = ShaderCache::computeKey(vertexSource, fragmentSource, driver);
+      binarySupported = isProgramBinarySupported();
+
+      ShaderCache::Entry entry;
+      if (binarySupported && cache->load(key, driver, vertexSource, fragmentSource, &entry) && !entry.binary.empty())
       {
-        length = 4096;
+        program = loadProgramBinary(entry);
       }
-      if (length > 0)
+    }
+
+    if (!program)
+    {
+      // Compile the vertex and fragment shaders.
+      GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vshPath, vertexSource, definesLength);
+      if (!vertexShader)
+        return nullptr;
+      GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fshPath, fragmentSource, definesLength);
+      if (!fragmentShader)
       {
-        infoLog = new char[length];
-        GL_ASSERT(glGetShaderInfoLog(fragmentShader, length, nullptr, infoLog));
-        infoLog[length - 1] = '\0';
+        GL_ASSERT(glDeleteShader(vertexShader));
+        return nullptr;
       }
 
-      // Write out the expanded shader file.
-      if (fshPath)
-        writeShaderToErrorFile(fshPath, shaderSource[2]);
-
-      GP_ERROR("Compile failed for fragment shader (%s): %s", fshPath == nullptr ? fshSource : fshPath, infoLog == nullptr ? "" : infoLog);
-      SAFE_DELETE_ARRAY(infoLog);
+      // Link program.
+      GL_ASSERT(program = glCreateProgram());
+      GL_ASSERT(glAttachShader(program, vertexShader));
+      GL_ASSERT(glAttachShader(program, fragmentShader));
+#ifndef OPENGL_ES
+      if (binarySupported)
+        GL_ASSERT(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+#endif
+      GL_ASSERT(glLinkProgram(program));
+      GL_ASSERT(glGetProgramiv(program, GL_LINK_STATUS, &success));
 
-      // Clean up.
+      // Delete shaders after linking.
       GL_ASSERT(glDeleteShader(vertexShader));
       GL_ASSERT(glDeleteShader(fragmentShader));
 
-      return nullptr;
-    }
-
-    // Link program.
-    GL_ASSERT(program = glCreateProgram());
-    GL_ASSERT(glAttachShader(program, vertexShader));
-    GL_ASSERT(glAttachShader(program, fragmentShader));
-    GL_ASSERT(glLinkProgram(program));
-    GL_ASSERT(glGetProgramiv(program, GL_LINK_STATUS, &success));
+      // Check link status.
+      if (success != GL_TRUE)
+      {
+        GL_ASSERT(glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length));
+        if (length == 0)
+        {
+          length = 4096;
+        }
+        if (length > 0)
+        {
+          infoLog = new char[length];
+          GL_ASSERT(glGetProgramInfoLog(program, length, nullptr, infoLog));
+          infoLog[length - 1] = '\0';
+        }
+        GP_ERROR("Linking program failed (%s,%s): %s", vshPath == nullptr ? "nullptr" : vshPath, fshPath == nullptr ? "nullptr" : fshPath, infoLog == nullptr ? "" : infoLog);
+        SAFE_DELETE_ARRAY(infoLog);
 
-    // Delete shaders after linking.
-    GL_ASSERT(glDeleteShader(vertexShader));
-    GL_ASSERT(glDeleteShader(fragmentShader));
+        // Clean up.
+        GL_ASSERT(glDeleteProgram(program));
 
-    // Check link status.
-    if (success != GL_TRUE)
-    {
-      GL_ASSERT(glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length));
-      if (length == 0)
-      {
-        length = 4096;
+        return nullptr;
       }
-      if (length > 0)
+
+      // Store the linked program so the next run can skip compiling it. When no binary can be
+      // retrieved, the preprocessed source is still stored once, so the entry exists.
+      if (cache)
       {
-        infoLog = new char[length];
-        GL_ASSERT(glGetProgramInfoLog(program, length, nullptr, infoLog));
-        infoLog[length - 1] = '\0';
+        ShaderCache::Entry entry;
+        entry.vertexSource = vertexSource;
+        entry.fragmentSource = fragmentSource;
+        if (binarySupported && getProgramBinary(program, &entry))
+        {
+          cache->save(key, driver, entry);
+        }
+        else if (!cache->contains(key))
+        {
+          entry.binaryFormat = 0;
+          entry.binary.clear();
+          cache->save(key, driver, entry);
+        }
       }
-      GP_ERROR("Linking program failed (%s,%s): %s", vshPath == nullptr ? "nullptr" : vshPath, fshPath == nullptr ? "nullptr" : fshPath, infoLog == nullptr ? "" : infoLog);
-      SAFE_DELETE_ARRAY(infoLog);
-
-      // Clean up.
-      GL_ASSERT(glDeleteProgram(program));
-
-      return nullptr;
     }
 
     // Create and return the new Effect.
@@ -521,79 +569,79 @@ namespace gameplay
   void Effect::setValue(Uniform* uniform, float value)
   {
     assert(uniform);
-    GL_ASSERT(glUniform1f(uniform->_location, value));
+    StateCache::getCurrent()->uniform1fv(uniform->_location, 1, &value);
   }
 
   void Effect::setValue(Uniform* uniform, const float* values, unsigned int count)
   {
     assert(uniform);
     assert(values);
-    GL_ASSERT(glUniform1fv(uniform->_location, count, values));
+    StateCache::getCurrent()->uniform1fv(uniform->_location, count, values);
   }
 
   void Effect::setValue(Uniform* uniform, int value)
   {
     assert(uniform);
-    GL_ASSERT(glUniform1i(uniform->_location, value));
+    StateCache::getCurrent()->uniform1iv(uniform->_location, 1, &value);
   }
 
   void Effect::setValue(Uniform* uniform, const int* values, unsigned int count)
   {
     assert(uniform);
     assert(values);
-    GL_ASSERT(glUniform1iv(uniform->_location, count, values));
+    StateCache::getCurrent()->uniform1iv(uniform->_location, count, values);
   }
 
   void Effect::setValue(Uniform* uniform, const Matrix& value)
   {
     assert(uniform);
-    GL_ASSERT(glUniformMatrix4fv(uniform->_location, 1, GL_FALSE, value.m));
+    StateCache::getCurrent()->uniformMatrix4fv(uniform->_location, 1, value.m);
   }
 
   void Effect::setValue(Uniform* uniform, const Matrix* values, unsigned int count)
   {
     assert(uniform);
     assert(values);
-    GL_ASSERT(glUniformMatrix4fv(uniform->_location, count, GL_FALSE, (GLfloat*)values));
+    StateCache::getCurrent()->uniformMatrix4fv(uniform->_location, count, (const GLfloat*)values);
   }
 
   void Effect::setValue(Uniform* uniform, const Vector2& value)
   {
     assert(uniform);
-    GL_ASSERT(glUniform2f(uniform->_location, value.x, value.y));
+    StateCache::getCurrent()->uniform2fv(uniform->_location, 1, &value.x);
   }
 
   void Effect::setValue(Uniform* uniform, const Vector2* values, unsigned int count)
   {
     assert(uniform);
     assert(values);
-    GL_ASSERT(glUniform2fv(uniform->_location, count, (GLfloat*)values));
+    StateCache::getCurrent()->uniform2fv(uniform->_location, count, (const GLfloat*)values);
   }
 
   void Effect::setValue(Uniform* uniform, const Vector3& value)
   {
     assert(uniform);
-    GL_ASSERT(glUniform3f(uniform->_location, value.x, value.y, value.z));
+    StateCache::getCurrent()->uniform3fv(uniform->_location, 1, &value.x);
   }
 
   void Effect::setValue(Uniform* uniform, const Vector3* values, unsigned int count)
   {
     assert(uniform);
     assert(values);
-    GL_ASSERT(glUniform3fv(uniform->_location, count, (GLfloat*)values));
+    StateCache::getCurrent()->uniform3fv(uniform->_location, count, (const GLfloat*)values);
   }
 
   void Effect::setValue(Uniform* uniform, const Vector4& value)
   {
     assert(uniform);
-    GL_ASSERT(glUniform4f(uniform->_location, value.x, value.y, value.z, value.w));
+    StateCache::getCurrent()->uniform4fv(uniform->_location, 1, &value.x);
   }
 
   void Effect::setValue(Uniform* uniform, const Vector4* values, unsigned int count)
   {
     assert(uniform);
     assert(values);
-    GL_ASSERT(glUniform4fv(uniform->_location, count, (GLfloat*)values));
+    StateCache::getCurrent()->uniform4fv(uniform->_location, count, (const GLfloat*)values);
   }
 
   void Effect::setValue(Uniform* uniform, const Texture::Sampler* sampler)
@@ -604,12 +652,13 @@ namespace gameplay
     assert((sampler->getTexture()->getType() == Texture::TEXTURE_2D && uniform->_type == GL_SAMPLER_2D) ||
       (sampler->getTexture()->getType() == Texture::TEXTURE_CUBE && uniform->_type == GL_SAMPLER_CUBE));
 
-    GL_ASSERT(glActiveTexture(GL_TEXTURE0 + uniform->_index));
+    StateCache::getCurrent()->activeTexture(GL_TEXTURE0 + uniform->_index);
 
     // Bind the sampler - this binds the texture and applies sampler state
     const_cast<Texture::Sampler*>(sampler)->bind();
 
-    GL_ASSERT(glUniform1i(uniform->_location, uniform->_index));
+    GLint unit = uniform->_index;
+    StateCache::getCurrent()->uniform1iv(uniform->_location, 1, &unit);
   }
 
   void Effect::setValue(Uniform* uniform, const Texture::Sampler** values, unsigned int count)
@@ -624,7 +673,7 @@ namespace gameplay
     {
       assert((const_cast<Texture::Sampler*>(values[i])->getTexture()->getType() == Texture::TEXTURE_2D && uniform->_type == GL_SAMPLER_2D) ||
         (const_cast<Texture::Sampler*>(values[i])->getTexture()->getType() == Texture::TEXTURE_CUBE && uniform->_type == GL_SAMPLER_CUBE));
-      GL_ASSERT(glActiveTexture(GL_TEXTURE0 + uniform->_index + i));
+      StateCache::getCurrent()->activeTexture(GL_TEXTURE0 + uniform->_index + i);
 
       // Bind the sampler - this binds the texture and applies sampler state
       const_cast<Texture::Sampler*>(values[i])->bind();
@@ -633,12 +682,12 @@ namespace gameplay
     }
 
     // Pass texture unit array to GL
-    GL_ASSERT(glUniform1iv(uniform->_location, count, units));
+    StateCache::getCurrent()->uniform1iv(uniform->_location, count, units);
   }
 
   void Effect::bind()
   {
-    GL_ASSERT(glUseProgram(_program));
+    StateCache::getCurrent()->useProgram(_program);
 
     __currentEffect = this;
   }
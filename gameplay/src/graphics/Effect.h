@@ -24,6 +24,8 @@ namespace gameplay
    */
   class Effect : public Ref
   {
+    friend class EffectManifest;
+
   public:
 
     /**
@@ -240,6 +242,35 @@ namespace gameplay
 
     static Effect* createFromSource(const char* vshPath, const char* vshSource, const char* fshPath, const char* fshSource, const char* defines = nullptr);
 
+    /**
+     * Creates an effect from fully preprocessed shader sources (see ShaderCache::preprocess()).
+     *
+     * @param definesLength The length of the #define lines at the start of each source.
+     */
+    static Effect* createFromPreprocessed(const char* vshPath, const char* fshPath, const std::string& vertexSource, const std::string& fragmentSource, size_t definesLength);
+
+    /**
+     * Gets the defines applied to every effect, for the platform and from game.config.
+     */
+    static std::string getGlobalDefines();
+
+    /**
+     * Gets the id an effect is cached under: "vshPath;fshPath;defines".
+     */
+    static std::string getUniqueId(const char* vshPath, const char* fshPath, const char* defines);
+
+    /**
+     * Finds a loaded effect by id and adds a reference to it, or returns nullptr.
+     */
+    static Effect* findCached(const std::string& uniqueId);
+
+    static void addToCache(Effect* effect, const std::string& uniqueId);
+
+    /**
+     * Appends the ids of all loaded effects.
+     */
+    static void getCachedIds(std::vector<std::string>& ids);
+
     GLuint _program;
     std::string _id;
     std::map<std::string, VertexAttribute> _vertexAttributes;
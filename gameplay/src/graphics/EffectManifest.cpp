@@ -0,0 +1,278 @@
+#include "framework/Base.h"
+#include "graphics/EffectManifest.h"
+#include "graphics/ShaderCache.h"
+#include "framework/FileSystem.h"
+#include "framework/JobSystem.h"
+#include "framework/Stream.h"
+#include "scene/Properties.h"
+
+namespace gameplay
+{
+
+  EffectManifest::EffectManifest() : _built(0)
+  {
+  }
+
+  EffectManifest::~EffectManifest()
+  {
+    for (size_t i = 0, count = _effects.size(); i < count; ++i)
+    {
+      SAFE_RELEASE(_effects[i]);
+    }
+  }
+
+  bool EffectManifest::add(const char* vshPath, const char* fshPath, const char* defines)
+  {
+    assert(vshPath);
+    assert(fshPath);
+
+    if (!_ids.insert(Effect::getUniqueId(vshPath, fshPath, defines)).second)
+      return false;
+
+    Permutation permutation;
+    permutation.vertexShader = vshPath;
+    permutation.fragmentShader = fshPath;
+    if (defines)
+      permutation.defines = defines;
+    _permutations.push_back(permutation);
+    return true;
+  }
+
+  unsigned int EffectManifest::addMaterial(Properties* materialProperties)
+  {
+    if (!materialProperties || strcmp(materialProperties->getNamespace(), "material") != 0)
+    {
+      GP_WARN("Properties object must be non-null and have namespace equal to 'material'.");
+      return 0;
+    }
+
+    // Walk the passes the same way Material::create() does.
+    unsigned int added = 0;
+    materialProperties->rewind();
+    Properties* techniqueProperties = nullptr;
+    while ((techniqueProperties = materialProperties->getNextNamespace()))
+    {
+      if (strcmp(techniqueProperties->getNamespace(), "technique") != 0)
+        continue;
+
+      techniqueProperties->rewind();
+      Properties* passProperties = nullptr;
+      while ((passProperties = techniqueProperties->getNextNamespace()))
+      {
+        if (strcmp(passProperties->getNamespace(), "pass") != 0)
+          continue;
+
+        const char* vertexShaderPath = passProperties->getString("vertexShader");
+        const char* fragmentShaderPath = passProperties->getString("fragmentShader");
+        if (vertexShaderPath && fragmentShaderPath && add(vertexShaderPath, fragmentShaderPath, passProperties->getString("defines")))
+          ++added;
+      }
+      techniqueProperties->rewind();
+    }
+    materialProperties->rewind();
+    return added;
+  }
+
+  unsigned int EffectManifest::addMaterial(const char* url)
+  {
+    Properties* properties = Properties::create(url);
+    if (properties == nullptr)
+    {
+      GP_WARN("Failed to read material from file: %s", url);
+      return 0;
+    }
+
+    unsigned int added = addMaterial((strlen(properties->getNamespace()) > 0) ? properties : properties->getNextNamespace());
+    SAFE_DELETE(properties);
+    return added;
+  }
+
+  unsigned int EffectManifest::addLoaded()
+  {
+    std::vector<std::string> ids;
+    Effect::getCachedIds(ids);
+
+    // Ids are "vshPath;fshPath;defines", where the defines may contain more semicolons.
+    unsigned int added = 0;
+    for (size_t i = 0, count = ids.size(); i < count; ++i)
+    {
+      const std::string& id = ids[i];
+      size_t vshEnd = id.find(';');
+      size_t fshEnd = vshEnd == std::string::npos ? std::string::npos : id.find(';', vshEnd + 1);
+      if (fshEnd == std::string::npos)
+        continue;
+
+      std::string vshPath = id.substr(0, vshEnd);
+      std::string fshPath = id.substr(vshEnd + 1, fshEnd - vshEnd - 1);
+      if (add(vshPath.c_str(), fshPath.c_str(), id.c_str() + fshEnd + 1))
+        ++added;
+    }
+    return added;
+  }
+
+  bool EffectManifest::load(const char* url)
+  {
+    Properties* properties = Properties::create(url);
+    if (properties == nullptr)
+    {
+      GP_WARN("Failed to read effect manifest: %s", url);
+      return false;
+    }
+
+    Properties* effects = (strlen(properties->getNamespace()) > 0) ? properties : properties->getNextNamespace();
+    if (!effects || strcmp(effects->getNamespace(), "effects") != 0)
+    {
+      GP_WARN("Effect manifest '%s' must have namespace equal to 'effects'.", url);
+      SAFE_DELETE(properties);
+      return false;
+    }
+
+    Properties* effect = nullptr;
+    while ((effect = effects->getNextNamespace()))
+    {
+      if (strcmp(effect->getNamespace(), "effect") != 0)
+        continue;
+
+      const char* vertexShaderPath = effect->getString("vertexShader");
+      const char* fragmentShaderPath = effect->getString("fragmentShader");
+      if (!vertexShaderPath || !fragmentShaderPath)
+      {
+        GP_WARN("Effect in manifest '%s' is missing its vertexShader or fragmentShader.", url);
+        continue;
+      }
+      add(vertexShaderPath, fragmentShaderPath, effect->getString("defines"));
+    }
+
+    SAFE_DELETE(properties);
+    return true;
+  }
+
+  bool EffectManifest::save(const char* path) const
+  {
+    assert(path);
+
+    std::string text = "effects\n{\n";
+    for (size_t i = 0, count = _permutations.size(); i < count; ++i)
+    {
+      const Permutation& permutation = _permutations[i];
+      text += "    effect\n    {\n";
+      text += "        vertexShader = " + permutation.vertexShader + "\n";
+      text += "        fragmentShader = " + permutation.fragmentShader + "\n";
+      if (!permutation.defines.empty())
+        text += "        defines = " + permutation.defines + "\n";
+      text += "    }\n";
+    }
+    text += "}\n";
+
+    std::unique_ptr<Stream> stream(FileSystem::open(path, FileSystem::WRITE));
+    if (stream.get() == nullptr || stream->write(text.c_str(), 1, text.length()) != text.length())
+    {
+      GP_WARN("Failed to write effect manifest '%s'.", path);
+      return false;
+    }
+
+    // Let the next load read what was just written rather than a cached copy.
+    Properties::invalidate(path);
+    return true;
+  }
+
+  unsigned int EffectManifest::getPermutationCount() const
+  {
+    return (unsigned int)_permutations.size();
+  }
+
+  const EffectManifest::Permutation& EffectManifest::getPermutation(unsigned int index) const
+  {
+    assert(index < _permutations.size());
+    return _permutations[index];
+  }
+
+  /**
+   * The sources of a permutation, ready to compile.
+   */
+  struct PreprocessedEffect
+  {
+    std::string id;
+    std::string vertexSource;
+    std::string fragmentSource;
+    size_t definesLength;
+    bool loaded;
+    bool valid;
+  };
+
+  unsigned int EffectManifest::build(JobSystem* jobSystem)
+  {
+    unsigned int count = (unsigned int)_permutations.size() - _built;
+    if (count == 0)
+      return (unsigned int)_effects.size();
+
+    // Keep permutations that are already loaded alive instead of building them again.
+    std::vector<PreprocessedEffect> effects(count);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      const Permutation& permutation = _permutations[_built + i];
+      PreprocessedEffect& effect = effects[i];
+      effect.id = Effect::getUniqueId(permutation.vertexShader.c_str(), permutation.fragmentShader.c_str(), permutation.defines.c_str());
+      Effect* loaded = Effect::findCached(effect.id);
+      effect.loaded = loaded != nullptr;
+      effect.valid = false;
+      if (loaded)
+        _effects.push_back(loaded);
+    }
+
+    // Preprocess in parallel. Shaders share most of their source and includes, so each file is read once.
+    std::string globalDefines = Effect::getGlobalDefines();
+    ShaderCache::SourceFiles files;
+    std::function<void(unsigned int)> preprocess = [this, &effects, &files, &globalDefines](unsigned int i)
+    {
+      PreprocessedEffect& effect = effects[i];
+      if (effect.loaded)
+        return;
+
+      const Permutation& permutation = _permutations[_built + i];
+      const std::string* vshSource = files.read(permutation.vertexShader);
+      const std::string* fshSource = files.read(permutation.fragmentShader);
+      if (!vshSource || !fshSource)
+        return;
+
+      std::string defines = ShaderCache::expandDefines(globalDefines.c_str(), permutation.defines.c_str());
+      defines += "\n";
+      effect.definesLength = defines.length();
+      effect.valid = ShaderCache::preprocess(permutation.vertexShader.c_str(), vshSource->c_str(), defines, effect.vertexSource, &files) &&
+        ShaderCache::preprocess(permutation.fragmentShader.c_str(), fshSource->c_str(), defines, effect.fragmentSource, &files);
+    };
+    if (jobSystem)
+    {
+      jobSystem->parallelFor(count, preprocess);
+    }
+    else
+    {
+      for (unsigned int i = 0; i < count; ++i)
+        preprocess(i);
+    }
+
+    // Compile, or load from the shader cache, on this thread since it owns the graphics context.
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      PreprocessedEffect& effect = effects[i];
+      if (effect.loaded)
+        continue;
+
+      const Permutation& permutation = _permutations[_built + i];
+      Effect* built = effect.valid ? Effect::createFromPreprocessed(permutation.vertexShader.c_str(), permutation.fragmentShader.c_str(),
+        effect.vertexSource, effect.fragmentSource, effect.definesLength) : nullptr;
+      if (built == nullptr)
+      {
+        GP_WARN("Failed to build effect: vertexShader = %s, fragmentShader = %s, defines = %s",
+          permutation.vertexShader.c_str(), permutation.fragmentShader.c_str(), permutation.defines.c_str());
+        continue;
+      }
+      Effect::addToCache(built, effect.id);
+      _effects.push_back(built);
+    }
+
+    _built = (unsigned int)_permutations.size();
+    return (unsigned int)_effects.size();
+  }
+
+}
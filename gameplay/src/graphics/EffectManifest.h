@@ -0,0 +1,182 @@
+#pragma once
+
+#include "graphics/Effect.h"
+
+namespace gameplay
+{
+
+  class JobSystem;
+  class Properties;
+
+  /**
+   * Defines a list of the effect permutations a game uses, so that they can
+   * all be built up front instead of when they are first drawn.
+   *
+   * A permutation is a vertex shader, a fragment shader and a set of defines,
+   * identified the same way as loaded effects. The list can be gathered from
+   * .material files, from the effects loaded while the game runs, or read from
+   * a manifest file saved earlier:
+   *
+   * @verbatim
+   effects
+   {
+       effect
+       {
+           vertexShader = res/shaders/textured.vert
+           fragmentShader = res/shaders/textured.frag
+           defines = DIRECTIONAL_LIGHT_COUNT 1;SPECULAR
+       }
+   }
+   @endverbatim
+   *
+   * Building preprocesses every permutation in parallel on the job system,
+   * reading each shader and include file once, then compiles or loads the
+   * programs from the shader cache on the calling thread. The manifest keeps
+   * a reference to every effect it built, so later requests for the same
+   * permutation (such as from Material::create()) find it already loaded.
+   *
+   * The game builds the manifest named by the "effectManifest" property of the
+   * "graphics" namespace in game.config at startup, and scenes build the
+   * effects of their materials before applying them to nodes.
+   *
+   * @script{ignore}
+   */
+  class EffectManifest
+  {
+  public:
+
+    /**
+     * An effect permutation.
+     */
+    struct Permutation
+    {
+      /**
+       * The path of the vertex shader.
+       */
+      std::string vertexShader;
+
+      /**
+       * The path of the fragment shader.
+       */
+      std::string fragmentShader;
+
+      /**
+       * A semicolon-delimited list of defines, which may be empty.
+       */
+      std::string defines;
+    };
+
+    /**
+     * Constructor.
+     */
+    EffectManifest();
+
+    /**
+     * Destructor. Releases the effects built by the manifest.
+     */
+    ~EffectManifest();
+
+    /**
+     * Adds a permutation, unless it is already in the manifest.
+     *
+     * @param vshPath The path of the vertex shader.
+     * @param fshPath The path of the fragment shader.
+     * @param defines A semicolon-delimited list of defines. May be nullptr.
+     *
+     * @return True if the permutation was added, false if it was already in the manifest.
+     */
+    bool add(const char* vshPath, const char* fshPath, const char* defines = nullptr);
+
+    /**
+     * Adds the permutations of every pass of a material.
+     *
+     * Defines added by a pass callback (see Material::create()) are not known
+     * until the material is created, so they are not included; use addLoaded()
+     * after creating such materials to capture them.
+     *
+     * @param materialProperties The properties of the material, with namespace "material".
+     *
+     * @return The number of permutations added.
+     */
+    unsigned int addMaterial(Properties* materialProperties);
+
+    /**
+     * Adds the permutations of every pass of a material file.
+     *
+     * @param url The URL of the .material file.
+     *
+     * @return The number of permutations added.
+     */
+    unsigned int addMaterial(const char* url);
+
+    /**
+     * Adds the permutations of every effect loaded from files that is currently alive.
+     *
+     * @return The number of permutations added.
+     */
+    unsigned int addLoaded();
+
+    /**
+     * Adds the permutations listed in a manifest file.
+     *
+     * @param url The URL of the manifest file.
+     *
+     * @return True if the file was read, false otherwise.
+     */
+    bool load(const char* url);
+
+    /**
+     * Writes the permutations to a manifest file that load() can read.
+     *
+     * @param path The path of the file to write.
+     *
+     * @return True if the file was written, false otherwise.
+     */
+    bool save(const char* path) const;
+
+    /**
+     * Gets the number of permutations in the manifest.
+     *
+     * @return The number of permutations.
+     */
+    unsigned int getPermutationCount() const;
+
+    /**
+     * Gets a permutation.
+     *
+     * @param index The index of the permutation.
+     *
+     * @return The permutation.
+     */
+    const Permutation& getPermutation(unsigned int index) const;
+
+    /**
+     * Builds the effect of every permutation that has not been built yet.
+     *
+     * Must be called on the thread that owns the graphics context.
+     *
+     * @param jobSystem The job system to preprocess shaders on, or nullptr to preprocess on the calling thread.
+     *
+     * @return The number of effects that are loaded after building, including those loaded earlier.
+     */
+    unsigned int build(JobSystem* jobSystem = nullptr);
+
+  private:
+
+    /**
+     * Hidden copy constructor.
+     */
+    EffectManifest(const EffectManifest& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    EffectManifest& operator=(const EffectManifest&);
+
+    std::vector<Permutation> _permutations;
+    std::unordered_set<std::string> _ids;
+    std::vector<Effect*> _effects;
+    unsigned int _built;
+  };
+
+}
@@ -1,6 +1,7 @@
 #include "framework/Base.h"
 #include "graphics/Mesh.h"
 #include "graphics/MeshPart.h"
+#include "renderer/StateCache.h"
 
 namespace gameplay
 {
@@ -18,6 +19,7 @@ namespace gameplay
     if (_vertexBuffer)
     {
       glDeleteBuffers(1, &_vertexBuffer);
+      StateCache::getCurrent()->bufferDeleted(_vertexBuffer);
       _vertexBuffer = 0;
     }
   }
@@ -26,7 +28,7 @@ namespace gameplay
   {
     GLuint vbo;
     GL_ASSERT(glGenBuffers(1, &vbo));
-    GL_ASSERT(glBindBuffer(GL_ARRAY_BUFFER, vbo));
+    StateCache::getCurrent()->bindBuffer(GL_ARRAY_BUFFER, vbo);
     GL_ASSERT(glBufferData(GL_ARRAY_BUFFER, vertexFormat.getVertexSize() * vertexCount, NULL, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW));
 
     auto mesh = std::make_shared<Mesh>(vertexFormat);
@@ -255,7 +257,7 @@ namespace gameplay
 
   void* Mesh::mapVertexBuffer()
   {
-    GL_ASSERT(glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer));
+    StateCache::getCurrent()->bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
 
     return (void*)glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
   }
@@ -267,7 +269,7 @@ namespace gameplay
 
   void Mesh::setVertexData(const void* vertexData, unsigned int vertexStart, unsigned int vertexCount)
   {
-    GL_ASSERT(glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer));
+    StateCache::getCurrent()->bindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
 
     if (vertexStart == 0 && vertexCount == 0)
     {
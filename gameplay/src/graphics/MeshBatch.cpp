@@ -3,6 +3,7 @@
 #include "renderer/Material.h"
 #include "renderer/VertexAttributeBinding.h"
 #include "renderer/Pass.h"
+#include "renderer/StateCache.h"
 
 namespace gameplay
 {
@@ -250,7 +251,7 @@ namespace gameplay
 
     // Not using VBOs, so unbind the element array buffer.
     // ARRAY_BUFFER will be unbound automatically during pass->bind().
-    GL_ASSERT(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+    StateCache::getCurrent()->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
     assert(_material);
     if (_indexed)
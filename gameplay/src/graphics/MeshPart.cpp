@@ -1,5 +1,6 @@
 #include "framework/Base.h"
 #include "graphics/MeshPart.h"
+#include "renderer/StateCache.h"
 
 namespace gameplay
 {
@@ -13,6 +14,7 @@ namespace gameplay
     if (_indexBuffer)
     {
       glDeleteBuffers(1, &_indexBuffer);
+      StateCache::getCurrent()->bufferDeleted(_indexBuffer);
     }
   }
 
@@ -22,7 +24,7 @@ namespace gameplay
     // Create a VBO for our index buffer.
     GLuint vbo;
     GL_ASSERT(glGenBuffers(1, &vbo));
-    GL_ASSERT(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo));
+    StateCache::getCurrent()->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo);
 
     unsigned int indexSize = 0;
     switch (indexFormat)
@@ -39,6 +41,7 @@ namespace gameplay
     default:
       GP_ERROR("Unsupported index format (%d).", indexFormat);
       glDeleteBuffers(1, &vbo);
+      StateCache::getCurrent()->bufferDeleted(vbo);
       return nullptr;
     }
 
@@ -82,7 +85,7 @@ namespace gameplay
 
   void* MeshPart::mapIndexBuffer()
   {
-    GL_ASSERT(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer));
+    StateCache::getCurrent()->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
 
     return (void*)glMapBuffer(GL_ELEMENT_ARRAY_BUFFER, GL_WRITE_ONLY);
   }
@@ -94,7 +97,7 @@ namespace gameplay
 
   void MeshPart::setIndexData(const void* indexData, unsigned int indexStart, unsigned int indexCount)
   {
-    GL_ASSERT(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer));
+    StateCache::getCurrent()->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
 
     unsigned int indexSize = 0;
     switch (_indexFormat)
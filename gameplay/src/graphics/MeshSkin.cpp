@@ -10,7 +10,8 @@ namespace gameplay
 {
 
   MeshSkin::MeshSkin()
-    : _rootJoint(nullptr), _rootNode(nullptr), _matrixPalette(nullptr), _model(nullptr)
+    : _rootJoint(nullptr), _rootNode(nullptr), _matrixPalette(nullptr), _model(nullptr),
+    _skinMatricesDirty(true), _paletteDirty(true)
   {
   }
 
@@ -29,6 +30,8 @@ namespace gameplay
   void MeshSkin::setBindShape(const float* matrix)
   {
     _bindShape.set(matrix);
+    _skinMatricesDirty = true;
+    _paletteDirty = true;
   }
 
   unsigned int MeshSkin::getJointCount() const
@@ -120,6 +123,10 @@ namespace gameplay
     {
       _joints[i] = nullptr;
     }
+    _jointMatrices.resize(jointCount);
+    _skinMatrices.resize(jointCount);
+    _skinMatricesDirty = true;
+    _paletteDirty = true;
 
     // Rebuild the matrix palette. Each matrix is 3 rows of Vector4.
     SAFE_DELETE_ARRAY(_matrixPalette);
@@ -147,6 +154,8 @@ namespace gameplay
     }
 
     _joints[index] = joint;
+    _skinMatricesDirty = true;
+    _paletteDirty = true;
 
     if (joint)
     {
@@ -159,14 +168,42 @@ namespace gameplay
   {
     assert(_matrixPalette);
 
-    for (size_t i = 0, count = _joints.size(); i < count; i++)
+    // Resolving a pending transform store update notifies the joints that moved.
+    if (_rootJoint)
     {
-      assert(_joints[i]);
-      _joints[i]->updateJointMatrix(getBindShape(), &_matrixPalette[i * PALETTE_ROWS]);
+      _rootJoint->getWorldMatrix();
+    }
+    if (_paletteDirty)
+    {
+      const_cast<MeshSkin*>(this)->updatePalette();
     }
     return _matrixPalette;
   }
 
+  void MeshSkin::updatePalette()
+  {
+    assert(_matrixPalette || _joints.empty());
+
+    const unsigned int jointCount = (unsigned int)_joints.size();
+    if (_skinMatricesDirty)
+    {
+      for (unsigned int i = 0; i < jointCount; ++i)
+      {
+        assert(_joints[i]);
+        Matrix::multiply(_joints[i]->getInverseBindPose(), _bindShape, &_skinMatrices[i]);
+      }
+      _skinMatricesDirty = false;
+    }
+
+    for (unsigned int i = 0; i < jointCount; ++i)
+    {
+      assert(_joints[i]);
+      _jointMatrices[i] = _joints[i]->getWorldMatrix();
+    }
+    Matrix::multiplyAffine(_jointMatrices.data(), _skinMatrices.data(), jointCount, _matrixPalette);
+    _paletteDirty = false;
+  }
+
   unsigned int MeshSkin::getMatrixPaletteSize() const
   {
     return (unsigned int)_joints.size() * PALETTE_ROWS;
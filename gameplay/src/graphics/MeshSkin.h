@@ -92,10 +92,24 @@ namespace gameplay
     /**
      * Returns the pointer to the Vector4 array for the purpose of binding to a shader.
      *
+     * The palette is updated first if any joint has moved since the last update.
+     *
      * @return The pointer to the matrix palette.
      */
     Vector4* getMatrixPalette() const;
 
+    /**
+     * Recomputes the matrix palette from the current joint transforms.
+     *
+     * The joint world matrices are gathered into a contiguous array and the
+     * whole palette is computed in a single vectorized pass. Only state owned
+     * by this skin is written, so different skins may be updated concurrently
+     * (for example from JobSystem::parallelFor()). Since node world matrices
+     * are resolved lazily, the joint transforms must be resolved before doing
+     * so if the skins share ancestor nodes (see Scene::updateTransforms()).
+     */
+    void updatePalette();
+
     /**
      * Returns the number of elements in the matrix palette array.
      * Each element is a Vector4* that represents a row.
@@ -189,6 +203,14 @@ namespace gameplay
     // The number of Vector4's is (_joints.size() * 3).
     Vector4* _matrixPalette;
     Model* _model;
+
+    // The world matrices of the joints, gathered for the palette update.
+    std::vector<Matrix> _jointMatrices;
+
+    // The inverse bind pose of each joint multiplied by the bind shape.
+    std::vector<Matrix> _skinMatrices;
+    bool _skinMatricesDirty;
+    bool _paletteDirty;
   };
 
 }
@@ -3,7 +3,12 @@
 #include "graphics/MeshPart.h"
 #include "renderer/Technique.h"
 #include "renderer/Pass.h"
+#include "renderer/RenderQueue.h"
+#include "renderer/StateCache.h"
 #include "scene/Node.h"
+#include "scene/Scene.h"
+#include "renderer/TextureStreamer.h"
+#include "framework/Game.h"
 
 namespace gameplay
 {
@@ -324,63 +329,114 @@ namespace gameplay
     }
   }
 
+  // Gets the size in pixels of the projected bounds of a node, or the largest float if it is unknown or contains the camera.
+  static float getScreenSize(Node* node)
+  {
+    Scene* scene = node ? node->getScene() : nullptr;
+    Camera* camera = scene ? scene->getActiveCamera() : nullptr;
+    if (!camera || !camera->getNode())
+      return std::numeric_limits<float>::max();
+
+    const BoundingSphere& sphere = node->getBoundingSphere();
+    const Matrix& projection = camera->getProjectionMatrix();
+    float size = sphere.radius * projection.m[5] * Game::getInstance()->getViewport().height;
+
+    // Perspective projections shrink the bounds with distance; orthographic ones do not.
+    if (projection.m[11] != 0.0f)
+    {
+      float distance = camera->getNode()->getTranslationWorld().distance(sphere.center);
+      if (distance <= sphere.radius)
+        return std::numeric_limits<float>::max();
+      size /= distance;
+    }
+    return size;
+  }
+
   unsigned int Model::draw(bool wireframe)
   {
     assert(_mesh);
 
     unsigned int partCount = _mesh->getPartCount();
-    if (partCount == 0)
+    for (unsigned int i = 0, count = std::max(partCount, 1u); i < count; ++i)
     {
-      // No mesh parts (index buffers).
-      if (_material)
+      // Meshes without parts (index buffers) are drawn whole with the shared material.
+      int partIndex = partCount == 0 ? -1 : (int)i;
+      Material* material = getMaterial(partIndex);
+      if (material)
       {
-        Technique* technique = _material->getTechnique();
+        Technique* technique = material->getTechnique();
         assert(technique);
         unsigned int passCount = technique->getPassCount();
-        for (unsigned int i = 0; i < passCount; ++i)
+        for (unsigned int j = 0; j < passCount; ++j)
         {
-          Pass* pass = technique->getPassByIndex(i);
+          Pass* pass = technique->getPassByIndex(j);
           assert(pass);
-          pass->bind();
-          GL_ASSERT(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
-          if (!wireframe || !drawWireframe(_mesh.get()))
-          {
-            GL_ASSERT(glDrawArrays(_mesh->getPrimitiveType(), 0, _mesh->getVertexCount()));
-          }
+          bindPass(pass);
+          drawPart(partIndex, wireframe);
           pass->unbind();
         }
       }
     }
-    else
+    return partCount;
+  }
+
+  void Model::enqueue(RenderQueue* queue)
+  {
+    assert(queue);
+    assert(_mesh);
+
+    unsigned int partCount = _mesh->getPartCount();
+    for (unsigned int i = 0, count = std::max(partCount, 1u); i < count; ++i)
     {
-      for (unsigned int i = 0; i < partCount; ++i)
+      int partIndex = partCount == 0 ? -1 : (int)i;
+      Material* material = getMaterial(partIndex);
+      if (material)
       {
-        MeshPart* part = _mesh->getPart(i);
-        assert(part);
-
-        // Get the material for this mesh part.
-        Material* material = getMaterial(i);
-        if (material)
+        Technique* technique = material->getTechnique();
+        assert(technique);
+        for (unsigned int j = 0, passCount = technique->getPassCount(); j < passCount; ++j)
         {
-          Technique* technique = material->getTechnique();
-          assert(technique);
-          unsigned int passCount = technique->getPassCount();
-          for (unsigned int j = 0; j < passCount; ++j)
-          {
-            Pass* pass = technique->getPassByIndex(j);
-            assert(pass);
-            pass->bind();
-            GL_ASSERT(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, part->_indexBuffer));
-            if (!wireframe || !drawWireframe(part))
-            {
-              GL_ASSERT(glDrawElements(part->getPrimitiveType(), part->getIndexCount(), part->getIndexFormat(), 0));
-            }
-            pass->unbind();
-          }
+          queue->add(technique->getPassByIndex(j), this, partIndex);
         }
       }
     }
-    return partCount;
+  }
+
+  void Model::bindPass(Pass* pass)
+  {
+    assert(pass);
+
+    // Let the texture streamer know how large the textures bound by this pass appear on screen.
+    TextureStreamer* streamer = Game::getInstance()->getTextureStreamer();
+    if (streamer)
+      streamer->beginDraw(getScreenSize(_node));
+    pass->bind();
+    if (streamer)
+      streamer->endDraw();
+  }
+
+  void Model::drawPart(int partIndex, bool wireframe)
+  {
+    assert(_mesh);
+
+    if (partIndex < 0)
+    {
+      StateCache::getCurrent()->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+      if (!wireframe || !drawWireframe(_mesh.get()))
+      {
+        GL_ASSERT(glDrawArrays(_mesh->getPrimitiveType(), 0, _mesh->getVertexCount()));
+      }
+    }
+    else
+    {
+      MeshPart* part = _mesh->getPart(partIndex);
+      assert(part);
+      StateCache::getCurrent()->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, part->_indexBuffer);
+      if (!wireframe || !drawWireframe(part))
+      {
+        GL_ASSERT(glDrawElements(part->getPrimitiveType(), part->getIndexCount(), part->getIndexFormat(), 0));
+      }
+    }
   }
 
   void Model::setMaterialNodeBinding(Material* material)
@@ -24,6 +24,8 @@ namespace gameplay
     friend class Scene;
     friend class Mesh;
     friend class Bundle;
+    friend class RenderQueue;
+    friend class Instancer;
 
   public:
 
@@ -140,6 +142,13 @@ namespace gameplay
      */
     unsigned int draw(bool wireframe = false);
 
+    /**
+     * @see Drawable::enqueue
+     *
+     * Adds an item for each pass of the material of each mesh part.
+     */
+    void enqueue(RenderQueue* queue);
+
   private:
 
     /**
@@ -184,6 +193,16 @@ namespace gameplay
      */
     void setMaterialNodeBinding(Material* m);
 
+    /**
+     * Binds a pass of one of this model's materials.
+     */
+    void bindPass(Pass* pass);
+
+    /**
+     * Draws a mesh part, or the whole mesh if partIndex is -1, with the bound pass.
+     */
+    void drawPart(int partIndex, bool wireframe);
+
     void validatePartCount();
 
     std::shared_ptr<Mesh> _mesh;
@@ -15,7 +15,7 @@ namespace gameplay
 {
 
   ParticleEmitter::ParticleEmitter(unsigned int particleCountMax) : Drawable(),
-    _particleCountMax(particleCountMax), _particleCount(0), _particles(nullptr),
+    _particleCountMax(particleCountMax), _particles(nullptr),
     _emissionRate(PARTICLE_EMISSION_RATE), _started(false), _ellipsoid(false),
     _sizeStartMin(1.0f), _sizeStartMax(1.0f), _sizeEndMin(1.0f), _sizeEndMax(1.0f),
     _energyMin(1000L), _energyMax(1000L),
@@ -25,20 +25,24 @@ namespace gameplay
     _acceleration(Vector3::zero()), _accelerationVar(Vector3::zero()),
     _rotationPerParticleSpeedMin(0.0f), _rotationPerParticleSpeedMax(0.0f),
     _rotationSpeedMin(0.0f), _rotationSpeedMax(0.0f),
-    _rotationAxis(Vector3::zero()), _rotation(Matrix::identity()),
+    _rotationAxis(Vector3::zero()),
     _spriteBatch(nullptr), _spriteBlendMode(BLEND_ALPHA), _spriteTextureWidth(0), _spriteTextureHeight(0), _spriteTextureWidthRatio(0), _spriteTextureHeightRatio(0), _spriteTextureCoords(nullptr),
     _spriteAnimated(false), _spriteLooped(false), _spriteFrameCount(1), _spriteFrameRandomOffset(0), _spriteFrameDuration(0L), _spriteFrameDurationSecs(0.0f), _spritePercentPerFrame(0.0f),
     _orbitPosition(false), _orbitVelocity(false), _orbitAcceleration(false),
-    _timePerEmission(PARTICLE_EMISSION_RATE_TIME_INTERVAL), _emitTime(0), _lastUpdated(0)
+    _timePerEmission(PARTICLE_EMISSION_RATE_TIME_INTERVAL), _emitTime(0), _updateTime(0), _randomState(0)
   {
     assert(particleCountMax);
-    _particles = new Particle[particleCountMax];
+
+    // Seed each emitter differently, but deterministically, by creation order.
+    static std::atomic<unsigned int> __emitterCount(0);
+    setRandomSeed(++__emitterCount);
+    _particles = new ParticlePool(particleCountMax);
   }
 
   ParticleEmitter::~ParticleEmitter()
   {
     SAFE_DELETE(_spriteBatch);
-    SAFE_DELETE_ARRAY(_particles);
+    SAFE_DELETE(_particles);
     SAFE_DELETE_ARRAY(_spriteTextureCoords);
   }
 
@@ -273,7 +277,7 @@ namespace gameplay
   void ParticleEmitter::start()
   {
     _started = true;
-    _lastUpdated = 0;
+    _updateTime = 0;
   }
 
   void ParticleEmitter::stop()
@@ -294,22 +298,29 @@ namespace gameplay
     if (!_node)
       return false;
 
-    return (_particleCount > 0);
+    return (_particles->getCount() > 0);
   }
 
   void ParticleEmitter::emitOnce(unsigned int particleCount)
   {
     assert(_node);
+
+    emit(particleCount, _node->getWorldMatrix());
+  }
+
+  void ParticleEmitter::emit(unsigned int particleCount, const Matrix& worldMatrix)
+  {
     assert(_particles);
 
     // Limit particleCount so as not to go over _particleCountMax.
-    if (particleCount + _particleCount > _particleCountMax)
+    unsigned int count = _particles->getCount();
+    if (particleCount + count > _particleCountMax)
     {
-      particleCount = _particleCountMax - _particleCount;
+      particleCount = _particleCountMax - count;
     }
 
     Vector3 translation;
-    Matrix world = _node->getWorldMatrix();
+    Matrix world = worldMatrix;
     world.getTranslation(&translation);
 
     // Take translation out of world matrix so it can be used to rotate orbiting properties.
@@ -318,71 +329,118 @@ namespace gameplay
     world.m[14] = 0.0f;
 
     // Emit the new particles.
+    ParticlePool* pool = _particles;
+    Vector4 colorStart;
+    Vector4 colorEnd;
+    Vector3 position;
+    Vector3 velocity;
+    Vector3 acceleration;
+    Vector3 rotationAxis;
     for (unsigned int i = 0; i < particleCount; i++)
     {
-      Particle* p = &_particles[_particleCount];
-
-      generateColor(_colorStart, _colorStartVar, &p->_colorStart);
-      generateColor(_colorEnd, _colorEndVar, &p->_colorEnd);
-      p->_color.set(p->_colorStart);
-
-      p->_energy = p->_energyStart = generateScalar(_energyMin, _energyMax);
-      p->_size = p->_sizeStart = generateScalar(_sizeStartMin, _sizeStartMax);
-      p->_sizeEnd = generateScalar(_sizeEndMin, _sizeEndMax);
-      p->_rotationPerParticleSpeed = generateScalar(_rotationPerParticleSpeedMin, _rotationPerParticleSpeedMax);
-      p->_angle = generateScalar(0.0f, p->_rotationPerParticleSpeed);
-      p->_rotationSpeed = generateScalar(_rotationSpeedMin, _rotationSpeedMax);
+      unsigned int index = pool->add();
+
+      generateColor(_colorStart, _colorStartVar, &colorStart);
+      generateColor(_colorEnd, _colorEndVar, &colorEnd);
+      pool->_colorR[index] = pool->_colorStartR[index] = colorStart.x;
+      pool->_colorG[index] = pool->_colorStartG[index] = colorStart.y;
+      pool->_colorB[index] = pool->_colorStartB[index] = colorStart.z;
+      pool->_colorA[index] = pool->_colorStartA[index] = colorStart.w;
+      pool->_colorEndR[index] = colorEnd.x;
+      pool->_colorEndG[index] = colorEnd.y;
+      pool->_colorEndB[index] = colorEnd.z;
+      pool->_colorEndA[index] = colorEnd.w;
+
+      pool->_energy[index] = pool->_energyStart[index] = (float)generateScalar(_energyMin, _energyMax);
+      pool->_size[index] = pool->_sizeStart[index] = generateScalar(_sizeStartMin, _sizeStartMax);
+      pool->_sizeEnd[index] = generateScalar(_sizeEndMin, _sizeEndMax);
+      pool->_rotationPerParticleSpeed[index] = generateScalar(_rotationPerParticleSpeedMin, _rotationPerParticleSpeedMax);
+      pool->_angle[index] = generateScalar(0.0f, pool->_rotationPerParticleSpeed[index]);
+      float rotationSpeed = generateScalar(_rotationSpeedMin, _rotationSpeedMax);
 
       // Only initial position can be generated within an ellipsoidal domain.
-      generateVector(_position, _positionVar, &p->_position, _ellipsoid);
-      generateVector(_velocity, _velocityVar, &p->_velocity, false);
-      generateVector(_acceleration, _accelerationVar, &p->_acceleration, false);
-      generateVector(_rotationAxis, _rotationAxisVar, &p->_rotationAxis, false);
+      generateVector(_position, _positionVar, &position, _ellipsoid);
+      generateVector(_velocity, _velocityVar, &velocity, false);
+      generateVector(_acceleration, _accelerationVar, &acceleration, false);
+      generateVector(_rotationAxis, _rotationAxisVar, &rotationAxis, false);
 
       // Initial position, velocity and acceleration can all be relative to the emitter's transform.
       // Rotate specified properties by the node's rotation.
       if (_orbitPosition)
       {
-        world.transformPoint(p->_position, &p->_position);
+        world.transformPoint(position, &position);
       }
 
       if (_orbitVelocity)
       {
-        world.transformPoint(p->_velocity, &p->_velocity);
+        world.transformPoint(velocity, &velocity);
       }
 
       if (_orbitAcceleration)
       {
-        world.transformPoint(p->_acceleration, &p->_acceleration);
+        world.transformPoint(acceleration, &acceleration);
       }
 
-      // The rotation axis always orbits the node.
-      if (p->_rotationSpeed != 0.0f && !p->_rotationAxis.isZero())
+      // The rotation axis always orbits the node. It is stored normalized, and
+      // particles without a usable axis simply do not rotate.
+      if (rotationSpeed != 0.0f && !rotationAxis.isZero())
+      {
+        world.transformPoint(rotationAxis, &rotationAxis);
+        rotationAxis.normalize();
+      }
+      else
       {
-        world.transformPoint(p->_rotationAxis, &p->_rotationAxis);
+        rotationSpeed = 0.0f;
       }
+      pool->_rotationSpeed[index] = rotationSpeed;
+      pool->_rotationAxisX[index] = rotationAxis.x;
+      pool->_rotationAxisY[index] = rotationAxis.y;
+      pool->_rotationAxisZ[index] = rotationAxis.z;
 
       // Translate position relative to the node's world space.
-      p->_position.add(translation);
+      pool->_positionX[index] = position.x + translation.x;
+      pool->_positionY[index] = position.y + translation.y;
+      pool->_positionZ[index] = position.z + translation.z;
+      pool->_velocityX[index] = velocity.x;
+      pool->_velocityY[index] = velocity.y;
+      pool->_velocityZ[index] = velocity.z;
+      pool->_accelerationX[index] = acceleration.x;
+      pool->_accelerationY[index] = acceleration.y;
+      pool->_accelerationZ[index] = acceleration.z;
 
       // Initial sprite frame.
       if (_spriteFrameRandomOffset > 0)
       {
-        p->_frame = rand() % _spriteFrameRandomOffset;
+        pool->_frame[index] = generateRandom() % _spriteFrameRandomOffset;
       }
       else
       {
-        p->_frame = 0;
+        pool->_frame[index] = 0;
       }
-      p->_timeOnCurrentFrame = 0.0f;
-
-      ++_particleCount;
+      pool->_timeOnCurrentFrame[index] = 0.0f;
     }
   }
 
   unsigned int ParticleEmitter::getParticlesCount() const
   {
-    return _particleCount;
+    return _particles->getCount();
+  }
+
+  const ParticlePool* ParticleEmitter::getParticles() const
+  {
+    return _particles;
+  }
+
+  void ParticleEmitter::setRandomSeed(unsigned int seed)
+  {
+    // Scramble the seed so that consecutive seeds give unrelated sequences,
+    // and keep the state non-zero as required by xorshift.
+    seed = (seed ^ 61u) ^ (seed >> 16);
+    seed *= 9u;
+    seed ^= seed >> 4;
+    seed *= 0x27d4eb2du;
+    seed ^= seed >> 15;
+    _randomState = seed ? seed : 0x9e3779b9u;
   }
 
   void ParticleEmitter::setEllipsoid(bool ellipsoid)
@@ -744,26 +802,39 @@ namespace gameplay
     return _orbitAcceleration;
   }
 
-  long ParticleEmitter::generateScalar(long min, long max)
+  unsigned int ParticleEmitter::generateRandom()
   {
-    // Note: this is not a very good RNG, but it should be suitable for our purposes.
-    long r = 0;
-    for (unsigned int i = 0; i < sizeof(long) / sizeof(int); i++)
-    {
-      r = r << 8; // sizeof(int) * CHAR_BITS
-      r |= rand();
-    }
+    // xorshift32
+    unsigned int x = _randomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    _randomState = x;
+    return x;
+  }
 
-    // Now we have a random long between 0 and MAX_LONG.  We need to clamp it between min and max.
-    r %= max - min;
-    r += min;
+  float ParticleEmitter::generateRandom01()
+  {
+    // Use the upper 24 bits, which convert to float exactly.
+    return (float)(generateRandom() >> 8) * (1.0f / 16777215.0f);
+  }
 
-    return r;
+  float ParticleEmitter::generateRandomMinus1To1()
+  {
+    return 2.0f * generateRandom01() - 1.0f;
+  }
+
+  long ParticleEmitter::generateScalar(long min, long max)
+  {
+    if (max <= min)
+      return min;
+
+    return min + (long)(generateRandom() % (unsigned long)(max - min));
   }
 
   float ParticleEmitter::generateScalar(float min, float max)
   {
-    return min + (max - min) * MATH_RANDOM_0_1();
+    return min + (max - min) * generateRandom01();
   }
 
   void ParticleEmitter::generateVectorInRect(const Vector3& base, const Vector3& variance, Vector3* dst)
@@ -772,9 +843,9 @@ namespace gameplay
 
     // Scale each component of the variance vector by a random float
     // between -1 and 1, then add this to the corresponding base component.
-    dst->x = base.x + variance.x * MATH_RANDOM_MINUS1_1();
-    dst->y = base.y + variance.y * MATH_RANDOM_MINUS1_1();
-    dst->z = base.z + variance.z * MATH_RANDOM_MINUS1_1();
+    dst->x = base.x + variance.x * generateRandomMinus1To1();
+    dst->y = base.y + variance.y * generateRandomMinus1To1();
+    dst->z = base.z + variance.z * generateRandomMinus1To1();
   }
 
   void ParticleEmitter::generateVectorInEllipsoid(const Vector3& center, const Vector3& scale, Vector3* dst)
@@ -784,9 +855,9 @@ namespace gameplay
     // Generate a point within a unit cube, then reject if the point is not in a unit sphere.
     do
     {
-      dst->x = MATH_RANDOM_MINUS1_1();
-      dst->y = MATH_RANDOM_MINUS1_1();
-      dst->z = MATH_RANDOM_MINUS1_1();
+      dst->x = generateRandomMinus1To1();
+      dst->y = generateRandomMinus1To1();
+      dst->z = generateRandomMinus1To1();
     } while (dst->length() > 1.0f);
 
     // Scale this point by the scaling vector.
@@ -816,10 +887,10 @@ namespace gameplay
 
     // Scale each component of the variance color by a random float
     // between -1 and 1, then add this to the corresponding base component.
-    dst->x = base.x + variance.x * MATH_RANDOM_MINUS1_1();
-    dst->y = base.y + variance.y * MATH_RANDOM_MINUS1_1();
-    dst->z = base.z + variance.z * MATH_RANDOM_MINUS1_1();
-    dst->w = base.w + variance.w * MATH_RANDOM_MINUS1_1();
+    dst->x = base.x + variance.x * generateRandomMinus1To1();
+    dst->y = base.y + variance.y * generateRandomMinus1To1();
+    dst->z = base.z + variance.z * generateRandomMinus1To1();
+    dst->w = base.w + variance.w * generateRandomMinus1To1();
   }
 
   ParticleEmitter::BlendMode ParticleEmitter::getBlendModeFromString(const char* str)
@@ -861,23 +932,27 @@ namespace gameplay
     if (!isActive())
       return;
 
+    simulate(elapsedTime, _node ? _node->getWorldMatrix() : Matrix::identity());
+  }
+
+  void ParticleEmitter::simulate(float elapsedTime, const Matrix& world)
+  {
     // Cap particle updates at a maximum rate. This saves processing
     // and also improves precision since updating with very small
     // time increments is more lossy.
-    static double runningTime = 0;
-    runningTime += elapsedTime;
-    if (runningTime < PARTICLE_UPDATE_RATE_MAX)
+    _updateTime += elapsedTime;
+    if (_updateTime < PARTICLE_UPDATE_RATE_MAX)
       return;
 
-    float elapsedMs = runningTime;
-    runningTime = 0;
+    float elapsedMs = _updateTime;
+    _updateTime = 0;
 
     float elapsedSecs = elapsedMs * 0.001f;
 
     if (_started && _emissionRate)
     {
       // Calculate how much time has passed since we last emitted particles.
-      _emitTime += elapsedMs; //+= elapsedTime;
+      _emitTime += elapsedMs;
 
       // How many particles should we emit this frame?
       assert(_timePerEmission);
@@ -889,94 +964,55 @@ namespace gameplay
         {
           _emitTime = fmod((double)_emitTime, (double)_timePerEmission);
         }
-        emitOnce(emitCount);
+        emit(emitCount, world);
       }
     }
 
     // Now update all currently living particles.
     assert(_particles);
-    for (unsigned int particlesIndex = 0; particlesIndex < _particleCount; ++particlesIndex)
-    {
-      Particle* p = &_particles[particlesIndex];
-      p->_energy -= elapsedMs;
+    ParticlePool* pool = _particles;
+    pool->update(elapsedMs);
 
-      if (p->_energy > 0L)
+    // Handle sprite animations.
+    if (_spriteAnimated)
+    {
+      unsigned int count = pool->getCount();
+      if (!_spriteLooped)
       {
-        if (p->_rotationSpeed != 0.0f && !p->_rotationAxis.isZero())
+        // The last frame should finish exactly when the particle dies.
+        for (unsigned int i = 0; i < count; ++i)
         {
-          _rotation = Matrix::createRotation(p->_rotationAxis, p->_rotationSpeed * elapsedSecs);
-
-          _rotation.transformPoint(p->_velocity, &p->_velocity);
-          _rotation.transformPoint(p->_acceleration, &p->_acceleration);
-        }
-
-        // Particle is still alive.
-        p->_velocity.x += p->_acceleration.x * elapsedSecs;
-        p->_velocity.y += p->_acceleration.y * elapsedSecs;
-        p->_velocity.z += p->_acceleration.z * elapsedSecs;
-
-        p->_position.x += p->_velocity.x * elapsedSecs;
-        p->_position.y += p->_velocity.y * elapsedSecs;
-        p->_position.z += p->_velocity.z * elapsedSecs;
-
-        p->_angle += p->_rotationPerParticleSpeed * elapsedSecs;
-
-        // Simple linear interpolation of color and size.
-        float percent = 1.0f - ((float)p->_energy / (float)p->_energyStart);
-
-        p->_color.x = p->_colorStart.x + (p->_colorEnd.x - p->_colorStart.x) * percent;
-        p->_color.y = p->_colorStart.y + (p->_colorEnd.y - p->_colorStart.y) * percent;
-        p->_color.z = p->_colorStart.z + (p->_colorEnd.z - p->_colorStart.z) * percent;
-        p->_color.w = p->_colorStart.w + (p->_colorEnd.w - p->_colorStart.w) * percent;
-
-        p->_size = p->_sizeStart + (p->_sizeEnd - p->_sizeStart) * percent;
-
-        // Handle sprite animations.
-        if (_spriteAnimated)
-        {
-          if (!_spriteLooped)
+          float percentSpent = pool->_frame[i] * _spritePercentPerFrame;
+          pool->_timeOnCurrentFrame[i] = pool->_percent[i] - percentSpent;
+          if (pool->_frame[i] < _spriteFrameCount - 1 &&
+            pool->_timeOnCurrentFrame[i] >= _spritePercentPerFrame)
           {
-            // The last frame should finish exactly when the particle dies.
-            float percentSpent = 0.0f;
-            for (unsigned int i = 0; i < p->_frame; i++)
-            {
-              percentSpent += _spritePercentPerFrame;
-            }
-            p->_timeOnCurrentFrame = percent - percentSpent;
-            if (p->_frame < _spriteFrameCount - 1 &&
-              p->_timeOnCurrentFrame >= _spritePercentPerFrame)
-            {
-              ++p->_frame;
-            }
-          }
-          else
-          {
-            // _spriteFrameDurationSecs is an absolute time measured in seconds,
-            // and the animation repeats indefinitely.
-            p->_timeOnCurrentFrame += elapsedSecs;
-            if (p->_timeOnCurrentFrame >= _spriteFrameDurationSecs)
-            {
-              p->_timeOnCurrentFrame -= _spriteFrameDurationSecs;
-              ++p->_frame;
-              if (p->_frame == _spriteFrameCount)
-              {
-                p->_frame = 0;
-              }
-            }
+            ++pool->_frame[i];
           }
         }
       }
       else
       {
-        // Particle is dead.  Move the particle furthest from the start of the array
-        // down to take its place, and re-use the slot at the end of the list of living particles.
-        if (particlesIndex != _particleCount - 1)
+        // _spriteFrameDurationSecs is an absolute time measured in seconds,
+        // and the animation repeats indefinitely.
+        for (unsigned int i = 0; i < count; ++i)
         {
-          _particles[particlesIndex] = _particles[_particleCount - 1];
+          pool->_timeOnCurrentFrame[i] += elapsedSecs;
+          if (pool->_timeOnCurrentFrame[i] >= _spriteFrameDurationSecs)
+          {
+            pool->_timeOnCurrentFrame[i] -= _spriteFrameDurationSecs;
+            ++pool->_frame[i];
+            if (pool->_frame[i] == _spriteFrameCount)
+            {
+              pool->_frame[i] = 0;
+            }
+          }
         }
-        --_particleCount;
       }
     }
+
+    // Recycle the slots of particles that ran out of energy.
+    pool->removeDead();
   }
 
   unsigned int ParticleEmitter::draw(bool wireframe)
@@ -984,7 +1020,8 @@ namespace gameplay
     if (!isActive())
       return 0;
 
-    if (_particleCount > 0)
+    unsigned int count = _particles->getCount();
+    if (count > 0)
     {
       assert(_spriteBatch);
       assert(_particles);
@@ -1009,13 +1046,16 @@ namespace gameplay
       Vector3 right = cameraWorldMatrix.getRightVector();
       Vector3 up = cameraWorldMatrix.getUpVector();
 
-      for (unsigned int i = 0; i < _particleCount; i++)
+      const ParticlePool* pool = _particles;
+      for (unsigned int i = 0; i < count; i++)
       {
-        Particle* p = &_particles[i];
+        Vector3 position(pool->_positionX[i], pool->_positionY[i], pool->_positionZ[i]);
+        Vector4 color(pool->_colorR[i], pool->_colorG[i], pool->_colorB[i], pool->_colorA[i]);
+        const float* texCoords = &_spriteTextureCoords[pool->_frame[i] * 4];
 
-        _spriteBatch->draw(p->_position, right, up, p->_size, p->_size,
-          _spriteTextureCoords[p->_frame * 4], _spriteTextureCoords[p->_frame * 4 + 1], _spriteTextureCoords[p->_frame * 4 + 2], _spriteTextureCoords[p->_frame * 4 + 3],
-          p->_color, pivot, p->_angle);
+        _spriteBatch->draw(position, right, up, pool->_size[i], pool->_size[i],
+          texCoords[0], texCoords[1], texCoords[2], texCoords[3],
+          color, pivot, pool->_angle[i]);
       }
 
       // Render.
@@ -9,6 +9,7 @@
 #include "graphics/SpriteBatch.h"
 #include "scene/Properties.h"
 #include "graphics/Drawable.h"
+#include "graphics/ParticlePool.h"
 
 namespace gameplay
 {
@@ -141,6 +142,7 @@ namespace gameplay
   class ParticleEmitter : public Ref, public Drawable
   {
     friend class Node;
+    friend class ParticleSystemManager;
 
   public:
 
@@ -291,6 +293,26 @@ namespace gameplay
      */
     unsigned int getParticlesCount() const;
 
+    /**
+     * Gets the particles of the emitter's system.
+     *
+     * The living particles occupy the first getParticlesCount() slots of the pool.
+     *
+     * @return The particle pool.
+     */
+    const ParticlePool* getParticles() const;
+
+    /**
+     * Seeds the random number generator used to assign properties to new particles.
+     *
+     * Each emitter owns its own generator, so the particles it emits only depend
+     * on its seed and not on other emitters or on the order in which emitters
+     * are updated. Emitters are seeded by default in the order they are created.
+     *
+     * @param seed The new seed.
+     */
+    void setRandomSeed(unsigned int seed);
+
     /**
      * Sets whether the positions of newly emitted particles are generated within an ellipsoidal domain.
      *
@@ -713,10 +735,12 @@ namespace gameplay
      */
     unsigned int draw(bool wireframe = false);
 
-  private:
+  protected:
 
     /**
      * Constructor.
+     *
+     * The emitter has no texture until setTexture() is called, so it can be updated but not drawn.
      */
     ParticleEmitter(unsigned int particlesCount);
 
@@ -725,6 +749,8 @@ namespace gameplay
      */
     ~ParticleEmitter();
 
+  private:
+
     /**
      * @see Drawable::clone
      */
@@ -745,6 +771,21 @@ namespace gameplay
      */
     ParticleEmitter& operator=(const ParticleEmitter&);
 
+    // Emits particles relative to the given world transform.
+    void emit(unsigned int particleCount, const Matrix& worldMatrix);
+
+    // Advances the emitter, emitting new particles relative to the given world transform.
+    void simulate(float elapsedTime, const Matrix& world);
+
+    // Generates the next value of this emitter's random number generator.
+    unsigned int generateRandom();
+
+    // Generates a random float between 0 and 1.
+    float generateRandom01();
+
+    // Generates a random float between -1 and 1.
+    float generateRandomMinus1To1();
+
     // Generates a scalar within the range defined by min and max.
     float generateScalar(float min, float max);
 
@@ -764,35 +805,8 @@ namespace gameplay
     // Gets the blend mode from string.
     static ParticleEmitter::BlendMode getBlendModeFromString(const char* src);
 
-    /**
-     * Defines the data for a single particle in the system.
-     */
-    class Particle
-    {
-
-    public:
-      Vector3 _position;
-      Vector3 _velocity;
-      Vector3 _acceleration;
-      Vector4 _colorStart;
-      Vector4 _colorEnd;
-      Vector4 _color;
-      float _rotationPerParticleSpeed;
-      Vector3 _rotationAxis;
-      float _rotationSpeed;
-      float _angle;
-      long _energyStart;
-      long _energy;
-      float _sizeStart;
-      float _sizeEnd;
-      float _size;
-      unsigned int _frame;
-      float _timeOnCurrentFrame;
-    };
-
     unsigned int _particleCountMax;
-    unsigned int _particleCount;
-    Particle* _particles;
+    ParticlePool* _particles;
     unsigned int _emissionRate;
     bool _started;
     bool _ellipsoid;
@@ -818,7 +832,6 @@ namespace gameplay
     float _rotationSpeedMax;
     Vector3 _rotationAxis;
     Vector3 _rotationAxisVar;
-    Matrix _rotation;
     SpriteBatch* _spriteBatch;
     BlendMode _spriteBlendMode;
     float _spriteTextureWidth;
@@ -838,7 +851,8 @@ namespace gameplay
     bool _orbitAcceleration;
     float _timePerEmission;
     float _emitTime;
-    double _lastUpdated;
+    float _updateTime;
+    unsigned int _randomState;
   };
 
 }
@@ -0,0 +1,229 @@
+#include "framework/Base.h"
+#include "graphics/ParticlePool.h"
+#include "math/MathUtil.h"
+
+// Number of float attribute arrays in a pool
+#define PARTICLE_STREAM_COUNT 34
+
+namespace gameplay
+{
+
+  // dst[i] += src[i] * scale
+  static void multiplyAdd(float* dst, const float* src, float scale, unsigned int count)
+  {
+    unsigned int i = 0;
+#ifdef GP_USE_SSE
+    __m128 s = _mm_set1_ps(scale);
+    for (; i + 4 <= count; i += 4)
+    {
+      _mm_storeu_ps(&dst[i], _mm_add_ps(_mm_loadu_ps(&dst[i]), _mm_mul_ps(_mm_loadu_ps(&src[i]), s)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+      dst[i] += src[i] * scale;
+    }
+  }
+
+  // dst[i] = start[i] + (end[i] - start[i]) * t[i]
+  static void interpolate(float* dst, const float* start, const float* end, const float* t, unsigned int count)
+  {
+    unsigned int i = 0;
+#ifdef GP_USE_SSE
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128 a = _mm_loadu_ps(&start[i]);
+      __m128 d = _mm_sub_ps(_mm_loadu_ps(&end[i]), a);
+      _mm_storeu_ps(&dst[i], _mm_add_ps(a, _mm_mul_ps(d, _mm_loadu_ps(&t[i]))));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+      dst[i] = start[i] + (end[i] - start[i]) * t[i];
+    }
+  }
+
+  // energy[i] -= elapsed, percent[i] = 1 - energy[i] / energyStart[i]
+  static void decayEnergy(float* energy, const float* energyStart, float* percent, float elapsed, unsigned int count)
+  {
+    unsigned int i = 0;
+#ifdef GP_USE_SSE
+    __m128 e = _mm_set1_ps(elapsed);
+    __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+      __m128 v = _mm_sub_ps(_mm_loadu_ps(&energy[i]), e);
+      _mm_storeu_ps(&energy[i], v);
+      _mm_storeu_ps(&percent[i], _mm_sub_ps(one, _mm_div_ps(v, _mm_loadu_ps(&energyStart[i]))));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+      energy[i] -= elapsed;
+      percent[i] = 1.0f - energy[i] / energyStart[i];
+    }
+  }
+
+  ParticlePool::ParticlePool(unsigned int capacity)
+    : _capacity(capacity), _stride((capacity + 3) & ~3u), _count(0), _data(nullptr)
+  {
+    assert(capacity);
+
+    // All float attributes share a single allocation, each one starting on a
+    // 16-byte boundary relative to the start of the block.
+    _data = new float[_stride * PARTICLE_STREAM_COUNT];
+    float* streams[PARTICLE_STREAM_COUNT];
+    for (unsigned int i = 0; i < PARTICLE_STREAM_COUNT; ++i)
+    {
+      streams[i] = _data + i * _stride;
+    }
+    _positionX = streams[0];
+    _positionY = streams[1];
+    _positionZ = streams[2];
+    _velocityX = streams[3];
+    _velocityY = streams[4];
+    _velocityZ = streams[5];
+    _accelerationX = streams[6];
+    _accelerationY = streams[7];
+    _accelerationZ = streams[8];
+    _colorStartR = streams[9];
+    _colorStartG = streams[10];
+    _colorStartB = streams[11];
+    _colorStartA = streams[12];
+    _colorEndR = streams[13];
+    _colorEndG = streams[14];
+    _colorEndB = streams[15];
+    _colorEndA = streams[16];
+    _colorR = streams[17];
+    _colorG = streams[18];
+    _colorB = streams[19];
+    _colorA = streams[20];
+    _sizeStart = streams[21];
+    _sizeEnd = streams[22];
+    _size = streams[23];
+    _energyStart = streams[24];
+    _energy = streams[25];
+    _percent = streams[26];
+    _angle = streams[27];
+    _rotationPerParticleSpeed = streams[28];
+    _rotationSpeed = streams[29];
+    _rotationAxisX = streams[30];
+    _rotationAxisY = streams[31];
+    _rotationAxisZ = streams[32];
+    _timeOnCurrentFrame = streams[33];
+    _frame = new unsigned int[_stride];
+  }
+
+  ParticlePool::~ParticlePool()
+  {
+    SAFE_DELETE_ARRAY(_data);
+    SAFE_DELETE_ARRAY(_frame);
+  }
+
+  unsigned int ParticlePool::getCapacity() const
+  {
+    return _capacity;
+  }
+
+  unsigned int ParticlePool::getCount() const
+  {
+    return _count;
+  }
+
+  unsigned int ParticlePool::add()
+  {
+    assert(_count < _capacity);
+    return _count++;
+  }
+
+  void ParticlePool::remove(unsigned int index)
+  {
+    assert(index < _count);
+
+    unsigned int last = _count - 1;
+    if (index != last)
+    {
+      for (unsigned int i = 0; i < PARTICLE_STREAM_COUNT; ++i)
+      {
+        float* stream = _data + i * _stride;
+        stream[index] = stream[last];
+      }
+      _frame[index] = _frame[last];
+    }
+    --_count;
+  }
+
+  void ParticlePool::removeDead()
+  {
+    unsigned int i = 0;
+    while (i < _count)
+    {
+      // The particle moved into this slot still needs to be checked.
+      if (_energy[i] <= 0.0f)
+        remove(i);
+      else
+        ++i;
+    }
+  }
+
+  void ParticlePool::clear()
+  {
+    _count = 0;
+  }
+
+  void ParticlePool::update(float elapsedTime)
+  {
+    if (_count == 0)
+      return;
+
+    float elapsedSecs = elapsedTime * 0.001f;
+
+    decayEnergy(_energy, _energyStart, _percent, elapsedTime, _count);
+
+    // Rotate velocity and acceleration around the (normalized) rotation axis
+    // using Rodrigues' formula, which avoids building a matrix per particle.
+    for (unsigned int i = 0; i < _count; ++i)
+    {
+      if (_rotationSpeed[i] == 0.0f)
+        continue;
+
+      float angle = _rotationSpeed[i] * elapsedSecs;
+      float c = cos(angle);
+      float s = sin(angle);
+      float t = 1.0f - c;
+      float kx = _rotationAxisX[i];
+      float ky = _rotationAxisY[i];
+      float kz = _rotationAxisZ[i];
+
+      float vx = _velocityX[i], vy = _velocityY[i], vz = _velocityZ[i];
+      float dot = (kx * vx + ky * vy + kz * vz) * t;
+      _velocityX[i] = vx * c + (ky * vz - kz * vy) * s + kx * dot;
+      _velocityY[i] = vy * c + (kz * vx - kx * vz) * s + ky * dot;
+      _velocityZ[i] = vz * c + (kx * vy - ky * vx) * s + kz * dot;
+
+      float ax = _accelerationX[i], ay = _accelerationY[i], az = _accelerationZ[i];
+      dot = (kx * ax + ky * ay + kz * az) * t;
+      _accelerationX[i] = ax * c + (ky * az - kz * ay) * s + kx * dot;
+      _accelerationY[i] = ay * c + (kz * ax - kx * az) * s + ky * dot;
+      _accelerationZ[i] = az * c + (kx * ay - ky * ax) * s + kz * dot;
+    }
+
+    multiplyAdd(_velocityX, _accelerationX, elapsedSecs, _count);
+    multiplyAdd(_velocityY, _accelerationY, elapsedSecs, _count);
+    multiplyAdd(_velocityZ, _accelerationZ, elapsedSecs, _count);
+
+    multiplyAdd(_positionX, _velocityX, elapsedSecs, _count);
+    multiplyAdd(_positionY, _velocityY, elapsedSecs, _count);
+    multiplyAdd(_positionZ, _velocityZ, elapsedSecs, _count);
+
+    multiplyAdd(_angle, _rotationPerParticleSpeed, elapsedSecs, _count);
+
+    // Simple linear interpolation of color and size.
+    interpolate(_colorR, _colorStartR, _colorEndR, _percent, _count);
+    interpolate(_colorG, _colorStartG, _colorEndG, _percent, _count);
+    interpolate(_colorB, _colorStartB, _colorEndB, _percent, _count);
+    interpolate(_colorA, _colorStartA, _colorEndA, _percent, _count);
+    interpolate(_size, _sizeStart, _sizeEnd, _percent, _count);
+  }
+
+}
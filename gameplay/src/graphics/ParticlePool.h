@@ -0,0 +1,142 @@
+#pragma once
+
+namespace gameplay
+{
+
+  /**
+   * Defines a fixed-capacity pool of particles stored as a structure of arrays.
+   *
+   * Every particle attribute is kept in its own contiguous float array, so the
+   * per-frame simulation (energy decay, integration and color/size
+   * interpolation) runs as a handful of vectorized passes over the whole pool
+   * instead of touching one large particle record at a time.
+   *
+   * Living particles always occupy the range [0, getCount()). Dead particles
+   * are removed by moving the last living particle into their slot.
+   *
+   * This is primarily used by ParticleEmitter.
+   */
+  class ParticlePool
+  {
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param capacity The maximum number of particles that can be alive at once.
+     */
+    ParticlePool(unsigned int capacity);
+
+    /**
+     * Destructor.
+     */
+    ~ParticlePool();
+
+    /**
+     * Gets the maximum number of particles that can be alive at once.
+     *
+     * @return The capacity of the pool.
+     */
+    unsigned int getCapacity() const;
+
+    /**
+     * Gets the number of living particles.
+     *
+     * @return The number of living particles.
+     */
+    unsigned int getCount() const;
+
+    /**
+     * Appends a particle to the pool.
+     *
+     * The attributes of the new particle are left uninitialized.
+     *
+     * @return The index of the new particle.
+     */
+    unsigned int add();
+
+    /**
+     * Removes the particle at the specified index by moving the last living
+     * particle into its slot.
+     *
+     * @param index The index of the particle to remove.
+     */
+    void remove(unsigned int index);
+
+    /**
+     * Removes all particles whose energy has run out.
+     */
+    void removeDead();
+
+    /**
+     * Removes all particles.
+     */
+    void clear();
+
+    /**
+     * Advances all living particles.
+     *
+     * Decreases particle energy, rotates velocities and accelerations around
+     * each particle's rotation axis, integrates velocities and positions,
+     * advances the sprite angle and interpolates color and size by the
+     * fraction of energy spent. Dead particles are not removed.
+     *
+     * @param elapsedTime The elapsed time, in milliseconds.
+     */
+    void update(float elapsedTime);
+
+    float* _positionX;
+    float* _positionY;
+    float* _positionZ;
+    float* _velocityX;
+    float* _velocityY;
+    float* _velocityZ;
+    float* _accelerationX;
+    float* _accelerationY;
+    float* _accelerationZ;
+    float* _colorStartR;
+    float* _colorStartG;
+    float* _colorStartB;
+    float* _colorStartA;
+    float* _colorEndR;
+    float* _colorEndG;
+    float* _colorEndB;
+    float* _colorEndA;
+    float* _colorR;
+    float* _colorG;
+    float* _colorB;
+    float* _colorA;
+    float* _sizeStart;
+    float* _sizeEnd;
+    float* _size;
+    float* _energyStart;
+    float* _energy;
+    float* _percent;
+    float* _angle;
+    float* _rotationPerParticleSpeed;
+    float* _rotationSpeed;
+    float* _rotationAxisX;
+    float* _rotationAxisY;
+    float* _rotationAxisZ;
+    float* _timeOnCurrentFrame;
+    unsigned int* _frame;
+
+  private:
+
+    /**
+     * Hidden copy constructor.
+     */
+    ParticlePool(const ParticlePool& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    ParticlePool& operator=(const ParticlePool&);
+
+    unsigned int _capacity;
+    unsigned int _stride;
+    unsigned int _count;
+    float* _data;
+  };
+
+}
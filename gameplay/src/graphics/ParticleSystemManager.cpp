@@ -0,0 +1,68 @@
+#include "framework/Base.h"
+#include "graphics/ParticleSystemManager.h"
+#include "scene/Scene.h"
+#include "framework/Game.h"
+
+namespace gameplay
+{
+
+  ParticleSystemManager::ParticleSystemManager(Scene* scene, JobSystem* jobSystem)
+    : _scene(scene), _jobSystem(jobSystem)
+  {
+    assert(scene);
+    assert(jobSystem);
+    _scene->addRef();
+  }
+
+  ParticleSystemManager::~ParticleSystemManager()
+  {
+    SAFE_RELEASE(_scene);
+  }
+
+  ParticleSystemManager* ParticleSystemManager::create(Scene* scene, JobSystem* jobSystem)
+  {
+    if (!jobSystem)
+    {
+      jobSystem = Game::getInstance()->getJobSystem();
+    }
+    return new ParticleSystemManager(scene, jobSystem);
+  }
+
+  Scene* ParticleSystemManager::getScene() const
+  {
+    return _scene;
+  }
+
+  unsigned int ParticleSystemManager::getEmitterCount() const
+  {
+    return (unsigned int)_emitters.size();
+  }
+
+  void ParticleSystemManager::update(float elapsedTime)
+  {
+    // Gather emitters and resolve their transforms on this thread, since
+    // world matrices are computed lazily and must not be touched concurrently.
+    _emitters.clear();
+    _worldMatrices.clear();
+    _scene->visit(this, &ParticleSystemManager::collectEmitter);
+
+    ParticleEmitter** emitters = _emitters.data();
+    const Matrix* worldMatrices = _worldMatrices.data();
+    _jobSystem->parallelFor((unsigned int)_emitters.size(), [emitters, worldMatrices, elapsedTime](unsigned int i)
+    {
+      emitters[i]->simulate(elapsedTime, worldMatrices[i]);
+    });
+  }
+
+  bool ParticleSystemManager::collectEmitter(Node* node)
+  {
+    ParticleEmitter* emitter = dynamic_cast<ParticleEmitter*>(node->getDrawable());
+    if (emitter && emitter->isActive())
+    {
+      _emitters.push_back(emitter);
+      _worldMatrices.push_back(node->getWorldMatrix());
+    }
+    return true;
+  }
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "graphics/ParticleEmitter.h"
+#include "framework/JobSystem.h"
+
+namespace gameplay
+{
+
+  class Scene;
+
+  /**
+   * Defines a manager that simulates all of the particle emitters in a scene in parallel.
+   *
+   * Each call to update() collects the ParticleEmitter drawables attached to
+   * nodes of the scene, snapshots their world transforms on the calling thread
+   * and then simulates the emitters concurrently on a job system.
+   * Emitters do not share any mutable state while simulating (each one owns its
+   * particle pool and random number generator), so the result is the same as
+   * updating them one after the other. Once update() returns, the emitters are
+   * drawn as usual with ParticleEmitter::draw().
+   *
+   * Emitters in a managed scene must not also be updated manually with
+   * ParticleEmitter::update(), otherwise they advance twice per frame.
+   */
+  class ParticleSystemManager : public Ref
+  {
+  public:
+
+    /**
+     * Creates a particle system manager for the specified scene.
+     *
+     * @param scene The scene whose emitters are updated.
+     * @param jobSystem The job system to simulate emitters on, or nullptr to
+     *        use the game's job system. Only its parallelFor() is used, so
+     *        emitters are simulated on the workers and the calling thread.
+     * @return The new manager.
+     * @script{create}
+     */
+    static ParticleSystemManager* create(Scene* scene, JobSystem* jobSystem = nullptr);
+
+    /**
+     * Gets the scene whose emitters are updated.
+     *
+     * @return The scene.
+     */
+    Scene* getScene() const;
+
+    /**
+     * Gets the number of emitters that were simulated by the last update.
+     *
+     * @return The number of simulated emitters.
+     */
+    unsigned int getEmitterCount() const;
+
+    /**
+     * Updates all active particle emitters in the scene.
+     *
+     * @param elapsedTime The amount of time that has passed since the last call to update(), in milliseconds.
+     */
+    void update(float elapsedTime);
+
+  private:
+
+    /**
+     * Constructor.
+     */
+    ParticleSystemManager(Scene* scene, JobSystem* jobSystem);
+
+    /**
+     * Destructor.
+     */
+    ~ParticleSystemManager();
+
+    /**
+     * Hidden copy constructor.
+     */
+    ParticleSystemManager(const ParticleSystemManager& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    ParticleSystemManager& operator=(const ParticleSystemManager&);
+
+    /**
+     * Collects the emitter attached to the given node, if any.
+     */
+    bool collectEmitter(Node* node);
+
+    Scene* _scene;
+    JobSystem* _jobSystem;
+    std::vector<ParticleEmitter*> _emitters;
+    std::vector<Matrix> _worldMatrices;
+  };
+
+}
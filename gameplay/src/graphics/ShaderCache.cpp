@@ -0,0 +1,321 @@
+#include "framework/Base.h"
+#include "graphics/ShaderCache.h"
+#include "framework/FileSystem.h"
+#include "framework/Stream.h"
+
+// Signature and version of cache entries
+#define SHADER_CACHE_SIGNATURE          "GPSC"
+#define SHADER_CACHE_VERSION            1
+#define SHADER_CACHE_EXTENSION          ".program"
+
+namespace gameplay
+{
+
+  ShaderCache::Entry::Entry() : binaryFormat(0)
+  {
+  }
+
+  ShaderCache::ShaderCache(const char* directory)
+    : _directory(directory)
+  {
+    assert(directory);
+
+    if (!_directory.empty() && _directory[_directory.length() - 1] != '/')
+      _directory += '/';
+    if (!_directory.empty())
+      FileSystem::createDirectory(_directory.c_str());
+  }
+
+  ShaderCache::~ShaderCache()
+  {
+  }
+
+  const char* ShaderCache::getDirectory() const
+  {
+    return _directory.c_str();
+  }
+
+  std::string ShaderCache::expandDefines(const char* globalDefines, const char* defines)
+  {
+    // Build full semicolon delimited list of defines
+    std::string out;
+    if (globalDefines && strlen(globalDefines) > 0)
+    {
+      out += globalDefines;
+    }
+    if (defines && strlen(defines) > 0)
+    {
+      if (out.length() > 0)
+        out += ';';
+      out += defines;
+    }
+
+    // Replace semicolons
+    if (out.length() > 0)
+    {
+      size_t pos;
+      out.insert(0, "#define ");
+      while ((pos = out.find(';')) != std::string::npos)
+      {
+        out.replace(pos, 1, "\n#define ");
+      }
+      out += "\n";
+    }
+    return out;
+  }
+
+  const std::string* ShaderCache::SourceFiles::read(const std::string& path)
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      std::unordered_map<std::string, std::unique_ptr<std::string> >::const_iterator itr = _files.find(path);
+      if (itr != _files.end())
+        return itr->second.get();
+    }
+
+    // Read outside the lock so other files can be read meanwhile. If two threads read the same file, the first one is kept.
+    int size = 0;
+    char* contents = FileSystem::fileExists(path.c_str()) ? FileSystem::readAll(path.c_str(), &size) : nullptr;
+    std::unique_ptr<std::string> file(contents ? new std::string(contents, size) : nullptr);
+    SAFE_DELETE_ARRAY(contents);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _files.emplace(path, std::move(file)).first->second.get();
+  }
+
+  bool ShaderCache::expandIncludes(const char* path, const char* source, std::string& out, SourceFiles* files)
+  {
+    assert(path);
+    assert(source);
+
+    // Replace the #include "xxxx.xxx" with the sourced file contents of "path/xxxx.xxx"
+    std::string str = source;
+    size_t lastPos = 0;
+    size_t headPos;
+    while ((headPos = str.find("#include", lastPos)) != std::string::npos)
+    {
+      // Append everything up to the "#include"
+      out.append(str, lastPos, headPos - lastPos);
+
+      // Find the quoted file name
+      size_t startQuote = str.find('"', headPos);
+      if (startQuote == std::string::npos)
+      {
+        GP_ERROR("Compile failed for shader '%s' missing leading \".", path);
+        return false;
+      }
+      ++startQuote;
+      size_t endQuote = str.find('"', startQuote);
+      if (endQuote == std::string::npos)
+      {
+        GP_ERROR("Compile failed for shader '%s' missing trailing \".", path);
+        return false;
+      }
+      lastPos = endQuote + 1;
+
+      // Source the file relative to the directory of the including file, expanding its includes too
+      std::string includePath = path;
+      includePath = includePath.substr(0, includePath.rfind('/') + 1);
+      includePath.append(str, startQuote, endQuote - startQuote);
+      bool expanded;
+      if (files)
+      {
+        const std::string* includedSource = files->read(includePath);
+        expanded = includedSource && expandIncludes(includePath.c_str(), includedSource->c_str(), out, files);
+      }
+      else
+      {
+        char* includedSource = FileSystem::readAll(includePath.c_str());
+        expanded = includedSource && expandIncludes(includePath.c_str(), includedSource, out);
+        SAFE_DELETE_ARRAY(includedSource);
+      }
+      if (!expanded)
+      {
+        GP_ERROR("Compile failed for shader '%s' invalid filepath.", path);
+        return false;
+      }
+    }
+
+    // Append the remaining
+    out.append(str, lastPos, std::string::npos);
+    return true;
+  }
+
+  bool ShaderCache::preprocess(const char* path, const char* source, const std::string& defines, std::string& out, SourceFiles* files)
+  {
+    assert(source);
+
+    out = defines;
+    if (!path)
+    {
+      out += source;
+      return true;
+    }
+    if (!expandIncludes(path, source, out, files))
+      return false;
+    if (strlen(source) != 0)
+      out += "\n";
+    return true;
+  }
+
+  unsigned long long ShaderCache::hash(const void* data, size_t length, unsigned long long seed)
+  {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    unsigned long long h = seed;
+    for (size_t i = 0; i < length; ++i)
+    {
+      h ^= bytes[i];
+      h *= 1099511628211ULL;
+    }
+    return h;
+  }
+
+  unsigned long long ShaderCache::computeKey(const std::string& vertexSource, const std::string& fragmentSource, const char* driver)
+  {
+    // Hash the lengths too, so that moving text from one string to the next changes the key.
+    unsigned long long lengths[3] = { vertexSource.length(), fragmentSource.length(), driver ? strlen(driver) : 0 };
+    unsigned long long key = hash(lengths, sizeof(lengths));
+    key = hash(vertexSource.c_str(), vertexSource.length(), key);
+    key = hash(fragmentSource.c_str(), fragmentSource.length(), key);
+    if (driver)
+      key = hash(driver, lengths[2], key);
+    return key;
+  }
+
+  std::string ShaderCache::getEntryPath(unsigned long long key) const
+  {
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", key);
+    std::string path = _directory;
+    path += name;
+    path += SHADER_CACHE_EXTENSION;
+    return path;
+  }
+
+  bool ShaderCache::contains(unsigned long long key) const
+  {
+    return FileSystem::fileExists(getEntryPath(key).c_str());
+  }
+
+  static void writeUInt(std::vector<unsigned char>& data, unsigned int value)
+  {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(value));
+  }
+
+  static void writeString(std::vector<unsigned char>& data, const char* str, size_t length)
+  {
+    writeUInt(data, (unsigned int)length);
+    data.insert(data.end(), str, str + length);
+  }
+
+  static bool readUInt(const unsigned char*& ptr, const unsigned char* end, unsigned int* value)
+  {
+    if ((size_t)(end - ptr) < sizeof(unsigned int))
+      return false;
+    memcpy(value, ptr, sizeof(unsigned int));
+    ptr += sizeof(unsigned int);
+    return true;
+  }
+
+  static bool readString(const unsigned char*& ptr, const unsigned char* end, const char** str, unsigned int* length)
+  {
+    if (!readUInt(ptr, end, length) || *length > (size_t)(end - ptr))
+      return false;
+    *str = reinterpret_cast<const char*>(ptr);
+    ptr += *length;
+    return true;
+  }
+
+  bool ShaderCache::save(unsigned long long key, const char* driver, const Entry& entry)
+  {
+    if (_directory.empty())
+      return false;
+
+    std::vector<unsigned char> data;
+    data.reserve(64 + entry.vertexSource.length() + entry.fragmentSource.length() + entry.binary.size());
+    data.insert(data.end(), SHADER_CACHE_SIGNATURE, SHADER_CACHE_SIGNATURE + 4);
+    writeUInt(data, SHADER_CACHE_VERSION);
+    data.insert(data.end(), reinterpret_cast<const unsigned char*>(&key), reinterpret_cast<const unsigned char*>(&key) + sizeof(key));
+    writeString(data, driver ? driver : "", driver ? strlen(driver) : 0);
+    writeString(data, entry.vertexSource.c_str(), entry.vertexSource.length());
+    writeString(data, entry.fragmentSource.c_str(), entry.fragmentSource.length());
+    writeUInt(data, entry.binaryFormat);
+    writeUInt(data, (unsigned int)entry.binary.size());
+    data.insert(data.end(), entry.binary.begin(), entry.binary.end());
+
+    // A checksum of everything before it catches entries that were only partly written.
+    unsigned long long checksum = hash(data.data(), data.size());
+    data.insert(data.end(), reinterpret_cast<const unsigned char*>(&checksum), reinterpret_cast<const unsigned char*>(&checksum) + sizeof(checksum));
+
+    std::string path = getEntryPath(key);
+    std::unique_ptr<Stream> stream(FileSystem::open(path.c_str(), FileSystem::WRITE));
+    if (stream.get() == nullptr || stream->write(data.data(), 1, data.size()) != data.size())
+    {
+      GP_WARN("Failed to write shader cache entry '%s'.", path.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  bool ShaderCache::load(unsigned long long key, const char* driver, const std::string& vertexSource, const std::string& fragmentSource, Entry* entry) const
+  {
+    assert(entry);
+
+    if (_directory.empty())
+      return false;
+
+    std::string path = getEntryPath(key);
+    if (!FileSystem::fileExists(path.c_str()))
+      return false;
+    int size = 0;
+    char* contents = FileSystem::readAll(path.c_str(), &size);
+    if (contents == nullptr)
+      return false;
+    std::unique_ptr<char[]> data(contents);
+
+    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(contents);
+    const unsigned char* end = ptr + size;
+    unsigned long long checksum;
+    if ((size_t)size < 4 + sizeof(unsigned int) + sizeof(key) + sizeof(checksum) || memcmp(ptr, SHADER_CACHE_SIGNATURE, 4) != 0)
+      return false;
+    end -= sizeof(checksum);
+    memcpy(&checksum, end, sizeof(checksum));
+    if (checksum != hash(ptr, end - ptr))
+    {
+      GP_WARN("Ignoring corrupt shader cache entry '%s'.", path.c_str());
+      return false;
+    }
+    ptr += 4;
+
+    unsigned int version;
+    unsigned long long entryKey;
+    readUInt(ptr, end, &version);
+    memcpy(&entryKey, ptr, sizeof(entryKey));
+    ptr += sizeof(entryKey);
+    if (version != SHADER_CACHE_VERSION || entryKey != key)
+      return false;
+
+    // The key is only a hash, so compare everything it was computed from.
+    const char* str;
+    unsigned int length;
+    size_t driverLength = driver ? strlen(driver) : 0;
+    if (!readString(ptr, end, &str, &length) || length != driverLength || (length > 0 && memcmp(str, driver, length) != 0))
+      return false;
+    if (!readString(ptr, end, &str, &length) || vertexSource.compare(0, std::string::npos, str, length) != 0)
+      return false;
+    if (!readString(ptr, end, &str, &length) || fragmentSource.compare(0, std::string::npos, str, length) != 0)
+      return false;
+
+    unsigned int binaryFormat, binaryLength;
+    if (!readUInt(ptr, end, &binaryFormat) || !readUInt(ptr, end, &binaryLength) || binaryLength != (size_t)(end - ptr))
+      return false;
+
+    entry->vertexSource = vertexSource;
+    entry->fragmentSource = fragmentSource;
+    entry->binaryFormat = binaryFormat;
+    entry->binary.assign(ptr, end);
+    return true;
+  }
+
+}
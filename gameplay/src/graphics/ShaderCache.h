@@ -0,0 +1,222 @@
+#pragma once
+
+namespace gameplay
+{
+
+  /**
+   * Defines a persistent, on-disk cache of compiled shader programs.
+   *
+   * Each program is stored under a key that hashes its fully preprocessed
+   * vertex and fragment source (defines and includes expanded) together with
+   * the driver that compiled it. An entry holds the preprocessed source and,
+   * when the driver supports it, the linked program binary returned by
+   * glGetProgramBinary. Loading the binary back with glProgramBinary skips
+   * compiling and linking on later launches.
+   *
+   * Entries are validated when they are read: the key, driver and source
+   * must match exactly and the binary must pass its checksum, otherwise the
+   * entry is ignored and the program is compiled from source again. A driver
+   * may still reject a valid binary (for example after a driver update with
+   * the same version string), in which case the effect also falls back to
+   * compiling.
+   *
+   * The cache itself makes no graphics calls, so preprocessing, hashing and
+   * reading and writing entries work without a graphics context.
+   *
+   * The game owns a shader cache (see Game::getShaderCache()) when the
+   * "shaderCache" property of the "graphics" namespace in game.config sets
+   * the directory to store it in. Without it, programs are always compiled.
+   *
+   * @script{ignore}
+   */
+  class ShaderCache
+  {
+  public:
+
+    /**
+     * A cached program.
+     */
+    struct Entry
+    {
+      /**
+       * The preprocessed vertex shader source.
+       */
+      std::string vertexSource;
+
+      /**
+       * The preprocessed fragment shader source.
+       */
+      std::string fragmentSource;
+
+      /**
+       * The format of the program binary, as returned by glGetProgramBinary.
+       */
+      unsigned int binaryFormat;
+
+      /**
+       * The program binary, or empty if only the source is cached.
+       */
+      std::vector<unsigned char> binary;
+
+      /**
+       * Constructor.
+       */
+      Entry();
+    };
+
+    /**
+     * Memoizes the shader files read while preprocessing, so that each file
+     * is read once no matter how many shaders use or include it.
+     *
+     * Files may be read from several threads at once.
+     */
+    class SourceFiles
+    {
+    public:
+
+      /**
+       * Reads a file, or returns the contents read earlier.
+       *
+       * @param path The path of the file.
+       *
+       * @return The contents of the file, or nullptr if it could not be read.
+       */
+      const std::string* read(const std::string& path);
+
+    private:
+
+      std::mutex _mutex;
+      std::unordered_map<std::string, std::unique_ptr<std::string> > _files;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param directory The directory to store entries in, relative to the resource path.
+     *      It is created if it does not exist.
+     */
+    ShaderCache(const char* directory);
+
+    /**
+     * Destructor.
+     */
+    ~ShaderCache();
+
+    /**
+     * Gets the directory entries are stored in.
+     *
+     * @return The cache directory.
+     */
+    const char* getDirectory() const;
+
+    /**
+     * Builds the block of #define lines that starts every shader.
+     *
+     * @param globalDefines A semicolon-delimited list of defines applied to every shader. May be nullptr.
+     * @param defines A semicolon-delimited list of defines for this shader. May be nullptr.
+     *
+     * @return One "#define" line per define, or an empty string if there are none.
+     */
+    static std::string expandDefines(const char* globalDefines, const char* defines);
+
+    /**
+     * Replaces each #include "file" in the source with the contents of the file, recursively.
+     *
+     * Included files are found relative to the directory of the including file.
+     *
+     * @param path The path of the file the source was read from.
+     * @param source The shader source.
+     * @param out The string to append the expanded source to.
+     * @param files The files read so far, or nullptr to read every included file.
+     *
+     * @return True if every included file was found, false otherwise.
+     */
+    static bool expandIncludes(const char* path, const char* source, std::string& out, SourceFiles* files = nullptr);
+
+    /**
+     * Builds the full source of a shader: its defines followed by its source with includes expanded.
+     *
+     * @param path The path of the file the source was read from, or nullptr if it was not read from a file.
+     *      Includes are only expanded in sources read from files.
+     * @param source The shader source.
+     * @param defines The #define lines that start the shader (see expandDefines()).
+     * @param out The string to set to the full source.
+     * @param files The files read so far, or nullptr to read every included file.
+     *
+     * @return True if every included file was found, false otherwise.
+     */
+    static bool preprocess(const char* path, const char* source, const std::string& defines, std::string& out, SourceFiles* files = nullptr);
+
+    /**
+     * Computes a 64-bit FNV-1a hash.
+     *
+     * @param data The data to hash.
+     * @param length The number of bytes to hash.
+     * @param seed The hash to continue from, for hashing data in pieces.
+     *
+     * @return The hash.
+     */
+    static unsigned long long hash(const void* data, size_t length, unsigned long long seed = 14695981039346656037ULL);
+
+    /**
+     * Computes the key a program is cached under.
+     *
+     * @param vertexSource The preprocessed vertex shader source.
+     * @param fragmentSource The preprocessed fragment shader source.
+     * @param driver A string identifying the graphics driver, such as its vendor, renderer and version.
+     *
+     * @return The key.
+     */
+    static unsigned long long computeKey(const std::string& vertexSource, const std::string& fragmentSource, const char* driver);
+
+    /**
+     * Checks whether an entry exists for the key, without reading or validating it.
+     *
+     * @param key The key of the program.
+     *
+     * @return True if an entry exists.
+     */
+    bool contains(unsigned long long key) const;
+
+    /**
+     * Reads and validates the entry for a program.
+     *
+     * @param key The key of the program.
+     * @param driver The driver the entry must have been written for.
+     * @param vertexSource The preprocessed vertex source the entry must hold.
+     * @param fragmentSource The preprocessed fragment source the entry must hold.
+     * @param entry The entry to fill.
+     *
+     * @return True if a valid entry was read, false if there is none or it does not match.
+     */
+    bool load(unsigned long long key, const char* driver, const std::string& vertexSource, const std::string& fragmentSource, Entry* entry) const;
+
+    /**
+     * Writes the entry for a program, replacing any existing entry.
+     *
+     * @param key The key of the program.
+     * @param driver The driver the program was compiled by.
+     * @param entry The entry to write. Its binary may be empty.
+     *
+     * @return True if the entry was written.
+     */
+    bool save(unsigned long long key, const char* driver, const Entry& entry);
+
+  private:
+
+    /**
+     * Hidden copy constructor.
+     */
+    ShaderCache(const ShaderCache& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    ShaderCache& operator=(const ShaderCache&);
+
+    std::string getEntryPath(unsigned long long key) const;
+
+    std::string _directory;
+  };
+
+}
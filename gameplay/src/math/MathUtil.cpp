@@ -1,9 +1,211 @@
 #include "framework/Base.h"
 #include "math/MathUtil.h"
 
+// The batched kernels dispatch to AVX at runtime when the CPU supports it.
+#if defined(GP_USE_SSE) && !defined(GP_NO_AVX) && (defined(_MSC_VER) || defined(__GNUC__))
+#define GP_USE_AVX_DISPATCH
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define GP_AVX_TARGET
+#else
+#define GP_AVX_TARGET __attribute__((target("avx")))
+#endif
+#endif
+
 namespace gameplay
 {
 
+#ifdef GP_USE_AVX_DISPATCH
+  GP_AVX_TARGET static void multiplyMatricesAVX(const float* m1, const float* m2, float* dst, unsigned int count)
+  {
+    for (unsigned int i = 0; i < count; ++i, m1 += 16, m2 += 16, dst += 16)
+    {
+      // Columns of m1 are duplicated into both 128-bit lanes, and two columns of
+      // m2 are processed per 256-bit register (one column per lane).
+      __m256 a0 = _mm256_broadcast_ps((const __m128*)&m1[0]);
+      __m256 a1 = _mm256_broadcast_ps((const __m128*)&m1[4]);
+      __m256 a2 = _mm256_broadcast_ps((const __m128*)&m1[8]);
+      __m256 a3 = _mm256_broadcast_ps((const __m128*)&m1[12]);
+      __m256 b01 = _mm256_loadu_ps(&m2[0]);
+      __m256 b23 = _mm256_loadu_ps(&m2[8]);
+
+      __m256 c01 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b01, b01, _MM_SHUFFLE(0, 0, 0, 0)));
+      c01 = _mm256_add_ps(c01, _mm256_mul_ps(a1, _mm256_shuffle_ps(b01, b01, _MM_SHUFFLE(1, 1, 1, 1))));
+      c01 = _mm256_add_ps(c01, _mm256_mul_ps(a2, _mm256_shuffle_ps(b01, b01, _MM_SHUFFLE(2, 2, 2, 2))));
+      c01 = _mm256_add_ps(c01, _mm256_mul_ps(a3, _mm256_shuffle_ps(b01, b01, _MM_SHUFFLE(3, 3, 3, 3))));
+
+      __m256 c23 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b23, b23, _MM_SHUFFLE(0, 0, 0, 0)));
+      c23 = _mm256_add_ps(c23, _mm256_mul_ps(a1, _mm256_shuffle_ps(b23, b23, _MM_SHUFFLE(1, 1, 1, 1))));
+      c23 = _mm256_add_ps(c23, _mm256_mul_ps(a2, _mm256_shuffle_ps(b23, b23, _MM_SHUFFLE(2, 2, 2, 2))));
+      c23 = _mm256_add_ps(c23, _mm256_mul_ps(a3, _mm256_shuffle_ps(b23, b23, _MM_SHUFFLE(3, 3, 3, 3))));
+
+      _mm256_storeu_ps(&dst[0], c01);
+      _mm256_storeu_ps(&dst[8], c23);
+    }
+    _mm256_zeroupper();
+  }
+
+  GP_AVX_TARGET static void transformVectors4AVX(const float* m, const float* vectors, float* dst, unsigned int count)
+  {
+    __m256 c0 = _mm256_broadcast_ps((const __m128*)&m[0]);
+    __m256 c1 = _mm256_broadcast_ps((const __m128*)&m[4]);
+    __m256 c2 = _mm256_broadcast_ps((const __m128*)&m[8]);
+    __m256 c3 = _mm256_broadcast_ps((const __m128*)&m[12]);
+
+    // Two vectors per iteration, one per 128-bit lane (count must be even).
+    for (unsigned int i = 0; i < count; i += 2, vectors += 8, dst += 8)
+    {
+      __m256 v = _mm256_loadu_ps(vectors);
+      __m256 r = _mm256_mul_ps(c0, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+      r = _mm256_add_ps(r, _mm256_mul_ps(c1, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+      r = _mm256_add_ps(r, _mm256_mul_ps(c2, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+      r = _mm256_add_ps(r, _mm256_mul_ps(c3, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+      _mm256_storeu_ps(dst, r);
+    }
+    _mm256_zeroupper();
+  }
+#endif
+
+  bool MathUtil::isAVXSupported()
+  {
+#ifdef GP_USE_AVX_DISPATCH
+    static const bool supported = []()
+    {
+#ifdef _MSC_VER
+      // AVX needs both CPU support and the OS saving the YMM registers.
+      int info[4];
+      __cpuid(info, 1);
+      bool osxsave = (info[2] & (1 << 27)) != 0;
+      bool avx = (info[2] & (1 << 28)) != 0;
+      return osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+#else
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx") != 0;
+#endif
+    }();
+    return supported;
+#else
+    return false;
+#endif
+  }
+
+  void MathUtil::multiplyMatrices(const float* m1, const float* m2, float* dst, unsigned int count)
+  {
+    assert(count == 0 || (m1 && m2 && dst));
+
+#ifdef GP_USE_AVX_DISPATCH
+    if (isAVXSupported())
+    {
+      multiplyMatricesAVX(m1, m2, dst, count);
+      return;
+    }
+#endif
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      multiplyMatrix(m1 + i * 16, m2 + i * 16, dst + i * 16);
+    }
+  }
+
+  void MathUtil::multiplyAffineMatrices(const float* m1, const float* m2, float* dst, unsigned int count)
+  {
+    assert(count == 0 || (m1 && m2 && dst));
+
+    // Both inputs are affine, so the last row of m2 is (0, 0, 0, 1) and only the
+    // first three rows of the product are computed. They are stored row by row.
+#ifdef GP_USE_SSE
+    for (unsigned int i = 0; i < count; ++i, m1 += 16, m2 += 16, dst += 12)
+    {
+      __m128 a0 = _mm_loadu_ps(&m1[0]);
+      __m128 a1 = _mm_loadu_ps(&m1[4]);
+      __m128 a2 = _mm_loadu_ps(&m1[8]);
+      __m128 a3 = _mm_loadu_ps(&m1[12]);
+
+      __m128 b0 = _mm_loadu_ps(&m2[0]);
+      __m128 b1 = _mm_loadu_ps(&m2[4]);
+      __m128 b2 = _mm_loadu_ps(&m2[8]);
+      __m128 b3 = _mm_loadu_ps(&m2[12]);
+
+      __m128 c0 = _mm_mul_ps(a0, _mm_shuffle_ps(b0, b0, _MM_SHUFFLE(0, 0, 0, 0)));
+      c0 = _mm_add_ps(c0, _mm_mul_ps(a1, _mm_shuffle_ps(b0, b0, _MM_SHUFFLE(1, 1, 1, 1))));
+      c0 = _mm_add_ps(c0, _mm_mul_ps(a2, _mm_shuffle_ps(b0, b0, _MM_SHUFFLE(2, 2, 2, 2))));
+
+      __m128 c1 = _mm_mul_ps(a0, _mm_shuffle_ps(b1, b1, _MM_SHUFFLE(0, 0, 0, 0)));
+      c1 = _mm_add_ps(c1, _mm_mul_ps(a1, _mm_shuffle_ps(b1, b1, _MM_SHUFFLE(1, 1, 1, 1))));
+      c1 = _mm_add_ps(c1, _mm_mul_ps(a2, _mm_shuffle_ps(b1, b1, _MM_SHUFFLE(2, 2, 2, 2))));
+
+      __m128 c2 = _mm_mul_ps(a0, _mm_shuffle_ps(b2, b2, _MM_SHUFFLE(0, 0, 0, 0)));
+      c2 = _mm_add_ps(c2, _mm_mul_ps(a1, _mm_shuffle_ps(b2, b2, _MM_SHUFFLE(1, 1, 1, 1))));
+      c2 = _mm_add_ps(c2, _mm_mul_ps(a2, _mm_shuffle_ps(b2, b2, _MM_SHUFFLE(2, 2, 2, 2))));
+
+      __m128 c3 = _mm_add_ps(a3, _mm_mul_ps(a0, _mm_shuffle_ps(b3, b3, _MM_SHUFFLE(0, 0, 0, 0))));
+      c3 = _mm_add_ps(c3, _mm_mul_ps(a1, _mm_shuffle_ps(b3, b3, _MM_SHUFFLE(1, 1, 1, 1))));
+      c3 = _mm_add_ps(c3, _mm_mul_ps(a2, _mm_shuffle_ps(b3, b3, _MM_SHUFFLE(2, 2, 2, 2))));
+
+      _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+      _mm_storeu_ps(&dst[0], c0);
+      _mm_storeu_ps(&dst[4], c1);
+      _mm_storeu_ps(&dst[8], c2);
+    }
+#else
+    for (unsigned int i = 0; i < count; ++i, m1 += 16, m2 += 16, dst += 12)
+    {
+      for (unsigned int r = 0; r < 3; ++r)
+      {
+        dst[r * 4 + 0] = m1[r] * m2[0] + m1[r + 4] * m2[1] + m1[r + 8] * m2[2];
+        dst[r * 4 + 1] = m1[r] * m2[4] + m1[r + 4] * m2[5] + m1[r + 8] * m2[6];
+        dst[r * 4 + 2] = m1[r] * m2[8] + m1[r + 4] * m2[9] + m1[r + 8] * m2[10];
+        dst[r * 4 + 3] = m1[r] * m2[12] + m1[r + 4] * m2[13] + m1[r + 8] * m2[14] + m1[r + 12];
+      }
+    }
+#endif
+  }
+
+  void MathUtil::transformPoints(const float* m, const float* points, float* dst, unsigned int count)
+  {
+    assert(count == 0 || (m && points && dst));
+
+#ifdef GP_USE_SSE
+    __m128 c0 = _mm_loadu_ps(&m[0]);
+    __m128 c1 = _mm_loadu_ps(&m[4]);
+    __m128 c2 = _mm_loadu_ps(&m[8]);
+    __m128 c3 = _mm_loadu_ps(&m[12]);
+    for (unsigned int i = 0; i < count; ++i, points += 3, dst += 3)
+    {
+      __m128 r = _mm_add_ps(c3, _mm_mul_ps(c0, _mm_set1_ps(points[0])));
+      r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(points[1])));
+      r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(points[2])));
+      _mm_storel_pi((__m64*)dst, r);
+      _mm_store_ss(&dst[2], _mm_movehl_ps(r, r));
+    }
+#else
+    for (unsigned int i = 0; i < count; ++i, points += 3, dst += 3)
+    {
+      transformVector4(m, points[0], points[1], points[2], 1.0f, dst);
+    }
+#endif
+  }
+
+  void MathUtil::transformVectors4(const float* m, const float* vectors, float* dst, unsigned int count)
+  {
+    assert(count == 0 || (m && vectors && dst));
+
+#ifdef GP_USE_AVX_DISPATCH
+    unsigned int i = 0;
+    if (isAVXSupported())
+    {
+      i = count & ~1u;
+      transformVectors4AVX(m, vectors, dst, i);
+    }
+#else
+    unsigned int i = 0;
+#endif
+    for (; i < count; ++i)
+    {
+      transformVector4(m, vectors + i * 4, dst + i * 4);
+    }
+  }
+
   void MathUtil::smooth(float* x, float target, float elapsedTime, float responseTime)
   {
     assert(x);
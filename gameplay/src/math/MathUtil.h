@@ -65,6 +65,16 @@ namespace gameplay
 
     inline static void crossVector3(const float* v1, const float* v2, float* dst);
 
+    static void multiplyMatrices(const float* m1, const float* m2, float* dst, unsigned int count);
+
+    static void multiplyAffineMatrices(const float* m1, const float* m2, float* dst, unsigned int count);
+
+    static void transformPoints(const float* m, const float* points, float* dst, unsigned int count);
+
+    static void transformVectors4(const float* m, const float* vectors, float* dst, unsigned int count);
+
+    static bool isAVXSupported();
+
     MathUtil();
   };
 
@@ -72,8 +82,17 @@ namespace gameplay
 
 #define MATRIX_SIZE ( sizeof(float) * 16)
 
-#ifdef GP_USE_NEON
+// Use SSE on x86 targets unless explicitly disabled (all x64 targets support it).
+#if !defined(GP_USE_NEON) && !defined(GP_USE_SSE) && !defined(GP_NO_SSE)
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define GP_USE_SSE
+#endif
+#endif
+
+#if defined(GP_USE_NEON)
 #include "math/MathUtilNeon.inl"
+#elif defined(GP_USE_SSE)
+#include "math/MathUtilSSE.inl"
 #else
 #include "math/MathUtil.inl"
 #endif
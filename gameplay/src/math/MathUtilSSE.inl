@@ -0,0 +1,156 @@
+#include <xmmintrin.h>
+
+namespace gameplay
+{
+
+  inline void MathUtil::addMatrix(const float* m, float scalar, float* dst)
+  {
+    __m128 s = _mm_set1_ps(scalar);
+    __m128 c0 = _mm_add_ps(_mm_loadu_ps(&m[0]), s);
+    __m128 c1 = _mm_add_ps(_mm_loadu_ps(&m[4]), s);
+    __m128 c2 = _mm_add_ps(_mm_loadu_ps(&m[8]), s);
+    __m128 c3 = _mm_add_ps(_mm_loadu_ps(&m[12]), s);
+    _mm_storeu_ps(&dst[0], c0);
+    _mm_storeu_ps(&dst[4], c1);
+    _mm_storeu_ps(&dst[8], c2);
+    _mm_storeu_ps(&dst[12], c3);
+  }
+
+  inline void MathUtil::addMatrix(const float* m1, const float* m2, float* dst)
+  {
+    __m128 c0 = _mm_add_ps(_mm_loadu_ps(&m1[0]), _mm_loadu_ps(&m2[0]));
+    __m128 c1 = _mm_add_ps(_mm_loadu_ps(&m1[4]), _mm_loadu_ps(&m2[4]));
+    __m128 c2 = _mm_add_ps(_mm_loadu_ps(&m1[8]), _mm_loadu_ps(&m2[8]));
+    __m128 c3 = _mm_add_ps(_mm_loadu_ps(&m1[12]), _mm_loadu_ps(&m2[12]));
+    _mm_storeu_ps(&dst[0], c0);
+    _mm_storeu_ps(&dst[4], c1);
+    _mm_storeu_ps(&dst[8], c2);
+    _mm_storeu_ps(&dst[12], c3);
+  }
+
+  inline void MathUtil::subtractMatrix(const float* m1, const float* m2, float* dst)
+  {
+    __m128 c0 = _mm_sub_ps(_mm_loadu_ps(&m1[0]), _mm_loadu_ps(&m2[0]));
+    __m128 c1 = _mm_sub_ps(_mm_loadu_ps(&m1[4]), _mm_loadu_ps(&m2[4]));
+    __m128 c2 = _mm_sub_ps(_mm_loadu_ps(&m1[8]), _mm_loadu_ps(&m2[8]));
+    __m128 c3 = _mm_sub_ps(_mm_loadu_ps(&m1[12]), _mm_loadu_ps(&m2[12]));
+    _mm_storeu_ps(&dst[0], c0);
+    _mm_storeu_ps(&dst[4], c1);
+    _mm_storeu_ps(&dst[8], c2);
+    _mm_storeu_ps(&dst[12], c3);
+  }
+
+  inline void MathUtil::multiplyMatrix(const float* m, float scalar, float* dst)
+  {
+    __m128 s = _mm_set1_ps(scalar);
+    __m128 c0 = _mm_mul_ps(_mm_loadu_ps(&m[0]), s);
+    __m128 c1 = _mm_mul_ps(_mm_loadu_ps(&m[4]), s);
+    __m128 c2 = _mm_mul_ps(_mm_loadu_ps(&m[8]), s);
+    __m128 c3 = _mm_mul_ps(_mm_loadu_ps(&m[12]), s);
+    _mm_storeu_ps(&dst[0], c0);
+    _mm_storeu_ps(&dst[4], c1);
+    _mm_storeu_ps(&dst[8], c2);
+    _mm_storeu_ps(&dst[12], c3);
+  }
+
+  inline void MathUtil::multiplyMatrix(const float* m1, const float* m2, float* dst)
+  {
+    // Each column of the product is a linear combination of the columns of m1.
+    // All inputs are loaded before storing to support m1 or m2 being the same array as dst.
+    __m128 a0 = _mm_loadu_ps(&m1[0]);
+    __m128 a1 = _mm_loadu_ps(&m1[4]);
+    __m128 a2 = _mm_loadu_ps(&m1[8]);
+    __m128 a3 = _mm_loadu_ps(&m1[12]);
+    __m128 b0 = _mm_loadu_ps(&m2[0]);
+    __m128 b1 = _mm_loadu_ps(&m2[4]);
+    __m128 b2 = _mm_loadu_ps(&m2[8]);
+    __m128 b3 = _mm_loadu_ps(&m2[12]);
+
+    __m128 c0 = _mm_mul_ps(a0, _mm_shuffle_ps(b0, b0, _MM_SHUFFLE(0, 0, 0, 0)));
+    c0 = _mm_add_ps(c0, _mm_mul_ps(a1, _mm_shuffle_ps(b0, b0, _MM_SHUFFLE(1, 1, 1, 1))));
+    c0 = _mm_add_ps(c0, _mm_mul_ps(a2, _mm_shuffle_ps(b0, b0, _MM_SHUFFLE(2, 2, 2, 2))));
+    c0 = _mm_add_ps(c0, _mm_mul_ps(a3, _mm_shuffle_ps(b0, b0, _MM_SHUFFLE(3, 3, 3, 3))));
+
+    __m128 c1 = _mm_mul_ps(a0, _mm_shuffle_ps(b1, b1, _MM_SHUFFLE(0, 0, 0, 0)));
+    c1 = _mm_add_ps(c1, _mm_mul_ps(a1, _mm_shuffle_ps(b1, b1, _MM_SHUFFLE(1, 1, 1, 1))));
+    c1 = _mm_add_ps(c1, _mm_mul_ps(a2, _mm_shuffle_ps(b1, b1, _MM_SHUFFLE(2, 2, 2, 2))));
+    c1 = _mm_add_ps(c1, _mm_mul_ps(a3, _mm_shuffle_ps(b1, b1, _MM_SHUFFLE(3, 3, 3, 3))));
+
+    __m128 c2 = _mm_mul_ps(a0, _mm_shuffle_ps(b2, b2, _MM_SHUFFLE(0, 0, 0, 0)));
+    c2 = _mm_add_ps(c2, _mm_mul_ps(a1, _mm_shuffle_ps(b2, b2, _MM_SHUFFLE(1, 1, 1, 1))));
+    c2 = _mm_add_ps(c2, _mm_mul_ps(a2, _mm_shuffle_ps(b2, b2, _MM_SHUFFLE(2, 2, 2, 2))));
+    c2 = _mm_add_ps(c2, _mm_mul_ps(a3, _mm_shuffle_ps(b2, b2, _MM_SHUFFLE(3, 3, 3, 3))));
+
+    __m128 c3 = _mm_mul_ps(a0, _mm_shuffle_ps(b3, b3, _MM_SHUFFLE(0, 0, 0, 0)));
+    c3 = _mm_add_ps(c3, _mm_mul_ps(a1, _mm_shuffle_ps(b3, b3, _MM_SHUFFLE(1, 1, 1, 1))));
+    c3 = _mm_add_ps(c3, _mm_mul_ps(a2, _mm_shuffle_ps(b3, b3, _MM_SHUFFLE(2, 2, 2, 2))));
+    c3 = _mm_add_ps(c3, _mm_mul_ps(a3, _mm_shuffle_ps(b3, b3, _MM_SHUFFLE(3, 3, 3, 3))));
+
+    _mm_storeu_ps(&dst[0], c0);
+    _mm_storeu_ps(&dst[4], c1);
+    _mm_storeu_ps(&dst[8], c2);
+    _mm_storeu_ps(&dst[12], c3);
+  }
+
+  inline void MathUtil::negateMatrix(const float* m, float* dst)
+  {
+    __m128 zero = _mm_setzero_ps();
+    __m128 c0 = _mm_sub_ps(zero, _mm_loadu_ps(&m[0]));
+    __m128 c1 = _mm_sub_ps(zero, _mm_loadu_ps(&m[4]));
+    __m128 c2 = _mm_sub_ps(zero, _mm_loadu_ps(&m[8]));
+    __m128 c3 = _mm_sub_ps(zero, _mm_loadu_ps(&m[12]));
+    _mm_storeu_ps(&dst[0], c0);
+    _mm_storeu_ps(&dst[4], c1);
+    _mm_storeu_ps(&dst[8], c2);
+    _mm_storeu_ps(&dst[12], c3);
+  }
+
+  inline void MathUtil::transposeMatrix(const float* m, float* dst)
+  {
+    __m128 c0 = _mm_loadu_ps(&m[0]);
+    __m128 c1 = _mm_loadu_ps(&m[4]);
+    __m128 c2 = _mm_loadu_ps(&m[8]);
+    __m128 c3 = _mm_loadu_ps(&m[12]);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    _mm_storeu_ps(&dst[0], c0);
+    _mm_storeu_ps(&dst[4], c1);
+    _mm_storeu_ps(&dst[8], c2);
+    _mm_storeu_ps(&dst[12], c3);
+  }
+
+  inline void MathUtil::transformVector4(const float* m, float x, float y, float z, float w, float* dst)
+  {
+    __m128 v = _mm_mul_ps(_mm_loadu_ps(&m[0]), _mm_set1_ps(x));
+    v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(&m[4]), _mm_set1_ps(y)));
+    v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(&m[8]), _mm_set1_ps(z)));
+    v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(&m[12]), _mm_set1_ps(w)));
+
+    // Only x, y and z are written since dst is usually a Vector3.
+    _mm_storel_pi((__m64*)dst, v);
+    _mm_store_ss(&dst[2], _mm_movehl_ps(v, v));
+  }
+
+  inline void MathUtil::transformVector4(const float* m, const float* v, float* dst)
+  {
+    // Handle case where v == dst.
+    __m128 p = _mm_loadu_ps(v);
+    __m128 r = _mm_mul_ps(_mm_loadu_ps(&m[0]), _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0)));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m[4]), _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1))));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m[8]), _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2))));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(&m[12]), _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 3, 3))));
+    _mm_storeu_ps(dst, r);
+  }
+
+  inline void MathUtil::crossVector3(const float* v1, const float* v2, float* dst)
+  {
+    // Vectors are only three floats wide, so a full SSE load would read past them.
+    float x = (v1[1] * v2[2]) - (v1[2] * v2[1]);
+    float y = (v1[2] * v2[0]) - (v1[0] * v2[2]);
+    float z = (v1[0] * v2[1]) - (v1[1] * v2[0]);
+
+    dst[0] = x;
+    dst[1] = y;
+    dst[2] = z;
+  }
+
+}
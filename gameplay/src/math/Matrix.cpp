@@ -751,6 +751,20 @@ namespace gameplay
     MathUtil::multiplyMatrix(m1.m, m2.m, dst->m);
   }
 
+  void Matrix::multiply(const Matrix* m1, const Matrix* m2, unsigned int count, Matrix* dst)
+  {
+    assert(count == 0 || (m1 && m2 && dst));
+
+    MathUtil::multiplyMatrices((const float*)m1, (const float*)m2, (float*)dst, count);
+  }
+
+  void Matrix::multiplyAffine(const Matrix* m1, const Matrix* m2, unsigned int count, Vector4* dst)
+  {
+    assert(count == 0 || (m1 && m2 && dst));
+
+    MathUtil::multiplyAffineMatrices((const float*)m1, (const float*)m2, (float*)dst, count);
+  }
+
   void Matrix::negate()
   {
     negate(this);
@@ -946,6 +960,20 @@ namespace gameplay
     MathUtil::transformVector4(m, (const float*)&vector, (float*)dst);
   }
 
+  void Matrix::transformPoints(const Vector3* points, unsigned int count, Vector3* dst) const
+  {
+    assert(count == 0 || (points && dst));
+
+    MathUtil::transformPoints(m, (const float*)points, (float*)dst, count);
+  }
+
+  void Matrix::transformVectors(const Vector4* vectors, unsigned int count, Vector4* dst) const
+  {
+    assert(count == 0 || (vectors && dst));
+
+    MathUtil::transformVectors4(m, (const float*)vectors, (float*)dst, count);
+  }
+
   void Matrix::translate(float x, float y, float z)
   {
     translate(x, y, z, this);
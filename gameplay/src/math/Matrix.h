@@ -525,6 +525,37 @@ namespace gameplay
      */
     static void multiply(const Matrix& m1, const Matrix& m2, Matrix* dst);
 
+    /**
+     * Multiplies each matrix in m1 by the matrix at the same index in m2 and
+     * stores the results in dst.
+     *
+     * This is faster than multiplying the matrices one at a time since the
+     * batch is processed by a single vectorized kernel (AVX is used when
+     * the CPU supports it). dst may be the same array as m1 or m2.
+     *
+     * @param m1 The array of first matrices to multiply.
+     * @param m2 The array of second matrices to multiply.
+     * @param count The number of matrices in each array.
+     * @param dst An array of count matrices to store the results in.
+     */
+    static void multiply(const Matrix* m1, const Matrix* m2, unsigned int count, Matrix* dst);
+
+    /**
+     * Multiplies each affine matrix in m1 by the affine matrix at the same
+     * index in m2 and stores the first three rows of each result in dst.
+     *
+     * Each result takes three consecutive Vector4's, one per row, which is the
+     * layout of a skinning matrix palette. Since the last row of an affine
+     * matrix is (0, 0, 0, 1) this is cheaper than a full multiplication. dst
+     * must not overlap m1 or m2.
+     *
+     * @param m1 The array of first affine matrices to multiply.
+     * @param m2 The array of second affine matrices to multiply.
+     * @param count The number of matrices in each array.
+     * @param dst An array of (count * 3) vectors to store the result rows in.
+     */
+    static void multiplyAffine(const Matrix* m1, const Matrix* m2, unsigned int count, Vector4* dst);
+
     /**
      * Negates this matrix.
      */
@@ -808,6 +839,30 @@ namespace gameplay
      */
     void transformVector(const Vector4& vector, Vector4* dst) const;
 
+    /**
+     * Transforms the specified array of points by this matrix, and stores
+     * the results in dst.
+     *
+     * dst may be the same array as points.
+     *
+     * @param points The points to transform.
+     * @param count The number of points.
+     * @param dst An array of count vectors to store the transformed points in.
+     */
+    void transformPoints(const Vector3* points, unsigned int count, Vector3* dst) const;
+
+    /**
+     * Transforms the specified array of vectors by this matrix, and stores
+     * the results in dst.
+     *
+     * dst may be the same array as vectors.
+     *
+     * @param vectors The vectors to transform.
+     * @param count The number of vectors.
+     * @param dst An array of count vectors to store the transformed vectors in.
+     */
+    void transformVectors(const Vector4* vectors, unsigned int count, Vector4* dst) const;
+
     /**
      * Post-multiplies this matrix by the matrix corresponding to the
      * specified translation.
@@ -825,90 +825,100 @@ namespace gameplay
   }
 
   void Transform::setAnimationPropertyValue(int propertyId, AnimationValue* value, float blendWeight)
+  {
+    char dirtyBits = blendAnimationPropertyValue(propertyId, value, blendWeight);
+    if (dirtyBits)
+      dirty(dirtyBits);
+  }
+
+  char Transform::blendAnimationPropertyValue(int propertyId, AnimationValue* value, float blendWeight)
   {
     assert(value);
     assert(blendWeight >= 0.0f && blendWeight <= 1.0f);
 
+    if (isStatic())
+      return 0;
+
     switch (propertyId)
     {
     case ANIMATE_SCALE_UNIT:
     {
       float scale = Curve::lerp(blendWeight, _scale.x, value->getFloat(0));
-      setScale(scale);
-      break;
+      _scale.set(scale, scale, scale);
+      return DIRTY_SCALE;
     }
     case ANIMATE_SCALE:
     {
-      setScale(Curve::lerp(blendWeight, _scale.x, value->getFloat(0)), Curve::lerp(blendWeight, _scale.y, value->getFloat(1)), Curve::lerp(blendWeight, _scale.z, value->getFloat(2)));
-      break;
+      blendAnimationValueVector(value, 0, blendWeight, &_scale);
+      return DIRTY_SCALE;
     }
     case ANIMATE_SCALE_X:
     {
-      setScaleX(Curve::lerp(blendWeight, _scale.x, value->getFloat(0)));
-      break;
+      _scale.x = Curve::lerp(blendWeight, _scale.x, value->getFloat(0));
+      return DIRTY_SCALE;
     }
     case ANIMATE_SCALE_Y:
     {
-      setScaleY(Curve::lerp(blendWeight, _scale.y, value->getFloat(0)));
-      break;
+      _scale.y = Curve::lerp(blendWeight, _scale.y, value->getFloat(0));
+      return DIRTY_SCALE;
     }
     case ANIMATE_SCALE_Z:
     {
-      setScaleZ(Curve::lerp(blendWeight, _scale.z, value->getFloat(0)));
-      break;
+      _scale.z = Curve::lerp(blendWeight, _scale.z, value->getFloat(0));
+      return DIRTY_SCALE;
     }
     case ANIMATE_ROTATE:
     {
-      applyAnimationValueRotation(value, 0, blendWeight);
-      break;
+      blendAnimationValueRotation(value, 0, blendWeight);
+      return DIRTY_ROTATION;
     }
     case ANIMATE_TRANSLATE:
     {
-      setTranslation(Curve::lerp(blendWeight, _translation.x, value->getFloat(0)), Curve::lerp(blendWeight, _translation.y, value->getFloat(1)), Curve::lerp(blendWeight, _translation.z, value->getFloat(2)));
-      break;
+      blendAnimationValueVector(value, 0, blendWeight, &_translation);
+      return DIRTY_TRANSLATION;
     }
     case ANIMATE_TRANSLATE_X:
     {
-      setTranslationX(Curve::lerp(blendWeight, _translation.x, value->getFloat(0)));
-      break;
+      _translation.x = Curve::lerp(blendWeight, _translation.x, value->getFloat(0));
+      return DIRTY_TRANSLATION;
     }
     case ANIMATE_TRANSLATE_Y:
     {
-      setTranslationY(Curve::lerp(blendWeight, _translation.y, value->getFloat(0)));
-      break;
+      _translation.y = Curve::lerp(blendWeight, _translation.y, value->getFloat(0));
+      return DIRTY_TRANSLATION;
     }
     case ANIMATE_TRANSLATE_Z:
     {
-      setTranslationZ(Curve::lerp(blendWeight, _translation.z, value->getFloat(0)));
-      break;
+      _translation.z = Curve::lerp(blendWeight, _translation.z, value->getFloat(0));
+      return DIRTY_TRANSLATION;
     }
     case ANIMATE_ROTATE_TRANSLATE:
     {
-      applyAnimationValueRotation(value, 0, blendWeight);
-      setTranslation(Curve::lerp(blendWeight, _translation.x, value->getFloat(4)), Curve::lerp(blendWeight, _translation.y, value->getFloat(5)), Curve::lerp(blendWeight, _translation.z, value->getFloat(6)));
-      break;
+      blendAnimationValueRotation(value, 0, blendWeight);
+      blendAnimationValueVector(value, 4, blendWeight, &_translation);
+      return DIRTY_ROTATION | DIRTY_TRANSLATION;
     }
     case ANIMATE_SCALE_ROTATE:
     {
-      setScale(Curve::lerp(blendWeight, _scale.x, value->getFloat(0)), Curve::lerp(blendWeight, _scale.y, value->getFloat(1)), Curve::lerp(blendWeight, _scale.z, value->getFloat(2)));
-      applyAnimationValueRotation(value, 3, blendWeight);
-      break;
+      blendAnimationValueVector(value, 0, blendWeight, &_scale);
+      blendAnimationValueRotation(value, 3, blendWeight);
+      return DIRTY_SCALE | DIRTY_ROTATION;
     }
     case ANIMATE_SCALE_TRANSLATE:
     {
-      setScale(Curve::lerp(blendWeight, _scale.x, value->getFloat(0)), Curve::lerp(blendWeight, _scale.y, value->getFloat(1)), Curve::lerp(blendWeight, _scale.z, value->getFloat(2)));
-      setTranslation(Curve::lerp(blendWeight, _translation.x, value->getFloat(3)), Curve::lerp(blendWeight, _translation.y, value->getFloat(4)), Curve::lerp(blendWeight, _translation.z, value->getFloat(5)));
-      break;
+      blendAnimationValueVector(value, 0, blendWeight, &_scale);
+      blendAnimationValueVector(value, 3, blendWeight, &_translation);
+      return DIRTY_SCALE | DIRTY_TRANSLATION;
     }
     case ANIMATE_SCALE_ROTATE_TRANSLATE:
     {
-      setScale(Curve::lerp(blendWeight, _scale.x, value->getFloat(0)), Curve::lerp(blendWeight, _scale.y, value->getFloat(1)), Curve::lerp(blendWeight, _scale.z, value->getFloat(2)));
-      applyAnimationValueRotation(value, 3, blendWeight);
-      setTranslation(Curve::lerp(blendWeight, _translation.x, value->getFloat(7)), Curve::lerp(blendWeight, _translation.y, value->getFloat(8)), Curve::lerp(blendWeight, _translation.z, value->getFloat(9)));
-      break;
+      blendAnimationValueVector(value, 0, blendWeight, &_scale);
+      blendAnimationValueRotation(value, 3, blendWeight);
+      blendAnimationValueVector(value, 7, blendWeight, &_translation);
+      return DIRTY_SCALE | DIRTY_ROTATION | DIRTY_TRANSLATION;
     }
     default:
-      break;
+      return 0;
     }
   }
 
@@ -1000,15 +1010,19 @@ namespace gameplay
     transform->dirty(DIRTY_TRANSLATION | DIRTY_ROTATION | DIRTY_SCALE);
   }
 
-  void Transform::applyAnimationValueRotation(AnimationValue* value, unsigned int index, float blendWeight)
+  void Transform::blendAnimationValueVector(AnimationValue* value, unsigned int index, float blendWeight, Vector3* dst)
   {
-    if (isStatic())
-      return;
+    assert(value);
+    dst->x = Curve::lerp(blendWeight, dst->x, value->getFloat(index));
+    dst->y = Curve::lerp(blendWeight, dst->y, value->getFloat(index + 1));
+    dst->z = Curve::lerp(blendWeight, dst->z, value->getFloat(index + 2));
+  }
 
+  void Transform::blendAnimationValueRotation(AnimationValue* value, unsigned int index, float blendWeight)
+  {
     assert(value);
     Quaternion::slerp(_rotation.x, _rotation.y, _rotation.z, _rotation.w, value->getFloat(index), value->getFloat(index + 1), value->getFloat(index + 2), value->getFloat(index + 3), blendWeight,
       &_rotation.x, &_rotation.y, &_rotation.z, &_rotation.w);
-    dirty(DIRTY_ROTATION);
   }
 
 }
@@ -33,6 +33,8 @@ namespace gameplay
     GP_SCRIPT_EVENT(transformChanged, "<Transform>");
     GP_SCRIPT_EVENTS_END();
 
+    friend class AnimationController;
+
   public:
 
     /**
@@ -891,7 +893,17 @@ namespace gameplay
 
   private:
 
-    void applyAnimationValueRotation(AnimationValue* value, unsigned int index, float blendWeight);
+    /**
+     * Blends an animation value into the scale, rotation and translation without marking the
+     * transform dirty, so that several values can be applied before a single call to dirty().
+     *
+     * @return The dirty bits of the components that were changed.
+     */
+    char blendAnimationPropertyValue(int propertyId, AnimationValue* value, float blendWeight);
+
+    static void blendAnimationValueVector(AnimationValue* value, unsigned int index, float blendWeight, Vector3* dst);
+
+    void blendAnimationValueRotation(AnimationValue* value, unsigned int index, float blendWeight);
 
     static int _suspendTransformChanged;
     static std::vector<Transform*> _transformsChanged;
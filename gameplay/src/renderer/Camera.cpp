@@ -20,15 +20,19 @@
 namespace gameplay
 {
 
+  // Versions are unique across all cameras, so a version identifies both the
+  // camera and the state of its view and projection.
+  static std::atomic<unsigned int> __cameraVersion(0);
+
   Camera::Camera(float fieldOfView, float aspectRatio, float nearPlane, float farPlane)
     : _type(PERSPECTIVE), _fieldOfView(fieldOfView), _aspectRatio(aspectRatio), _nearPlane(nearPlane), _farPlane(farPlane),
-    _bits(CAMERA_DIRTY_ALL), _node(nullptr), _listeners(nullptr)
+    _bits(CAMERA_DIRTY_ALL), _version(++__cameraVersion), _node(nullptr), _listeners(nullptr)
   {
   }
 
   Camera::Camera(float zoomX, float zoomY, float aspectRatio, float nearPlane, float farPlane)
     : _type(ORTHOGRAPHIC), _aspectRatio(aspectRatio), _nearPlane(nearPlane), _farPlane(farPlane),
-    _bits(CAMERA_DIRTY_ALL), _node(nullptr), _listeners(nullptr)
+    _bits(CAMERA_DIRTY_ALL), _version(++__cameraVersion), _node(nullptr), _listeners(nullptr)
   {
     // Orthographic camera.
     _zoom[0] = zoomX;
@@ -457,8 +461,15 @@ namespace gameplay
     cameraChanged();
   }
 
+  unsigned int Camera::getVersion() const
+  {
+    return _version;
+  }
+
   void Camera::cameraChanged()
   {
+    _version = ++__cameraVersion;
+
     if (_listeners == nullptr)
       return;
 
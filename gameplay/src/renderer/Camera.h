@@ -357,6 +357,12 @@ namespace gameplay
      */
     void transformChanged(Transform* transform, long cookie);
 
+    /**
+     * Gets a version number that changes whenever the view or projection of
+     * this camera changes. Versions are never shared between cameras.
+     */
+    unsigned int getVersion() const;
+
     void cameraChanged();
 
     Camera::Type _type;
@@ -372,6 +378,7 @@ namespace gameplay
     mutable Matrix _inverseViewProjection;
     mutable Frustum _bounds;
     mutable int _bits;
+    unsigned int _version;
     Node* _node;
     std::list<Camera::Listener*>* _listeners;
   };
@@ -0,0 +1,312 @@
+#include "framework/Base.h"
+#include "renderer/Instancer.h"
+#include "renderer/Material.h"
+#include "renderer/Pass.h"
+#include "renderer/StateCache.h"
+#include "renderer/Technique.h"
+#include "graphics/Effect.h"
+#include "graphics/Mesh.h"
+#include "graphics/MeshPart.h"
+#include "graphics/Model.h"
+#include "scene/Node.h"
+
+namespace gameplay
+{
+
+  bool Instancer::_supported = false;
+
+  Instancer::Instancer()
+    : _instanceBuffer(0), _instanceBufferSize(0)
+  {
+  }
+
+  Instancer::~Instancer()
+  {
+    if (_instanceBuffer)
+    {
+      GL_ASSERT(glDeleteBuffers(1, &_instanceBuffer));
+      StateCache::getCurrent()->bufferDeleted(_instanceBuffer);
+      _instanceBuffer = 0;
+    }
+  }
+
+  void Instancer::initialize()
+  {
+#ifdef GP_USE_INSTANCING
+    // The entry points are loaded with the context, and are missing on drivers older than OpenGL 3.3.
+    _supported = glDrawArraysInstanced && glDrawElementsInstanced && glVertexAttribDivisor;
+#else
+    _supported = false;
+#endif
+  }
+
+  bool Instancer::isSupported()
+  {
+    return _supported;
+  }
+
+  bool Instancer::add(Node* node)
+  {
+    assert(node);
+
+    Model* model = dynamic_cast<Model*>(node->getDrawable());
+    if (model == nullptr || model->getMesh() == nullptr)
+      return true;
+
+    // Skinned models have their own joint palettes, and every part must share the model's material.
+    Material* material = model->getMaterial();
+    bool instanceable = material && model->getSkin() == nullptr;
+    for (unsigned int i = 0, count = model->getMeshPartCount(); i < count && instanceable; ++i)
+    {
+      instanceable = model->getMaterial(i) == material;
+    }
+
+    if (instanceable)
+      add(model, model->getMesh(), material, node->getWorldMatrix());
+    else
+      _singleModels.push_back(model);
+    return true;
+  }
+
+  void Instancer::add(Model* model, Mesh* mesh, Material* material, const Matrix& worldMatrix)
+  {
+    std::pair<Mesh*, Material*> key(mesh, material);
+    std::map<std::pair<Mesh*, Material*>, unsigned int>::iterator itr = _groupIds.find(key);
+    unsigned int group;
+    if (itr != _groupIds.end())
+    {
+      group = itr->second;
+    }
+    else
+    {
+      group = (unsigned int)_groupIds.size();
+      _groupIds[key] = group;
+    }
+
+    Instance instance;
+    instance.group = group;
+    instance.model = model;
+    instance.worldMatrix = worldMatrix;
+    _added.push_back(instance);
+  }
+
+  void Instancer::build()
+  {
+    // Count the instances of each group, then place each instance after the ones of its group added before it.
+    _groups.resize(_groupIds.size());
+    for (std::map<std::pair<Mesh*, Material*>, unsigned int>::const_iterator itr = _groupIds.begin(); itr != _groupIds.end(); ++itr)
+    {
+      Group& group = _groups[itr->second];
+      group.mesh = itr->first.first;
+      group.material = itr->first.second;
+      group.count = 0;
+    }
+    for (const Instance& instance : _added)
+    {
+      ++_groups[instance.group].count;
+    }
+
+    unsigned int first = 0;
+    std::vector<unsigned int> next(_groups.size());
+    for (size_t i = 0; i < _groups.size(); ++i)
+    {
+      _groups[i].first = first;
+      next[i] = first;
+      first += _groups[i].count;
+    }
+
+    _matrices.resize(_added.size());
+    _models.resize(_added.size());
+    for (const Instance& instance : _added)
+    {
+      unsigned int index = next[instance.group]++;
+      _matrices[index] = instance.worldMatrix;
+      _models[index] = instance.model;
+    }
+  }
+
+  unsigned int Instancer::draw(bool wireframe)
+  {
+    build();
+
+    unsigned int drawCallCount = 0;
+    for (Model* model : _singleModels)
+    {
+      drawCallCount += model->draw(wireframe);
+    }
+
+    // Upload the matrices of every group at once; each group draws from its own offset.
+    bool hardware = isSupported();
+#ifdef GP_USE_INSTANCING
+    if (hardware && !wireframe && !_matrices.empty())
+    {
+      if (_instanceBuffer == 0)
+      {
+        GL_ASSERT(glGenBuffers(1, &_instanceBuffer));
+      }
+      size_t size = _matrices.size() * sizeof(Matrix);
+      StateCache::getCurrent()->bindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+      if (size > _instanceBufferSize)
+      {
+        _instanceBufferSize = std::max(size, _instanceBufferSize * 2);
+        GL_ASSERT(glBufferData(GL_ARRAY_BUFFER, _instanceBufferSize, nullptr, GL_STREAM_DRAW));
+      }
+      GL_ASSERT(glBufferSubData(GL_ARRAY_BUFFER, 0, size, _matrices.data()));
+      StateCache::getCurrent()->bindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+#endif
+
+    for (const Group& group : _groups)
+    {
+      // Instanced effects need the instance matrices even for a single model or a wireframe.
+      if (isInstanced(group.material))
+      {
+        drawCallCount += drawGroup(group, hardware && group.count > 1 && !wireframe, wireframe);
+      }
+      else
+      {
+        for (unsigned int i = 0; i < group.count; ++i)
+          drawCallCount += _models[group.first + i]->draw(wireframe);
+      }
+    }
+    return drawCallCount;
+  }
+
+  unsigned int Instancer::drawGroup(const Group& group, bool hardware, bool wireframe)
+  {
+    // The pass binds the material of the first model, whose per-node bindings the instanced shaders do not use.
+    Model* model = _models[group.first];
+    Technique* technique = group.material->getTechnique();
+    assert(technique);
+
+    unsigned int drawCallCount = 0;
+    unsigned int partCount = group.mesh->getPartCount();
+    for (unsigned int i = 0, count = std::max(partCount, 1u); i < count; ++i)
+    {
+      int partIndex = partCount == 0 ? -1 : (int)i;
+      for (unsigned int j = 0, passCount = technique->getPassCount(); j < passCount; ++j)
+      {
+        Pass* pass = technique->getPassByIndex(j);
+        assert(pass);
+        GLuint attrib = (GLuint)pass->getEffect()->getVertexAttribute(VERTEX_ATTRIBUTE_INSTANCE_MATRIX_NAME);
+        model->bindPass(pass);
+
+#ifdef GP_USE_INSTANCING
+        if (hardware)
+        {
+          // A matrix attribute takes one location per column, advancing once per instance.
+          StateCache::getCurrent()->bindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+          for (GLuint c = 0; c < 4; ++c)
+          {
+            GL_ASSERT(glEnableVertexAttribArray(attrib + c));
+            GL_ASSERT(glVertexAttribPointer(attrib + c, 4, GL_FLOAT, GL_FALSE, sizeof(Matrix), (void*)(group.first * sizeof(Matrix) + c * 4 * sizeof(float))));
+            GL_ASSERT(glVertexAttribDivisor(attrib + c, 1));
+          }
+          StateCache::getCurrent()->bindBuffer(GL_ARRAY_BUFFER, 0);
+
+          if (partIndex < 0)
+          {
+            StateCache::getCurrent()->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+            GL_ASSERT(glDrawArraysInstanced(group.mesh->getPrimitiveType(), 0, group.mesh->getVertexCount(), group.count));
+          }
+          else
+          {
+            MeshPart* part = group.mesh->getPart(partIndex);
+            assert(part);
+            StateCache::getCurrent()->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, part->getIndexBuffer());
+            GL_ASSERT(glDrawElementsInstanced(part->getPrimitiveType(), part->getIndexCount(), part->getIndexFormat(), 0, group.count));
+          }
+          ++drawCallCount;
+
+          // Leave the vertex array of the pass as it was for the next frame.
+          for (GLuint c = 0; c < 4; ++c)
+          {
+            GL_ASSERT(glVertexAttribDivisor(attrib + c, 0));
+            GL_ASSERT(glDisableVertexAttribArray(attrib + c));
+          }
+        }
+        else
+#endif
+        {
+          // Without instanced arrays, each instance sets its matrix as a constant attribute.
+          for (GLuint c = 0; c < 4; ++c)
+          {
+            GL_ASSERT(glDisableVertexAttribArray(attrib + c));
+          }
+          for (unsigned int k = 0; k < group.count; ++k)
+          {
+            const float* m = _matrices[group.first + k].m;
+            for (GLuint c = 0; c < 4; ++c)
+            {
+              GL_ASSERT(glVertexAttrib4fv(attrib + c, m + c * 4));
+            }
+            model->drawPart(partIndex, wireframe);
+            ++drawCallCount;
+          }
+        }
+        pass->unbind();
+      }
+    }
+    return drawCallCount;
+  }
+
+  bool Instancer::isInstanced(Material* material)
+  {
+    // Every pass must read the instance matrices, or the group is drawn model by model.
+    Technique* technique = material->getTechnique();
+    if (technique == nullptr || technique->getPassCount() == 0)
+      return false;
+
+    for (unsigned int i = 0, count = technique->getPassCount(); i < count; ++i)
+    {
+      Pass* pass = technique->getPassByIndex(i);
+      if (pass == nullptr || pass->getEffect() == nullptr || pass->getEffect()->getVertexAttribute(VERTEX_ATTRIBUTE_INSTANCE_MATRIX_NAME) == -1)
+        return false;
+    }
+    return true;
+  }
+
+  void Instancer::clear()
+  {
+    _groupIds.clear();
+    _added.clear();
+    _groups.clear();
+    _matrices.clear();
+    _models.clear();
+    _singleModels.clear();
+  }
+
+  unsigned int Instancer::getGroupCount() const
+  {
+    return (unsigned int)_groups.size();
+  }
+
+  const Instancer::Group& Instancer::getGroup(unsigned int index) const
+  {
+    assert(index < _groups.size());
+    return _groups[index];
+  }
+
+  unsigned int Instancer::getInstanceCount() const
+  {
+    return (unsigned int)_matrices.size();
+  }
+
+  const Matrix& Instancer::getInstanceMatrix(unsigned int index) const
+  {
+    assert(index < _matrices.size());
+    return _matrices[index];
+  }
+
+  Model* Instancer::getInstanceModel(unsigned int index) const
+  {
+    assert(index < _models.size());
+    return _models[index];
+  }
+
+  unsigned int Instancer::getSingleModelCount() const
+  {
+    return (unsigned int)_singleModels.size();
+  }
+
+}
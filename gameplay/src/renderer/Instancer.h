@@ -0,0 +1,221 @@
+#pragma once
+
+#include "math/Matrix.h"
+
+namespace gameplay
+{
+
+  class Material;
+  class Mesh;
+  class Model;
+  class Node;
+
+  /**
+   * Defines an instancer, which draws the models of a frame that share a mesh
+   * and a material with one instanced draw call per mesh part and pass.
+   *
+   * Nodes are added as the scene is visited, for example with
+   * scene->visit(instancer, &Instancer::add). Models are grouped by their mesh
+   * and material, and the world matrices of each group are uploaded to an
+   * instance buffer, from which the vertex shader reads them as the
+   * a_instanceMatrix attribute.
+   *
+   * Groups are drawn instanced when the effects of their material have the
+   * a_instanceMatrix attribute. The built-in colored and textured shaders
+   * have it when INSTANCED is defined, and then expect the VIEW_MATRIX and
+   * VIEW_PROJECTION_MATRIX auto bindings on u_viewMatrix and
+   * u_viewProjectionMatrix instead of the world-derived matrices. Such
+   * materials must be drawn through an instancer. Without hardware
+   * instancing, and for groups of one model or wireframes, the same effects
+   * are drawn once per instance with the world matrix set as a constant
+   * attribute.
+   *
+   * Models are drawn one by one, as Model::draw() does, when their material
+   * is not instanced, or when they are skinned or have per-part materials.
+   *
+   * Grouping does not use the graphics device, so it can be done and
+   * inspected without a graphics context (see build()).
+   *
+   * @script{ignore}
+   */
+  class Instancer
+  {
+    friend class Game;
+
+  public:
+
+    /**
+     * A group of instances that share a mesh and a material.
+     */
+    struct Group
+    {
+      /**
+       * The shared mesh.
+       */
+      Mesh* mesh;
+
+      /**
+       * The shared material.
+       */
+      Material* material;
+
+      /**
+       * The index of the first instance of the group.
+       */
+      unsigned int first;
+
+      /**
+       * The number of instances in the group.
+       */
+      unsigned int count;
+    };
+
+    /**
+     * Constructor.
+     */
+    Instancer();
+
+    /**
+     * Destructor.
+     */
+    ~Instancer();
+
+    /**
+     * Determines whether the graphics device supports instanced drawing.
+     * Support is determined once the graphics context is created, at game
+     * startup, and is false before that.
+     *
+     * @return True if instanced drawing is supported.
+     */
+    static bool isSupported();
+
+    /**
+     * Adds the model of a node, if it has one. Matches the signature of Scene::visit().
+     *
+     * @param node The node.
+     *
+     * @return True, to continue visiting the children of the node.
+     */
+    bool add(Node* node);
+
+    /**
+     * Adds an instance of a model.
+     *
+     * @param model The model, which is drawn with the world matrix of its own node if it is drawn alone.
+     * @param mesh The mesh of the model.
+     * @param material The material of the model.
+     * @param worldMatrix The world matrix of the instance.
+     */
+    void add(Model* model, Mesh* mesh, Material* material, const Matrix& worldMatrix);
+
+    /**
+     * Groups the instances added since the last build. Called by draw().
+     */
+    void build();
+
+    /**
+     * Draws the models added since the last clear().
+     *
+     * @param wireframe True to draw wireframes, which draws each model by itself.
+     *
+     * @return The number of draw calls.
+     */
+    unsigned int draw(bool wireframe = false);
+
+    /**
+     * Removes all models. Called once per frame before adding models.
+     */
+    void clear();
+
+    /**
+     * Gets the number of groups after build().
+     *
+     * @return The number of groups.
+     */
+    unsigned int getGroupCount() const;
+
+    /**
+     * Gets a group after build(). Groups are in the order their first instance was added.
+     *
+     * @param index The index of the group.
+     *
+     * @return The group.
+     */
+    const Group& getGroup(unsigned int index) const;
+
+    /**
+     * Gets the number of instances after build().
+     *
+     * @return The number of instances.
+     */
+    unsigned int getInstanceCount() const;
+
+    /**
+     * Gets the world matrix of an instance after build(). The instances of
+     * each group are contiguous, in the order they were added.
+     *
+     * @param index The index of the instance.
+     *
+     * @return The world matrix.
+     */
+    const Matrix& getInstanceMatrix(unsigned int index) const;
+
+    /**
+     * Gets the model of an instance after build().
+     *
+     * @param index The index of the instance.
+     *
+     * @return The model.
+     */
+    Model* getInstanceModel(unsigned int index) const;
+
+    /**
+     * Gets the number of models added that cannot be instanced.
+     *
+     * @return The number of models drawn by themselves.
+     */
+    unsigned int getSingleModelCount() const;
+
+  private:
+
+    /**
+     * An instance as it was added.
+     */
+    struct Instance
+    {
+      unsigned int group;
+      Model* model;
+      Matrix worldMatrix;
+    };
+
+    /**
+     * Hidden copy constructor.
+     */
+    Instancer(const Instancer& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    Instancer& operator=(const Instancer&);
+
+    /**
+     * Static initializer that is called during game startup, once the graphics context is created.
+     */
+    static void initialize();
+
+    static bool isInstanced(Material* material);
+
+    unsigned int drawGroup(const Group& group, bool hardware, bool wireframe);
+
+    std::map<std::pair<Mesh*, Material*>, unsigned int> _groupIds;
+    std::vector<Instance> _added;
+    std::vector<Group> _groups;
+    std::vector<Matrix> _matrices;
+    std::vector<Model*> _models;
+    std::vector<Model*> _singleModels;
+    GLuint _instanceBuffer;
+    size_t _instanceBufferSize;
+    static bool _supported;
+  };
+
+}
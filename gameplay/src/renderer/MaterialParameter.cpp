@@ -6,7 +6,7 @@ namespace gameplay
 {
 
   MaterialParameter::MaterialParameter(const char* name) :
-    _type(MaterialParameter::NONE), _count(1), _dynamic(false), _name(name ? name : ""), _uniform(nullptr), _loggerDirtyBits(0)
+    _type(MaterialParameter::NONE), _count(1), _dynamic(false), _name(name ? name : ""), _loggerDirtyBits(0)
   {
     clearValue();
   }
@@ -446,63 +446,60 @@ namespace gameplay
     _type = MaterialParameter::SAMPLER_ARRAY;
   }
 
-  void MaterialParameter::bind(Effect* effect)
+  Uniform* MaterialParameter::getUniform(Effect* effect)
   {
     assert(effect);
 
-    // If we had a Uniform cached that is not from the passed in effect,
-    // we need to update our uniform to point to the new effect's uniform.
-    if (!_uniform || _uniform->getEffect() != effect)
+    Uniform* uniform = effect->getUniform(_name.c_str());
+    if (!uniform && (_loggerDirtyBits & UNIFORM_NOT_FOUND) == 0)
     {
-      _uniform = effect->getUniform(_name.c_str());
-
-      if (!_uniform)
-      {
-        if ((_loggerDirtyBits & UNIFORM_NOT_FOUND) == 0)
-        {
-          // This parameter was not found in the specified effect, so do nothing.
-          GP_WARN("Material parameter for uniform '%s' not found in effect: '%s'.", _name.c_str(), effect->getId());
-          _loggerDirtyBits |= UNIFORM_NOT_FOUND;
-        }
-        return;
-      }
+      // This parameter was not found in the specified effect, so it is not bound.
+      GP_WARN("Material parameter for uniform '%s' not found in effect: '%s'.", _name.c_str(), effect->getId());
+      _loggerDirtyBits |= UNIFORM_NOT_FOUND;
     }
+    return uniform;
+  }
+
+  void MaterialParameter::bind(Effect* effect, Uniform* uniform)
+  {
+    assert(effect);
+    assert(uniform);
 
     switch (_type)
     {
     case MaterialParameter::FLOAT:
-      effect->setValue(_uniform, _value.floatValue);
+      effect->setValue(uniform, _value.floatValue);
       break;
     case MaterialParameter::FLOAT_ARRAY:
-      effect->setValue(_uniform, _value.floatPtrValue, _count);
+      effect->setValue(uniform, _value.floatPtrValue, _count);
       break;
     case MaterialParameter::INT:
-      effect->setValue(_uniform, _value.intValue);
+      effect->setValue(uniform, _value.intValue);
       break;
     case MaterialParameter::INT_ARRAY:
-      effect->setValue(_uniform, _value.intPtrValue, _count);
+      effect->setValue(uniform, _value.intPtrValue, _count);
       break;
     case MaterialParameter::VECTOR2:
-      effect->setValue(_uniform, reinterpret_cast<Vector2*>(_value.floatPtrValue), _count);
+      effect->setValue(uniform, reinterpret_cast<Vector2*>(_value.floatPtrValue), _count);
       break;
     case MaterialParameter::VECTOR3:
-      effect->setValue(_uniform, reinterpret_cast<Vector3*>(_value.floatPtrValue), _count);
+      effect->setValue(uniform, reinterpret_cast<Vector3*>(_value.floatPtrValue), _count);
       break;
     case MaterialParameter::VECTOR4:
-      effect->setValue(_uniform, reinterpret_cast<Vector4*>(_value.floatPtrValue), _count);
+      effect->setValue(uniform, reinterpret_cast<Vector4*>(_value.floatPtrValue), _count);
       break;
     case MaterialParameter::MATRIX:
-      effect->setValue(_uniform, reinterpret_cast<Matrix*>(_value.floatPtrValue), _count);
+      effect->setValue(uniform, reinterpret_cast<Matrix*>(_value.floatPtrValue), _count);
       break;
     case MaterialParameter::SAMPLER:
-      effect->setValue(_uniform, _value.samplerValue);
+      effect->setValue(uniform, _value.samplerValue);
       break;
     case MaterialParameter::SAMPLER_ARRAY:
-      effect->setValue(_uniform, _value.samplerArrayValue, _count);
+      effect->setValue(uniform, _value.samplerArrayValue, _count);
       break;
     case MaterialParameter::METHOD:
       if (_value.method)
-        _value.method->setValue(effect);
+        _value.method->setValue(effect, uniform);
       break;
     default:
     {
@@ -516,94 +513,64 @@ namespace gameplay
     }
   }
 
+  // The node methods a parameter can be bound to by name (see bindValue()).
+  static const struct
+  {
+    const char* name;
+    Vector3(Node::* method)() const;
+  } __nodeVector3Bindings[] =
+  {
+    { "&Node::getBackVector", &Node::getBackVector },
+    { "&Node::getDownVector", &Node::getDownVector },
+    { "&Node::getTranslationWorld", &Node::getTranslationWorld },
+    { "&Node::getTranslationView", &Node::getTranslationView },
+    { "&Node::getForwardVector", &Node::getForwardVector },
+    { "&Node::getForwardVectorWorld", &Node::getForwardVectorWorld },
+    { "&Node::getForwardVectorView", &Node::getForwardVectorView },
+    { "&Node::getLeftVector", &Node::getLeftVector },
+    { "&Node::getRightVector", &Node::getRightVector },
+    { "&Node::getRightVectorWorld", &Node::getRightVectorWorld },
+    { "&Node::getUpVector", &Node::getUpVector },
+    { "&Node::getUpVectorWorld", &Node::getUpVectorWorld },
+    { "&Node::getActiveCameraTranslationWorld", &Node::getActiveCameraTranslationWorld },
+    { "&Node::getActiveCameraTranslationView", &Node::getActiveCameraTranslationView }
+  };
+
+  static const struct
+  {
+    const char* name;
+    float(Node::* method)() const;
+  } __nodeFloatBindings[] =
+  {
+    { "&Node::getScaleX", &Node::getScaleX },
+    { "&Node::getScaleY", &Node::getScaleY },
+    { "&Node::getScaleZ", &Node::getScaleZ },
+    { "&Node::getTranslationX", &Node::getTranslationX },
+    { "&Node::getTranslationY", &Node::getTranslationY },
+    { "&Node::getTranslationZ", &Node::getTranslationZ }
+  };
+
   void MaterialParameter::bindValue(Node* node, const char* binding)
   {
     assert(binding);
 
-    if (strcmp(binding, "&Node::getBackVector") == 0)
+    for (const auto& b : __nodeVector3Bindings)
     {
-      bindValue<Node, Vector3>(node, &Node::getBackVector);
-    }
-    else if (strcmp(binding, "&Node::getDownVector") == 0)
-    {
-      bindValue<Node, Vector3>(node, &Node::getDownVector);
-    }
-    else if (strcmp(binding, "&Node::getTranslationWorld") == 0)
-    {
-      bindValue<Node, Vector3>(node, &Node::getTranslationWorld);
-    }
-    else if (strcmp(binding, "&Node::getTranslationView") == 0)
-    {
-      bindValue<Node, Vector3>(node, &Node::getTranslationView);
-    }
-    else if (strcmp(binding, "&Node::getForwardVector") == 0)
-    {
-      bindValue<Node, Vector3>(node, &Node::getForwardVector);
-    }
-    else if (strcmp(binding, "&Node::getForwardVectorWorld") == 0)
-    {
-      bindValue<Node, Vector3>(node, &Node::getForwardVectorWorld);
-    }
-    else if (strcmp(binding, "&Node::getForwardVectorView") == 0)
-    {
-      bindValue<Node, Vector3>(node, &Node::getForwardVectorView);
-    }
-    else if (strcmp(binding, "&Node::getLeftVector") == 0)
-    {
-      bindValue<Node, Vector3>(node, &Node::getLeftVector);
-    }
-    else if (strcmp(binding, "&Node::getRightVector") == 0)
-    {
-      bindValue<Node, Vector3>(node, &Node::getRightVector);
-    }
-    else if (strcmp(binding, "&Node::getRightVectorWorld") == 0)
-    {
-      bindValue<Node, Vector3>(node, &Node::getRightVectorWorld);
-    }
-    else if (strcmp(binding, "&Node::getUpVector") == 0)
-    {
-      bindValue<Node, Vector3>(node, &Node::getUpVector);
-    }
-    else if (strcmp(binding, "&Node::getUpVectorWorld") == 0)
-    {
-      bindValue<Node, Vector3>(node, &Node::getUpVectorWorld);
-    }
-    else if (strcmp(binding, "&Node::getActiveCameraTranslationWorld") == 0)
-    {
-      bindValue<Node, Vector3>(node, &Node::getActiveCameraTranslationWorld);
-    }
-    else if (strcmp(binding, "&Node::getActiveCameraTranslationView") == 0)
-    {
-      bindValue<Node, Vector3>(node, &Node::getActiveCameraTranslationView);
-    }
-    else if (strcmp(binding, "&Node::getScaleX") == 0)
-    {
-      bindValue<Node, float>(node, &Node::getScaleX);
-    }
-    else if (strcmp(binding, "&Node::getScaleY") == 0)
-    {
-      bindValue<Node, float>(node, &Node::getScaleY);
-    }
-    else if (strcmp(binding, "&Node::getScaleZ") == 0)
-    {
-      bindValue<Node, float>(node, &Node::getScaleZ);
-    }
-    else if (strcmp(binding, "&Node::getTranslationX") == 0)
-    {
-      bindValue<Node, float>(node, &Node::getTranslationX);
-    }
-    else if (strcmp(binding, "&Node::getTranslationY") == 0)
-    {
-      bindValue<Node, float>(node, &Node::getTranslationY);
-    }
-    else if (strcmp(binding, "&Node::getTranslationZ") == 0)
-    {
-      bindValue<Node, float>(node, &Node::getTranslationZ);
+      if (strcmp(binding, b.name) == 0)
+      {
+        bindValue<Node, Vector3>(node, b.method);
+        return;
+      }
     }
-    else
+    for (const auto& b : __nodeFloatBindings)
     {
-      GP_WARN("Unsupported material parameter binding '%s'.", binding);
+      if (strcmp(binding, b.name) == 0)
+      {
+        bindValue<Node, float>(node, b.method);
+        return;
+      }
     }
+    GP_WARN("Unsupported material parameter binding '%s'.", binding);
   }
 
   unsigned int MaterialParameter::getAnimationPropertyComponentCount(int propertyId) const
@@ -760,7 +727,6 @@ namespace gameplay
     materialParameter->_type = _type;
     materialParameter->_count = _count;
     materialParameter->_dynamic = _dynamic;
-    materialParameter->_uniform = _uniform;
     switch (_type)
     {
     case NONE:
@@ -371,7 +371,7 @@ namespace gameplay
 
     public:
 
-      virtual void setValue(Effect* effect) = 0;
+      virtual void setValue(Effect* effect, Uniform* uniform) = 0;
 
     protected:
 
@@ -403,7 +403,7 @@ namespace gameplay
       typedef ParameterType(ClassType::* ValueMethod)() const;
     public:
       MethodValueBinding(MaterialParameter* param, ClassType* instance, ValueMethod valueMethod);
-      void setValue(Effect* effect);
+      void setValue(Effect* effect, Uniform* uniform);
     private:
       ClassType* _instance;
       ValueMethod _valueMethod;
@@ -420,7 +420,7 @@ namespace gameplay
       typedef unsigned int (ClassType::* CountMethod)() const;
     public:
       MethodArrayBinding(MaterialParameter* param, ClassType* instance, ValueMethod valueMethod, CountMethod countMethod);
-      void setValue(Effect* effect);
+      void setValue(Effect* effect, Uniform* uniform);
     private:
       ClassType* _instance;
       ValueMethod _valueMethod;
@@ -429,7 +429,15 @@ namespace gameplay
 
     void clearValue();
 
-    void bind(Effect* effect);
+    /**
+     * Gets the uniform of an effect that this parameter sets, warning once if the effect has none.
+     */
+    Uniform* getUniform(Effect* effect);
+
+    /**
+     * Sets the uniform of an effect to the value of this parameter.
+     */
+    void bind(Effect* effect, Uniform* uniform);
 
     void applyAnimationValue(AnimationValue* value, float blendWeight, int components);
 
@@ -478,7 +486,6 @@ namespace gameplay
     unsigned int _count;
     bool _dynamic;
     std::string _name;
-    Uniform* _uniform;
     char _loggerDirtyBits;
   };
 
@@ -509,9 +516,9 @@ namespace gameplay
   }
 
   template <class ClassType, class ParameterType>
-  void MaterialParameter::MethodValueBinding<ClassType, ParameterType>::setValue(Effect* effect)
+  void MaterialParameter::MethodValueBinding<ClassType, ParameterType>::setValue(Effect* effect, Uniform* uniform)
   {
-    effect->setValue(_parameter->_uniform, (_instance->*_valueMethod)());
+    effect->setValue(uniform, (_instance->*_valueMethod)());
   }
 
   template <class ClassType, class ParameterType>
@@ -521,9 +528,9 @@ namespace gameplay
   }
 
   template <class ClassType, class ParameterType>
-  void MaterialParameter::MethodArrayBinding<ClassType, ParameterType>::setValue(Effect* effect)
+  void MaterialParameter::MethodArrayBinding<ClassType, ParameterType>::setValue(Effect* effect, Uniform* uniform)
   {
-    effect->setValue(_parameter->_uniform, (_instance->*_valueMethod)(), (_instance->*_countMethod)());
+    effect->setValue(uniform, (_instance->*_valueMethod)(), (_instance->*_countMethod)());
   }
 
 }
@@ -0,0 +1,292 @@
+#include "framework/Base.h"
+#include "renderer/RenderQueue.h"
+#include "renderer/Camera.h"
+#include "renderer/Pass.h"
+#include "graphics/Drawable.h"
+#include "graphics/Model.h"
+#include "scene/Node.h"
+#include "scene/Scene.h"
+
+// Sort key layout, from the most significant bit down. Opaque items order by
+// state, then depth; transparent items order by depth, then state.
+#define KEY_LAYER_SHIFT 60
+#define KEY_TRANSPARENT_SHIFT 59
+#define KEY_DEPTH_MAX 0xFFFFFFull
+#define KEY_ID_MASK 0xFFFFull
+#define KEY_OPAQUE_EFFECT_SHIFT 43
+#define KEY_OPAQUE_PASS_SHIFT 27
+#define KEY_OPAQUE_DEPTH_SHIFT 3
+#define KEY_TRANSPARENT_DEPTH_SHIFT 35
+#define KEY_TRANSPARENT_EFFECT_SHIFT 19
+#define KEY_TRANSPARENT_PASS_SHIFT 3
+
+// The radix sort orders 8 bits per pass.
+#define RADIX_BITS 8
+#define RADIX_SIZE (1 << RADIX_BITS)
+#define RADIX_PASS_COUNT (64 / RADIX_BITS)
+
+namespace gameplay
+{
+
+  RenderQueue::RenderQueue(bool headless)
+    : _headless(headless), _camera(nullptr), _layer(0), _drawCallCount(0), _passBindCount(0), _effectChangeCount(0)
+  {
+  }
+
+  RenderQueue::~RenderQueue()
+  {
+  }
+
+  bool RenderQueue::isHeadless() const
+  {
+    return _headless;
+  }
+
+  void RenderQueue::setCamera(Camera* camera)
+  {
+    _camera = camera;
+  }
+
+  void RenderQueue::setLayer(unsigned int layer)
+  {
+    assert(layer < LAYER_COUNT);
+    _layer = layer;
+  }
+
+  unsigned int RenderQueue::getLayer() const
+  {
+    return _layer;
+  }
+
+  bool RenderQueue::add(Node* node)
+  {
+    assert(node);
+
+    Drawable* drawable = node->getDrawable();
+    if (drawable)
+      drawable->enqueue(this);
+    return true;
+  }
+
+  void RenderQueue::add(Pass* pass, Drawable* drawable, int partIndex)
+  {
+    assert(drawable);
+
+    float depth = getDepth(drawable->getNode());
+    if (pass == nullptr)
+    {
+      // Drawables that draw themselves (sprites, text, particles) usually blend,
+      // so they are drawn back to front after the opaque items of their layer.
+      add(makeKey(_layer, true, 0, 0, depth), nullptr, drawable, partIndex);
+      return;
+    }
+    unsigned int effect = getId(_effectIds, pass->getEffect());
+    add(makeKey(_layer, pass->isBlendEnabled(), effect, getId(_passIds, pass), depth), pass, drawable, partIndex);
+  }
+
+  void RenderQueue::add(unsigned long long key, Pass* pass, Drawable* drawable, int partIndex)
+  {
+    Item item;
+    item.key = key;
+    item.pass = pass;
+    item.drawable = drawable;
+    item.partIndex = partIndex;
+    _items.push_back(item);
+  }
+
+  void RenderQueue::sort()
+  {
+    unsigned int count = (unsigned int)_items.size();
+    if (count < 2)
+      return;
+
+    _entries.resize(count);
+    _scratch.resize(count);
+    unsigned int histograms[RADIX_PASS_COUNT][RADIX_SIZE] = {};
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      unsigned long long key = _items[i].key;
+      _entries[i].key = key;
+      _entries[i].index = i;
+      for (unsigned int p = 0; p < RADIX_PASS_COUNT; ++p)
+        ++histograms[p][(key >> (p * RADIX_BITS)) & (RADIX_SIZE - 1)];
+    }
+
+    // Least significant digit first; each pass is stable, so the whole sort is.
+    SortEntry* src = _entries.data();
+    SortEntry* dst = _scratch.data();
+    for (unsigned int p = 0; p < RADIX_PASS_COUNT; ++p)
+    {
+      unsigned int shift = p * RADIX_BITS;
+      unsigned int* histogram = histograms[p];
+
+      // Skip digits that are the same in every key, such as unused layers.
+      if (histogram[(src[0].key >> shift) & (RADIX_SIZE - 1)] == count)
+        continue;
+
+      unsigned int offset = 0;
+      for (unsigned int d = 0; d < RADIX_SIZE; ++d)
+      {
+        unsigned int size = histogram[d];
+        histogram[d] = offset;
+        offset += size;
+      }
+      for (unsigned int i = 0; i < count; ++i)
+        dst[histogram[(src[i].key >> shift) & (RADIX_SIZE - 1)]++] = src[i];
+      std::swap(src, dst);
+    }
+
+    _sortedItems.resize(count);
+    for (unsigned int i = 0; i < count; ++i)
+      _sortedItems[i] = _items[src[i].index];
+    _items.swap(_sortedItems);
+  }
+
+  unsigned int RenderQueue::submit(bool wireframe)
+  {
+    _drawCallCount = 0;
+    _passBindCount = 0;
+    _effectChangeCount = 0;
+
+    // Effect changes are tracked through the effect ids in the keys, so headless queues never touch the passes.
+    Pass* currentPass = nullptr;
+    unsigned int currentEffect = 0;
+    for (const Item& item : _items)
+    {
+      if (item.pass)
+      {
+        if (item.pass != currentPass)
+        {
+          if (currentPass && !_headless)
+            currentPass->unbind();
+          if (!_headless)
+            static_cast<Model*>(item.drawable)->bindPass(item.pass);
+          currentPass = item.pass;
+          ++_passBindCount;
+
+          unsigned int effect = getEffectId(item.key);
+          if (effect != currentEffect)
+          {
+            currentEffect = effect;
+            ++_effectChangeCount;
+          }
+        }
+        if (!_headless)
+          static_cast<Model*>(item.drawable)->drawPart(item.partIndex, wireframe);
+        ++_drawCallCount;
+      }
+      else
+      {
+        // Drawables that draw themselves bind their own state.
+        if (currentPass)
+        {
+          if (!_headless)
+            currentPass->unbind();
+          currentPass = nullptr;
+        }
+        currentEffect = 0;
+        _drawCallCount += _headless ? 1 : item.drawable->draw(wireframe);
+      }
+    }
+    if (currentPass && !_headless)
+      currentPass->unbind();
+    return _drawCallCount;
+  }
+
+  void RenderQueue::clear()
+  {
+    _items.clear();
+    _effectIds.clear();
+    _passIds.clear();
+    _drawCallCount = 0;
+    _passBindCount = 0;
+    _effectChangeCount = 0;
+  }
+
+  unsigned int RenderQueue::getItemCount() const
+  {
+    return (unsigned int)_items.size();
+  }
+
+  const RenderQueue::Item& RenderQueue::getItem(unsigned int index) const
+  {
+    assert(index < _items.size());
+    return _items[index];
+  }
+
+  unsigned int RenderQueue::getDrawCallCount() const
+  {
+    return _drawCallCount;
+  }
+
+  unsigned int RenderQueue::getPassBindCount() const
+  {
+    return _passBindCount;
+  }
+
+  unsigned int RenderQueue::getEffectChangeCount() const
+  {
+    return _effectChangeCount;
+  }
+
+  unsigned long long RenderQueue::makeKey(unsigned int layer, bool transparent, unsigned int effect, unsigned int pass, float depth)
+  {
+    assert(layer < LAYER_COUNT);
+
+    unsigned long long d = (unsigned long long)(std::min(std::max(depth, 0.0f), 1.0f) * KEY_DEPTH_MAX);
+    unsigned long long e = effect & KEY_ID_MASK;
+    unsigned long long p = pass & KEY_ID_MASK;
+    unsigned long long key = (unsigned long long)(layer & (LAYER_COUNT - 1)) << KEY_LAYER_SHIFT;
+    if (transparent)
+    {
+      key |= 1ull << KEY_TRANSPARENT_SHIFT;
+      key |= (KEY_DEPTH_MAX - d) << KEY_TRANSPARENT_DEPTH_SHIFT;
+      key |= e << KEY_TRANSPARENT_EFFECT_SHIFT;
+      key |= p << KEY_TRANSPARENT_PASS_SHIFT;
+    }
+    else
+    {
+      key |= e << KEY_OPAQUE_EFFECT_SHIFT;
+      key |= p << KEY_OPAQUE_PASS_SHIFT;
+      key |= d << KEY_OPAQUE_DEPTH_SHIFT;
+    }
+    return key;
+  }
+
+  unsigned int RenderQueue::getEffectId(unsigned long long key)
+  {
+    if (key & (1ull << KEY_TRANSPARENT_SHIFT))
+      return (unsigned int)((key >> KEY_TRANSPARENT_EFFECT_SHIFT) & KEY_ID_MASK);
+    return (unsigned int)((key >> KEY_OPAQUE_EFFECT_SHIFT) & KEY_ID_MASK);
+  }
+
+  unsigned int RenderQueue::getId(std::unordered_map<const void*, unsigned int>& ids, const void* object)
+  {
+    // Ids are dense in the order objects are first seen; 0 is left for items without a pass.
+    std::unordered_map<const void*, unsigned int>::iterator itr = ids.find(object);
+    if (itr != ids.end())
+      return itr->second;
+    unsigned int id = (unsigned int)ids.size() + 1;
+    ids[object] = id;
+    return id;
+  }
+
+  float RenderQueue::getDepth(Node* node) const
+  {
+    if (node == nullptr)
+      return 0.0f;
+
+    Camera* camera = _camera;
+    if (camera == nullptr)
+    {
+      Scene* scene = node->getScene();
+      camera = scene ? scene->getActiveCamera() : nullptr;
+    }
+    if (camera == nullptr || camera->getNode() == nullptr || camera->getFarPlane() <= 0.0f)
+      return 0.0f;
+
+    float distance = camera->getNode()->getTranslationWorld().distance(node->getBoundingSphere().center);
+    return distance / camera->getFarPlane();
+  }
+
+}
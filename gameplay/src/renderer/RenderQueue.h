@@ -0,0 +1,252 @@
+#pragma once
+
+namespace gameplay
+{
+
+  class Camera;
+  class Drawable;
+  class Node;
+  class Pass;
+
+  /**
+   * Defines a render queue, which collects the draws of a frame, sorts them
+   * and submits them in an order that minimizes state changes.
+   *
+   * Instead of drawing each node as the scene is visited, the nodes are added
+   * to the queue, for example with scene->visit(queue, &RenderQueue::add).
+   * Each pass of each mesh part of a model becomes a draw item with a 64 bit
+   * sort key; other drawables become a single item that calls Drawable::draw()
+   * and is sorted with the transparent items, since such drawables usually blend.
+   * The keys order items by, from the most significant bits down:
+   *
+   * - the layer (see setLayer()),
+   * - opaque items before transparent ones (passes with blending enabled),
+   * - for opaque items: the effect, then the pass, then depth front to back,
+   * - for transparent items: depth back to front, then the effect and pass.
+   *
+   * sort() orders the keys with a radix sort, which is stable, so items with
+   * equal keys are drawn in the order they were added. submit() then binds a
+   * pass only when it differs from the previous item's.
+   *
+   * A headless queue makes no graphics calls: submit() only counts the pass
+   * binds and draw calls it would make. Items can be added with explicit keys
+   * (see makeKey()), so queues can be built, sorted and measured without a
+   * graphics context.
+   *
+   * @script{ignore}
+   */
+  class RenderQueue
+  {
+  public:
+
+    /**
+     * The number of layers.
+     */
+    static const unsigned int LAYER_COUNT = 16;
+
+    /**
+     * A draw item.
+     */
+    struct Item
+    {
+      /**
+       * The sort key.
+       */
+      unsigned long long key;
+
+      /**
+       * The pass to bind, or nullptr for drawables that draw themselves.
+       */
+      Pass* pass;
+
+      /**
+       * The drawable, which is a Model when there is a pass.
+       */
+      Drawable* drawable;
+
+      /**
+       * The mesh part to draw, or -1 for the whole mesh.
+       */
+      int partIndex;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param headless True to make no graphics calls when submitting.
+     */
+    RenderQueue(bool headless = false);
+
+    /**
+     * Destructor.
+     */
+    ~RenderQueue();
+
+    /**
+     * Determines whether the queue makes graphics calls when submitting.
+     *
+     * @return True if the queue is headless.
+     */
+    bool isHeadless() const;
+
+    /**
+     * Sets the camera that depth is measured from. The scene's active camera is used if none is set.
+     * The camera is not retained.
+     *
+     * @param camera The camera, or nullptr.
+     */
+    void setCamera(Camera* camera);
+
+    /**
+     * Sets the layer of the items added from now on. Lower layers are drawn first.
+     *
+     * @param layer The layer, less than LAYER_COUNT.
+     */
+    void setLayer(unsigned int layer);
+
+    /**
+     * Gets the layer of the items added from now on.
+     *
+     * @return The layer.
+     */
+    unsigned int getLayer() const;
+
+    /**
+     * Adds the draw items of the drawable of a node. Matches the signature of Scene::visit().
+     *
+     * @param node The node.
+     *
+     * @return True, to continue visiting the children of the node.
+     */
+    bool add(Node* node);
+
+    /**
+     * Adds a draw item for a drawable, keyed by its pass and the depth of its node.
+     *
+     * @param pass The pass, or nullptr for drawables that draw themselves.
+     * @param drawable The drawable, which must be a Model if there is a pass.
+     * @param partIndex The mesh part to draw, or -1 for the whole mesh.
+     */
+    void add(Pass* pass, Drawable* drawable, int partIndex);
+
+    /**
+     * Adds a draw item with an explicit sort key.
+     *
+     * @param key The sort key (see makeKey()).
+     * @param pass The pass to bind, or nullptr for drawables that draw themselves.
+     * @param drawable The drawable, which must be a Model if there is a pass.
+     * @param partIndex The mesh part to draw, or -1 for the whole mesh.
+     */
+    void add(unsigned long long key, Pass* pass, Drawable* drawable, int partIndex);
+
+    /**
+     * Sorts the items by their keys.
+     */
+    void sort();
+
+    /**
+     * Draws the items in order, binding each pass only when it changes.
+     *
+     * @param wireframe True to draw wireframes where the mesh supports it.
+     *
+     * @return The number of draw calls.
+     */
+    unsigned int submit(bool wireframe = false);
+
+    /**
+     * Removes all items and resets the counters. Called once per frame before adding items.
+     */
+    void clear();
+
+    /**
+     * Gets the number of items.
+     *
+     * @return The number of items.
+     */
+    unsigned int getItemCount() const;
+
+    /**
+     * Gets an item.
+     *
+     * @param index The index of the item, in sorted order after sort().
+     *
+     * @return The item.
+     */
+    const Item& getItem(unsigned int index) const;
+
+    /**
+     * Gets the number of draw calls made by the last submit().
+     *
+     * @return The number of draw calls.
+     */
+    unsigned int getDrawCallCount() const;
+
+    /**
+     * Gets the number of times the last submit() bound a pass.
+     *
+     * @return The number of pass binds.
+     */
+    unsigned int getPassBindCount() const;
+
+    /**
+     * Gets the number of times the last submit() changed the effect.
+     *
+     * @return The number of effect changes.
+     */
+    unsigned int getEffectChangeCount() const;
+
+    /**
+     * Builds a sort key.
+     *
+     * @param layer The layer, less than LAYER_COUNT.
+     * @param transparent True if the item blends with what is behind it.
+     * @param effect The id of the effect, of which the low 16 bits are used.
+     * @param pass The id of the pass, of which the low 16 bits are used.
+     * @param depth The depth, from 0 at the camera to 1 at the far plane. Clamped to [0, 1].
+     *
+     * @return The key.
+     */
+    static unsigned long long makeKey(unsigned int layer, bool transparent, unsigned int effect, unsigned int pass, float depth);
+
+  private:
+
+    /**
+     * An item key and the index of the item, which is what the radix sort moves.
+     */
+    struct SortEntry
+    {
+      unsigned long long key;
+      unsigned int index;
+    };
+
+    /**
+     * Hidden copy constructor.
+     */
+    RenderQueue(const RenderQueue& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    RenderQueue& operator=(const RenderQueue&);
+
+    unsigned int getId(std::unordered_map<const void*, unsigned int>& ids, const void* object);
+
+    float getDepth(Node* node) const;
+
+    static unsigned int getEffectId(unsigned long long key);
+
+    bool _headless;
+    Camera* _camera;
+    unsigned int _layer;
+    std::vector<Item> _items;
+    std::vector<Item> _sortedItems;
+    std::vector<SortEntry> _entries;
+    std::vector<SortEntry> _scratch;
+    std::unordered_map<const void*, unsigned int> _effectIds;
+    std::unordered_map<const void*, unsigned int> _passIds;
+    unsigned int _drawCallCount;
+    unsigned int _passBindCount;
+    unsigned int _effectChangeCount;
+  };
+
+}
@@ -31,7 +31,7 @@ namespace gameplay
   std::vector<RenderState::AutoBindingResolver*> RenderState::_customAutoBindingResolvers;
 
   RenderState::RenderState()
-    : _nodeBinding(nullptr), _state(nullptr), _parent(nullptr)
+    : _nodeBinding(nullptr), _state(nullptr), _parent(nullptr), _parameterBindingsEffect(nullptr), _parameterBindingsVersion(0), _parametersVersion(1)
   {
   }
 
@@ -76,6 +76,7 @@ namespace gameplay
     }
 
     // Create a new parameter and store it in our list.
+    ++_parametersVersion;
     return _parameters.emplace_back(new MaterialParameter(name));
   }
 
@@ -93,6 +94,7 @@ namespace gameplay
   {
     _parameters.push_back(param);
     param->addRef();
+    ++_parametersVersion;
   }
 
   void RenderState::removeParameter(const char* name)
@@ -104,63 +106,51 @@ namespace gameplay
       {
         _parameters.erase(_parameters.begin() + i);
         SAFE_RELEASE(p);
+        ++_parametersVersion;
         break;
       }
     }
   }
 
-  /**
-   * @script{ignore}
-   */
-  const char* autoBindingToString(RenderState::AutoBinding autoBinding)
+  // The names of the built-in auto bindings, indexed by RenderState::AutoBinding.
+  static const char* __autoBindingNames[] =
   {
-    // NOTE: As new AutoBinding values are added, this switch statement must be updatd.
-    switch (autoBinding)
-    {
-    case RenderState::NONE:
-      return nullptr;
-
-    case RenderState::VIEW_MATRIX:
-      return "VIEW_MATRIX";
-
-    case RenderState::PROJECTION_MATRIX:
-      return "PROJECTION_MATRIX";
-
-    case RenderState::WORLD_VIEW_MATRIX:
-      return "WORLD_VIEW_MATRIX";
-
-    case RenderState::VIEW_PROJECTION_MATRIX:
-      return "VIEW_PROJECTION_MATRIX";
-
-    case RenderState::WORLD_VIEW_PROJECTION_MATRIX:
-      return "WORLD_VIEW_PROJECTION_MATRIX";
-
-    case RenderState::INVERSE_TRANSPOSE_WORLD_MATRIX:
-      return "INVERSE_TRANSPOSE_WORLD_MATRIX";
-
-    case RenderState::INVERSE_TRANSPOSE_WORLD_VIEW_MATRIX:
-      return "INVERSE_TRANSPOSE_WORLD_VIEW_MATRIX";
-
-    case RenderState::CAMERA_WORLD_POSITION:
-      return "CAMERA_WORLD_POSITION";
+    nullptr,
+    "WORLD_MATRIX",
+    "VIEW_MATRIX",
+    "PROJECTION_MATRIX",
+    "WORLD_VIEW_MATRIX",
+    "VIEW_PROJECTION_MATRIX",
+    "WORLD_VIEW_PROJECTION_MATRIX",
+    "INVERSE_TRANSPOSE_WORLD_MATRIX",
+    "INVERSE_TRANSPOSE_WORLD_VIEW_MATRIX",
+    "CAMERA_WORLD_POSITION",
+    "CAMERA_VIEW_POSITION",
+    "MATRIX_PALETTE",
+    "SCENE_AMBIENT_COLOR"
+  };
 
-    case RenderState::CAMERA_VIEW_POSITION:
-      return "CAMERA_VIEW_POSITION";
-
-    case RenderState::MATRIX_PALETTE:
-      return "MATRIX_PALETTE";
-
-    case RenderState::SCENE_AMBIENT_COLOR:
-      return "SCENE_AMBIENT_COLOR";
+  RenderState::AutoBinding RenderState::getAutoBinding(const char* name)
+  {
+    assert(name);
 
-    default:
-      return "";
+    for (unsigned int i = WORLD_MATRIX; i <= SCENE_AMBIENT_COLOR; ++i)
+    {
+      if (strcmp(name, __autoBindingNames[i]) == 0)
+        return (AutoBinding)i;
     }
+    return NONE;
+  }
+
+  const char* RenderState::getAutoBindingName(AutoBinding autoBinding)
+  {
+    assert(autoBinding >= NONE && autoBinding <= SCENE_AMBIENT_COLOR);
+    return __autoBindingNames[autoBinding];
   }
 
   void RenderState::setParameterAutoBinding(const char* name, AutoBinding autoBinding)
   {
-    setParameterAutoBinding(name, autoBindingToString(autoBinding));
+    setParameterAutoBinding(name, getAutoBindingName(autoBinding));
   }
 
   void RenderState::setParameterAutoBinding(const char* name, const char* autoBinding)
@@ -266,58 +256,48 @@ namespace gameplay
     {
       bound = true;
 
-      if (strcmp(autoBinding, "WORLD_MATRIX") == 0)
+      switch (getAutoBinding(autoBinding))
       {
+      case WORLD_MATRIX:
         param->bindValue(this, &RenderState::autoBindingGetWorldMatrix);
-      }
-      else if (strcmp(autoBinding, "VIEW_MATRIX") == 0)
-      {
+        break;
+      case VIEW_MATRIX:
         param->bindValue(this, &RenderState::autoBindingGetViewMatrix);
-      }
-      else if (strcmp(autoBinding, "PROJECTION_MATRIX") == 0)
-      {
+        break;
+      case PROJECTION_MATRIX:
         param->bindValue(this, &RenderState::autoBindingGetProjectionMatrix);
-      }
-      else if (strcmp(autoBinding, "WORLD_VIEW_MATRIX") == 0)
-      {
+        break;
+      case WORLD_VIEW_MATRIX:
         param->bindValue(this, &RenderState::autoBindingGetWorldViewMatrix);
-      }
-      else if (strcmp(autoBinding, "VIEW_PROJECTION_MATRIX") == 0)
-      {
+        break;
+      case VIEW_PROJECTION_MATRIX:
         param->bindValue(this, &RenderState::autoBindingGetViewProjectionMatrix);
-      }
-      else if (strcmp(autoBinding, "WORLD_VIEW_PROJECTION_MATRIX") == 0)
-      {
+        break;
+      case WORLD_VIEW_PROJECTION_MATRIX:
         param->bindValue(this, &RenderState::autoBindingGetWorldViewProjectionMatrix);
-      }
-      else if (strcmp(autoBinding, "INVERSE_TRANSPOSE_WORLD_MATRIX") == 0)
-      {
+        break;
+      case INVERSE_TRANSPOSE_WORLD_MATRIX:
         param->bindValue(this, &RenderState::autoBindingGetInverseTransposeWorldMatrix);
-      }
-      else if (strcmp(autoBinding, "INVERSE_TRANSPOSE_WORLD_VIEW_MATRIX") == 0)
-      {
+        break;
+      case INVERSE_TRANSPOSE_WORLD_VIEW_MATRIX:
         param->bindValue(this, &RenderState::autoBindingGetInverseTransposeWorldViewMatrix);
-      }
-      else if (strcmp(autoBinding, "CAMERA_WORLD_POSITION") == 0)
-      {
+        break;
+      case CAMERA_WORLD_POSITION:
         param->bindValue(this, &RenderState::autoBindingGetCameraWorldPosition);
-      }
-      else if (strcmp(autoBinding, "CAMERA_VIEW_POSITION") == 0)
-      {
+        break;
+      case CAMERA_VIEW_POSITION:
         param->bindValue(this, &RenderState::autoBindingGetCameraViewPosition);
-      }
-      else if (strcmp(autoBinding, "MATRIX_PALETTE") == 0)
-      {
+        break;
+      case MATRIX_PALETTE:
         param->bindValue(this, &RenderState::autoBindingGetMatrixPalette, &RenderState::autoBindingGetMatrixPaletteSize);
-      }
-      else if (strcmp(autoBinding, "SCENE_AMBIENT_COLOR") == 0)
-      {
+        break;
+      case SCENE_AMBIENT_COLOR:
         param->bindValue(this, &RenderState::autoBindingGetAmbientColor);
-      }
-      else
-      {
+        break;
+      default:
         bound = false;
         GP_WARN("Unsupported auto binding type (%s).", autoBinding);
+        break;
       }
     }
 
@@ -413,8 +393,9 @@ namespace gameplay
   {
     assert(pass);
 
-    // Get the combined modified state bits for our RenderState hierarchy.
+    // Get the combined modified state bits and parameter versions for our RenderState hierarchy.
     long stateOverrideBits = _state ? _state->_bits : 0;
+    unsigned int parametersVersion = _parametersVersion;
     RenderState* rs = _parent;
     while (rs)
     {
@@ -422,28 +403,58 @@ namespace gameplay
       {
         stateOverrideBits |= rs->_state->_bits;
       }
+      parametersVersion += rs->_parametersVersion;
       rs = rs->_parent;
     }
 
     // Restore renderer state to its default, except for explicitly specified states
     StateBlock::restore(stateOverrideBits);
 
-    // Apply parameter bindings and renderer state for the entire hierarchy, top-down.
-    rs = nullptr;
+    // Apply parameter bindings for the entire hierarchy, top-down, without looking up any uniform.
     Effect* effect = pass->getEffect();
+    if (_parameterBindingsEffect != effect || _parameterBindingsVersion != parametersVersion)
+    {
+      compileParameterBindings(effect, parametersVersion);
+    }
+    for (const ParameterBinding& binding : _parameterBindings)
+    {
+      binding.parameter->bind(effect, binding.uniform);
+    }
+
+    // Apply renderer state for the entire hierarchy, top-down.
+    rs = nullptr;
     while ((rs = getTopmost(rs)))
     {
-      for (size_t i = 0, count = rs->_parameters.size(); i < count; ++i)
+      if (rs->_state)
       {
-        assert(rs->_parameters[i]);
-        rs->_parameters[i]->bind(effect);
+        rs->_state->bindNoRestore();
       }
+    }
+  }
 
-      if (rs->_state)
+  void RenderState::compileParameterBindings(Effect* effect, unsigned int parametersVersion)
+  {
+    assert(effect);
+
+    _parameterBindings.clear();
+    RenderState* rs = nullptr;
+    while ((rs = getTopmost(rs)))
+    {
+      for (MaterialParameter* param : rs->_parameters)
       {
-        rs->_state->bindNoRestore();
+        assert(param);
+        Uniform* uniform = param->getUniform(effect);
+        if (uniform)
+        {
+          ParameterBinding binding;
+          binding.parameter = param;
+          binding.uniform = uniform;
+          _parameterBindings.push_back(binding);
+        }
       }
     }
+    _parameterBindingsEffect = effect;
+    _parameterBindingsVersion = parametersVersion;
   }
 
   RenderState* RenderState::getTopmost(RenderState* below)
@@ -468,6 +479,16 @@ namespace gameplay
     return nullptr;
   }
 
+  bool RenderState::isBlendEnabled() const
+  {
+    for (const RenderState* rs = this; rs; rs = rs->_parent)
+    {
+      if (rs->_state && (rs->_state->_bits & RS_BLEND))
+        return rs->_state->_blendEnabled;
+    }
+    return false;
+  }
+
   void RenderState::cloneInto(RenderState* renderState, NodeCloneContext& context) const
   {
     assert(renderState);
@@ -487,6 +508,7 @@ namespace gameplay
       assert(param);
       auto& paramCopy = renderState->_parameters.emplace_back(new MaterialParameter(param->getName()));
       param->cloneInto(paramCopy);
+      ++renderState->_parametersVersion;
     }
 
     //for (auto& param : _parameters)
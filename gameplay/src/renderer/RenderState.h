@@ -7,10 +7,12 @@
 namespace gameplay
 {
 
+  class Effect;
   class MaterialParameter;
   class Node;
   class NodeCloneContext;
   class Pass;
+  class Uniform;
 
   /**
    * Defines the rendering state of the graphics device.
@@ -22,6 +24,7 @@ namespace gameplay
     friend class Technique;
     friend class Pass;
     friend class Model;
+    friend class RenderQueue;
 
   public:
 
@@ -529,6 +532,24 @@ namespace gameplay
      */
     void setParameterAutoBinding(const char* name, const char* autoBinding);
 
+    /**
+     * Gets the built-in auto binding with the given name.
+     *
+     * @param name The name of an AutoBinding enum constant, such as "WORLD_MATRIX".
+     *
+     * @return The auto binding, or NONE if the name is not a built-in auto binding.
+     */
+    static AutoBinding getAutoBinding(const char* name);
+
+    /**
+     * Gets the name of a built-in auto binding.
+     *
+     * @param autoBinding The auto binding.
+     *
+     * @return The name of the AutoBinding enum constant, or nullptr for NONE.
+     */
+    static const char* getAutoBindingName(AutoBinding autoBinding);
+
     /**
      * Sets the fixed-function render state of this object to the state contained
      * in the specified StateBlock.
@@ -603,6 +624,9 @@ namespace gameplay
     /**
      * Binds the render state for this RenderState and any of its parents, top-down,
      * for the given pass.
+     *
+     * The parameters of the hierarchy are matched to the uniforms of the pass
+     * effect once, and set from that table on every bind after that.
      */
     void bind(Pass* pass);
 
@@ -611,6 +635,12 @@ namespace gameplay
      */
     RenderState* getTopmost(RenderState* below);
 
+    /**
+     * Determines whether blending is enabled when this RenderState is bound, which
+     * is set by the state block nearest to it in the hierarchy that sets it.
+     */
+    bool isBlendEnabled() const;
+
     /**
      * Copies the data from this RenderState into the given RenderState.
      *
@@ -631,6 +661,23 @@ namespace gameplay
      */
     RenderState& operator=(const RenderState&);
 
+    /**
+     * A parameter of the hierarchy and the uniform of the pass effect that it sets.
+     */
+    struct ParameterBinding
+    {
+      MaterialParameter* parameter;
+      Uniform* uniform;
+    };
+
+    /**
+     * Matches the parameters of the hierarchy, top-down, to the uniforms of an effect.
+     *
+     * @param effect The effect of the pass being bound.
+     * @param parametersVersion The sum of the parameter versions of the hierarchy.
+     */
+    void compileParameterBindings(Effect* effect, unsigned int parametersVersion);
+
     // Internal auto binding handler methods.
     const Matrix& autoBindingGetWorldMatrix() const;
     const Matrix& autoBindingGetViewMatrix() const;
@@ -679,6 +726,13 @@ namespace gameplay
      * Map of custom auto binding resolvers.
      */
     static std::vector<AutoBindingResolver*> _customAutoBindingResolvers;
+
+  private:
+
+    std::vector<ParameterBinding> _parameterBindings;
+    Effect* _parameterBindingsEffect;
+    unsigned int _parameterBindingsVersion;
+    mutable unsigned int _parametersVersion;   // Changes when parameters are added to or removed from this render state.
   };
 
 }
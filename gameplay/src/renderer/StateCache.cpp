@@ -0,0 +1,325 @@
+#include "framework/Base.h"
+#include "renderer/StateCache.h"
+
+// Shadowed state that is not known, which every call changes.
+#define STATE_UNKNOWN 0xFFFFFFFFu
+
+namespace gameplay
+{
+
+  static void deviceUseProgram(GLuint program)
+  {
+    GL_ASSERT(glUseProgram(program));
+  }
+
+  static void deviceActiveTexture(GLenum texture)
+  {
+    GL_ASSERT(glActiveTexture(texture));
+  }
+
+  static void deviceBindTexture(GLenum target, GLuint texture)
+  {
+    GL_ASSERT(glBindTexture(target, texture));
+  }
+
+  static void deviceBindBuffer(GLenum target, GLuint buffer)
+  {
+    GL_ASSERT(glBindBuffer(target, buffer));
+  }
+
+  static void deviceBindVertexArray(GLuint array)
+  {
+#ifdef GP_USE_VAO
+    GL_ASSERT(glBindVertexArray(array));
+#endif
+  }
+
+  static void deviceUniform1fv(GLint location, GLsizei count, const GLfloat* values)
+  {
+    GL_ASSERT(glUniform1fv(location, count, values));
+  }
+
+  static void deviceUniform2fv(GLint location, GLsizei count, const GLfloat* values)
+  {
+    GL_ASSERT(glUniform2fv(location, count, values));
+  }
+
+  static void deviceUniform3fv(GLint location, GLsizei count, const GLfloat* values)
+  {
+    GL_ASSERT(glUniform3fv(location, count, values));
+  }
+
+  static void deviceUniform4fv(GLint location, GLsizei count, const GLfloat* values)
+  {
+    GL_ASSERT(glUniform4fv(location, count, values));
+  }
+
+  static void deviceUniform1iv(GLint location, GLsizei count, const GLint* values)
+  {
+    GL_ASSERT(glUniform1iv(location, count, values));
+  }
+
+  static void deviceUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* values)
+  {
+    GL_ASSERT(glUniformMatrix4fv(location, count, transpose, values));
+  }
+
+  static const StateCache::Functions __deviceFunctions =
+  {
+    deviceUseProgram,
+    deviceActiveTexture,
+    deviceBindTexture,
+    deviceBindBuffer,
+    deviceBindVertexArray,
+    deviceUniform1fv,
+    deviceUniform2fv,
+    deviceUniform3fv,
+    deviceUniform4fv,
+    deviceUniform1iv,
+    deviceUniformMatrix4fv
+  };
+
+  StateCache::StateCache()
+    : StateCache(__deviceFunctions)
+  {
+  }
+
+  StateCache::StateCache(const Functions& functions)
+    : _functions(functions), _programUniforms(nullptr)
+  {
+    invalidate();
+    resetStatistics();
+  }
+
+  StateCache::~StateCache()
+  {
+  }
+
+  StateCache* StateCache::getCurrent()
+  {
+    static StateCache cache;
+    return &cache;
+  }
+
+  void StateCache::useProgram(GLuint program)
+  {
+    if (record(PROGRAM, program != _program))
+    {
+      _functions.useProgram(program);
+      _program = program;
+      _programUniforms = program ? &_uniforms[program] : nullptr;
+    }
+  }
+
+  void StateCache::activeTexture(GLenum texture)
+  {
+    if (record(ACTIVE_TEXTURE, texture != _activeTexture))
+    {
+      _functions.activeTexture(texture);
+      _activeTexture = texture;
+    }
+  }
+
+  void StateCache::bindTexture(GLenum target, GLuint texture)
+  {
+    int slot = target == GL_TEXTURE_2D ? 0 : (target == GL_TEXTURE_CUBE_MAP ? 1 : -1);
+    unsigned int unit = _activeTexture - GL_TEXTURE0;
+    if (slot < 0 || _activeTexture == STATE_UNKNOWN || unit >= TEXTURE_UNIT_COUNT)
+    {
+      // Without a known unit, the binding could have changed on any of them.
+      if (slot >= 0 && _activeTexture == STATE_UNKNOWN)
+      {
+        for (unsigned int i = 0; i < TEXTURE_UNIT_COUNT; ++i)
+          _textures[i][slot] = STATE_UNKNOWN;
+      }
+      record(TEXTURE, true);
+      _functions.bindTexture(target, texture);
+      return;
+    }
+
+    if (record(TEXTURE, texture != _textures[unit][slot]))
+    {
+      _functions.bindTexture(target, texture);
+      _textures[unit][slot] = texture;
+    }
+  }
+
+  void StateCache::bindBuffer(GLenum target, GLuint buffer)
+  {
+    GLuint* binding = target == GL_ARRAY_BUFFER ? &_arrayBuffer : (target == GL_ELEMENT_ARRAY_BUFFER ? &_elementArrayBuffer : nullptr);
+    if (record(BUFFER, binding == nullptr || buffer != *binding))
+    {
+      _functions.bindBuffer(target, buffer);
+      if (binding)
+        *binding = buffer;
+    }
+  }
+
+  void StateCache::bindVertexArray(GLuint array)
+  {
+    if (record(VERTEX_ARRAY, array != _vertexArray))
+    {
+      _functions.bindVertexArray(array);
+      _vertexArray = array;
+
+      // The element array buffer binding is part of the vertex array.
+      _elementArrayBuffer = STATE_UNKNOWN;
+    }
+  }
+
+  void StateCache::uniform1fv(GLint location, GLsizei count, const GLfloat* values)
+  {
+    if (setUniform(location, count, values, count * sizeof(GLfloat)))
+      _functions.uniform1fv(location, count, values);
+  }
+
+  void StateCache::uniform2fv(GLint location, GLsizei count, const GLfloat* values)
+  {
+    if (setUniform(location, count, values, count * 2 * sizeof(GLfloat)))
+      _functions.uniform2fv(location, count, values);
+  }
+
+  void StateCache::uniform3fv(GLint location, GLsizei count, const GLfloat* values)
+  {
+    if (setUniform(location, count, values, count * 3 * sizeof(GLfloat)))
+      _functions.uniform3fv(location, count, values);
+  }
+
+  void StateCache::uniform4fv(GLint location, GLsizei count, const GLfloat* values)
+  {
+    if (setUniform(location, count, values, count * 4 * sizeof(GLfloat)))
+      _functions.uniform4fv(location, count, values);
+  }
+
+  void StateCache::uniform1iv(GLint location, GLsizei count, const GLint* values)
+  {
+    if (setUniform(location, count, values, count * sizeof(GLint)))
+      _functions.uniform1iv(location, count, values);
+  }
+
+  void StateCache::uniformMatrix4fv(GLint location, GLsizei count, const GLfloat* values)
+  {
+    if (setUniform(location, count, values, count * 16 * sizeof(GLfloat)))
+      _functions.uniformMatrix4fv(location, count, GL_FALSE, values);
+  }
+
+  bool StateCache::setUniform(GLint location, GLsizei count, const void* values, unsigned int size)
+  {
+    assert(values);
+
+    if (_programUniforms == nullptr || location < 0)
+      return record(UNIFORM, true);
+
+    if (count != 1)
+    {
+      // Array elements can also be set through their own locations, so after
+      // setting several values none of the program's values are known.
+      _programUniforms->clear();
+      return record(UNIFORM, true);
+    }
+
+    assert(size <= sizeof(UniformValue::data));
+    UniformValue& value = (*_programUniforms)[location];
+    bool changed = value.size != size || memcmp(value.data, values, size) != 0;
+    if (changed)
+    {
+      value.size = size;
+      memcpy(value.data, values, size);
+    }
+    return record(UNIFORM, changed);
+  }
+
+  void StateCache::programDeleted(GLuint program)
+  {
+    if (program == _program)
+      _programUniforms = nullptr;
+    _uniforms.erase(program);
+  }
+
+  void StateCache::textureDeleted(GLuint texture)
+  {
+    if (texture == 0)
+      return;
+
+    for (unsigned int i = 0; i < TEXTURE_UNIT_COUNT; ++i)
+    {
+      for (unsigned int j = 0; j < 2; ++j)
+      {
+        if (_textures[i][j] == texture)
+          _textures[i][j] = 0;
+      }
+    }
+  }
+
+  void StateCache::bufferDeleted(GLuint buffer)
+  {
+    if (buffer == 0)
+      return;
+
+    if (_arrayBuffer == buffer)
+      _arrayBuffer = 0;
+    if (_elementArrayBuffer == buffer)
+      _elementArrayBuffer = 0;
+  }
+
+  void StateCache::vertexArrayDeleted(GLuint array)
+  {
+    if (array != 0 && _vertexArray == array)
+    {
+      _vertexArray = 0;
+      _elementArrayBuffer = STATE_UNKNOWN;
+    }
+  }
+
+  void StateCache::invalidate()
+  {
+    _program = STATE_UNKNOWN;
+    invalidateTextures();
+    _arrayBuffer = STATE_UNKNOWN;
+    _elementArrayBuffer = STATE_UNKNOWN;
+    _vertexArray = STATE_UNKNOWN;
+    _uniforms.clear();
+    _programUniforms = nullptr;
+  }
+
+  void StateCache::invalidateTextures()
+  {
+    _activeTexture = STATE_UNKNOWN;
+    for (unsigned int i = 0; i < TEXTURE_UNIT_COUNT; ++i)
+    {
+      _textures[i][0] = STATE_UNKNOWN;
+      _textures[i][1] = STATE_UNKNOWN;
+    }
+  }
+
+  unsigned int StateCache::getIssuedCount(CallType type) const
+  {
+    assert(type < CALL_TYPE_COUNT);
+    return _issued[type];
+  }
+
+  unsigned int StateCache::getSkippedCount(CallType type) const
+  {
+    assert(type < CALL_TYPE_COUNT);
+    return _skipped[type];
+  }
+
+  void StateCache::resetStatistics()
+  {
+    for (unsigned int i = 0; i < CALL_TYPE_COUNT; ++i)
+    {
+      _issued[i] = 0;
+      _skipped[i] = 0;
+    }
+  }
+
+  bool StateCache::record(CallType type, bool changed)
+  {
+    if (changed)
+      ++_issued[type];
+    else
+      ++_skipped[type];
+    return changed;
+  }
+
+}
@@ -0,0 +1,291 @@
+#pragma once
+
+namespace gameplay
+{
+
+  /**
+   * Defines a cache of the bound graphics state, which skips the calls that
+   * would bind or set again what is already bound or set.
+   *
+   * The cache shadows the program in use, the active texture unit and the 2D
+   * and cube map textures bound to each unit, the array and element array
+   * buffers, the vertex array, and the uniform values of each program. A call
+   * is only made when it changes the shadowed state, or when the state it
+   * changes is not shadowed.
+   *
+   * Every bind and uniform upload of the engine goes through the current
+   * cache (see getCurrent()), which keeps it in sync with the context. Code
+   * that makes these calls directly must call invalidate() afterwards, and so
+   * must the platform whenever it creates or recreates the context.
+   *
+   * The cache makes its calls through a table of functions, so it can be
+   * tested against a mock table without a graphics context. It counts the
+   * calls it issues and skips (see getIssuedCount() and getSkippedCount()).
+   *
+   * @script{ignore}
+   */
+  class StateCache
+  {
+  public:
+
+    /**
+     * The kinds of calls the cache makes.
+     */
+    enum CallType
+    {
+      PROGRAM,
+      ACTIVE_TEXTURE,
+      TEXTURE,
+      BUFFER,
+      VERTEX_ARRAY,
+      UNIFORM,
+      CALL_TYPE_COUNT
+    };
+
+    /**
+     * The functions the cache makes its calls through, with the signatures of the matching GL functions.
+     * Single uniform values are set with a count of 1.
+     */
+    struct Functions
+    {
+      void (*useProgram)(GLuint program);
+      void (*activeTexture)(GLenum texture);
+      void (*bindTexture)(GLenum target, GLuint texture);
+      void (*bindBuffer)(GLenum target, GLuint buffer);
+      void (*bindVertexArray)(GLuint array);
+      void (*uniform1fv)(GLint location, GLsizei count, const GLfloat* values);
+      void (*uniform2fv)(GLint location, GLsizei count, const GLfloat* values);
+      void (*uniform3fv)(GLint location, GLsizei count, const GLfloat* values);
+      void (*uniform4fv)(GLint location, GLsizei count, const GLfloat* values);
+      void (*uniform1iv)(GLint location, GLsizei count, const GLint* values);
+      void (*uniformMatrix4fv)(GLint location, GLsizei count, GLboolean transpose, const GLfloat* values);
+    };
+
+    /**
+     * Constructor, for a cache that calls the graphics device.
+     */
+    StateCache();
+
+    /**
+     * Constructor.
+     *
+     * @param functions The functions to make calls through.
+     */
+    StateCache(const Functions& functions);
+
+    /**
+     * Destructor.
+     */
+    ~StateCache();
+
+    /**
+     * Gets the cache the engine binds state through, which calls the graphics device.
+     *
+     * @return The current cache.
+     */
+    static StateCache* getCurrent();
+
+    /**
+     * Uses a program.
+     *
+     * @param program The program, or 0 for none.
+     */
+    void useProgram(GLuint program);
+
+    /**
+     * Makes a texture unit active.
+     *
+     * @param texture GL_TEXTURE0 plus the index of the unit.
+     */
+    void activeTexture(GLenum texture);
+
+    /**
+     * Binds a texture to the active texture unit.
+     *
+     * @param target The target, such as GL_TEXTURE_2D.
+     * @param texture The texture, or 0 for none.
+     */
+    void bindTexture(GLenum target, GLuint texture);
+
+    /**
+     * Binds a buffer.
+     *
+     * @param target The target, such as GL_ARRAY_BUFFER.
+     * @param buffer The buffer, or 0 for none.
+     */
+    void bindBuffer(GLenum target, GLuint buffer);
+
+    /**
+     * Binds a vertex array, which also binds its element array buffer.
+     *
+     * @param array The vertex array, or 0 for none.
+     */
+    void bindVertexArray(GLuint array);
+
+    /**
+     * Sets float uniform values of the program in use.
+     *
+     * @param location The location of the uniform.
+     * @param count The number of values.
+     * @param values The values.
+     */
+    void uniform1fv(GLint location, GLsizei count, const GLfloat* values);
+
+    /**
+     * Sets vec2 uniform values of the program in use.
+     *
+     * @param location The location of the uniform.
+     * @param count The number of values.
+     * @param values The values, 2 floats each.
+     */
+    void uniform2fv(GLint location, GLsizei count, const GLfloat* values);
+
+    /**
+     * Sets vec3 uniform values of the program in use.
+     *
+     * @param location The location of the uniform.
+     * @param count The number of values.
+     * @param values The values, 3 floats each.
+     */
+    void uniform3fv(GLint location, GLsizei count, const GLfloat* values);
+
+    /**
+     * Sets vec4 uniform values of the program in use.
+     *
+     * @param location The location of the uniform.
+     * @param count The number of values.
+     * @param values The values, 4 floats each.
+     */
+    void uniform4fv(GLint location, GLsizei count, const GLfloat* values);
+
+    /**
+     * Sets int or sampler uniform values of the program in use.
+     *
+     * @param location The location of the uniform.
+     * @param count The number of values.
+     * @param values The values.
+     */
+    void uniform1iv(GLint location, GLsizei count, const GLint* values);
+
+    /**
+     * Sets mat4 uniform values of the program in use.
+     *
+     * @param location The location of the uniform.
+     * @param count The number of values.
+     * @param values The values, 16 floats each in column-major order.
+     */
+    void uniformMatrix4fv(GLint location, GLsizei count, const GLfloat* values);
+
+    /**
+     * Forgets the uniform values of a program that was deleted.
+     *
+     * @param program The program.
+     */
+    void programDeleted(GLuint program);
+
+    /**
+     * Forgets a texture that was deleted, which the graphics device unbinds from every unit.
+     *
+     * @param texture The texture.
+     */
+    void textureDeleted(GLuint texture);
+
+    /**
+     * Forgets a buffer that was deleted, which the graphics device unbinds.
+     *
+     * @param buffer The buffer.
+     */
+    void bufferDeleted(GLuint buffer);
+
+    /**
+     * Forgets a vertex array that was deleted, which the graphics device unbinds.
+     *
+     * @param array The vertex array.
+     */
+    void vertexArrayDeleted(GLuint array);
+
+    /**
+     * Forgets all the shadowed state, so that the next call of each kind is made.
+     * Must be called after changing the state without going through the cache.
+     */
+    void invalidate();
+
+    /**
+     * Forgets the shadowed active texture unit and texture bindings, keeping the rest of the state.
+     * Must be called after binding textures without going through the cache.
+     */
+    void invalidateTextures();
+
+    /**
+     * Gets the number of calls of a kind made since the last resetStatistics().
+     *
+     * @param type The kind of call.
+     *
+     * @return The number of calls made.
+     */
+    unsigned int getIssuedCount(CallType type) const;
+
+    /**
+     * Gets the number of calls of a kind skipped since the last resetStatistics().
+     *
+     * @param type The kind of call.
+     *
+     * @return The number of calls skipped.
+     */
+    unsigned int getSkippedCount(CallType type) const;
+
+    /**
+     * Resets the counts of calls made and skipped.
+     */
+    void resetStatistics();
+
+  private:
+
+    /**
+     * The number of texture units whose bindings are shadowed.
+     */
+    static const unsigned int TEXTURE_UNIT_COUNT = 32;
+
+    /**
+     * A shadowed uniform value, up to a mat4.
+     */
+    struct UniformValue
+    {
+      unsigned int size;
+      unsigned char data[16 * sizeof(GLfloat)];
+    };
+
+    /**
+     * Hidden copy constructor.
+     */
+    StateCache(const StateCache& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    StateCache& operator=(const StateCache&);
+
+    /**
+     * Records a uniform upload, and returns whether it must be made.
+     */
+    bool setUniform(GLint location, GLsizei count, const void* values, unsigned int size);
+
+    /**
+     * Counts a call, and returns whether it must be made.
+     */
+    bool record(CallType type, bool changed);
+
+    Functions _functions;
+    GLuint _program;
+    GLenum _activeTexture;
+    GLuint _textures[TEXTURE_UNIT_COUNT][2];
+    GLuint _arrayBuffer;
+    GLuint _elementArrayBuffer;
+    GLuint _vertexArray;
+    std::unordered_map<GLuint, std::unordered_map<GLint, UniformValue> > _uniforms;
+    std::unordered_map<GLint, UniformValue>* _programUniforms;
+    unsigned int _issued[CALL_TYPE_COUNT];
+    unsigned int _skipped[CALL_TYPE_COUNT];
+  };
+
+}
@@ -1,7 +1,12 @@
 #include "framework/Base.h"
 #include "ui/Image.h"
+#include "renderer/StateCache.h"
 #include "renderer/Texture.h"
+#include "renderer/TextureContainer.h"
+#include "renderer/TextureStreamer.h"
+#include "framework/Game.h"
 #include "framework/FileSystem.h"
+#include "utils/ResourceRegistry.h"
 
 // PVRTC (GL_IMG_texture_compression_pvrtc) : Imagination based gpus
 #ifndef GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG
@@ -47,31 +52,32 @@
 namespace gameplay
 {
 
-  static std::vector<Texture*> __textureCache;
-  static TextureHandle __currentTextureId = 0;
-  static Texture::Type __currentTextureType = Texture::TEXTURE_2D;
+  static ResourceCache<Texture> __textureCache("textures");
 
   Texture::Texture() : _handle(0), _format(UNKNOWN), _type((Texture::Type)0), _width(0), _height(0), _mipmapped(false), _cached(false), _compressed(false),
-    _wrapS(Texture::REPEAT), _wrapT(Texture::REPEAT), _wrapR(Texture::REPEAT), _minFilter(Texture::NEAREST_MIPMAP_LINEAR), _magFilter(Texture::LINEAR)
+    _wrapS(Texture::REPEAT), _wrapT(Texture::REPEAT), _wrapR(Texture::REPEAT), _minFilter(Texture::NEAREST_MIPMAP_LINEAR), _magFilter(Texture::LINEAR),
+    _internalFormat(0), _texelType(0), _bpp(0), _baseLevel(0), _streamer(nullptr)
   {
   }
 
   Texture::~Texture()
   {
+    if (_streamer)
+    {
+      _streamer->remove(this);
+    }
+
     if (_handle)
     {
       GL_ASSERT(glDeleteTextures(1, &_handle));
+      StateCache::getCurrent()->textureDeleted(_handle);
       _handle = 0;
     }
 
     // Remove ourself from the texture cache.
     if (_cached)
     {
-      std::vector<Texture*>::iterator itr = std::find(__textureCache.begin(), __textureCache.end(), this);
-      if (itr != __textureCache.end())
-      {
-        __textureCache.erase(itr);
-      }
+      __textureCache.remove(_path, this);
     }
   }
 
@@ -80,27 +86,9 @@ namespace gameplay
     assert(path);
 
     // Search texture cache first.
-    for (size_t i = 0, count = __textureCache.size(); i < count; ++i)
-    {
-      Texture* t = __textureCache[i];
-      assert(t);
-      if (t->_path == path)
-      {
-        // If 'generateMipmaps' is true, call Texture::generateMipamps() to force the
-        // texture to generate its mipmap chain if it hasn't already done so.
-        if (generateMipmaps)
-        {
-          t->generateMipmaps();
-        }
-
-        // Found a match.
-        t->addRef();
-
-        return t;
-      }
-    }
-
-    Texture* texture = nullptr;
+    Texture* texture = findCached(path, generateMipmaps);
+    if (texture)
+      return texture;
 
     // Filter loading based on file extension.
     const char* ext = strrchr(FileSystem::resolvePath(path), '.');
@@ -113,7 +101,7 @@ namespace gameplay
         {
           Image* image = Image::create(path);
           if (image)
-            texture = create(image, generateMipmaps);
+            texture = createFromImage(path, image, generateMipmaps);
           SAFE_RELEASE(image);
         }
         else if (tolower(ext[1]) == 'p' && tolower(ext[2]) == 'v' && tolower(ext[3]) == 'r')
@@ -126,18 +114,28 @@ namespace gameplay
           // DDS file format (DXT/S3TC) compressed textures
           texture = createCompressedDDS(path);
         }
+        else if (tolower(ext[1]) == 'k' && tolower(ext[2]) == 't' && tolower(ext[3]) == 'x')
+        {
+          // KTX container (pre-mipped, usually compressed) textures
+          std::unique_ptr<TextureContainer> container(TextureContainer::create(path));
+          if (container)
+            texture = createFromContainer(path, container.get(), generateMipmaps);
+        }
+        break;
+      case 5:
+        if (tolower(ext[1]) == 'k' && tolower(ext[2]) == 't' && tolower(ext[3]) == 'x' && ext[4] == '2')
+        {
+          std::unique_ptr<TextureContainer> container(TextureContainer::create(path));
+          if (container)
+            texture = createFromContainer(path, container.get(), generateMipmaps);
+        }
         break;
       }
     }
 
     if (texture)
     {
-      texture->_path = path;
-      texture->_cached = true;
-
-      // Add to texture cache.
-      __textureCache.push_back(texture);
-
+      texture->addToCache(path);
       return texture;
     }
 
@@ -145,6 +143,42 @@ namespace gameplay
     return nullptr;
   }
 
+  Texture* Texture::findCached(const char* path, bool generateMipmaps)
+  {
+    assert(path);
+
+    Texture* t = __textureCache.find(path);
+    if (t)
+    {
+      // If 'generateMipmaps' is true, call Texture::generateMipamps() to force the
+      // texture to generate its mipmap chain if it hasn't already done so.
+      if (generateMipmaps)
+      {
+        t->generateMipmaps();
+      }
+
+      // Found a match.
+      t->addRef();
+    }
+
+    return t;
+  }
+
+  void Texture::addToCache(const char* path)
+  {
+    assert(path);
+    assert(!_cached);
+
+    _path = path;
+    _cached = true;
+
+    // Estimate the memory used, including a third more for the mipmap chain.
+    size_t memoryUsage = (size_t)_width * _height * getFormatBPP(_format) * (_type == TEXTURE_CUBE ? 6 : 1);
+    if (_mipmapped)
+      memoryUsage += memoryUsage / 3;
+    __textureCache.add(_path, this, memoryUsage);
+  }
+
   Texture* Texture::create(Image* image, bool generateMipmaps)
   {
     assert(image);
@@ -161,6 +195,119 @@ namespace gameplay
     }
   }
 
+  Texture* Texture::createFromImage(const char* path, Image* image, bool generateMipmaps)
+  {
+    assert(path);
+    assert(image);
+
+    // Stream mipmapped textures when the game has a streamer; small ones are created whole.
+    TextureStreamer* streamer = generateMipmaps ? Game::getInstance()->getTextureStreamer() : nullptr;
+    Texture* texture = streamer ? streamer->create(path, image) : nullptr;
+    if (texture == nullptr)
+      texture = create(image, generateMipmaps);
+    return texture;
+  }
+
+  Texture* Texture::createFromLevels(Format format, unsigned int width, unsigned int height, const std::vector<std::vector<unsigned char> >& levels)
+  {
+    assert(!levels.empty());
+
+    GLint internalFormat = getFormatInternal(format);
+    assert(internalFormat != 0);
+    GLenum texelType = getFormatTexel(format);
+
+    GLuint textureId;
+    GL_ASSERT(glGenTextures(1, &textureId));
+    StateCache::getCurrent()->bindTexture(GL_TEXTURE_2D, textureId);
+    GL_ASSERT(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    for (unsigned int level = 0, count = (unsigned int)levels.size(); level < count; ++level)
+    {
+      GLsizei levelWidth = std::max(width >> level, 1u);
+      GLsizei levelHeight = std::max(height >> level, 1u);
+      GL_ASSERT(glTexImage2D(GL_TEXTURE_2D, level, internalFormat, levelWidth, levelHeight, 0, internalFormat, texelType, levels[level].data()));
+    }
+
+    bool mipmapped = levels.size() > 1;
+    Filter minFilter = mipmapped ? NEAREST_MIPMAP_LINEAR : LINEAR;
+    GL_ASSERT(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
+
+    Texture* texture = new Texture();
+    texture->_handle = textureId;
+    texture->_format = format;
+    texture->_type = TEXTURE_2D;
+    texture->_width = width;
+    texture->_height = height;
+    texture->_mipmapped = mipmapped;
+    texture->_minFilter = minFilter;
+    texture->_internalFormat = internalFormat;
+    texture->_texelType = texelType;
+    texture->_bpp = getFormatBPP(format);
+
+    return texture;
+  }
+
+  Texture* Texture::createStreamed(Format format, unsigned int width, unsigned int height, unsigned int levelCount)
+  {
+    assert(levelCount > 0);
+
+    GLint internalFormat = getFormatInternal(format);
+    assert(internalFormat != 0);
+
+    GLuint textureId;
+    GL_ASSERT(glGenTextures(1, &textureId));
+    StateCache::getCurrent()->bindTexture(GL_TEXTURE_2D, textureId);
+#if defined(GL_TEXTURE_BASE_LEVEL)
+    GL_ASSERT(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, levelCount - 1));
+    GL_ASSERT(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1));
+#endif
+    GL_ASSERT(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, NEAREST_MIPMAP_LINEAR));
+
+    Texture* texture = new Texture();
+    texture->_handle = textureId;
+    texture->_format = format;
+    texture->_type = TEXTURE_2D;
+    texture->_width = width;
+    texture->_height = height;
+    texture->_mipmapped = true;
+    texture->_minFilter = NEAREST_MIPMAP_LINEAR;
+    texture->_internalFormat = internalFormat;
+    texture->_texelType = getFormatTexel(format);
+    texture->_bpp = getFormatBPP(format);
+    texture->_baseLevel = levelCount;
+
+    return texture;
+  }
+
+  void Texture::setBaseLevel(unsigned int baseLevel, const std::vector<std::vector<unsigned char> >* levels)
+  {
+    assert(_type == TEXTURE_2D);
+
+    if (baseLevel == _baseLevel)
+      return;
+
+    StateCache::getCurrent()->bindTexture(GL_TEXTURE_2D, _handle);
+    GL_ASSERT(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+    // Upload the new levels before sampling from them.
+    for (unsigned int level = baseLevel; level < _baseLevel; ++level)
+    {
+      assert(levels && level < levels->size() && !(*levels)[level].empty());
+      GLsizei width = std::max(_width >> level, 1u);
+      GLsizei height = std::max(_height >> level, 1u);
+      GL_ASSERT(glTexImage2D(GL_TEXTURE_2D, level, _internalFormat, width, height, 0, _internalFormat, _texelType, (*levels)[level].data()));
+    }
+#if defined(GL_TEXTURE_BASE_LEVEL)
+    GL_ASSERT(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, baseLevel));
+#endif
+
+    // Respecifying a level as empty frees its storage.
+    for (unsigned int level = _baseLevel; level < baseLevel; ++level)
+    {
+      GL_ASSERT(glTexImage2D(GL_TEXTURE_2D, level, _internalFormat, 0, 0, 0, _internalFormat, _texelType, nullptr));
+    }
+    _baseLevel = baseLevel;
+  }
+
   GLint Texture::getFormatInternal(Format format)
   {
     switch (format)
@@ -244,7 +391,7 @@ namespace gameplay
     // Create the texture.
     GLuint textureId;
     GL_ASSERT(glGenTextures(1, &textureId));
-    GL_ASSERT(glBindTexture(target, textureId));
+    StateCache::getCurrent()->bindTexture(target, textureId);
     GL_ASSERT(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
 #ifndef OPENGL_ES
     // glGenerateMipmap is new in OpenGL 3.0. For OpenGL 2.0 we must fallback to use glTexParameteri
@@ -267,6 +414,7 @@ namespace gameplay
       if (bpp == 0)
       {
         glDeleteTextures(1, &textureId);
+        StateCache::getCurrent()->textureDeleted(textureId);
         GP_ERROR("Failed to determine texture size because format is UNKNOWN.");
         return nullptr;
       }
@@ -311,10 +459,6 @@ namespace gameplay
     if (generateMipmaps)
       texture->generateMipmaps();
 
-
-    // Restore the texture id
-    GL_ASSERT(glBindTexture((GLenum)__currentTextureType, __currentTextureId));
-
     return texture;
   }
 
@@ -326,7 +470,8 @@ namespace gameplay
     if (glIsTexture(handle))
     {
       // There is no real way to query for texture type, but an error will be returned if a cube texture is bound to a 2D texture... so check for that
-      glBindTexture(GL_TEXTURE_CUBE_MAP, handle);
+      StateCache* stateCache = StateCache::getCurrent();
+      stateCache->bindTexture(GL_TEXTURE_CUBE_MAP, handle);
       if (glGetError() == GL_NO_ERROR)
       {
         texture->_type = TEXTURE_CUBE;
@@ -335,10 +480,10 @@ namespace gameplay
       {
         // For now, it's either or. But if 3D textures and others are added, it might be useful to simply test a bunch of bindings and seeing which one doesn't error out
         texture->_type = TEXTURE_2D;
-      }
 
-      // Restore the texture id
-      GL_ASSERT(glBindTexture((GLenum)__currentTextureType, __currentTextureId));
+        // The failed bind left the previous cube map binding in place, which the cache now has wrong.
+        stateCache->invalidateTextures();
+      }
     }
     texture->_handle = handle;
     texture->_format = format;
@@ -358,7 +503,7 @@ namespace gameplay
     assert((!_compressed));
     assert((!_cached));
 
-    GL_ASSERT(glBindTexture((GLenum)_type, _handle));
+    StateCache::getCurrent()->bindTexture((GLenum)_type, _handle);
 
     if (_type == Texture::TEXTURE_2D)
     {
@@ -380,9 +525,117 @@ namespace gameplay
     {
       generateMipmaps();
     }
+  }
+
+  // Determines whether the device can sample a compressed format. The list of formats is queried once.
+  static bool isCompressedFormatSupported(GLenum format)
+  {
+    static std::vector<GLint> formats;
+    static bool queried = false;
+    if (!queried)
+    {
+      GLint count = 0;
+      GL_ASSERT(glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count));
+      formats.resize(count);
+      if (count > 0)
+        GL_ASSERT(glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data()));
+      queried = true;
+    }
+    return std::find(formats.begin(), formats.end(), (GLint)format) != formats.end();
+  }
+
+  Texture* Texture::createFromContainer(const char* path, TextureContainer* container, bool generateMipmaps)
+  {
+    assert(path);
+    assert(container);
+
+    // Fall back to decoding on the CPU when the device lacks the compressed format.
+    GLenum internalFormat = container->getInternalFormat();
+    bool compressed = container->isCompressed();
+    bool decompress = compressed && !isCompressedFormatSupported(internalFormat);
+    if (decompress && !TextureContainer::canDecompress(internalFormat))
+    {
+      GP_ERROR("Failed to create texture from '%s': compressed format 0x%x is unsupported by the device.", path, internalFormat);
+      return nullptr;
+    }
+
+    Format format = UNKNOWN;
+    GLenum pixelFormat = decompress ? GL_RGBA : container->getPixelFormat();
+    if (pixelFormat == GL_RGBA)
+      format = RGBA;
+    else if (pixelFormat == GL_RGB)
+      format = RGB;
+
+    // Upload uncompressed images with their sized internal format, which keeps sRGB. OpenGL ES 2 only accepts the pixel format.
+#ifdef OPENGL_ES
+    GLenum uncompressedFormat = pixelFormat;
+#else
+    GLenum uncompressedFormat = internalFormat;
+#endif
 
-    // Restore the texture id
-    GL_ASSERT(glBindTexture((GLenum)__currentTextureType, __currentTextureId));
+    unsigned int faceCount = container->getFaceCount();
+    unsigned int levelCount = container->getLevelCount();
+    GLenum target = faceCount == 6 ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+    GLuint textureId;
+    GL_ASSERT(glGenTextures(1, &textureId));
+    StateCache::getCurrent()->bindTexture(target, textureId);
+    GL_ASSERT(glPixelStorei(GL_UNPACK_ALIGNMENT, decompress ? 1 : container->getUnpackAlignment()));
+
+    // Upload the images straight from the container, without copying them.
+    std::vector<unsigned char> pixels;
+    for (unsigned int level = 0; level < levelCount; ++level)
+    {
+      GLsizei width = std::max(container->getWidth() >> level, 1u);
+      GLsizei height = std::max(container->getHeight() >> level, 1u);
+      for (unsigned int face = 0; face < faceCount; ++face)
+      {
+        GLenum faceTarget = faceCount == 6 ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : GL_TEXTURE_2D;
+        size_t size;
+        const unsigned char* data = container->getImage(level, face, &size);
+        if (decompress)
+        {
+          pixels.resize((size_t)width * height * 4);
+          if (!TextureContainer::decompress(internalFormat, data, size, width, height, pixels.data()))
+          {
+            GL_ASSERT(glDeleteTextures(1, &textureId));
+            StateCache::getCurrent()->textureDeleted(textureId);
+            GP_ERROR("Failed to decode level %u of texture '%s'.", level, path);
+            return nullptr;
+          }
+          GL_ASSERT(glTexImage2D(faceTarget, level, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data()));
+        }
+        else if (compressed)
+        {
+          GL_ASSERT(glCompressedTexImage2D(faceTarget, level, internalFormat, width, height, 0, (GLsizei)size, data));
+        }
+        else
+        {
+          GL_ASSERT(glTexImage2D(faceTarget, level, uncompressedFormat, width, height, 0, pixelFormat, container->getPixelType(), data));
+        }
+      }
+    }
+
+    // Compressed levels cannot be generated, so those textures use the levels they come with.
+    bool generate = (container->getGenerateMipmaps() || (generateMipmaps && levelCount == 1)) && (!compressed || decompress);
+    Filter minFilter = (levelCount > 1 || generate) ? NEAREST_MIPMAP_LINEAR : LINEAR;
+    GL_ASSERT(glTexParameteri(target, GL_TEXTURE_MIN_FILTER, minFilter));
+
+    Texture* texture = new Texture();
+    texture->_handle = textureId;
+    texture->_format = format;
+    texture->_type = (Type)target;
+    texture->_width = container->getWidth();
+    texture->_height = container->getHeight();
+    texture->_compressed = compressed && !decompress;
+    texture->_mipmapped = levelCount > 1;
+    texture->_minFilter = minFilter;
+    texture->_internalFormat = texture->_compressed ? internalFormat : pixelFormat;
+    texture->_texelType = texture->_compressed ? 0 : (decompress ? GL_UNSIGNED_BYTE : container->getPixelType());
+    texture->_bpp = getFormatBPP(format);
+    if (generate)
+      texture->generateMipmaps();
+
+    return texture;
   }
 
   // Computes the size of a PVRTC data chunk for a mipmap level of the given size.
@@ -465,7 +718,7 @@ namespace gameplay
     GLenum target = faceCount > 1 ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
     GLuint textureId;
     GL_ASSERT(glGenTextures(1, &textureId));
-    GL_ASSERT(glBindTexture(target, textureId));
+    StateCache::getCurrent()->bindTexture(target, textureId);
 
     Filter minFilter = mipMapCount > 1 ? NEAREST_MIPMAP_LINEAR : LINEAR;
     GL_ASSERT(glTexParameteri(target, GL_TEXTURE_MIN_FILTER, minFilter));
@@ -499,9 +752,6 @@ namespace gameplay
     // Free data.
     SAFE_DELETE_ARRAY(data);
 
-    // Restore the texture id
-    GL_ASSERT(glBindTexture((GLenum)__currentTextureType, __currentTextureId));
-
     return texture;
   }
 
@@ -1107,7 +1357,7 @@ namespace gameplay
     // Generate GL texture.
     GLuint textureId;
     GL_ASSERT(glGenTextures(1, &textureId));
-    GL_ASSERT(glBindTexture(target, textureId));
+    StateCache::getCurrent()->bindTexture(target, textureId);
 
     Filter minFilter = header.dwMipMapCount > 1 ? NEAREST_MIPMAP_LINEAR : LINEAR;
     GL_ASSERT(glTexParameteri(target, GL_TEXTURE_MIN_FILTER, minFilter));
@@ -1146,9 +1396,6 @@ namespace gameplay
     // Clean up mip levels structure.
     SAFE_DELETE_ARRAY(mipLevels);
 
-    // Restore the texture id
-    GL_ASSERT(glBindTexture((GLenum)__currentTextureType, __currentTextureId));
-
     return texture;
   }
 
@@ -1187,15 +1434,12 @@ namespace gameplay
     if (!_mipmapped)
     {
       GLenum target = (GLenum)_type;
-      GL_ASSERT(glBindTexture(target, _handle));
+      StateCache::getCurrent()->bindTexture(target, _handle);
       GL_ASSERT(glHint(GL_GENERATE_MIPMAP_HINT, GL_NICEST));
       if (std::addressof(glGenerateMipmap))
         GL_ASSERT(glGenerateMipmap(target));
 
       _mipmapped = true;
-
-      // Restore the texture id
-      GL_ASSERT(glBindTexture((GLenum)__currentTextureType, __currentTextureId));
     }
   }
 
@@ -1258,13 +1502,11 @@ namespace gameplay
   {
     assert(_texture);
 
+    if (_texture->_streamer)
+      _texture->_streamer->markUsed(_texture);
+
     GLenum target = (GLenum)_texture->_type;
-    if (__currentTextureId != _texture->_handle)
-    {
-      GL_ASSERT(glBindTexture(target, _texture->_handle));
-      __currentTextureId = _texture->_handle;
-      __currentTextureType = _texture->_type;
-    }
+    StateCache::getCurrent()->bindTexture(target, _texture->_handle);
 
     if (_texture->_minFilter != _minFilter)
     {
@@ -7,6 +7,8 @@ namespace gameplay
 {
 
   class Image;
+  class TextureContainer;
+  class TextureStreamer;
 
   /**
    * Defines a standard texture.
@@ -14,6 +16,9 @@ namespace gameplay
   class Texture : public Ref
   {
     friend class Sampler;
+    friend class AssetLoader;
+    friend class TextureDecoder;
+    friend class TextureStreamer;
 
   public:
 
@@ -321,6 +326,43 @@ namespace gameplay
      */
     Texture& operator=(const Texture&);
 
+    /**
+     * Returns a new reference to the cached texture loaded from the given path, or nullptr if it is not cached.
+     */
+    static Texture* findCached(const char* path, bool generateMipmaps);
+
+    /**
+     * Adds this texture to the texture cache under the given path.
+     */
+    void addToCache(const char* path);
+
+    /**
+     * Creates a texture from an image loaded from the given path, streaming it if the game has a texture streamer.
+     */
+    static Texture* createFromImage(const char* path, Image* image, bool generateMipmaps);
+
+    /**
+     * Creates a 2D texture from decoded levels, which are mipmaps when there is more than one.
+     */
+    static Texture* createFromLevels(Format format, unsigned int width, unsigned int height, const std::vector<std::vector<unsigned char> >& levels);
+
+    /**
+     * Creates a mipmapped 2D texture with no levels resident yet, for the texture streamer.
+     */
+    static Texture* createStreamed(Format format, unsigned int width, unsigned int height, unsigned int levelCount);
+
+    /**
+     * Makes the given level the most detailed one sampled, uploading the more
+     * detailed levels from the given data or freeing the levels that are no longer sampled.
+     */
+    void setBaseLevel(unsigned int baseLevel, const std::vector<std::vector<unsigned char> >* levels);
+
+    /**
+     * Creates a texture from the images of a KTX or KTX2 container, decoding
+     * them on the CPU if the device lacks their compressed format.
+     */
+    static Texture* createFromContainer(const char* path, TextureContainer* container, bool generateMipmaps);
+
     static Texture* createCompressedPVRTC(const char* path);
 
     static Texture* createCompressedDDS(const char* path);
@@ -352,6 +394,8 @@ namespace gameplay
     GLint _internalFormat;
     GLenum _texelType;
     size_t _bpp;
+    unsigned int _baseLevel;
+    TextureStreamer* _streamer;
   };
 
 }
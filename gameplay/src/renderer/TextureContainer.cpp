@@ -0,0 +1,752 @@
+#include "framework/Base.h"
+#include "renderer/TextureContainer.h"
+#include "framework/FileSystem.h"
+
+// Uncompressed formats
+#ifndef GL_RGB8
+#define GL_RGB8 0x8051
+#endif
+#ifndef GL_RGBA8
+#define GL_RGBA8 0x8058
+#endif
+#ifndef GL_SRGB8
+#define GL_SRGB8 0x8C41
+#endif
+#ifndef GL_SRGB8_ALPHA8
+#define GL_SRGB8_ALPHA8 0x8C43
+#endif
+
+// S3TC/DXT (GL_EXT_texture_compression_s3tc)
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+// ETC1 (OES_compressed_ETC1_RGB8_texture) and ETC2 (OpenGL ES 3.0, OpenGL 4.3)
+#ifndef ETC1_RGB8
+#define ETC1_RGB8 0x8D64
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 0x9276
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+
+// ASTC (GL_KHR_texture_compression_astc_ldr)
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#endif
+
+// Sizes of the fixed parts of the containers
+#define KTX_HEADER_SIZE                 64
+#define KTX2_HEADER_SIZE                80
+#define KTX2_LEVEL_INDEX_SIZE           24
+
+namespace gameplay
+{
+
+  static const unsigned char KTX_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+  static const unsigned char KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+  /**
+   * Maps a Vulkan format used by KTX2 to the OpenGL formats used to upload it.
+   */
+  struct VkFormatMapping
+  {
+    unsigned int vkFormat;
+    unsigned int internalFormat;
+    unsigned int pixelFormat;
+    unsigned int pixelType;
+  };
+
+  static const VkFormatMapping __vkFormats[] =
+  {
+    { 23, GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE },                          // VK_FORMAT_R8G8B8_UNORM
+    { 29, GL_SRGB8, GL_RGB, GL_UNSIGNED_BYTE },                         // VK_FORMAT_R8G8B8_SRGB
+    { 37, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE },                        // VK_FORMAT_R8G8B8A8_UNORM
+    { 43, GL_SRGB8_ALPHA8, GL_RGBA, GL_UNSIGNED_BYTE },                 // VK_FORMAT_R8G8B8A8_SRGB
+    { 131, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 0, 0 },                     // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+    { 133, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 0, 0 },                    // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+    { 135, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, 0, 0 },                    // VK_FORMAT_BC2_UNORM_BLOCK
+    { 137, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 0, 0 },                    // VK_FORMAT_BC3_UNORM_BLOCK
+    { 147, GL_COMPRESSED_RGB8_ETC2, 0, 0 },                             // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+    { 149, GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, 0, 0 },         // VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK
+    { 151, GL_COMPRESSED_RGBA8_ETC2_EAC, 0, 0 },                        // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+    { 157, GL_COMPRESSED_RGBA_ASTC_4x4_KHR, 0, 0 }                      // VK_FORMAT_ASTC_4x4_UNORM_BLOCK
+  };
+
+  static unsigned int readUInt(const unsigned char* ptr, bool swap)
+  {
+    unsigned int value;
+    memcpy(&value, ptr, sizeof(value));
+    if (swap)
+      value = ((value & 0xFF) << 24) | ((value & 0xFF00) << 8) | ((value >> 8) & 0xFF00) | (value >> 24);
+    return value;
+  }
+
+  static unsigned long long readULongLong(const unsigned char* ptr)
+  {
+    unsigned long long value;
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+  }
+
+  TextureContainer::TextureContainer()
+    : _size(0), _width(0), _height(0), _levelCount(0), _faceCount(0), _generateMipmaps(false),
+    _internalFormat(0), _pixelFormat(0), _pixelType(0), _unpackAlignment(1)
+  {
+  }
+
+  TextureContainer::~TextureContainer()
+  {
+  }
+
+  TextureContainer* TextureContainer::create(const char* path)
+  {
+    assert(path);
+
+    // The whole file is read at once; images are used where they lie in it.
+    int size = 0;
+    char* data = FileSystem::readAll(path, &size);
+    if (data == nullptr)
+    {
+      GP_WARN("Failed to read texture container '%s'.", path);
+      return nullptr;
+    }
+
+    TextureContainer* container = create(reinterpret_cast<unsigned char*>(data), (size_t)size);
+    if (container == nullptr)
+      GP_WARN("Failed to parse texture container '%s'.", path);
+    return container;
+  }
+
+  TextureContainer* TextureContainer::create(unsigned char* data, size_t size)
+  {
+    assert(data);
+
+    TextureContainer* container = new TextureContainer();
+    container->_data.reset(data);
+    container->_size = size;
+
+    bool parsed = false;
+    if (size >= KTX_HEADER_SIZE && memcmp(data, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) == 0)
+      parsed = container->parseKTX();
+    else if (size >= KTX2_HEADER_SIZE && memcmp(data, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0)
+      parsed = container->parseKTX2();
+    else
+      GP_WARN("Texture container is not a KTX or KTX2 file.");
+
+    if (!parsed)
+      SAFE_DELETE(container);
+    return container;
+  }
+
+  bool TextureContainer::addImage(size_t offset, size_t size)
+  {
+    if (offset > _size || size > _size - offset)
+    {
+      GP_WARN("Texture container image at offset %u is truncated.", (unsigned int)offset);
+      return false;
+    }
+    _images.push_back(std::make_pair(offset, size));
+    return true;
+  }
+
+  bool TextureContainer::parseKTX()
+  {
+    const unsigned char* header = _data.get() + sizeof(KTX_IDENTIFIER);
+
+    // Files written on a machine of the other endianness store everything swapped.
+    unsigned int endianness = readUInt(header, false);
+    if (endianness != 0x04030201 && endianness != 0x01020304)
+    {
+      GP_WARN("Invalid KTX endianness (0x%08x).", endianness);
+      return false;
+    }
+    bool swap = endianness == 0x01020304;
+    unsigned int glType = readUInt(header + 4, swap);
+    unsigned int glTypeSize = readUInt(header + 8, swap);
+    unsigned int glFormat = readUInt(header + 12, swap);
+    unsigned int glInternalFormat = readUInt(header + 16, swap);
+    unsigned int pixelWidth = readUInt(header + 24, swap);
+    unsigned int pixelHeight = readUInt(header + 28, swap);
+    unsigned int pixelDepth = readUInt(header + 32, swap);
+    unsigned int arrayElementCount = readUInt(header + 36, swap);
+    unsigned int faceCount = readUInt(header + 40, swap);
+    unsigned int levelCount = readUInt(header + 44, swap);
+    unsigned int keyValueDataSize = readUInt(header + 48, swap);
+
+    if (swap && glTypeSize > 1)
+    {
+      GP_WARN("Byte-swapped KTX files with %u byte components are unsupported.", glTypeSize);
+      return false;
+    }
+    if (pixelWidth == 0 || pixelHeight == 0 || pixelDepth > 1 || arrayElementCount > 0 || (faceCount != 1 && faceCount != 6))
+    {
+      GP_WARN("Unsupported KTX texture (%ux%ux%u, %u array elements, %u faces); only 2D and cube textures are supported.",
+        pixelWidth, pixelHeight, pixelDepth, arrayElementCount, faceCount);
+      return false;
+    }
+
+    _width = pixelWidth;
+    _height = pixelHeight;
+    _faceCount = faceCount;
+    _levelCount = std::max(levelCount, 1u);
+    _generateMipmaps = levelCount == 0;
+    _internalFormat = glInternalFormat;
+    _pixelFormat = glFormat;
+    _pixelType = glFormat != 0 ? glType : 0;
+    _unpackAlignment = 4;
+
+    // Each level is its size followed by its faces, each padded to 4 bytes.
+    size_t offset = (size_t)KTX_HEADER_SIZE + keyValueDataSize;
+    for (unsigned int level = 0; level < _levelCount; ++level)
+    {
+      if (offset > _size || _size - offset < sizeof(unsigned int))
+      {
+        GP_WARN("KTX level %u is truncated.", level);
+        return false;
+      }
+      size_t imageSize = readUInt(_data.get() + offset, swap);
+      offset += sizeof(unsigned int);
+      for (unsigned int face = 0; face < _faceCount; ++face)
+      {
+        if (!addImage(offset, imageSize))
+          return false;
+        offset += (imageSize + 3) & ~(size_t)3;
+      }
+    }
+    return true;
+  }
+
+  bool TextureContainer::parseKTX2()
+  {
+    const unsigned char* header = _data.get() + sizeof(KTX2_IDENTIFIER);
+    unsigned int vkFormat = readUInt(header, false);
+    unsigned int pixelWidth = readUInt(header + 8, false);
+    unsigned int pixelHeight = readUInt(header + 12, false);
+    unsigned int pixelDepth = readUInt(header + 16, false);
+    unsigned int layerCount = readUInt(header + 20, false);
+    unsigned int faceCount = readUInt(header + 24, false);
+    unsigned int levelCount = readUInt(header + 28, false);
+    unsigned int supercompressionScheme = readUInt(header + 32, false);
+
+    if (supercompressionScheme != 0)
+    {
+      GP_WARN("Supercompressed KTX2 files (scheme %u) are unsupported.", supercompressionScheme);
+      return false;
+    }
+    if (pixelWidth == 0 || pixelHeight == 0 || pixelDepth > 0 || layerCount > 0 || (faceCount != 1 && faceCount != 6))
+    {
+      GP_WARN("Unsupported KTX2 texture (%ux%ux%u, %u layers, %u faces); only 2D and cube textures are supported.",
+        pixelWidth, pixelHeight, pixelDepth, layerCount, faceCount);
+      return false;
+    }
+
+    const VkFormatMapping* mapping = nullptr;
+    for (size_t i = 0; i < sizeof(__vkFormats) / sizeof(__vkFormats[0]); ++i)
+    {
+      if (__vkFormats[i].vkFormat == vkFormat)
+        mapping = &__vkFormats[i];
+    }
+    if (mapping == nullptr)
+    {
+      GP_WARN("Unsupported KTX2 format (VkFormat %u).", vkFormat);
+      return false;
+    }
+
+    _width = pixelWidth;
+    _height = pixelHeight;
+    _faceCount = faceCount;
+    _levelCount = std::max(levelCount, 1u);
+    _generateMipmaps = levelCount == 0;
+    _internalFormat = mapping->internalFormat;
+    _pixelFormat = mapping->pixelFormat;
+    _pixelType = mapping->pixelType;
+
+    // The level index follows the header, most detailed level first; faces are stored one after another in each level.
+    if (_size - KTX2_HEADER_SIZE < (size_t)_levelCount * KTX2_LEVEL_INDEX_SIZE)
+    {
+      GP_WARN("KTX2 level index is truncated.");
+      return false;
+    }
+    for (unsigned int level = 0; level < _levelCount; ++level)
+    {
+      const unsigned char* entry = _data.get() + KTX2_HEADER_SIZE + level * KTX2_LEVEL_INDEX_SIZE;
+      unsigned long long byteOffset = readULongLong(entry);
+      unsigned long long byteLength = readULongLong(entry + 8);
+      if (byteOffset > _size || byteLength > _size)
+      {
+        GP_WARN("KTX2 level %u is truncated.", level);
+        return false;
+      }
+      size_t faceSize = (size_t)byteLength / _faceCount;
+      for (unsigned int face = 0; face < _faceCount; ++face)
+      {
+        if (!addImage((size_t)byteOffset + face * faceSize, faceSize))
+          return false;
+      }
+    }
+    return true;
+  }
+
+  unsigned int TextureContainer::getWidth() const
+  {
+    return _width;
+  }
+
+  unsigned int TextureContainer::getHeight() const
+  {
+    return _height;
+  }
+
+  unsigned int TextureContainer::getLevelCount() const
+  {
+    return _levelCount;
+  }
+
+  unsigned int TextureContainer::getFaceCount() const
+  {
+    return _faceCount;
+  }
+
+  bool TextureContainer::getGenerateMipmaps() const
+  {
+    return _generateMipmaps;
+  }
+
+  unsigned int TextureContainer::getInternalFormat() const
+  {
+    return _internalFormat;
+  }
+
+  unsigned int TextureContainer::getPixelFormat() const
+  {
+    return _pixelFormat;
+  }
+
+  unsigned int TextureContainer::getPixelType() const
+  {
+    return _pixelType;
+  }
+
+  bool TextureContainer::isCompressed() const
+  {
+    return _pixelFormat == 0;
+  }
+
+  unsigned int TextureContainer::getUnpackAlignment() const
+  {
+    return _unpackAlignment;
+  }
+
+  const unsigned char* TextureContainer::getImage(unsigned int level, unsigned int face, size_t* size) const
+  {
+    assert(level < _levelCount);
+    assert(face < _faceCount);
+    assert(size);
+
+    const std::pair<size_t, size_t>& image = _images[level * _faceCount + face];
+    *size = image.second;
+    return _data.get() + image.first;
+  }
+
+  bool TextureContainer::canDecompress(unsigned int internalFormat)
+  {
+    switch (internalFormat)
+    {
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+    case ETC1_RGB8:
+    case GL_COMPRESSED_RGB8_ETC2:
+    case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  // Expands a 565 color to 8 bits per channel.
+  static void decode565(unsigned int color, unsigned char* rgba)
+  {
+    unsigned int r = (color >> 11) & 31;
+    unsigned int g = (color >> 5) & 63;
+    unsigned int b = color & 31;
+    rgba[0] = (unsigned char)((r << 3) | (r >> 2));
+    rgba[1] = (unsigned char)((g << 2) | (g >> 4));
+    rgba[2] = (unsigned char)((b << 3) | (b >> 2));
+    rgba[3] = 255;
+  }
+
+  // Decodes the color half of an S3TC block. Only BC1 uses the three color mode, where the fourth color is black or transparent.
+  static void decodeS3TCColor(const unsigned char* block, bool threeColorMode, bool transparent, unsigned char pixels[16][4])
+  {
+    unsigned int c0 = block[0] | (block[1] << 8);
+    unsigned int c1 = block[2] | (block[3] << 8);
+    unsigned char colors[4][4];
+    decode565(c0, colors[0]);
+    decode565(c1, colors[1]);
+    for (int i = 0; i < 3; ++i)
+    {
+      if (c0 > c1 || !threeColorMode)
+      {
+        colors[2][i] = (unsigned char)((2 * colors[0][i] + colors[1][i]) / 3);
+        colors[3][i] = (unsigned char)((colors[0][i] + 2 * colors[1][i]) / 3);
+      }
+      else
+      {
+        colors[2][i] = (unsigned char)((colors[0][i] + colors[1][i]) / 2);
+        colors[3][i] = 0;
+      }
+    }
+    colors[2][3] = 255;
+    colors[3][3] = (c0 <= c1 && threeColorMode && transparent) ? 0 : 255;
+
+    unsigned int indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((unsigned int)block[7] << 24);
+    for (int i = 0; i < 16; ++i)
+    {
+      memcpy(pixels[i], colors[(indices >> (2 * i)) & 3], 4);
+    }
+  }
+
+  // Decodes the interpolated alpha half of a BC3 block.
+  static void decodeBC3Alpha(const unsigned char* block, unsigned char pixels[16][4])
+  {
+    unsigned int a0 = block[0];
+    unsigned int a1 = block[1];
+    unsigned char alphas[8] = { (unsigned char)a0, (unsigned char)a1 };
+    if (a0 > a1)
+    {
+      for (unsigned int i = 1; i < 7; ++i)
+        alphas[i + 1] = (unsigned char)(((7 - i) * a0 + i * a1) / 7);
+    }
+    else
+    {
+      for (unsigned int i = 1; i < 5; ++i)
+        alphas[i + 1] = (unsigned char)(((5 - i) * a0 + i * a1) / 5);
+      alphas[6] = 0;
+      alphas[7] = 255;
+    }
+
+    unsigned long long indices = 0;
+    for (int i = 0; i < 6; ++i)
+      indices |= (unsigned long long)block[2 + i] << (8 * i);
+    for (int i = 0; i < 16; ++i)
+    {
+      pixels[i][3] = alphas[(indices >> (3 * i)) & 7];
+    }
+  }
+
+  // Expands a 4 bit color channel to 8 bits.
+  static inline int expand4(int value)
+  {
+    return (value << 4) | value;
+  }
+
+  // Decodes the color of an ETC1 or ETC2 block. Pixels are indexed column by column in the block, and written row by row.
+  // ETC2 blocks whose differential base colors overflow use the T, H and planar modes instead. Punchthrough blocks
+  // store an opaque flag in place of the differential flag, and when it is clear, pixel index 2 is transparent black.
+  static void decodeETC(const unsigned char* block, bool etc2, bool punchthrough, unsigned char pixels[16][4])
+  {
+    static const int modifiers[8][4] =
+    {
+      { 2, 8, -2, -8 },
+      { 5, 17, -5, -17 },
+      { 9, 29, -9, -29 },
+      { 13, 42, -13, -42 },
+      { 18, 60, -18, -60 },
+      { 24, 80, -24, -80 },
+      { 33, 106, -33, -106 },
+      { 47, 183, -47, -183 }
+    };
+    static const int distances[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+    bool differential = punchthrough || (block[3] & 2) != 0;
+    bool opaque = !punchthrough || (block[3] & 2) != 0;
+    unsigned int msbs = (block[4] << 8) | block[5];
+    unsigned int lsbs = (block[6] << 8) | block[7];
+
+    // The sums of the 5 bit base colors and their signed 3 bit offsets select the ETC2 modes.
+    int sums[3];
+    for (int c = 0; c < 3; ++c)
+    {
+      int delta = block[c] & 7;
+      sums[c] = (block[c] >> 3) + (delta >= 4 ? delta - 8 : delta);
+    }
+
+    if (etc2 && differential && (sums[0] < 0 || sums[0] > 31 || sums[1] < 0 || sums[1] > 31))
+    {
+      int colors[2][3];
+      int paint[4][3];
+      if (sums[0] < 0 || sums[0] > 31)
+      {
+        // T mode: the first color, and the second color moved by a distance along the gray axis.
+        colors[0][0] = expand4((((block[0] >> 3) & 3) << 2) | (block[0] & 3));
+        colors[0][1] = expand4(block[1] >> 4);
+        colors[0][2] = expand4(block[1] & 15);
+        colors[1][0] = expand4(block[2] >> 4);
+        colors[1][1] = expand4(block[2] & 15);
+        colors[1][2] = expand4(block[3] >> 4);
+        int distance = distances[(((block[3] >> 2) & 3) << 1) | (block[3] & 1)];
+        for (int c = 0; c < 3; ++c)
+        {
+          paint[0][c] = colors[0][c];
+          paint[1][c] = colors[1][c] + distance;
+          paint[2][c] = colors[1][c];
+          paint[3][c] = colors[1][c] - distance;
+        }
+      }
+      else
+      {
+        // H mode: both colors moved by a distance, whose lowest bit is the order of the colors.
+        colors[0][0] = expand4((block[0] >> 3) & 15);
+        colors[0][1] = expand4(((block[0] & 7) << 1) | ((block[1] >> 4) & 1));
+        colors[0][2] = expand4((block[1] & 8) | ((block[1] & 3) << 1) | (block[2] >> 7));
+        colors[1][0] = expand4((block[2] >> 3) & 15);
+        colors[1][1] = expand4(((block[2] & 7) << 1) | (block[3] >> 7));
+        colors[1][2] = expand4((block[3] >> 3) & 15);
+        int first = (colors[0][0] << 16) | (colors[0][1] << 8) | colors[0][2];
+        int second = (colors[1][0] << 16) | (colors[1][1] << 8) | colors[1][2];
+        int distance = distances[(block[3] & 4) | ((block[3] & 1) << 1) | (first >= second ? 1 : 0)];
+        for (int c = 0; c < 3; ++c)
+        {
+          paint[0][c] = colors[0][c] + distance;
+          paint[1][c] = colors[0][c] - distance;
+          paint[2][c] = colors[1][c] + distance;
+          paint[3][c] = colors[1][c] - distance;
+        }
+      }
+
+      for (int x = 0; x < 4; ++x)
+      {
+        for (int y = 0; y < 4; ++y)
+        {
+          int i = x * 4 + y;
+          int index = (((msbs >> i) & 1) << 1) | ((lsbs >> i) & 1);
+          unsigned char* pixel = pixels[y * 4 + x];
+          if (!opaque && index == 2)
+          {
+            memset(pixel, 0, 4);
+            continue;
+          }
+          for (int c = 0; c < 3; ++c)
+            pixel[c] = (unsigned char)std::min(std::max(paint[index][c], 0), 255);
+          pixel[3] = 255;
+        }
+      }
+      return;
+    }
+
+    if (etc2 && differential && (sums[2] < 0 || sums[2] > 31))
+    {
+      // Planar mode: colors at the origin and at the horizontal and vertical ends, interpolated over the block.
+      int origin[3] =
+      {
+        (block[0] >> 1) & 63,
+        ((block[0] & 1) << 6) | ((block[1] >> 1) & 63),
+        ((block[1] & 1) << 5) | (block[2] & 0x18) | ((block[2] & 3) << 1) | (block[3] >> 7)
+      };
+      int horizontal[3] =
+      {
+        ((block[3] & 0x7C) >> 1) | (block[3] & 1),
+        (block[4] >> 1) & 127,
+        ((block[4] & 1) << 5) | (block[5] >> 3)
+      };
+      int vertical[3] =
+      {
+        ((block[5] & 7) << 3) | (block[6] >> 5),
+        ((block[6] & 31) << 2) | (block[7] >> 6),
+        block[7] & 63
+      };
+      for (int c = 0; c < 3; ++c)
+      {
+        // Green has 7 bits and red and blue have 6.
+        int shift = c == 1 ? 1 : 2;
+        int high = c == 1 ? 6 : 4;
+        origin[c] = (origin[c] << shift) | (origin[c] >> high);
+        horizontal[c] = (horizontal[c] << shift) | (horizontal[c] >> high);
+        vertical[c] = (vertical[c] << shift) | (vertical[c] >> high);
+      }
+      for (int y = 0; y < 4; ++y)
+      {
+        for (int x = 0; x < 4; ++x)
+        {
+          unsigned char* pixel = pixels[y * 4 + x];
+          for (int c = 0; c < 3; ++c)
+          {
+            int value = (x * (horizontal[c] - origin[c]) + y * (vertical[c] - origin[c]) + 4 * origin[c] + 2) >> 2;
+            pixel[c] = (unsigned char)std::min(std::max(value, 0), 255);
+          }
+          pixel[3] = 255;
+        }
+      }
+      return;
+    }
+
+    int base[2][3];
+    if (differential)
+    {
+      // Differential mode: 5 bit base colors, the second a signed 3 bit offset from the first.
+      for (int c = 0; c < 3; ++c)
+      {
+        int value = block[c] >> 3;
+        int second = sums[c] & 31;
+        base[0][c] = (value << 3) | (value >> 2);
+        base[1][c] = (second << 3) | (second >> 2);
+      }
+    }
+    else
+    {
+      // Individual mode: two 4 bit base colors.
+      for (int c = 0; c < 3; ++c)
+      {
+        base[0][c] = expand4(block[c] >> 4);
+        base[1][c] = expand4(block[c] & 15);
+      }
+    }
+    const int* table[2] = { modifiers[block[3] >> 5], modifiers[(block[3] >> 2) & 7] };
+    bool flip = (block[3] & 1) != 0;
+
+    for (int x = 0; x < 4; ++x)
+    {
+      for (int y = 0; y < 4; ++y)
+      {
+        int i = x * 4 + y;
+        int subblock = flip ? (y >= 2) : (x >= 2);
+        int index = (((msbs >> i) & 1) << 1) | ((lsbs >> i) & 1);
+        unsigned char* pixel = pixels[y * 4 + x];
+        if (!opaque && index == 2)
+        {
+          memset(pixel, 0, 4);
+          continue;
+        }
+
+        // Without the opaque flag, the smaller positive modifier is replaced by none.
+        int modifier = (!opaque && index == 0) ? 0 : table[subblock][index];
+        for (int c = 0; c < 3; ++c)
+          pixel[c] = (unsigned char)std::min(std::max(base[subblock][c] + modifier, 0), 255);
+        pixel[3] = 255;
+      }
+    }
+  }
+
+  // Decodes an EAC alpha block, whose 3 bit indices select a scaled modifier to add to the base alpha.
+  static void decodeEACAlpha(const unsigned char* block, unsigned char pixels[16][4])
+  {
+    static const int modifiers[16][8] =
+    {
+      { -3, -6, -9, -15, 2, 5, 8, 14 },
+      { -3, -7, -10, -13, 2, 6, 9, 12 },
+      { -2, -5, -8, -13, 1, 4, 7, 12 },
+      { -2, -4, -6, -13, 1, 3, 5, 12 },
+      { -3, -6, -8, -12, 2, 5, 7, 11 },
+      { -3, -7, -9, -11, 2, 6, 8, 10 },
+      { -4, -7, -8, -11, 3, 6, 7, 10 },
+      { -3, -5, -8, -11, 2, 4, 7, 10 },
+      { -2, -6, -8, -10, 1, 5, 7, 9 },
+      { -2, -5, -8, -10, 1, 4, 7, 9 },
+      { -2, -4, -8, -10, 1, 3, 7, 9 },
+      { -2, -5, -7, -10, 1, 4, 6, 9 },
+      { -3, -4, -7, -10, 2, 3, 6, 9 },
+      { -1, -2, -3, -10, 0, 1, 2, 9 },
+      { -4, -6, -8, -9, 3, 5, 7, 8 },
+      { -3, -5, -7, -9, 2, 4, 6, 8 }
+    };
+
+    int base = block[0];
+    int multiplier = block[1] >> 4;
+    const int* table = modifiers[block[1] & 15];
+    unsigned long long indices = 0;
+    for (int i = 0; i < 6; ++i)
+      indices = (indices << 8) | block[2 + i];
+    for (int x = 0; x < 4; ++x)
+    {
+      for (int y = 0; y < 4; ++y)
+      {
+        int index = (int)((indices >> (45 - 3 * (x * 4 + y))) & 7);
+        pixels[y * 4 + x][3] = (unsigned char)std::min(std::max(base + table[index] * multiplier, 0), 255);
+      }
+    }
+  }
+
+  bool TextureContainer::decompress(unsigned int internalFormat, const unsigned char* data, size_t size, unsigned int width, unsigned int height, unsigned char* rgba)
+  {
+    assert(data);
+    assert(rgba);
+
+    if (!canDecompress(internalFormat))
+      return false;
+
+    size_t blockSize = (internalFormat == GL_COMPRESSED_RGBA_S3TC_DXT3_EXT || internalFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT || internalFormat == GL_COMPRESSED_RGBA8_ETC2_EAC) ? 16 : 8;
+    unsigned int blocksWide = (width + 3) / 4;
+    unsigned int blocksHigh = (height + 3) / 4;
+    if (size < (size_t)blocksWide * blocksHigh * blockSize)
+      return false;
+
+    unsigned char pixels[16][4];
+    const unsigned char* block = data;
+    for (unsigned int by = 0; by < blocksHigh; ++by)
+    {
+      for (unsigned int bx = 0; bx < blocksWide; ++bx, block += blockSize)
+      {
+        switch (internalFormat)
+        {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+          decodeS3TCColor(block, true, false, pixels);
+          break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+          decodeS3TCColor(block, true, true, pixels);
+          break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+          decodeS3TCColor(block + 8, false, false, pixels);
+          for (int i = 0; i < 16; ++i)
+            pixels[i][3] = (unsigned char)(((block[i / 2] >> (4 * (i & 1))) & 15) * 17);
+          break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+          decodeS3TCColor(block + 8, false, false, pixels);
+          decodeBC3Alpha(block, pixels);
+          break;
+        case GL_COMPRESSED_RGB8_ETC2:
+          decodeETC(block, true, false, pixels);
+          break;
+        case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+          decodeETC(block, true, true, pixels);
+          break;
+        case GL_COMPRESSED_RGBA8_ETC2_EAC:
+          decodeETC(block + 8, true, false, pixels);
+          decodeEACAlpha(block, pixels);
+          break;
+        default:
+          decodeETC(block, false, false, pixels);
+          break;
+        }
+
+        // Blocks overhanging the edges of the image only write the pixels inside it.
+        for (unsigned int y = 0; y < 4 && by * 4 + y < height; ++y)
+        {
+          for (unsigned int x = 0; x < 4 && bx * 4 + x < width; ++x)
+          {
+            memcpy(&rgba[(((size_t)by * 4 + y) * width + bx * 4 + x) * 4], pixels[y * 4 + x], 4);
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+}
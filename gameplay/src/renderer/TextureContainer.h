@@ -0,0 +1,194 @@
+#pragma once
+
+namespace gameplay
+{
+
+  /**
+   * Defines a parsed KTX or KTX2 texture container.
+   *
+   * Containers hold images that are ready to upload: pre-generated mip levels,
+   * usually block-compressed, laid out so that the whole file is read with a
+   * single read and each image is used in place. Parsing makes no graphics
+   * calls, so containers can be read on any thread and tested without a
+   * graphics context.
+   *
+   * KTX2 files must not be supercompressed (Basis Universal or Zstandard),
+   * since no decoder for those is built in.
+   *
+   * For devices that lack a compressed format, decompress() decodes the S3TC
+   * (BC1, BC2, BC3), ETC1 and ETC2 (RGB8, RGB8A1 and RGBA8 EAC) formats to
+   * RGBA on the CPU. ASTC has no CPU decoder, so ASTC files only load on
+   * devices that support ASTC, and fail to load with an error elsewhere.
+   *
+   * @script{ignore}
+   */
+  class TextureContainer
+  {
+  public:
+
+    /**
+     * Destructor.
+     */
+    ~TextureContainer();
+
+    /**
+     * Reads a container from a .ktx or .ktx2 file.
+     *
+     * @param path The path of the file.
+     *
+     * @return The container, or nullptr if the file could not be read or is not a supported container.
+     */
+    static TextureContainer* create(const char* path);
+
+    /**
+     * Parses a container from memory.
+     *
+     * @param data The contents of a .ktx or .ktx2 file. The container takes ownership of it.
+     * @param size The size of the data in bytes.
+     *
+     * @return The container, or nullptr if the data is not a supported container.
+     */
+    static TextureContainer* create(unsigned char* data, size_t size);
+
+    /**
+     * Gets the width of the most detailed level.
+     *
+     * @return The width in pixels.
+     */
+    unsigned int getWidth() const;
+
+    /**
+     * Gets the height of the most detailed level.
+     *
+     * @return The height in pixels.
+     */
+    unsigned int getHeight() const;
+
+    /**
+     * Gets the number of mip levels stored in the container.
+     *
+     * @return The number of levels, at least 1.
+     */
+    unsigned int getLevelCount() const;
+
+    /**
+     * Gets the number of faces, which is 6 for cube maps and 1 otherwise.
+     *
+     * @return The number of faces.
+     */
+    unsigned int getFaceCount() const;
+
+    /**
+     * Determines whether the container asks for the mip chain to be generated after upload.
+     *
+     * @return True if the mip levels should be generated.
+     */
+    bool getGenerateMipmaps() const;
+
+    /**
+     * Gets the OpenGL internal format of the images.
+     *
+     * @return The internal format, such as GL_COMPRESSED_RGBA_S3TC_DXT5_EXT or GL_RGBA8.
+     */
+    unsigned int getInternalFormat() const;
+
+    /**
+     * Gets the OpenGL pixel format of uncompressed images.
+     *
+     * @return The pixel format, such as GL_RGBA, or 0 if the images are compressed.
+     */
+    unsigned int getPixelFormat() const;
+
+    /**
+     * Gets the OpenGL type of uncompressed images.
+     *
+     * @return The type, such as GL_UNSIGNED_BYTE, or 0 if the images are compressed.
+     */
+    unsigned int getPixelType() const;
+
+    /**
+     * Determines whether the images are block-compressed.
+     *
+     * @return True if the images are compressed.
+     */
+    bool isCompressed() const;
+
+    /**
+     * Gets the alignment of the rows of uncompressed images, for GL_UNPACK_ALIGNMENT.
+     *
+     * @return 4 for KTX files, whose rows are padded to 4 bytes, and 1 for KTX2 files.
+     */
+    unsigned int getUnpackAlignment() const;
+
+    /**
+     * Gets the data of an image.
+     *
+     * @param level The mip level.
+     * @param face The face.
+     * @param size Set to the size of the image in bytes.
+     *
+     * @return The image data.
+     */
+    const unsigned char* getImage(unsigned int level, unsigned int face, size_t* size) const;
+
+    /**
+     * Determines whether decompress() can decode a compressed format.
+     *
+     * @param internalFormat The OpenGL internal format.
+     *
+     * @return True if the format can be decoded on the CPU.
+     */
+    static bool canDecompress(unsigned int internalFormat);
+
+    /**
+     * Decodes a block-compressed image to RGBA.
+     *
+     * @param internalFormat The OpenGL internal format of the image.
+     * @param data The compressed image.
+     * @param size The size of the compressed image in bytes.
+     * @param width The width of the image.
+     * @param height The height of the image.
+     * @param rgba The buffer to write width * height * 4 bytes of RGBA pixels to.
+     *
+     * @return True if the image was decoded, false if the format is unsupported or the image is too small.
+     */
+    static bool decompress(unsigned int internalFormat, const unsigned char* data, size_t size, unsigned int width, unsigned int height, unsigned char* rgba);
+
+  private:
+
+    /**
+     * Constructor.
+     */
+    TextureContainer();
+
+    /**
+     * Hidden copy constructor.
+     */
+    TextureContainer(const TextureContainer& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    TextureContainer& operator=(const TextureContainer&);
+
+    bool parseKTX();
+
+    bool parseKTX2();
+
+    bool addImage(size_t offset, size_t size);
+
+    std::unique_ptr<unsigned char[]> _data;
+    size_t _size;
+    unsigned int _width;
+    unsigned int _height;
+    unsigned int _levelCount;
+    unsigned int _faceCount;
+    bool _generateMipmaps;
+    unsigned int _internalFormat;
+    unsigned int _pixelFormat;
+    unsigned int _pixelType;
+    unsigned int _unpackAlignment;
+    std::vector<std::pair<size_t, size_t> > _images;  // Offset and size of each face of each level, level by level.
+  };
+
+}
@@ -0,0 +1,311 @@
+#include "framework/Base.h"
+#include "renderer/TextureDecoder.h"
+#include "framework/JobSystem.h"
+#include "math/MathUtil.h"
+#include "ui/Image.h"
+
+// The box filter averages pixel pairs with SSE2 where it is available (all x64 targets).
+#if defined(GP_USE_SSE) && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define GP_USE_SSE2_DOWNSAMPLE
+#endif
+
+// The Kaiser filter has 6 taps per axis: the source pixels within 3 pixels of the center of each destination pixel.
+#define KAISER_TAP_COUNT 6
+#define KAISER_BETA 4.0f
+
+namespace gameplay
+{
+
+  static TextureDecoder::Filter __filter = TextureDecoder::BOX;
+
+  TextureDecoder::Result::Result()
+    : format(Texture::UNKNOWN), width(0), height(0)
+  {
+  }
+
+  TextureDecoder::Filter TextureDecoder::getFilter()
+  {
+    return __filter;
+  }
+
+  void TextureDecoder::setFilter(Filter filter)
+  {
+    __filter = filter;
+  }
+
+  bool TextureDecoder::decode(const char* path, bool generateMipmaps, Filter filter, Result* result)
+  {
+    assert(path);
+    assert(result);
+
+    Image* image = Image::create(path);
+    if (image == nullptr)
+    {
+      *result = Result();
+      return false;
+    }
+
+    result->format = image->getFormat() == Image::RGBA ? Texture::RGBA : Texture::RGB;
+    result->width = image->getWidth();
+    result->height = image->getHeight();
+    size_t bpp = image->getFormat() == Image::RGBA ? 4 : 3;
+    if (generateMipmaps)
+    {
+      generateLevels(image->getData(), result->width, result->height, bpp, filter, result->levels);
+    }
+    else
+    {
+      result->levels.resize(1);
+      result->levels[0].assign(image->getData(), image->getData() + (size_t)result->width * result->height * bpp);
+    }
+    SAFE_RELEASE(image);
+    return true;
+  }
+
+  void TextureDecoder::decode(JobSystem* jobSystem, const std::vector<std::string>& paths, bool generateMipmaps, Filter filter, std::vector<Result>& results)
+  {
+    results.clear();
+    results.resize(paths.size());
+    Result* data = results.data();
+    std::function<void(unsigned int)> decodeImage = [&paths, generateMipmaps, filter, data](unsigned int i)
+    {
+      decode(paths[i].c_str(), generateMipmaps, filter, &data[i]);
+    };
+
+    if (jobSystem)
+    {
+      jobSystem->parallelFor((unsigned int)paths.size(), decodeImage);
+    }
+    else
+    {
+      for (unsigned int i = 0, count = (unsigned int)paths.size(); i < count; ++i)
+        decodeImage(i);
+    }
+  }
+
+  Texture* TextureDecoder::createTexture(const Result& result)
+  {
+    if (result.format == Texture::UNKNOWN || result.levels.empty())
+      return nullptr;
+
+    return Texture::createFromLevels(result.format, result.width, result.height, result.levels);
+  }
+
+  void TextureDecoder::load(JobSystem* jobSystem, const std::vector<std::string>& paths, bool generateMipmaps, std::vector<Texture*>& textures)
+  {
+    textures.assign(paths.size(), nullptr);
+
+    // Only decode the images that are not loaded yet, once each.
+    std::vector<std::string> decodePaths;
+    std::vector<size_t> decodeIndices;
+    std::unordered_map<std::string, size_t> pending;
+    for (size_t i = 0, count = paths.size(); i < count; ++i)
+    {
+      textures[i] = Texture::findCached(paths[i].c_str(), generateMipmaps);
+      if (textures[i])
+        continue;
+
+      std::unordered_map<std::string, size_t>::iterator itr = pending.find(paths[i]);
+      if (itr != pending.end())
+      {
+        decodeIndices.push_back(itr->second);
+        continue;
+      }
+      pending[paths[i]] = decodePaths.size();
+      decodeIndices.push_back(decodePaths.size());
+      decodePaths.push_back(paths[i]);
+    }
+    if (decodePaths.empty())
+      return;
+
+    std::vector<Result> results;
+    decode(jobSystem, decodePaths, generateMipmaps, getFilter(), results);
+
+    // Upload in path order; later paths naming an uploaded image share its texture.
+    std::vector<Texture*> created(decodePaths.size(), nullptr);
+    for (size_t i = 0, j = 0, count = paths.size(); i < count; ++i)
+    {
+      if (textures[i])
+        continue;
+
+      size_t index = decodeIndices[j++];
+      if (created[index])
+      {
+        created[index]->addRef();
+      }
+      else
+      {
+        created[index] = createTexture(results[index]);
+        if (created[index])
+          created[index]->addToCache(paths[i].c_str());
+      }
+      textures[i] = created[index];
+    }
+  }
+
+  void TextureDecoder::generateLevels(const unsigned char* data, unsigned int width, unsigned int height, size_t bpp, Filter filter, Levels& levels)
+  {
+    assert(data);
+
+    unsigned int levelCount = 1;
+    for (unsigned int size = std::max(width, height); size > 1; size >>= 1)
+      ++levelCount;
+
+    levels.resize(levelCount);
+    levels[0].assign(data, data + (size_t)width * height * bpp);
+    for (unsigned int level = 1; level < levelCount; ++level)
+    {
+      unsigned int srcWidth = std::max(width >> (level - 1), 1u);
+      unsigned int srcHeight = std::max(height >> (level - 1), 1u);
+      levels[level].resize((size_t)std::max(srcWidth >> 1, 1u) * std::max(srcHeight >> 1, 1u) * bpp);
+      downsample(levels[level - 1].data(), srcWidth, srcHeight, bpp, filter, levels[level].data());
+    }
+  }
+
+  // Averages each 2x2 block, repeating the last row or column of odd sizes.
+  static void downsampleBox(const unsigned char* src, unsigned int srcWidth, unsigned int srcHeight, size_t bpp, unsigned char* dst)
+  {
+    unsigned int dstWidth = std::max(srcWidth >> 1, 1u);
+    unsigned int dstHeight = std::max(srcHeight >> 1, 1u);
+    for (unsigned int y = 0; y < dstHeight; ++y)
+    {
+      const unsigned char* row0 = src + (size_t)std::min(y * 2, srcHeight - 1) * srcWidth * bpp;
+      const unsigned char* row1 = src + (size_t)std::min(y * 2 + 1, srcHeight - 1) * srcWidth * bpp;
+      unsigned char* out = dst + (size_t)y * dstWidth * bpp;
+      unsigned int x = 0;
+#if defined(GP_USE_SSE2_DOWNSAMPLE)
+      if (bpp == 4)
+      {
+        // Widen 4 source pixels of each row to 16 bits, add the rows, then add the pixel pairs and round.
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i two = _mm_set1_epi16(2);
+        for (; x + 1 < dstWidth && x * 2 + 3 < srcWidth; x += 2)
+        {
+          __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+          __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+          __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+          __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+          __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+          sum = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(sum, sum));
+        }
+      }
+#endif
+      for (; x < dstWidth; ++x)
+      {
+        size_t x0 = (size_t)std::min(x * 2, srcWidth - 1) * bpp;
+        size_t x1 = (size_t)std::min(x * 2 + 1, srcWidth - 1) * bpp;
+        for (size_t c = 0; c < bpp; ++c)
+        {
+          out[x * bpp + c] = (unsigned char)((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+        }
+      }
+    }
+  }
+
+  // Zeroth order modified Bessel function of the first kind, for the Kaiser window.
+  static float besselI0(float x)
+  {
+    float sum = 1.0f;
+    float term = 1.0f;
+    for (int k = 1; k < 16; ++k)
+    {
+      term *= (x * 0.5f / k) * (x * 0.5f / k);
+      sum += term;
+    }
+    return sum;
+  }
+
+  // Computes the weights of the source pixels at offsets -2.5 to 2.5 from the center of a destination pixel.
+  static std::vector<float> computeKaiserWeights()
+  {
+    // A sinc at half the source rate, windowed to the 3 pixel radius of the taps.
+    std::vector<float> weights(KAISER_TAP_COUNT);
+    float total = 0.0f;
+    for (int i = 0; i < KAISER_TAP_COUNT; ++i)
+    {
+      float offset = (float)i - 2.5f;
+      float x = offset * 0.5f * MATH_PI;
+      float window = offset / 3.0f;
+      weights[i] = sinf(x) / x * besselI0(KAISER_BETA * sqrtf(1.0f - window * window)) / besselI0(KAISER_BETA);
+      total += weights[i];
+    }
+    for (int i = 0; i < KAISER_TAP_COUNT; ++i)
+      weights[i] /= total;
+    return weights;
+  }
+
+  // Mirrors an index outside [0, size) about the edge pixel, which keeps the filter symmetric at the edges.
+  static int mirror(int index, int size)
+  {
+    if (index < 0)
+      index = -index;
+    if (index >= size)
+      index = 2 * (size - 1) - index;
+    return std::min(std::max(index, 0), size - 1);
+  }
+
+  // Filters rows then columns. Taps outside the image are mirrored; sides of 1 pixel pass through.
+  static void downsampleKaiser(const unsigned char* src, unsigned int srcWidth, unsigned int srcHeight, size_t bpp, unsigned char* dst)
+  {
+    static const std::vector<float> weights = computeKaiserWeights();
+    unsigned int dstWidth = std::max(srcWidth >> 1, 1u);
+    unsigned int dstHeight = std::max(srcHeight >> 1, 1u);
+    size_t dstStride = (size_t)dstWidth * bpp;
+
+    std::vector<float> rows((size_t)srcHeight * dstStride);
+    for (unsigned int y = 0; y < srcHeight; ++y)
+    {
+      const unsigned char* in = src + (size_t)y * srcWidth * bpp;
+      float* out = &rows[y * dstStride];
+      for (unsigned int x = 0; x < dstWidth; ++x)
+      {
+        for (size_t c = 0; c < bpp; ++c)
+        {
+          float sum = 0.0f;
+          for (int i = 0; i < KAISER_TAP_COUNT; ++i)
+          {
+            int sx = mirror((int)(x * 2) - 2 + i, (int)srcWidth);
+            sum += weights[i] * in[sx * bpp + c];
+          }
+          out[x * bpp + c] = srcWidth > 1 ? sum : in[c];
+        }
+      }
+    }
+
+    for (unsigned int y = 0; y < dstHeight; ++y)
+    {
+      unsigned char* out = dst + y * dstStride;
+      for (size_t i = 0; i < dstStride; ++i)
+      {
+        float sum = 0.0f;
+        if (srcHeight > 1)
+        {
+          for (int t = 0; t < KAISER_TAP_COUNT; ++t)
+          {
+            int sy = mirror((int)(y * 2) - 2 + t, (int)srcHeight);
+            sum += weights[t] * rows[sy * dstStride + i];
+          }
+        }
+        else
+        {
+          sum = rows[i];
+        }
+        out[i] = (unsigned char)std::min(std::max(sum + 0.5f, 0.0f), 255.0f);
+      }
+    }
+  }
+
+  void TextureDecoder::downsample(const unsigned char* src, unsigned int width, unsigned int height, size_t bpp, Filter filter, unsigned char* dst)
+  {
+    assert(src);
+    assert(dst);
+
+    if (filter == KAISER)
+      downsampleKaiser(src, width, height, bpp, dst);
+    else
+      downsampleBox(src, width, height, bpp, dst);
+  }
+
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "renderer/Texture.h"
+
+namespace gameplay
+{
+
+  class JobSystem;
+
+  /**
+   * Defines a texture decoder, which decodes images and generates their mip
+   * chains on the CPU, producing levels that are ready to upload.
+   *
+   * Decoding a batch of images spreads the images over the job system's
+   * workers, so that texture-heavy scenes do not decode one image after
+   * another on the main thread. Generated levels are uploaded as they are
+   * instead of being generated by the graphics driver.
+   *
+   * Levels are generated with a 2x2 box filter, or with a Kaiser-windowed
+   * sinc filter that keeps distant textures sharper at a higher cost. The
+   * filter used when loading is read from the "mipmapFilter" property
+   * ("BOX" or "KAISER") of the "graphics" namespace in game.config.
+   *
+   * Only PNG images are decoded.
+   *
+   * @script{ignore}
+   */
+  class TextureDecoder
+  {
+  public:
+
+    /**
+     * Defines the filters used to generate mip levels.
+     */
+    enum Filter
+    {
+      BOX,
+      KAISER
+    };
+
+    /**
+     * The pixel data of the mip levels of a texture, indexed by level.
+     */
+    typedef std::vector<std::vector<unsigned char> > Levels;
+
+    /**
+     * A decoded image and its generated levels.
+     */
+    struct Result
+    {
+      /**
+       * Constructor.
+       */
+      Result();
+
+      /**
+       * The format of the image, or Texture::UNKNOWN if it failed to decode.
+       */
+      Texture::Format format;
+
+      /**
+       * The width of level 0.
+       */
+      unsigned int width;
+
+      /**
+       * The height of level 0.
+       */
+      unsigned int height;
+
+      /**
+       * The decoded image as level 0, followed by the generated levels.
+       */
+      Levels levels;
+    };
+
+    /**
+     * Gets the filter used to generate levels when textures are loaded.
+     *
+     * @return The filter.
+     */
+    static Filter getFilter();
+
+    /**
+     * Sets the filter used to generate levels when textures are loaded.
+     *
+     * @param filter The filter.
+     */
+    static void setFilter(Filter filter);
+
+    /**
+     * Decodes an image and generates its mip chain. May be called from any thread.
+     *
+     * @param path The path of the image.
+     * @param generateMipmaps True to generate the full mip chain, false to only decode level 0.
+     * @param filter The filter to generate levels with.
+     * @param result The result to fill.
+     *
+     * @return True if the image was decoded.
+     */
+    static bool decode(const char* path, bool generateMipmaps, Filter filter, Result* result);
+
+    /**
+     * Decodes a batch of images concurrently on the workers of a job system.
+     *
+     * @param jobSystem The job system, or nullptr to decode on the calling thread.
+     * @param paths The paths of the images.
+     * @param generateMipmaps True to generate the full mip chain of each image.
+     * @param filter The filter to generate levels with.
+     * @param results Set to the result of each image, in the order of the paths.
+     */
+    static void decode(JobSystem* jobSystem, const std::vector<std::string>& paths, bool generateMipmaps, Filter filter, std::vector<Result>& results);
+
+    /**
+     * Creates a texture from a decoded result, uploading all of its levels.
+     * Must be called on the main thread.
+     *
+     * @param result The decoded result.
+     *
+     * @return The new texture, or nullptr if the result failed to decode.
+     */
+    static Texture* createTexture(const Result& result);
+
+    /**
+     * Loads a batch of textures: images that are not already loaded are
+     * decoded concurrently, then uploaded and added to the texture cache so
+     * that Texture::create() returns them. Must be called on the main thread.
+     *
+     * @param jobSystem The job system, or nullptr to decode on the calling thread.
+     * @param paths The paths of the images.
+     * @param generateMipmaps True to create mipmapped textures.
+     * @param textures Set to a reference to each texture, in the order of the paths, or nullptr
+     *        for images that failed to load. The caller releases the textures.
+     */
+    static void load(JobSystem* jobSystem, const std::vector<std::string>& paths, bool generateMipmaps, std::vector<Texture*>& textures);
+
+    /**
+     * Generates the full mip chain of an image.
+     *
+     * @param data The tightly packed pixels of level 0.
+     * @param width The width of level 0.
+     * @param height The height of level 0.
+     * @param bpp The number of bytes per pixel.
+     * @param filter The filter.
+     * @param levels Set to level 0 followed by each generated level, down to 1x1.
+     */
+    static void generateLevels(const unsigned char* data, unsigned int width, unsigned int height, size_t bpp, Filter filter, Levels& levels);
+
+    /**
+     * Generates the next mip level of an image, halving each side that is larger than 1.
+     *
+     * @param src The tightly packed pixels of the image.
+     * @param width The width of the image.
+     * @param height The height of the image.
+     * @param bpp The number of bytes per pixel.
+     * @param filter The filter.
+     * @param dst The buffer to write the level to, max(width / 2, 1) * max(height / 2, 1) * bpp bytes.
+     */
+    static void downsample(const unsigned char* src, unsigned int width, unsigned int height, size_t bpp, Filter filter, unsigned char* dst);
+
+  private:
+
+    /**
+     * Hidden constructor.
+     */
+    TextureDecoder();
+  };
+
+}
@@ -0,0 +1,332 @@
+#include "framework/Base.h"
+#include "renderer/TextureStreamer.h"
+#include "renderer/TextureDecoder.h"
+#include "ui/Image.h"
+
+namespace gameplay
+{
+
+  TextureStreamer::Entry::Entry()
+    : levelCount(0), minLevel(0), wantedLevel(0), requestedBytes(0), screenSize(0.0f), lastUsedFrame(0), request(nullptr)
+  {
+  }
+
+  TextureStreamer::TextureStreamer(AssetLoader* loader, size_t budget, unsigned int minSize)
+    : _loader(loader), _budget(budget), _minSize(std::max(minSize, 1u)), _residentBytes(0), _evictedBytes(0),
+    _pendingCount(0), _pendingBytes(0), _frame(0), _screenSize(-1.0f)
+  {
+    assert(loader);
+  }
+
+  TextureStreamer::~TextureStreamer()
+  {
+    // Textures outlive the streamer with the levels they have.
+    for (auto& pair : _entries)
+    {
+      if (pair.second.request)
+      {
+        _loader->cancel(pair.second.request);
+        SAFE_RELEASE(pair.second.request);
+      }
+      pair.first->_streamer = nullptr;
+    }
+  }
+
+  bool TextureStreamer::isSupported()
+  {
+#if defined(GL_TEXTURE_BASE_LEVEL)
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  size_t TextureStreamer::getBudget() const
+  {
+    return _budget;
+  }
+
+  void TextureStreamer::setBudget(size_t budget)
+  {
+    _budget = budget;
+  }
+
+  size_t TextureStreamer::getResidentBytes() const
+  {
+    return _residentBytes;
+  }
+
+  unsigned int TextureStreamer::getPendingCount() const
+  {
+    return _pendingCount;
+  }
+
+  unsigned int TextureStreamer::getTextureCount() const
+  {
+    return (unsigned int)_entries.size();
+  }
+
+  size_t TextureStreamer::getEvictedBytes() const
+  {
+    return _evictedBytes;
+  }
+
+  void TextureStreamer::beginDraw(float screenSize)
+  {
+    _screenSize = std::max(screenSize, 0.0f);
+  }
+
+  void TextureStreamer::endDraw()
+  {
+    _screenSize = -1.0f;
+  }
+
+  void TextureStreamer::markUsed(Texture* texture)
+  {
+    std::unordered_map<Texture*, Entry>::iterator itr = _entries.find(texture);
+    if (itr == _entries.end())
+      return;
+
+    Entry& entry = itr->second;
+    float screenSize = _screenSize < 0.0f ? std::numeric_limits<float>::max() : _screenSize;
+    if (entry.lastUsedFrame != _frame || screenSize > entry.screenSize)
+      entry.screenSize = screenSize;
+    entry.lastUsedFrame = _frame;
+  }
+
+  unsigned int TextureStreamer::getLevelCount(unsigned int width, unsigned int height)
+  {
+    unsigned int size = std::max(width, height);
+    unsigned int count = 1;
+    while (size > 1)
+    {
+      size >>= 1;
+      ++count;
+    }
+    return count;
+  }
+
+  size_t TextureStreamer::getLevelSize(unsigned int width, unsigned int height, size_t bpp, unsigned int level)
+  {
+    return (size_t)std::max(width >> level, 1u) * std::max(height >> level, 1u) * bpp;
+  }
+
+  unsigned int TextureStreamer::getLevelForScreenSize(unsigned int width, unsigned int height, float screenSize)
+  {
+    float size = (float)std::max(width, height);
+    if (screenSize >= size)
+      return 0;
+
+    // Each level halves the size, so the level is the number of halvings that still cover the screen size.
+    unsigned int level = (unsigned int)floorf(log2f(size / std::max(screenSize, 1.0f)));
+    return std::min(level, getLevelCount(width, height) - 1);
+  }
+
+  void TextureStreamer::generateLevels(const unsigned char* data, unsigned int width, unsigned int height, size_t bpp,
+    unsigned int firstLevel, unsigned int endLevel, Levels& levels)
+  {
+    assert(data);
+    assert(endLevel <= levels.size());
+
+    if (firstLevel == 0 && endLevel > 0)
+      levels[0].assign(data, data + (size_t)width * height * bpp);
+
+    std::vector<unsigned char> previous;
+    std::vector<unsigned char> next;
+    const unsigned char* src = data;
+    unsigned int srcWidth = width;
+    unsigned int srcHeight = height;
+    for (unsigned int level = 1; level < endLevel; ++level)
+    {
+      unsigned int dstWidth = std::max(srcWidth >> 1, 1u);
+      unsigned int dstHeight = std::max(srcHeight >> 1, 1u);
+      next.resize((size_t)dstWidth * dstHeight * bpp);
+      TextureDecoder::downsample(src, srcWidth, srcHeight, bpp, TextureDecoder::getFilter(), next.data());
+
+      if (level >= firstLevel)
+        levels[level] = next;
+      previous.swap(next);
+      src = previous.data();
+      srcWidth = dstWidth;
+      srcHeight = dstHeight;
+    }
+  }
+
+  Texture* TextureStreamer::create(const char* path, Image* image)
+  {
+    assert(path);
+    assert(image);
+
+    unsigned int width = image->getWidth();
+    unsigned int height = image->getHeight();
+    Texture::Format format = image->getFormat() == Image::RGBA ? Texture::RGBA : Texture::RGB;
+    size_t bpp = Texture::getFormatBPP(format);
+
+    // Find the most detailed level within the minimum size; textures that already fit are not streamed.
+    unsigned int levelCount = getLevelCount(width, height);
+    unsigned int minLevel = 0;
+    while (std::max(width >> minLevel, height >> minLevel) > _minSize)
+      ++minLevel;
+    if (minLevel == 0)
+      return nullptr;
+
+    Levels levels(levelCount);
+    generateLevels(image->getData(), width, height, bpp, minLevel, levelCount, levels);
+
+    Texture* texture = Texture::createStreamed(format, width, height, levelCount);
+    texture->_streamer = this;
+
+    Entry& entry = _entries[texture];
+    entry.path = path;
+    entry.levelCount = levelCount;
+    entry.minLevel = minLevel;
+    entry.wantedLevel = minLevel;
+    entry.lastUsedFrame = _frame;
+    setBaseLevel(texture, minLevel, &levels);
+    return texture;
+  }
+
+  void TextureStreamer::remove(Texture* texture)
+  {
+    std::unordered_map<Texture*, Entry>::iterator itr = _entries.find(texture);
+    if (itr == _entries.end())
+      return;
+
+    Entry& entry = itr->second;
+    if (entry.request)
+    {
+      _loader->cancel(entry.request);
+      SAFE_RELEASE(entry.request);
+      --_pendingCount;
+      _pendingBytes -= entry.requestedBytes;
+    }
+    _residentBytes -= getResidentSize(texture, texture->_baseLevel);
+    _entries.erase(itr);
+  }
+
+  size_t TextureStreamer::getResidentSize(const Texture* texture, unsigned int baseLevel) const
+  {
+    assert(texture);
+
+    size_t size = 0;
+    unsigned int levelCount = getLevelCount(texture->_width, texture->_height);
+    for (unsigned int level = baseLevel; level < levelCount; ++level)
+    {
+      size += getLevelSize(texture->_width, texture->_height, texture->_bpp, level);
+    }
+    return size;
+  }
+
+  void TextureStreamer::setBaseLevel(Texture* texture, unsigned int level, const Levels* levels)
+  {
+    assert(texture);
+
+    size_t before = getResidentSize(texture, texture->_baseLevel);
+    texture->setBaseLevel(level, levels);
+    size_t after = getResidentSize(texture, level);
+    _residentBytes = _residentBytes - before + after;
+    if (after < before)
+      _evictedBytes += before - after;
+  }
+
+  void TextureStreamer::update()
+  {
+    // Work out the levels needed from the sizes textures were drawn at last frame.
+    for (auto& pair : _entries)
+    {
+      Entry& entry = pair.second;
+      if (entry.lastUsedFrame == _frame)
+        entry.wantedLevel = std::min(getLevelForScreenSize(pair.first->_width, pair.first->_height, entry.screenSize), entry.minLevel);
+      else
+        entry.wantedLevel = entry.minLevel;
+    }
+    ++_frame;
+
+    if (_residentBytes + _pendingBytes > _budget)
+      evict(_budget > _pendingBytes ? _budget - _pendingBytes : 0);
+
+    // Request missing levels, evicting unneeded ones to make room. Requests that do not fit ask for less detail.
+    for (auto& pair : _entries)
+    {
+      Texture* texture = pair.first;
+      Entry& entry = pair.second;
+      if (entry.request || entry.wantedLevel >= texture->_baseLevel)
+        continue;
+
+      size_t resident = getResidentSize(texture, texture->_baseLevel);
+      size_t needed = getResidentSize(texture, entry.wantedLevel) - resident;
+      if (_residentBytes + _pendingBytes + needed > _budget && _budget > _pendingBytes + needed)
+        evict(_budget - _pendingBytes - needed);
+
+      unsigned int level = entry.wantedLevel;
+      while (level < texture->_baseLevel && _residentBytes + _pendingBytes + getResidentSize(texture, level) - resident > _budget)
+        ++level;
+      if (level < texture->_baseLevel)
+        request(texture, entry, level);
+    }
+  }
+
+  void TextureStreamer::request(Texture* texture, Entry& entry, unsigned int level)
+  {
+    assert(texture);
+    assert(!entry.request);
+    assert(level < texture->_baseLevel);
+
+    // Levels down to the minimum are generated, so the request still applies if levels are evicted while it loads.
+    std::shared_ptr<Levels> levels(new Levels(entry.levelCount));
+    std::string path = entry.path;
+    unsigned int width = texture->_width;
+    unsigned int height = texture->_height;
+    size_t bpp = texture->_bpp;
+    unsigned int endLevel = entry.minLevel;
+    std::function<bool()> load = [levels, path, width, height, bpp, level, endLevel]()
+    {
+      Image* image = Image::create(path.c_str());
+      bool loaded = image && image->getWidth() == width && image->getHeight() == height &&
+        Texture::getFormatBPP(image->getFormat() == Image::RGBA ? Texture::RGBA : Texture::RGB) == bpp;
+      if (loaded)
+        generateLevels(image->getData(), width, height, bpp, level, endLevel, *levels);
+      SAFE_RELEASE(image);
+      return loaded;
+    };
+    std::function<bool(bool)> finalize = [this, texture, levels, level](bool loaded)
+    {
+      // Cancelled requests are never finalized, so the texture is still streamed.
+      Entry& entry = _entries[texture];
+      SAFE_RELEASE(entry.request);
+      --_pendingCount;
+      _pendingBytes -= entry.requestedBytes;
+      entry.requestedBytes = 0;
+      if (loaded && level < texture->_baseLevel)
+        setBaseLevel(texture, level, levels.get());
+      return loaded;
+    };
+
+    entry.requestedBytes = getResidentSize(texture, level) - getResidentSize(texture, texture->_baseLevel);
+    _pendingBytes += entry.requestedBytes;
+    ++_pendingCount;
+
+    // Textures missing the most detail load first.
+    entry.request = _loader->load(path.c_str(), load, finalize, (int)(texture->_baseLevel - level));
+    entry.request->addRef();
+  }
+
+  void TextureStreamer::evict(size_t target)
+  {
+    // Drop the detail textures do not need, least recently used first. Levels that are needed are never evicted.
+    std::vector<std::pair<unsigned int, Texture*> > candidates;
+    for (auto& pair : _entries)
+    {
+      if (!pair.second.request && pair.first->_baseLevel < pair.second.wantedLevel)
+        candidates.push_back(std::make_pair(pair.second.lastUsedFrame, pair.first));
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (size_t i = 0, count = candidates.size(); i < count && _residentBytes > target; ++i)
+    {
+      Texture* texture = candidates[i].second;
+      setBaseLevel(texture, _entries[texture].wantedLevel, nullptr);
+    }
+  }
+
+}
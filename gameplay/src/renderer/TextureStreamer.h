@@ -0,0 +1,246 @@
+#pragma once
+
+#include "framework/AssetLoader.h"
+#include "renderer/Texture.h"
+
+namespace gameplay
+{
+
+  class Image;
+
+  /**
+   * Defines a texture streamer, which keeps only the mip levels of textures
+   * that are actually needed on screen resident, within a memory budget.
+   *
+   * A streamed texture starts with only its smallest mip levels resident, up
+   * to the minimum resident size. While drawing, the renderer reports the
+   * screen size each texture is drawn at (see beginDraw() and markUsed()), and
+   * once per frame update() requests the more detailed levels that are needed.
+   * The levels are decoded and generated on the asset loader's I/O threads and
+   * uploaded when the request is finalized on the main thread.
+   *
+   * When the resident levels exceed the budget, levels are evicted from the
+   * least recently used textures first: detail beyond what a texture needs is
+   * dropped before textures that are in use lose any. Textures never drop
+   * below the minimum resident size.
+   *
+   * Only mipmapped PNG textures are streamed; compressed formats carry their
+   * own mip chains and are loaded whole. Streaming needs GL_TEXTURE_BASE_LEVEL
+   * (OpenGL 1.2, OpenGL ES 3.0).
+   *
+   * The game owns a texture streamer (see Game::getTextureStreamer()) when the
+   * "textureBudget" property (in megabytes) of the "graphics" namespace in
+   * game.config is set. The minimum resident size is read from the
+   * "textureMinSize" property and defaults to 64 pixels.
+   *
+   * @script{ignore}
+   */
+  class TextureStreamer
+  {
+    friend class Texture;
+
+  public:
+
+    /**
+     * The pixel data of the mip levels of a texture, indexed by level.
+     * Levels that are not loaded are empty.
+     */
+    typedef std::vector<std::vector<unsigned char> > Levels;
+
+    /**
+     * Constructor.
+     *
+     * @param loader The asset loader to load levels with.
+     * @param budget The number of bytes the resident levels of all streamed textures may use.
+     * @param minSize The size, in pixels, that textures are always resident at.
+     */
+    TextureStreamer(AssetLoader* loader, size_t budget, unsigned int minSize = 64);
+
+    /**
+     * Destructor. Cancels pending loads; streamed textures keep their resident levels.
+     */
+    ~TextureStreamer();
+
+    /**
+     * Determines whether textures can be streamed with the current graphics API.
+     *
+     * @return True if streaming is supported.
+     */
+    static bool isSupported();
+
+    /**
+     * Gets the budget for resident levels.
+     *
+     * @return The budget in bytes.
+     */
+    size_t getBudget() const;
+
+    /**
+     * Sets the budget for resident levels. Levels are evicted on the next update() if it is exceeded.
+     *
+     * @param budget The budget in bytes.
+     */
+    void setBudget(size_t budget);
+
+    /**
+     * Gets the number of bytes used by the resident levels of all streamed textures.
+     *
+     * @return The resident bytes.
+     */
+    size_t getResidentBytes() const;
+
+    /**
+     * Gets the number of level loads that have been requested but not uploaded yet.
+     *
+     * @return The number of pending requests.
+     */
+    unsigned int getPendingCount() const;
+
+    /**
+     * Gets the number of streamed textures.
+     *
+     * @return The number of streamed textures.
+     */
+    unsigned int getTextureCount() const;
+
+    /**
+     * Gets the total number of bytes evicted since the streamer was created.
+     *
+     * @return The evicted bytes.
+     */
+    size_t getEvictedBytes() const;
+
+    /**
+     * Sets the screen size that textures bound from now on are drawn at.
+     *
+     * @param screenSize The size in pixels, such as the projected diameter of the bounds of the drawn model.
+     */
+    void beginDraw(float screenSize);
+
+    /**
+     * Stops attributing a screen size to bound textures. Textures bound
+     * outside beginDraw() and endDraw() are assumed to need every level.
+     */
+    void endDraw();
+
+    /**
+     * Records that a texture is drawn at the current screen size this frame.
+     *
+     * @param texture The texture. Nothing happens if it is not streamed.
+     */
+    void markUsed(Texture* texture);
+
+    /**
+     * Requests the levels that textures used in the last frame need, and
+     * evicts levels if the budget is exceeded. Called once per frame.
+     */
+    void update();
+
+    /**
+     * Gets the number of mip levels in a full chain.
+     *
+     * @param width The width of the texture.
+     * @param height The height of the texture.
+     *
+     * @return The number of levels.
+     */
+    static unsigned int getLevelCount(unsigned int width, unsigned int height);
+
+    /**
+     * Gets the number of bytes used by a mip level.
+     *
+     * @param width The width of the texture.
+     * @param height The height of the texture.
+     * @param bpp The number of bytes per pixel.
+     * @param level The level.
+     *
+     * @return The size of the level in bytes.
+     */
+    static size_t getLevelSize(unsigned int width, unsigned int height, size_t bpp, unsigned int level);
+
+    /**
+     * Gets the most detailed level needed to draw a texture at a screen size.
+     *
+     * @param width The width of the texture.
+     * @param height The height of the texture.
+     * @param screenSize The size the texture is drawn at, in pixels.
+     *
+     * @return The level, which is 0 when the full resolution is needed.
+     */
+    static unsigned int getLevelForScreenSize(unsigned int width, unsigned int height, float screenSize);
+
+    /**
+     * Generates mip levels from an image by repeated downsampling with the
+     * filter used when loading (see TextureDecoder::getFilter()).
+     *
+     * @param data The tightly packed pixels of level 0.
+     * @param width The width of level 0.
+     * @param height The height of level 0.
+     * @param bpp The number of bytes per pixel.
+     * @param firstLevel The first level to keep.
+     * @param endLevel One past the last level to generate.
+     * @param levels The levels to fill. Levels in [firstLevel, endLevel) are set; the others are left as they are.
+     */
+    static void generateLevels(const unsigned char* data, unsigned int width, unsigned int height, size_t bpp,
+      unsigned int firstLevel, unsigned int endLevel, Levels& levels);
+
+  private:
+
+    /**
+     * The streaming state of a texture.
+     */
+    struct Entry
+    {
+      Entry();
+
+      std::string path;
+      unsigned int levelCount;
+      unsigned int minLevel;      // The most detailed level that is always resident.
+      unsigned int wantedLevel;   // The most detailed level needed when last drawn.
+      size_t requestedBytes;      // The bytes the pending request will add.
+      float screenSize;           // The largest size drawn at this frame.
+      unsigned int lastUsedFrame;
+      AssetLoader::Request* request;
+    };
+
+    /**
+     * Hidden copy constructor.
+     */
+    TextureStreamer(const TextureStreamer& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    TextureStreamer& operator=(const TextureStreamer&);
+
+    /**
+     * Creates a streamed texture from a decoded image, or returns nullptr if it is too small to stream.
+     */
+    Texture* create(const char* path, Image* image);
+
+    /**
+     * Stops streaming a texture that is being destroyed.
+     */
+    void remove(Texture* texture);
+
+    size_t getResidentSize(const Texture* texture, unsigned int baseLevel) const;
+
+    void request(Texture* texture, Entry& entry, unsigned int level);
+
+    void evict(size_t target);
+
+    void setBaseLevel(Texture* texture, unsigned int level, const Levels* levels);
+
+    AssetLoader* _loader;
+    size_t _budget;
+    unsigned int _minSize;
+    size_t _residentBytes;
+    size_t _evictedBytes;
+    unsigned int _pendingCount;
+    size_t _pendingBytes;
+    unsigned int _frame;
+    float _screenSize;
+    std::unordered_map<Texture*, Entry> _entries;
+  };
+
+}
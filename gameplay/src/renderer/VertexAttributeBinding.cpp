@@ -1,5 +1,6 @@
 #include "framework/Base.h"
 #include "renderer/VertexAttributeBinding.h"
+#include "renderer/StateCache.h"
 #include "graphics/Mesh.h"
 #include "graphics/Effect.h"
 
@@ -33,6 +34,7 @@ namespace gameplay
     if (_handle)
     {
       GL_ASSERT(glDeleteVertexArrays(1, &_handle));
+      StateCache::getCurrent()->vertexArrayDeleted(_handle);
       _handle = 0;
     }
   }
@@ -95,8 +97,8 @@ namespace gameplay
 #ifdef GP_USE_VAO
     if (mesh && glGenVertexArrays)
     {
-      GL_ASSERT(glBindBuffer(GL_ARRAY_BUFFER, 0));
-      GL_ASSERT(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+      StateCache::getCurrent()->bindBuffer(GL_ARRAY_BUFFER, 0);
+      StateCache::getCurrent()->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
       // Use hardware VAOs.
       GL_ASSERT(glGenVertexArrays(1, &b->_handle));
@@ -109,10 +111,10 @@ namespace gameplay
       }
 
       // Bind the new VAO.
-      GL_ASSERT(glBindVertexArray(b->_handle));
+      StateCache::getCurrent()->bindVertexArray(b->_handle);
 
       // Bind the Mesh VBO so our glVertexAttribPointer calls use it.
-      GL_ASSERT(glBindBuffer(GL_ARRAY_BUFFER, mesh->getVertexBuffer()));
+      StateCache::getCurrent()->bindBuffer(GL_ARRAY_BUFFER, mesh->getVertexBuffer());
     }
     else
 #endif
@@ -209,7 +211,7 @@ namespace gameplay
 
     if (b->_handle)
     {
-      GL_ASSERT(glBindVertexArray(0));
+      StateCache::getCurrent()->bindVertexArray(0);
     }
 
     return b;
@@ -243,18 +245,18 @@ namespace gameplay
     if (_handle)
     {
       // Hardware mode
-      GL_ASSERT(glBindVertexArray(_handle));
+      StateCache::getCurrent()->bindVertexArray(_handle);
     }
     else
     {
       // Software mode
       if (_mesh)
       {
-        GL_ASSERT(glBindBuffer(GL_ARRAY_BUFFER, _mesh->getVertexBuffer()));
+        StateCache::getCurrent()->bindBuffer(GL_ARRAY_BUFFER, _mesh->getVertexBuffer());
       }
       else
       {
-        GL_ASSERT(glBindBuffer(GL_ARRAY_BUFFER, 0));
+        StateCache::getCurrent()->bindBuffer(GL_ARRAY_BUFFER, 0);
       }
 
       assert(_attributes);
@@ -275,14 +277,14 @@ namespace gameplay
     if (_handle)
     {
       // Hardware mode
-      GL_ASSERT(glBindVertexArray(0));
+      StateCache::getCurrent()->bindVertexArray(0);
     }
     else
     {
       // Software mode
       if (_mesh)
       {
-        GL_ASSERT(glBindBuffer(GL_ARRAY_BUFFER, 0));
+        StateCache::getCurrent()->bindBuffer(GL_ARRAY_BUFFER, 0);
       }
 
       assert(_attributes);
@@ -4,6 +4,7 @@
 #include "graphics/MeshPart.h"
 #include "scene/Scene.h"
 #include "animation/Joint.h"
+#include "utils/ResourceRegistry.h"
 
 // Minimum version numbers supported
 #define BUNDLE_VERSION_MAJOR_REQUIRED   1 
@@ -30,10 +31,18 @@
 #define BUNDLE_VERSION_MAJOR_FONT_FORMAT  1
 #define BUNDLE_VERSION_MINOR_FONT_FORMAT  5
 
+#define BUNDLE_VERSION_MAJOR_ANIMATION_KEY_FORMAT  1
+#define BUNDLE_VERSION_MINOR_ANIMATION_KEY_FORMAT  6
+
+// Animation channel key formats
+#define BUNDLE_ANIMATION_KEYS_RAW         0
+#define BUNDLE_ANIMATION_KEYS_COMPRESSED  1
+#define BUNDLE_ANIMATION_NO_QUATERNION    0xFFFFFFFF
+
 namespace gameplay
 {
 
-  static std::vector<Bundle*> __bundleCache;
+  static ResourceCache<Bundle> __bundleCache("bundles");
 
   Bundle::Bundle(const char* path) :
     _path(path), _referenceCount(0), _references(nullptr), _stream(nullptr), _trackedNodes(nullptr)
@@ -45,11 +54,7 @@ namespace gameplay
     clearLoadSession();
 
     // Remove this Bundle from the cache.
-    std::vector<Bundle*>::iterator itr = std::find(__bundleCache.begin(), __bundleCache.end(), this);
-    if (itr != __bundleCache.end())
-    {
-      __bundleCache.erase(itr);
-    }
+    __bundleCache.remove(_path, this);
 
     SAFE_DELETE_ARRAY(_references);
 
@@ -173,20 +178,29 @@ namespace gameplay
     assert(path);
 
     // Search the cache for this bundle.
-    for (size_t i = 0, count = __bundleCache.size(); i < count; ++i)
-    {
-      Bundle* p = __bundleCache[i];
-      assert(p);
-      if (p->_path == path)
-      {
-        // Found a match
-        p->addRef();
-        return p;
-      }
-    }
+    Bundle* bundle = findCached(path);
+    if (bundle)
+      return bundle;
+
+    return open(path);
+  }
+
+  Bundle* Bundle::findCached(const char* path)
+  {
+    assert(path);
+
+    Bundle* bundle = __bundleCache.find(path);
+    if (bundle)
+      bundle->addRef();
+    return bundle;
+  }
+
+  Bundle* Bundle::open(const char* path)
+  {
+    assert(path);
 
     // Open the bundle.
-    Stream* stream = FileSystem::open(path);
+    Stream* stream = FileSystem::open(path, FileSystem::READ | FileSystem::MAPPED);
     if (!stream)
     {
       GP_WARN("Failed to open file '%s'.", path);
@@ -248,6 +262,7 @@ namespace gameplay
     bundle->_version[1] = version[1];
     bundle->_referenceCount = refCount;
     bundle->_references = refs;
+    bundle->buildReferenceIndex();
     bundle->_stream = stream;
 
     return bundle;
@@ -258,17 +273,23 @@ namespace gameplay
     assert(id);
     assert(_references);
 
-    // Search the ref table for the given id (case-sensitive).
+    // Look up the given id in the ref table (case-sensitive).
+    std::unordered_map<std::string, Reference*>::const_iterator itr = _referencesById.find(id);
+    return itr != _referencesById.end() ? itr->second : nullptr;
+  }
+
+  void Bundle::buildReferenceIndex()
+  {
+    _referencesById.reserve(_referenceCount);
+    _referencesByOffset.reserve(_referenceCount);
     for (unsigned int i = 0; i < _referenceCount; ++i)
     {
-      if (_references[i].id == id)
-      {
-        // Found a match
-        return &_references[i];
-      }
+      // The first reference wins if an id or offset appears more than once, as it did with a linear search.
+      Reference* ref = &_references[i];
+      _referencesById.emplace(ref->id, ref);
+      if (ref->id.length() > 0)
+        _referencesByOffset.emplace(ref->offset, ref);
     }
-
-    return nullptr;
   }
 
   void Bundle::clearLoadSession()
@@ -291,14 +312,9 @@ namespace gameplay
     // Search the ref table for the given offset.
     if (offset > 0)
     {
-      assert(_references);
-      for (unsigned int i = 0; i < _referenceCount; ++i)
-      {
-        if (_references[i].offset == offset && _references[i].id.length() > 0)
-        {
-          return _references[i].id.c_str();
-        }
-      }
+      std::unordered_map<unsigned int, Reference*>::const_iterator itr = _referencesByOffset.find(offset);
+      if (itr != _referencesByOffset.end())
+        return itr->second->id.c_str();
     }
     return nullptr;
   }
@@ -1289,6 +1305,25 @@ namespace gameplay
   {
     assert(id);
 
+    unsigned int keyFormat = BUNDLE_ANIMATION_KEYS_RAW;
+    if (getVersionMajor() >= BUNDLE_VERSION_MAJOR_ANIMATION_KEY_FORMAT && getVersionMinor() >= BUNDLE_VERSION_MINOR_ANIMATION_KEY_FORMAT)
+    {
+      if (!read(&keyFormat))
+      {
+        GP_ERROR("Failed to read the key format for animation '%s'.", id);
+        return nullptr;
+      }
+    }
+    if (keyFormat == BUNDLE_ANIMATION_KEYS_COMPRESSED)
+    {
+      return readCompressedAnimationChannelData(animation, id, target, targetAttribute);
+    }
+    else if (keyFormat != BUNDLE_ANIMATION_KEYS_RAW)
+    {
+      GP_ERROR("Unsupported key format (%u) for animation '%s'.", keyFormat, id);
+      return nullptr;
+    }
+
     std::vector<unsigned int> keyTimes;
     std::vector<float> values;
     std::vector<float> tangentsIn;
@@ -1355,6 +1390,79 @@ namespace gameplay
     return animation;
   }
 
+  Animation* Bundle::readCompressedAnimationChannelData(Animation* animation, const char* id, AnimationTarget* target, unsigned int targetAttribute)
+  {
+    std::vector<unsigned int> keyTimes;
+    std::vector<float> ranges;
+    std::vector<unsigned short> values;
+    unsigned int keyTimesCount;
+    unsigned int quaternionOffset;
+    unsigned int rangesCount;
+    unsigned int valuesCount;
+
+    if (!readArray(&keyTimesCount, &keyTimes, sizeof(unsigned int)))
+    {
+      GP_ERROR("Failed to read key times for animation '%s'.", id);
+      return nullptr;
+    }
+    if (!read(&quaternionOffset))
+    {
+      GP_ERROR("Failed to read the quaternion offset for animation '%s'.", id);
+      return nullptr;
+    }
+    if (!readArray(&rangesCount, &ranges))
+    {
+      GP_ERROR("Failed to read key value ranges for animation '%s'.", id);
+      return nullptr;
+    }
+    if (!readArray(&valuesCount, &values))
+    {
+      GP_ERROR("Failed to read key values for animation '%s'.", id);
+      return nullptr;
+    }
+
+    if (targetAttribute == 0)
+      return animation;
+
+    assert(target);
+    unsigned int componentCount = rangesCount / 2;
+    unsigned int stride = quaternionOffset == BUNDLE_ANIMATION_NO_QUATERNION ? componentCount : componentCount - 1;
+    if (keyTimesCount == 0 || componentCount != target->getAnimationPropertyComponentCount(targetAttribute) ||
+      (quaternionOffset != BUNDLE_ANIMATION_NO_QUATERNION && quaternionOffset + 4 > componentCount) ||
+      valuesCount != keyTimesCount * stride)
+    {
+      GP_ERROR("Invalid compressed key data for animation '%s'.", id);
+      return nullptr;
+    }
+
+    // Normalize key times the same way Animation::createChannel() does.
+    unsigned int lowest = keyTimes[0];
+    unsigned long duration = keyTimes[keyTimesCount - 1] - lowest;
+    std::vector<float> normalizedKeyTimes(keyTimesCount);
+    for (unsigned int i = 0; i < keyTimesCount; i++)
+    {
+      normalizedKeyTimes[i] = duration > 0 ? (float)(keyTimes[i] - lowest) / (float)duration : 0.0f;
+    }
+    normalizedKeyTimes[keyTimesCount - 1] = keyTimesCount > 1 ? 1.0f : 0.0f;
+
+    int offset = quaternionOffset == BUNDLE_ANIMATION_NO_QUATERNION ? -1 : (int)quaternionOffset;
+    Curve* curve = Curve::createPacked(keyTimesCount, componentCount, offset, &normalizedKeyTimes[0], &ranges[0], &values[0]);
+    if (animation == nullptr)
+    {
+      animation = new Animation(id);
+      animation->createChannel(target, targetAttribute, curve, duration);
+      // Release the animation because a newly created animation has a ref count of 1 and the channels hold the ref to animation.
+      animation->release();
+    }
+    else
+    {
+      animation->createChannel(target, targetAttribute, curve, duration);
+    }
+    curve->release();
+
+    return animation;
+  }
+
   std::shared_ptr<Mesh> Bundle::loadMesh(const char* id)
   {
     return loadMesh(id, nullptr);
@@ -1381,8 +1489,8 @@ namespace gameplay
       return nullptr;
     }
 
-    // Read mesh data.
-    auto meshData = readMeshData();
+    // Read mesh data. The data is uploaded before returning, so it can stay in the mapped file.
+    auto meshData = readMeshData(true);
     if (meshData == nullptr)
     {
       GP_ERROR("Failed to load mesh data for mesh '%s'.", id);
@@ -1430,7 +1538,32 @@ namespace gameplay
     return mesh;
   }
 
-  std::unique_ptr<Bundle::MeshData> Bundle::readMeshData()
+  unsigned char* Bundle::readData(unsigned int byteCount, bool mapped, bool* owned)
+  {
+    assert(owned);
+
+    const unsigned char* mapping = mapped ? (const unsigned char*)_stream->data() : nullptr;
+    if (mapping)
+    {
+      // Seeking fails if the block extends past the end of the file.
+      long int position = _stream->position();
+      if (!_stream->seek(byteCount, SEEK_CUR))
+        return nullptr;
+      *owned = false;
+      return const_cast<unsigned char*>(mapping + position);
+    }
+
+    unsigned char* data = new unsigned char[byteCount];
+    if (_stream->read(data, 1, byteCount) != byteCount)
+    {
+      SAFE_DELETE_ARRAY(data);
+      return nullptr;
+    }
+    *owned = true;
+    return data;
+  }
+
+  std::unique_ptr<Bundle::MeshData> Bundle::readMeshData(bool mapped)
   {
     // Read vertex format/elements.
     unsigned int vertexElementCount;
@@ -1488,8 +1621,8 @@ namespace gameplay
 
     assert(meshData->vertexFormat.getVertexSize());
     meshData->vertexCount = vertexByteCount / meshData->vertexFormat.getVertexSize();
-    meshData->vertexData = new unsigned char[vertexByteCount];
-    if (_stream->read(meshData->vertexData, 1, vertexByteCount) != vertexByteCount)
+    meshData->vertexData = readData(vertexByteCount, mapped, &meshData->ownsData);
+    if (meshData->vertexData == nullptr)
     {
       GP_ERROR("Failed to load vertex data.");
       meshData.release();
@@ -1573,8 +1706,8 @@ namespace gameplay
       assert(indexSize);
       partData->indexCount = iByteCount / indexSize;
 
-      partData->indexData = new unsigned char[iByteCount];
-      if (_stream->read(partData->indexData, 1, iByteCount) != iByteCount)
+      partData->indexData = readData(iByteCount, mapped, &partData->ownsData);
+      if (partData->indexData == nullptr)
       {
         GP_ERROR("Failed to read index data for mesh part with index %d.", i);
         meshData.release();
@@ -1873,23 +2006,29 @@ namespace gameplay
   }
 
   Bundle::MeshPartData::MeshPartData() :
-    primitiveType(Mesh::TRIANGLES), indexFormat(Mesh::INDEX32), indexCount(0), indexData(nullptr)
+    primitiveType(Mesh::TRIANGLES), indexFormat(Mesh::INDEX32), indexCount(0), indexData(nullptr), ownsData(true)
   {
   }
 
   Bundle::MeshPartData::~MeshPartData()
   {
-    SAFE_DELETE_ARRAY(indexData);
+    if (ownsData)
+    {
+      SAFE_DELETE_ARRAY(indexData);
+    }
   }
 
   Bundle::MeshData::MeshData(const VertexFormat& vertexFormat)
-    : vertexFormat(vertexFormat), vertexCount(0), vertexData(nullptr), primitiveType(Mesh::TRIANGLES)
+    : vertexFormat(vertexFormat), vertexCount(0), vertexData(nullptr), primitiveType(Mesh::TRIANGLES), ownsData(true)
   {
   }
 
   Bundle::MeshData::~MeshData()
   {
-    SAFE_DELETE_ARRAY(vertexData);
+    if (ownsData)
+    {
+      SAFE_DELETE_ARRAY(vertexData);
+    }
 
     for (unsigned int i = 0; i < parts.size(); ++i)
     {
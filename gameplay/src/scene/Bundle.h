@@ -17,6 +17,7 @@ namespace gameplay
   {
     friend class PhysicsController;
     friend class SceneLoader;
+    friend class AssetLoader;
 
   public:
 
@@ -149,6 +150,7 @@ namespace gameplay
       Mesh::IndexFormat indexFormat;
       unsigned int indexCount;
       unsigned char* indexData;
+      bool ownsData;
     };
 
     struct MeshData
@@ -163,6 +165,7 @@ namespace gameplay
       BoundingSphere boundingSphere;
       Mesh::PrimitiveType primitiveType;
       std::vector<MeshPartData*> parts;
+      bool ownsData;
     };
 
     Bundle(const char* path);
@@ -177,11 +180,28 @@ namespace gameplay
      */
     Bundle& operator=(const Bundle&);
 
+    /**
+     * Returns a new reference to the cached bundle with the given path, or nullptr if it is not cached.
+     */
+    static Bundle* findCached(const char* path);
+
+    /**
+     * Opens the bundle file and reads its header and reference table without consulting the cache.
+     *
+     * This does not touch any graphics state and may be called from a background thread.
+     */
+    static Bundle* open(const char* path);
+
     /**
      * Finds a reference by ID.
      */
     Reference* find(const char* id) const;
 
+    /**
+     * Indexes the ref table by id and by offset.
+     */
+    void buildReferenceIndex();
+
     /**
      * Resets any load session specific state for the bundle.
      */
@@ -364,8 +384,23 @@ namespace gameplay
 
     /**
      * Reads mesh data from the current file position.
+     *
+     * @param mapped True to point the vertex and index data straight into the bundle
+     *        when its stream is memory mapped, instead of copying them. The data is
+     *        then only valid while the bundle is alive.
+     */
+    std::unique_ptr<Bundle::MeshData> readMeshData(bool mapped = false);
+
+    /**
+     * Reads a block of data from the current file position.
+     *
+     * @param byteCount The number of bytes to read.
+     * @param mapped True to return a pointer into the bundle if its stream is memory mapped.
+     * @param owned Set to true if the returned data was allocated and must be deleted by the caller.
+     *
+     * @return The data, or nullptr if it could not be read.
      */
-    std::unique_ptr<Bundle::MeshData> readMeshData();
+    unsigned char* readData(unsigned int byteCount, bool mapped, bool* owned);
 
     /**
      * Reads mesh data for the specified URL.
@@ -427,6 +462,13 @@ namespace gameplay
      */
     Animation* readAnimationChannelData(Animation* animation, const char* id, AnimationTarget* target, unsigned int targetAttribute);
 
+    /**
+     * Reads animation channel data stored with compressed keys.
+     *
+     * @see readAnimationChannelData
+     */
+    Animation* readCompressedAnimationChannelData(Animation* animation, const char* id, AnimationTarget* target, unsigned int targetAttribute);
+
     /**
      * Sets the transformation matrix.
      *
@@ -454,6 +496,8 @@ namespace gameplay
     std::string _materialPath;
     unsigned int _referenceCount;
     Reference* _references;
+    std::unordered_map<std::string, Reference*> _referencesById;
+    std::unordered_map<unsigned int, Reference*> _referencesByOffset;
     Stream* _stream;
 
     std::vector<MeshSkinData*> _meshSkins;
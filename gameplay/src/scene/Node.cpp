@@ -2,6 +2,8 @@
 #include "scene/Node.h"
 #include "audio/AudioSource.h"
 #include "scene/Scene.h"
+#include "scene/TransformStore.h"
+#include "scene/SpatialIndex.h"
 #include "animation/Joint.h"
 #include "physics/PhysicsRigidBody.h"
 #include "physics/PhysicsVehicle.h"
@@ -27,7 +29,8 @@ namespace gameplay
   Node::Node(const char* id)
     : _scene(nullptr), _firstChild(nullptr), _nextSibling(nullptr), _prevSibling(nullptr), _parent(nullptr), _childCount(0), _enabled(true), _tags(nullptr),
     _drawable(nullptr), _camera(nullptr), _light(nullptr), _audioSource(nullptr), _collisionObject(nullptr), _agent(nullptr), _userObject(nullptr),
-    _dirtyBits(NODE_DIRTY_ALL)
+    _dirtyBits(NODE_DIRTY_ALL), _transformStore(nullptr), _transformIndex(-1),
+    _spatialIndex(nullptr), _spatialProxy(-1), _spatialDirtyIndex(-1), _worldVersion(1), _derivedMatrices(nullptr)
   {
     GP_REGISTER_SCRIPT_EVENTS();
     if (id)
@@ -51,6 +54,7 @@ namespace gameplay
     SAFE_DELETE(_collisionObject);
     SAFE_RELEASE(_userObject);
     SAFE_DELETE(_tags);
+    SAFE_DELETE(_derivedMatrices);
     setAgent(nullptr);
   }
 
@@ -100,6 +104,16 @@ namespace gameplay
     ++_childCount;
     setBoundsDirty();
 
+    if (_transformStore)
+    {
+      _transformStore->attach(child);
+    }
+
+    if (_spatialIndex)
+    {
+      _spatialIndex->attach(child);
+    }
+
     if (_dirtyBits & NODE_DIRTY_HIERARCHY)
     {
       hierarchyChanged();
@@ -131,6 +145,20 @@ namespace gameplay
 
   void Node::remove()
   {
+    // Stop tracking our subtree in the scene transform store and fall back to
+    // lazy evaluation, which our new world transform will need.
+    if (_transformStore)
+    {
+      _transformStore->detach(this);
+      transformChanged();
+    }
+
+    // Stop indexing our subtree in the scene spatial index.
+    if (_spatialIndex)
+    {
+      _spatialIndex->detach(this);
+    }
+
     // Re-link our neighbours.
     if (_prevSibling)
     {
@@ -388,6 +416,14 @@ namespace gameplay
 
   const Matrix& Node::getWorldMatrix() const
   {
+    if (_transformStore)
+    {
+      // Resolve any pending changes in the scene's flattened transform store.
+      _transformStore->update();
+      if (_transformIndex >= 0)
+        return _transformStore->_world[_transformIndex];
+    }
+
     if (_dirtyBits & NODE_DIRTY_WORLD)
     {
       // Clear our dirty flag immediately to prevent this block from being entered if our
@@ -419,29 +455,72 @@ namespace gameplay
     return _world;
   }
 
+  Node::DerivedMatrices::DerivedMatrices()
+    : inverseTransposeWorldVersion(0)
+  {
+    worldViewVersion[0] = worldViewVersion[1] = 0;
+    inverseTransposeWorldViewVersion[0] = inverseTransposeWorldViewVersion[1] = 0;
+    worldViewProjectionVersion[0] = worldViewProjectionVersion[1] = 0;
+  }
+
+  Node::DerivedMatrices* Node::getDerivedMatrices(unsigned int* worldVersion, unsigned int* cameraVersion) const
+  {
+    // Resolving the world matrix first delivers any pending transform store
+    // notifications, which bump the node and camera versions.
+    getWorldMatrix();
+
+    if (!_derivedMatrices)
+    {
+      _derivedMatrices = new DerivedMatrices();
+    }
+    *worldVersion = _worldVersion;
+    if (cameraVersion)
+    {
+      Scene* scene = getScene();
+      Camera* camera = scene ? scene->getActiveCamera() : nullptr;
+      *cameraVersion = camera ? camera->getVersion() : 0;
+    }
+    return _derivedMatrices;
+  }
+
   const Matrix& Node::getWorldViewMatrix() const
   {
-    static Matrix worldView;
-    Matrix::multiply(getViewMatrix(), getWorldMatrix(), &worldView);
-    return worldView;
+    unsigned int worldVersion, cameraVersion;
+    DerivedMatrices* derived = getDerivedMatrices(&worldVersion, &cameraVersion);
+    if (derived->worldViewVersion[0] != worldVersion || derived->worldViewVersion[1] != cameraVersion)
+    {
+      Matrix::multiply(getViewMatrix(), getWorldMatrix(), &derived->worldView);
+      derived->worldViewVersion[0] = worldVersion;
+      derived->worldViewVersion[1] = cameraVersion;
+    }
+    return derived->worldView;
   }
 
   const Matrix& Node::getInverseTransposeWorldViewMatrix() const
   {
-    static Matrix invTransWorldView;
-    Matrix::multiply(getViewMatrix(), getWorldMatrix(), &invTransWorldView);
-    invTransWorldView.invert();
-    invTransWorldView.transpose();
-    return invTransWorldView;
+    unsigned int worldVersion, cameraVersion;
+    DerivedMatrices* derived = getDerivedMatrices(&worldVersion, &cameraVersion);
+    if (derived->inverseTransposeWorldViewVersion[0] != worldVersion || derived->inverseTransposeWorldViewVersion[1] != cameraVersion)
+    {
+      getWorldViewMatrix().invert(&derived->inverseTransposeWorldView);
+      derived->inverseTransposeWorldView.transpose();
+      derived->inverseTransposeWorldViewVersion[0] = worldVersion;
+      derived->inverseTransposeWorldViewVersion[1] = cameraVersion;
+    }
+    return derived->inverseTransposeWorldView;
   }
 
   const Matrix& Node::getInverseTransposeWorldMatrix() const
   {
-    static Matrix invTransWorld;
-    invTransWorld = getWorldMatrix();
-    invTransWorld.invert();
-    invTransWorld.transpose();
-    return invTransWorld;
+    unsigned int worldVersion;
+    DerivedMatrices* derived = getDerivedMatrices(&worldVersion, nullptr);
+    if (derived->inverseTransposeWorldVersion != worldVersion)
+    {
+      getWorldMatrix().invert(&derived->inverseTransposeWorld);
+      derived->inverseTransposeWorld.transpose();
+      derived->inverseTransposeWorldVersion = worldVersion;
+    }
+    return derived->inverseTransposeWorld;
   }
 
   const Matrix& Node::getViewMatrix() const
@@ -513,11 +592,15 @@ namespace gameplay
 
   const Matrix& Node::getWorldViewProjectionMatrix() const
   {
-    // Always re-calculate worldViewProjection matrix since it's extremely difficult
-    // to track whether the camera has changed (it may frequently change every frame).
-    static Matrix worldViewProj;
-    Matrix::multiply(getViewProjectionMatrix(), getWorldMatrix(), &worldViewProj);
-    return worldViewProj;
+    unsigned int worldVersion, cameraVersion;
+    DerivedMatrices* derived = getDerivedMatrices(&worldVersion, &cameraVersion);
+    if (derived->worldViewProjectionVersion[0] != worldVersion || derived->worldViewProjectionVersion[1] != cameraVersion)
+    {
+      Matrix::multiply(getViewProjectionMatrix(), getWorldMatrix(), &derived->worldViewProjection);
+      derived->worldViewProjectionVersion[0] = worldVersion;
+      derived->worldViewProjectionVersion[1] = cameraVersion;
+    }
+    return derived->worldViewProjection;
   }
 
   Vector3 Node::getTranslationWorld() const
@@ -604,6 +687,20 @@ namespace gameplay
   {
     // Our local transform was changed, so mark our world matrices dirty.
     _dirtyBits |= NODE_DIRTY_WORLD | NODE_DIRTY_BOUNDS;
+    ++_worldVersion;
+
+    if (_spatialIndex)
+      _spatialIndex->setDirty(this);
+
+    if (_transformStore)
+    {
+      // Children are notified by the store when it resolves the change, unless
+      // this is that notification being delivered.
+      if (_transformStore->_notifying != this)
+        _transformStore->setDirty(_transformIndex);
+      Transform::transformChanged();
+      return;
+    }
 
     // Notify our children that their transform has also changed (since transforms are inherited).
     for (Node* n = getFirstChild(); n != nullptr; n = n->getNextSibling())
@@ -630,6 +727,10 @@ namespace gameplay
     // Mark ourself and our parent nodes as dirty
     _dirtyBits |= NODE_DIRTY_BOUNDS;
 
+    // Refit our leaf in the scene spatial index before its next query.
+    if (_spatialIndex)
+      _spatialIndex->setDirty(this);
+
     // Mark our parent bounds as dirty as well
     if (_parent)
       _parent->setBoundsDirty();
@@ -765,6 +866,10 @@ namespace gameplay
 
   const BoundingSphere& Node::getBoundingSphere() const
   {
+    // Deliver pending transform changes, which dirty our bounds.
+    if (_transformStore)
+      _transformStore->update();
+
     if (_dirtyBits & NODE_DIRTY_BOUNDS)
     {
       _dirtyBits &= ~NODE_DIRTY_BOUNDS;
@@ -948,7 +1053,7 @@ namespace gameplay
       node->_tags = new std::map<std::string, std::string>(_tags->begin(), _tags->end());
     }
 
-    node->_world = _world;
+    node->_world = getWorldMatrix();
     node->_bounds = _bounds;
 
     // TODO: Clone the rest of the node data.
@@ -1023,6 +1128,10 @@ namespace gameplay
       break;  // Already deleted, Just don't add a new collision object back.
     }
 
+    // Collision objects decide whether the world transform is inherited.
+    if (_transformStore)
+      _transformStore->setDirty(_transformIndex);
+
     return _collisionObject;
   }
 
@@ -1096,6 +1205,10 @@ namespace gameplay
       return nullptr;
     }
 
+    // Collision objects decide whether the world transform is inherited.
+    if (_transformStore)
+      _transformStore->setDirty(_transformIndex);
+
     return _collisionObject;
   }
 
@@ -24,6 +24,8 @@ namespace gameplay
   class AudioSource;
   class AIAgent;
   class Drawable;
+  class TransformStore;
+  class SpatialIndex;
 
   /**
    * Defines a hierarchical structure of objects in 3D transformation spaces.
@@ -40,6 +42,8 @@ namespace gameplay
     friend class Bundle;
     friend class MeshSkin;
     friend class Light;
+    friend class TransformStore;
+    friend class SpatialIndex;
 
     GP_SCRIPT_EVENTS_START();
     GP_SCRIPT_EVENT(update, "<Node>f");
@@ -271,7 +275,13 @@ namespace gameplay
     /**
      * Gets the world matrix corresponding to this node.
      *
+     * If the node belongs to a scene with a transform store enabled, the
+     * matrix is read from the store (which is updated first if needed) and the
+     * returned reference is only valid until the scene hierarchy changes.
+     *
      * @return The world matrix of this node.
+     *
+     * @see Scene::setTransformStoreEnabled
      */
     virtual const Matrix& getWorldMatrix() const;
 
@@ -344,6 +354,11 @@ namespace gameplay
      * Gets the world * view * projection matrix corresponding to this node based
      * on the scene's active camera.
      *
+     * Like the other world-derived matrices of a node, the result is cached on
+     * the node and only recomputed after the node or the active camera changes.
+     * Since no state is shared between nodes, different nodes may be queried
+     * from different threads once their world matrices have been resolved.
+     *
      * @return The world * view * projection matrix of this node.
      */
     const Matrix& getWorldViewProjectionMatrix() const;
@@ -711,6 +726,30 @@ namespace gameplay
 
     PhysicsCollisionObject* setCollisionObject(Properties* properties);
 
+    /**
+     * Matrices derived from the world matrix and the active camera, cached
+     * with the versions they were computed from.
+     */
+    struct DerivedMatrices
+    {
+      DerivedMatrices();
+
+      Matrix worldView;
+      Matrix inverseTransposeWorld;
+      Matrix inverseTransposeWorldView;
+      Matrix worldViewProjection;
+      unsigned int worldViewVersion[2];
+      unsigned int inverseTransposeWorldVersion;
+      unsigned int inverseTransposeWorldViewVersion[2];
+      unsigned int worldViewProjectionVersion[2];
+    };
+
+    /**
+     * Gets the cached derived matrices, resolving the world matrix and
+     * returning the world and camera versions to compare them against.
+     */
+    DerivedMatrices* getDerivedMatrices(unsigned int* worldVersion, unsigned int* cameraVersion) const;
+
   protected:
 
     /** The scene this node is attached to. */
@@ -751,6 +790,20 @@ namespace gameplay
     mutable BoundingSphere _bounds;
     /** The dirty bits used for optimization. */
     mutable int _dirtyBits;
+    /** The scene transform store tracking this node, if any. */
+    TransformStore* _transformStore;
+    /** The index of this node in the transform store, or -1 if not yet sorted. */
+    int _transformIndex;
+    /** The scene spatial index tracking this node, if any. */
+    SpatialIndex* _spatialIndex;
+    /** The leaf of this node in the spatial index, or -1 if it is not indexed. */
+    int _spatialProxy;
+    /** The position of this node in the dirty list of the spatial index, or -1 if it is not dirty. */
+    int _spatialDirtyIndex;
+    /** Incremented whenever the world matrix of this node changes. */
+    unsigned int _worldVersion;
+    /** The cached derived matrices, allocated on first use. */
+    mutable DerivedMatrices* _derivedMatrices;
   };
 
   /**
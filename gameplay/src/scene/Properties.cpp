@@ -2,10 +2,30 @@
 #include "scene/Properties.h"
 #include "framework/FileSystem.h"
 #include "math/Quaternion.h"
+#include "utils/ResourceRegistry.h"
+
+// Signature and version of precompiled (binary) properties files
+#define PROPERTIES_BINARY_SIGNATURE       "\xABGPP\xBB\r\n\x1A\n"
+#define PROPERTIES_BINARY_VERSION_MAJOR   1
+#define PROPERTIES_BINARY_VERSION_MINOR   0
+
+// For sanity checking binary reads
+#define PROPERTIES_BINARY_MAX_DEPTH       256
+
+// Namespaces with more properties than this are looked up through a hashed index
+#define PROPERTIES_INDEX_THRESHOLD        8
 
 namespace gameplay
 {
 
+  // Parsed documents by resolved file path. Each file is parsed once per session;
+  // create() hands out clones of the namespace it was asked for.
+  static ResourceCache<Properties> __documentCache("properties");
+  static std::mutex __documentMutex;
+
+  // Incremented whenever namespaces are moved between trees, which invalidates every namespace index.
+  static std::atomic<unsigned int> __namespaceVersion(1);
+
   /**
    * Reads the next character from the stream. Returns EOF if the end of the stream is reached.
    */
@@ -23,15 +43,15 @@ namespace gameplay
   /** @script{ignore} */
   void calculateNamespacePath(const std::string& urlString, std::string& fileString, std::vector<std::string>& namespacePath);
   /** @script{ignore} */
-  Properties* getPropertiesFromNamespacePath(Properties* properties, const std::vector<std::string>& namespacePath);
+  Properties* getPropertiesFromNamespacePath(const Properties* properties, const std::vector<std::string>& namespacePath);
 
   Properties::Properties()
-    : _variables(nullptr), _dirPath(nullptr), _visited(false), _parent(nullptr)
+    : _variables(nullptr), _dirPath(nullptr), _visited(false), _parent(nullptr), _namespacesByIdVersion(0), _namespacesByNameVersion(0)
   {
   }
 
   Properties::Properties(const Properties& copy)
-    : _namespace(copy._namespace), _id(copy._id), _parentID(copy._parentID), _properties(copy._properties), _variables(nullptr), _dirPath(nullptr), _visited(false), _parent(copy._parent)
+    : _namespace(copy._namespace), _id(copy._id), _parentID(copy._parentID), _properties(copy._properties), _variables(nullptr), _dirPath(nullptr), _visited(false), _parent(copy._parent), _namespacesByIdVersion(0), _namespacesByNameVersion(0)
   {
     setDirectoryPath(copy._dirPath);
     _namespaces = std::vector<Properties*>();
@@ -45,14 +65,14 @@ namespace gameplay
   }
 
   Properties::Properties(Stream* stream)
-    : _variables(nullptr), _dirPath(nullptr), _visited(false), _parent(nullptr)
+    : _variables(nullptr), _dirPath(nullptr), _visited(false), _parent(nullptr), _namespacesByIdVersion(0), _namespacesByNameVersion(0)
   {
     readProperties(stream);
     rewind();
   }
 
   Properties::Properties(Stream* stream, const char* name, const char* id, const char* parentID, Properties* parent)
-    : _namespace(name), _variables(nullptr), _dirPath(nullptr), _visited(false), _parent(parent)
+    : _namespace(name), _variables(nullptr), _dirPath(nullptr), _visited(false), _parent(parent), _namespacesByIdVersion(0), _namespacesByNameVersion(0)
   {
     if (id)
     {
@@ -80,36 +100,339 @@ namespace gameplay
     std::vector<std::string> namespacePath;
     calculateNamespacePath(urlString, fileString, namespacePath);
 
-    std::unique_ptr<Stream> stream(FileSystem::open(fileString.c_str()));
+    const Properties* document = getDocument(fileString.c_str());
+    if (!document)
+      return nullptr;
+
+    // Get the specified properties object.
+    const Properties* p = getPropertiesFromNamespacePath(document, namespacePath);
+    if (!p)
+    {
+      GP_WARN("Failed to load properties from url '%s'.", url);
+      return nullptr;
+    }
+
+    // The cached document is shared, so callers always get their own copy.
+    Properties* properties = p->clone();
+
+    // The copy has no parent, so give it the variables defined by the namespaces around it.
+    for (const Properties* ancestor = p->_parent; ancestor; ancestor = ancestor->_parent)
+    {
+      if (!ancestor->_variables)
+        continue;
+      for (size_t i = 0, count = ancestor->_variables->size(); i < count; ++i)
+      {
+        const Property& variable = (*ancestor->_variables)[i];
+        if (!properties->getVariable(variable.name.c_str()))
+          properties->setVariable(variable.name.c_str(), variable.value.c_str());
+      }
+    }
+    properties->setDirectoryPath(FileSystem::getDirectoryName(fileString.c_str()));
+    return properties;
+  }
+
+  void Properties::clearCache()
+  {
+    std::vector<Properties*> documents;
+    {
+      std::lock_guard<std::mutex> lock(__documentMutex);
+      __documentCache.clear(&documents);
+    }
+    for (size_t i = 0, count = documents.size(); i < count; ++i)
+    {
+      SAFE_DELETE(documents[i]);
+    }
+  }
+
+  void Properties::invalidate(const char* path)
+  {
+    assert(path);
+
+    Properties* document;
+    {
+      std::lock_guard<std::mutex> lock(__documentMutex);
+      document = __documentCache.remove(FileSystem::resolvePath(path));
+    }
+    SAFE_DELETE(document);
+  }
+
+  const Properties* Properties::getDocument(const char* path)
+  {
+    assert(path);
+
+    std::string resolvedPath = FileSystem::resolvePath(path);
+    {
+      std::lock_guard<std::mutex> lock(__documentMutex);
+      Properties* document = __documentCache.find(resolvedPath);
+      if (document)
+        return document;
+    }
+
+    // Parse the file outside the lock so that other files can be loaded meanwhile.
+    std::unique_ptr<Stream> stream(FileSystem::open(path, FileSystem::READ | FileSystem::MAPPED));
     if (stream.get() == nullptr)
     {
-      GP_WARN("Failed to open file '%s'.", fileString.c_str());
+      GP_WARN("Failed to open file '%s'.", path);
       return nullptr;
     }
 
-    Properties* properties = new Properties(stream.get());
-    properties->resolveInheritance();
+    Properties* document = nullptr;
+    char signature[9];
+    if (stream->read(signature, 1, 9) == 9 && memcmp(signature, PROPERTIES_BINARY_SIGNATURE, 9) == 0)
+    {
+      document = readBinary(stream.get());
+      if (!document)
+      {
+        GP_WARN("Failed to read precompiled properties file '%s'.", path);
+        return nullptr;
+      }
+    }
+    else
+    {
+      stream->rewind();
+      document = new Properties(stream.get());
+      document->resolveInheritance();
+    }
+    size_t memoryUsage = stream->length();
     stream->close();
 
-    // Get the specified properties object.
-    Properties* p = getPropertiesFromNamespacePath(properties, namespacePath);
-    if (!p)
+    std::lock_guard<std::mutex> lock(__documentMutex);
+    Properties* existing = __documentCache.find(resolvedPath);
+    if (existing)
     {
-      GP_WARN("Failed to load properties from url '%s'.", url);
-      SAFE_DELETE(properties);
+      // Another thread parsed the same file first.
+      SAFE_DELETE(document);
+      return existing;
+    }
+    __documentCache.add(resolvedPath, document, memoryUsage);
+    return document;
+  }
+
+  bool Properties::compile(const char* path, const char* binaryPath)
+  {
+    assert(path);
+    assert(binaryPath);
+
+    std::unique_ptr<Stream> stream(FileSystem::open(path));
+    if (stream.get() == nullptr)
+    {
+      GP_WARN("Failed to open file '%s'.", path);
+      return false;
+    }
+    std::unique_ptr<Properties> document(new Properties(stream.get()));
+    document->resolveInheritance();
+    stream->close();
+
+    // Every name, value, namespace and id is stored once in a string table and referenced by index.
+    std::vector<const std::string*> strings;
+    std::unordered_map<std::string, unsigned int> indices;
+    document->internStrings(strings, indices);
+
+    std::unique_ptr<Stream> output(FileSystem::open(binaryPath, FileSystem::WRITE));
+    if (output.get() == nullptr)
+    {
+      GP_WARN("Failed to create file '%s'.", binaryPath);
+      return false;
+    }
+
+    unsigned char version[2] = { PROPERTIES_BINARY_VERSION_MAJOR, PROPERTIES_BINARY_VERSION_MINOR };
+    unsigned int stringCount = (unsigned int)strings.size();
+    bool written = output->write(PROPERTIES_BINARY_SIGNATURE, 1, 9) == 9 &&
+      output->write(version, 1, 2) == 2 &&
+      output->write(&stringCount, 4, 1) == 1;
+    for (size_t i = 0; i < strings.size() && written; ++i)
+    {
+      unsigned int length = (unsigned int)strings[i]->length();
+      written = output->write(&length, 4, 1) == 1 &&
+        (length == 0 || output->write(strings[i]->c_str(), 1, length) == length);
+    }
+    written = written && document->writeBinary(output.get(), indices);
+    output->close();
+    invalidate(binaryPath);
+
+    if (!written)
+      GP_ERROR("Failed to write precompiled properties file '%s'.", binaryPath);
+    return written;
+  }
+
+  static unsigned int internString(const std::string& str, std::vector<const std::string*>& strings, std::unordered_map<std::string, unsigned int>& indices)
+  {
+    std::pair<std::unordered_map<std::string, unsigned int>::iterator, bool> result = indices.emplace(str, (unsigned int)strings.size());
+    if (result.second)
+      strings.push_back(&result.first->first);
+    return result.first->second;
+  }
+
+  void Properties::internStrings(std::vector<const std::string*>& strings, std::unordered_map<std::string, unsigned int>& indices) const
+  {
+    internString(_namespace, strings, indices);
+    internString(_id, strings, indices);
+    for (std::list<Property>::const_iterator itr = _properties.begin(); itr != _properties.end(); ++itr)
+    {
+      internString(itr->name, strings, indices);
+      internString(itr->value, strings, indices);
+    }
+    if (_variables)
+    {
+      for (size_t i = 0, count = _variables->size(); i < count; ++i)
+      {
+        internString((*_variables)[i].name, strings, indices);
+        internString((*_variables)[i].value, strings, indices);
+      }
+    }
+    for (size_t i = 0, count = _namespaces.size(); i < count; ++i)
+    {
+      _namespaces[i]->internStrings(strings, indices);
+    }
+  }
+
+  bool Properties::writeBinary(Stream* stream, const std::unordered_map<std::string, unsigned int>& indices) const
+  {
+    assert(stream);
+
+    std::vector<unsigned int> data;
+    data.push_back(indices.at(_namespace));
+    data.push_back(indices.at(_id));
+    data.push_back((unsigned int)_properties.size());
+    for (std::list<Property>::const_iterator itr = _properties.begin(); itr != _properties.end(); ++itr)
+    {
+      data.push_back(indices.at(itr->name));
+      data.push_back(indices.at(itr->value));
+    }
+    data.push_back(_variables ? (unsigned int)_variables->size() : 0);
+    if (_variables)
+    {
+      for (size_t i = 0, count = _variables->size(); i < count; ++i)
+      {
+        data.push_back(indices.at((*_variables)[i].name));
+        data.push_back(indices.at((*_variables)[i].value));
+      }
+    }
+    data.push_back((unsigned int)_namespaces.size());
+
+    if (stream->write(data.data(), 4, data.size()) != data.size())
+      return false;
+    for (size_t i = 0, count = _namespaces.size(); i < count; ++i)
+    {
+      if (!_namespaces[i]->writeBinary(stream, indices))
+        return false;
+    }
+    return true;
+  }
+
+  /**
+   * Reads a 32-bit value from memory, advancing the read pointer. Returns false past the end of the data.
+   */
+  static bool readUInt(const unsigned char*& ptr, const unsigned char* end, unsigned int* value)
+  {
+    if (end - ptr < 4)
+      return false;
+    memcpy(value, ptr, 4);
+    ptr += 4;
+    return true;
+  }
+
+  Properties* Properties::readBinary(Stream* stream)
+  {
+    assert(stream);
+
+    unsigned char version[2];
+    if (stream->read(version, 1, 2) != 2 || version[0] != PROPERTIES_BINARY_VERSION_MAJOR)
+    {
+      GP_WARN("Unsupported precompiled properties version.");
       return nullptr;
     }
 
-    // If the loaded properties object is not the root namespace,
-    // then we have to clone it and delete the root namespace
-    // so that we don't leak memory.
-    if (p != properties)
+    // Read straight out of the mapped file when possible.
+    size_t position = (size_t)stream->position();
+    size_t length = stream->length();
+    std::vector<unsigned char> buffer;
+    const unsigned char* ptr = static_cast<const unsigned char*>(stream->data());
+    if (ptr)
     {
-      p = p->clone();
-      SAFE_DELETE(properties);
+      ptr += position;
     }
-    p->setDirectoryPath(FileSystem::getDirectoryName(fileString.c_str()));
-    return p;
+    else
+    {
+      buffer.resize(length - position);
+      if (stream->read(buffer.data(), 1, buffer.size()) != buffer.size())
+        return nullptr;
+      ptr = buffer.data();
+    }
+    const unsigned char* end = ptr + (length - position);
+
+    unsigned int stringCount;
+    if (!readUInt(ptr, end, &stringCount) || stringCount > (unsigned int)(end - ptr) / 4)
+      return nullptr;
+    std::vector<std::string> strings(stringCount);
+    for (unsigned int i = 0; i < stringCount; ++i)
+    {
+      unsigned int stringLength;
+      if (!readUInt(ptr, end, &stringLength) || stringLength > (unsigned int)(end - ptr))
+        return nullptr;
+      strings[i].assign(reinterpret_cast<const char*>(ptr), stringLength);
+      ptr += stringLength;
+    }
+
+    Properties* document = new Properties();
+    if (!document->readBinary(ptr, end, strings, 0))
+    {
+      SAFE_DELETE(document);
+      return nullptr;
+    }
+    return document;
+  }
+
+  bool Properties::readBinary(const unsigned char*& ptr, const unsigned char* end, const std::vector<std::string>& strings, unsigned int depth)
+  {
+    unsigned int stringCount = (unsigned int)strings.size();
+    unsigned int namespaceIndex, idIndex, count;
+    if (depth > PROPERTIES_BINARY_MAX_DEPTH ||
+      !readUInt(ptr, end, &namespaceIndex) || namespaceIndex >= stringCount ||
+      !readUInt(ptr, end, &idIndex) || idIndex >= stringCount)
+      return false;
+    _namespace = strings[namespaceIndex];
+    _id = strings[idIndex];
+
+    if (!readUInt(ptr, end, &count))
+      return false;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      unsigned int name, value;
+      if (!readUInt(ptr, end, &name) || name >= stringCount || !readUInt(ptr, end, &value) || value >= stringCount)
+        return false;
+      _properties.emplace_back(Property(strings[name].c_str(), strings[value].c_str()));
+    }
+
+    if (!readUInt(ptr, end, &count))
+      return false;
+    if (count > 0)
+    {
+      _variables = new std::vector<Property>();
+      _variables->reserve(count);
+    }
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      unsigned int name, value;
+      if (!readUInt(ptr, end, &name) || name >= stringCount || !readUInt(ptr, end, &value) || value >= stringCount)
+        return false;
+      _variables->emplace_back(Property(strings[name].c_str(), strings[value].c_str()));
+    }
+
+    if (!readUInt(ptr, end, &count))
+      return false;
+    _namespaces.reserve(std::min<unsigned int>(count, (unsigned int)(end - ptr) / 4));
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      Properties* child = new Properties();
+      child->_parent = this;
+      _namespaces.push_back(child);
+      if (!child->readBinary(ptr, end, strings, depth + 1))
+        return false;
+    }
+
+    rewind();
+    return true;
   }
 
   static bool isVariable(const char* str, char* outName, size_t outSize)
@@ -474,6 +797,7 @@ namespace gameplay
 
           // Copy data from the parent into the child.
           derived->_properties = parent->_properties;
+          derived->_propertyIndex.clear();
           derived->_namespaces.clear();
           derived->_namespaces.reserve(parent->_namespaces.size());
 
@@ -483,6 +807,7 @@ namespace gameplay
             });
 
           derived->rewind();
+          ++__namespaceVersion;
 
           // Take the original copy of the child and override the data copied from the parent.
           derived->mergeWith(overrides);
@@ -547,6 +872,7 @@ namespace gameplay
         // Add this new namespace.
         this->_namespaces.emplace_back(new Properties(*overridesNamespace));
         this->_namespacesItr = this->_namespaces.end();
+        ++__namespaceVersion;
       }
 
       overridesNamespace = overrides->getNextNamespace();
@@ -600,24 +926,47 @@ namespace gameplay
   {
     assert(id);
 
+    if (recurse)
+    {
+      const std::unordered_map<std::string_view, Properties*>& index = getNamespaceIndex(searchNames);
+      std::unordered_map<std::string_view, Properties*>::const_iterator itr = index.find(id);
+      return itr == index.end() ? nullptr : itr->second;
+    }
+
     for (std::vector<Properties*>::const_iterator it = _namespaces.begin(); it < _namespaces.end(); ++it)
     {
       Properties* p = *it;
       if (strcmp(searchNames ? p->_namespace.c_str() : p->_id.c_str(), id) == 0)
         return p;
-
-      if (recurse)
-      {
-        // Search recursively.
-        p = p->getNamespace(id, searchNames, true);
-        if (p)
-          return p;
-      }
     }
 
     return nullptr;
   }
 
+  const std::unordered_map<std::string_view, Properties*>& Properties::getNamespaceIndex(bool searchNames) const
+  {
+    std::unordered_map<std::string_view, Properties*>& index = searchNames ? _namespacesByName : _namespacesById;
+    unsigned int& version = searchNames ? _namespacesByNameVersion : _namespacesByIdVersion;
+    unsigned int currentVersion = __namespaceVersion;
+    if (version == currentVersion)
+      return index;
+
+    // Index every descendant in depth-first order, keeping the first match like a recursive search would.
+    index.clear();
+    std::vector<const Properties*> stack(1, this);
+    while (!stack.empty())
+    {
+      const Properties* current = stack.back();
+      stack.pop_back();
+      for (std::vector<Properties*>::const_reverse_iterator it = current->_namespaces.rbegin(); it != current->_namespaces.rend(); ++it)
+        stack.push_back(*it);
+      if (current != this)
+        index.emplace(searchNames ? current->_namespace : current->_id, const_cast<Properties*>(current));
+    }
+    version = currentVersion;
+    return index;
+  }
+
   const char* Properties::getNamespace() const
   {
     return _namespace.c_str();
@@ -633,13 +982,7 @@ namespace gameplay
     if (name == nullptr)
       return false;
 
-    for (std::list<Property>::const_iterator itr = _properties.begin(); itr != _properties.end(); ++itr)
-    {
-      if (itr->name == name)
-        return true;
-    }
-
-    return false;
+    return findProperty(name) != nullptr;
   }
 
   static const bool isStringNumeric(const char* str)
@@ -710,39 +1053,49 @@ namespace gameplay
     }
   }
 
-  const char* Properties::getString(const char* name, const char* defaultValue) const
+  Properties::Property* Properties::findProperty(const char* name) const
   {
-    char variable[256];
-    const char* value = nullptr;
-
-    if (name)
+    if (!name)
     {
-      // If 'name' is a variable, return the variable value
-      if (isVariable(name, variable, 256))
-      {
-        return getVariable(variable, defaultValue);
-      }
+      // No name provided - get the property at the current iterator position
+      return _propertiesItr != _properties.end() ? &*_propertiesItr : nullptr;
+    }
 
+    if (_properties.size() <= PROPERTIES_INDEX_THRESHOLD)
+    {
       for (std::list<Property>::const_iterator itr = _properties.begin(); itr != _properties.end(); ++itr)
       {
         if (itr->name == name)
-        {
-          value = itr->value.c_str();
-          break;
-        }
+          return const_cast<Property*>(&*itr);
       }
+      return nullptr;
     }
-    else
+
+    if (_propertyIndex.empty())
     {
-      // No name provided - get the value at the current iterator position
-      if (_propertiesItr != _properties.end())
-      {
-        value = _propertiesItr->value.c_str();
-      }
+      // Properties are only appended once the index exists, so it keeps the first property with each name.
+      for (std::list<Property>::const_iterator itr = _properties.begin(); itr != _properties.end(); ++itr)
+        _propertyIndex.emplace(itr->name, const_cast<Property*>(&*itr));
+    }
+    std::unordered_map<std::string_view, Property*>::const_iterator itr = _propertyIndex.find(name);
+    return itr == _propertyIndex.end() ? nullptr : itr->second;
+  }
+
+  const char* Properties::getString(const char* name, const char* defaultValue) const
+  {
+    char variable[256];
+
+    // If 'name' is a variable, return the variable value
+    if (name && isVariable(name, variable, 256))
+    {
+      return getVariable(variable, defaultValue);
     }
 
-    if (value)
+    const Property* property = findProperty(name);
+    if (property)
     {
+      const char* value = property->value.c_str();
+
       // If the value references a variable, return the variable value
       if (isVariable(value, variable, 256))
         return getVariable(variable, defaultValue);
@@ -757,18 +1110,19 @@ namespace gameplay
   {
     if (name)
     {
-      for (std::list<Property>::iterator itr = _properties.begin(); itr != _properties.end(); ++itr)
+      Property* property = findProperty(name);
+      if (property)
       {
-        if (itr->name == name)
-        {
-          // Update the first property that matches this name
-          itr->value = value ? value : "";
-          return true;
-        }
+        // Update the first property that matches this name
+        property->value = value ? value : "";
+        property->cachedType = Property::CACHED_NONE;
+        return true;
       }
 
       // There is no property with this name, so add one
       _properties.emplace_back(Property(name, value ? value : ""));
+      if (!_propertyIndex.empty())
+        _propertyIndex.emplace(_properties.back().name, &_properties.back());
     }
     else
     {
@@ -777,6 +1131,7 @@ namespace gameplay
         return false;
 
       _propertiesItr->value = value ? value : "";
+      _propertiesItr->cachedType = Property::CACHED_NONE;
     }
 
     return true;
@@ -793,8 +1148,18 @@ namespace gameplay
     return defaultValue;
   }
 
+  bool Properties::isCacheable(const Property* property, const char* value)
+  {
+    // Values read through a variable can change with the variable, so only direct values are cached.
+    return property && value == property->value.c_str();
+  }
+
   int Properties::getInt(const char* name) const
   {
+    const Property* property = findProperty(name);
+    if (property && property->cachedType == Property::CACHED_INT)
+      return property->cached.intValue;
+
     const char* valueString = getString(name);
     if (valueString)
     {
@@ -806,6 +1171,11 @@ namespace gameplay
         GP_ERROR("Error attempting to parse property '%s' as an integer.", name);
         return 0;
       }
+      if (isCacheable(property, valueString))
+      {
+        property->cachedType = Property::CACHED_INT;
+        property->cached.intValue = value;
+      }
       return value;
     }
 
@@ -814,6 +1184,10 @@ namespace gameplay
 
   float Properties::getFloat(const char* name) const
   {
+    const Property* property = findProperty(name);
+    if (property && property->cachedType == Property::CACHED_FLOAT)
+      return property->cached.floatValue;
+
     const char* valueString = getString(name);
     if (valueString)
     {
@@ -825,6 +1199,11 @@ namespace gameplay
         GP_ERROR("Error attempting to parse property '%s' as a float.", name);
         return 0.0f;
       }
+      if (isCacheable(property, valueString))
+      {
+        property->cachedType = Property::CACHED_FLOAT;
+        property->cached.floatValue = value;
+      }
       return value;
     }
 
@@ -833,6 +1212,10 @@ namespace gameplay
 
   long Properties::getLong(const char* name) const
   {
+    const Property* property = findProperty(name);
+    if (property && property->cachedType == Property::CACHED_LONG)
+      return property->cached.longValue;
+
     const char* valueString = getString(name);
     if (valueString)
     {
@@ -844,6 +1227,11 @@ namespace gameplay
         GP_ERROR("Error attempting to parse property '%s' as a long integer.", name);
         return 0L;
       }
+      if (isCacheable(property, valueString))
+      {
+        property->cachedType = Property::CACHED_LONG;
+        property->cached.longValue = value;
+      }
       return value;
     }
 
@@ -880,17 +1268,74 @@ namespace gameplay
 
   bool Properties::getVector2(const char* name, Vector2* out) const
   {
-    return parseVector2(getString(name), out);
+    assert(out);
+
+    const Property* property = findProperty(name);
+    if (property && property->cachedType == Property::CACHED_VECTOR2)
+    {
+      out->set(property->cached.vectorValue);
+      return true;
+    }
+
+    const char* valueString = getString(name);
+    if (!parseVector2(valueString, out))
+      return false;
+    if (isCacheable(property, valueString))
+    {
+      property->cachedType = Property::CACHED_VECTOR2;
+      property->cached.vectorValue[0] = out->x;
+      property->cached.vectorValue[1] = out->y;
+    }
+    return true;
   }
 
   bool Properties::getVector3(const char* name, Vector3* out) const
   {
-    return parseVector3(getString(name), out);
+    assert(out);
+
+    const Property* property = findProperty(name);
+    if (property && property->cachedType == Property::CACHED_VECTOR3)
+    {
+      out->set(property->cached.vectorValue);
+      return true;
+    }
+
+    const char* valueString = getString(name);
+    if (!parseVector3(valueString, out))
+      return false;
+    if (isCacheable(property, valueString))
+    {
+      property->cachedType = Property::CACHED_VECTOR3;
+      property->cached.vectorValue[0] = out->x;
+      property->cached.vectorValue[1] = out->y;
+      property->cached.vectorValue[2] = out->z;
+    }
+    return true;
   }
 
   bool Properties::getVector4(const char* name, Vector4* out) const
   {
-    return parseVector4(getString(name), out);
+    assert(out);
+
+    const Property* property = findProperty(name);
+    if (property && property->cachedType == Property::CACHED_VECTOR4)
+    {
+      out->set(property->cached.vectorValue);
+      return true;
+    }
+
+    const char* valueString = getString(name);
+    if (!parseVector4(valueString, out))
+      return false;
+    if (isCacheable(property, valueString))
+    {
+      property->cachedType = Property::CACHED_VECTOR4;
+      property->cached.vectorValue[0] = out->x;
+      property->cached.vectorValue[1] = out->y;
+      property->cached.vectorValue[2] = out->z;
+      property->cached.vectorValue[3] = out->w;
+    }
+    return true;
   }
 
   bool Properties::getQuaternionFromAxisAngle(const char* name, Quaternion* out) const
@@ -900,12 +1345,51 @@ namespace gameplay
 
   bool Properties::getColor(const char* name, Vector3* out) const
   {
-    return parseColor(getString(name), out);
+    assert(out);
+
+    const Property* property = findProperty(name);
+    if (property && property->cachedType == Property::CACHED_COLOR3)
+    {
+      out->set(property->cached.vectorValue);
+      return true;
+    }
+
+    const char* valueString = getString(name);
+    if (!parseColor(valueString, out))
+      return false;
+    if (isCacheable(property, valueString))
+    {
+      property->cachedType = Property::CACHED_COLOR3;
+      property->cached.vectorValue[0] = out->x;
+      property->cached.vectorValue[1] = out->y;
+      property->cached.vectorValue[2] = out->z;
+    }
+    return true;
   }
 
   bool Properties::getColor(const char* name, Vector4* out) const
   {
-    return parseColor(getString(name), out);
+    assert(out);
+
+    const Property* property = findProperty(name);
+    if (property && property->cachedType == Property::CACHED_COLOR4)
+    {
+      out->set(property->cached.vectorValue);
+      return true;
+    }
+
+    const char* valueString = getString(name);
+    if (!parseColor(valueString, out))
+      return false;
+    if (isCacheable(property, valueString))
+    {
+      property->cachedType = Property::CACHED_COLOR4;
+      property->cached.vectorValue[0] = out->x;
+      property->cached.vectorValue[1] = out->y;
+      property->cached.vectorValue[2] = out->z;
+      property->cached.vectorValue[3] = out->w;
+    }
+    return true;
   }
 
   bool Properties::getPath(const char* name, std::string* path) const
@@ -1004,7 +1488,7 @@ namespace gameplay
     }
   }
 
-  Properties* Properties::clone()
+  Properties* Properties::clone() const
   {
     Properties* p = new Properties();
 
@@ -1013,6 +1497,8 @@ namespace gameplay
     p->_parentID = _parentID;
     p->_properties = _properties;
     p->_propertiesItr = p->_properties.end();
+    if (_variables)
+      p->_variables = new std::vector<Property>(*_variables);
     p->setDirectoryPath(_dirPath);
 
     for (size_t i = 0, count = _namespaces.size(); i < count; i++)
@@ -1073,47 +1559,20 @@ namespace gameplay
     }
   }
 
-  Properties* getPropertiesFromNamespacePath(Properties* properties, const std::vector<std::string>& namespacePath)
+  Properties* getPropertiesFromNamespacePath(const Properties* properties, const std::vector<std::string>& namespacePath)
   {
-    // If the url references a specific namespace within the file,
-    // return the specified namespace or notify the user if it cannot be found.
-    if (namespacePath.size() > 0)
-    {
-      size_t size = namespacePath.size();
-      properties->rewind();
-      Properties* iter = properties->getNextNamespace();
-      for (size_t i = 0; i < size; )
-      {
-        while (true)
-        {
-          if (iter == nullptr)
-          {
-            GP_WARN("Failed to load properties object from url.");
-            return nullptr;
-          }
-
-          if (strcmp(iter->getId(), namespacePath[i].c_str()) == 0)
-          {
-            if (i != size - 1)
-            {
-              properties = iter->getNextNamespace();
-              iter = properties;
-            }
-            else
-              properties = iter;
+    assert(properties);
 
-            i++;
-            break;
-          }
-
-          iter = properties->getNextNamespace();
-        }
-      }
-
-      return properties;
+    // Descend into the child namespace with each id of the path in turn. The children are
+    // looked up directly, so the iteration position of every namespace is left unchanged.
+    Properties* p = const_cast<Properties*>(properties);
+    for (size_t i = 0, size = namespacePath.size(); i < size; ++i)
+    {
+      p = p->getNamespace(namespacePath[i].c_str(), false, false);
+      if (p == nullptr)
+        return nullptr;
     }
-    else
-      return properties;
+    return p;
   }
 
   bool Properties::parseVector2(const char* str, Vector2* out)
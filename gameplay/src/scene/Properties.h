@@ -121,6 +121,11 @@ namespace gameplay
    * modified to do so.  Also note that nothing in a properties file indicates the type
    * of a property. If the type is unknown, its string can be retrieved and interpreted
    * as necessary.
+   *
+   * A Properties object is not safe to use from several threads at once, not even
+   * through its const getters: they index names and cache parsed values on first use.
+   * Every call to create() returns a separate copy, so threads that load assets
+   * concurrently should each create their own.
    */
   class Properties
   {
@@ -154,6 +159,41 @@ namespace gameplay
      */
     static Properties* create(const char* url);
 
+    /**
+     * Compiles a properties file into the precompiled binary format.
+     *
+     * Precompiled files have namespace inheritance already resolved and every
+     * string stored once, so create() loads them without any parsing. They are
+     * recognized by their contents, so a precompiled file can replace its text
+     * source under the same name.
+     *
+     * @param path The path of the text properties file.
+     * @param binaryPath The path of the precompiled file to write.
+     *
+     * @return True if the file was compiled, false otherwise.
+     * @script{ignore}
+     */
+    static bool compile(const char* path, const char* binaryPath);
+
+    /**
+     * Releases the parsed files cached by create().
+     *
+     * Every file is parsed once and kept for later calls to create(). This must
+     * not be called while properties are being created on another thread.
+     */
+    static void clearCache();
+
+    /**
+     * Releases the parsed file cached for the given path, if any.
+     *
+     * Code that writes a properties file calls this so that the next call to
+     * create() parses the new contents. The same restriction as for
+     * clearCache() applies.
+     *
+     * @param path The path of the file.
+     */
+    static void invalidate(const char* path);
+
     /**
      * Destructor.
      */
@@ -512,9 +552,34 @@ namespace gameplay
      */
     struct Property
     {
+      /**
+       * The kinds of parsed value a property can cache.
+       */
+      enum CachedType
+      {
+        CACHED_NONE,
+        CACHED_INT,
+        CACHED_LONG,
+        CACHED_FLOAT,
+        CACHED_VECTOR2,
+        CACHED_VECTOR3,
+        CACHED_VECTOR4,
+        CACHED_COLOR3,
+        CACHED_COLOR4
+      };
+
       std::string name;
       std::string value;
-      Property(const char* name, const char* value) : name(name), value(value) { }
+      // The last value parsed from the string, so repeated reads skip sscanf.
+      mutable CachedType cachedType;
+      mutable union
+      {
+        int intValue;
+        long longValue;
+        float floatValue;
+        float vectorValue[4];
+      } cached;
+      Property(const char* name, const char* value) : name(name), value(value), cachedType(CACHED_NONE) { }
     };
 
     /**
@@ -547,7 +612,29 @@ namespace gameplay
 
     char* trimWhiteSpace(char* str);
 
-    Properties* clone();
+    Properties* clone() const;
+
+    /**
+     * Returns the parsed file at the given path, parsing it on first use.
+     */
+    static const Properties* getDocument(const char* path);
+
+    void internStrings(std::vector<const std::string*>& strings, std::unordered_map<std::string, unsigned int>& indices) const;
+
+    bool writeBinary(Stream* stream, const std::unordered_map<std::string, unsigned int>& indices) const;
+
+    static Properties* readBinary(Stream* stream);
+
+    bool readBinary(const unsigned char*& ptr, const unsigned char* end, const std::vector<std::string>& strings, unsigned int depth);
+
+    /**
+     * Finds the first property with the given name, or the current property if name is nullptr.
+     */
+    Property* findProperty(const char* name) const;
+
+    const std::unordered_map<std::string_view, Properties*>& getNamespaceIndex(bool searchNames) const;
+
+    static bool isCacheable(const Property* property, const char* value);
 
     void mergeWith(Properties* overrides);
 
@@ -565,6 +652,11 @@ namespace gameplay
     std::string* _dirPath;
     bool _visited;
     Properties* _parent;
+    mutable std::unordered_map<std::string_view, Property*> _propertyIndex;
+    mutable std::unordered_map<std::string_view, Properties*> _namespacesById;
+    mutable std::unordered_map<std::string_view, Properties*> _namespacesByName;
+    mutable unsigned int _namespacesByIdVersion;
+    mutable unsigned int _namespacesByNameVersion;
   };
 
 }
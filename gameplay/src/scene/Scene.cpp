@@ -61,7 +61,7 @@ namespace gameplay
 
   Scene::Scene()
     : _id(""), _activeCamera(nullptr), _firstNode(nullptr), _lastNode(nullptr), _nodeCount(0), _bindAudioListenerToCamera(true),
-    _nextItr(nullptr), _nextReset(true)
+    _nextItr(nullptr), _nextReset(true), _transformStore(nullptr), _spatialIndex(nullptr)
   {
     __sceneList.push_back(this);
   }
@@ -82,6 +82,8 @@ namespace gameplay
 
     // Remove all nodes from the scene
     removeAllNodes();
+    SAFE_DELETE(_transformStore);
+    SAFE_DELETE(_spatialIndex);
 
     // Remove the scene from global list
     std::vector<Scene*>::iterator itr = std::find(__sceneList.begin(), __sceneList.end(), this);
@@ -273,6 +275,16 @@ namespace gameplay
 
     ++_nodeCount;
 
+    if (_transformStore)
+    {
+      _transformStore->attach(node);
+    }
+
+    if (_spatialIndex)
+    {
+      _spatialIndex->attach(node);
+    }
+
     // If we don't have an active camera set, then check for one and set it.
     if (_activeCamera == nullptr)
     {
@@ -386,6 +398,79 @@ namespace gameplay
     _ambientColor.set(red, green, blue);
   }
 
+  void Scene::setTransformStoreEnabled(bool enabled)
+  {
+    if (enabled == (_transformStore != nullptr))
+      return;
+
+    if (enabled)
+    {
+      _transformStore = new TransformStore(this);
+      for (Node* node = _firstNode; node != nullptr; node = node->_nextSibling)
+      {
+        _transformStore->attach(node);
+      }
+    }
+    else
+    {
+      for (Node* node = _firstNode; node != nullptr; node = node->_nextSibling)
+      {
+        _transformStore->detach(node);
+        node->transformChanged();
+      }
+      SAFE_DELETE(_transformStore);
+    }
+  }
+
+  bool Scene::isTransformStoreEnabled() const
+  {
+    return _transformStore != nullptr;
+  }
+
+  TransformStore* Scene::getTransformStore() const
+  {
+    return _transformStore;
+  }
+
+  void Scene::updateTransforms()
+  {
+    if (_transformStore)
+      _transformStore->update();
+  }
+
+  void Scene::setSpatialIndexEnabled(bool enabled)
+  {
+    if (enabled == (_spatialIndex != nullptr))
+      return;
+
+    if (enabled)
+    {
+      _spatialIndex = new SpatialIndex(this);
+      for (Node* node = _firstNode; node != nullptr; node = node->_nextSibling)
+      {
+        _spatialIndex->attach(node);
+      }
+    }
+    else
+    {
+      for (Node* node = _firstNode; node != nullptr; node = node->_nextSibling)
+      {
+        _spatialIndex->detach(node);
+      }
+      SAFE_DELETE(_spatialIndex);
+    }
+  }
+
+  bool Scene::isSpatialIndexEnabled() const
+  {
+    return _spatialIndex != nullptr;
+  }
+
+  SpatialIndex* Scene::getSpatialIndex() const
+  {
+    return _spatialIndex;
+  }
+
   void Scene::update(float elapsedTime)
   {
     for (Node* node = _firstNode; node != nullptr; node = node->_nextSibling)
@@ -393,6 +478,9 @@ namespace gameplay
       if (node->isEnabled())
         node->update(elapsedTime);
     }
+
+    // Resolve the transforms changed by this update in a single pass.
+    updateTransforms();
   }
 
   void Scene::reset()
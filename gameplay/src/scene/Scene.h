@@ -1,6 +1,8 @@
 #pragma once
 
 #include "scene/Node.h"
+#include "scene/TransformStore.h"
+#include "scene/SpatialIndex.h"
 #include "graphics/MeshBatch.h"
 #include "scripting/ScriptController.h"
 #include "graphics/Light.h"
@@ -176,6 +178,81 @@ namespace gameplay
      */
     void setAmbientColor(float red, float green, float blue);
 
+    /**
+     * Enables or disables the flattened transform store for this scene.
+     *
+     * When enabled, the local and world matrices of all nodes in the scene are kept
+     * in contiguous arrays sorted parent-before-child, and world matrices are resolved
+     * in a single linear pass over the dirty ranges instead of by recursively
+     * dirtying and lazily walking the node hierarchy. Node::getWorldMatrix() keeps
+     * working as before and reads its result from the store.
+     *
+     * Transform changes inherited from a parent are delivered to the listeners of
+     * child nodes when the store is updated, which happens on update(), visit(),
+     * updateTransforms() or the first world matrix query after the change.
+     *
+     * The store is disabled by default.
+     *
+     * @param enabled true to enable the transform store, false to disable it.
+     *
+     * @see TransformStore
+     */
+    void setTransformStoreEnabled(bool enabled);
+
+    /**
+     * Determines if the flattened transform store is enabled for this scene.
+     *
+     * @return true if the transform store is enabled, false otherwise.
+     */
+    bool isTransformStoreEnabled() const;
+
+    /**
+     * Gets the flattened transform store for this scene.
+     *
+     * @return The transform store, or nullptr if it is not enabled.
+     * @script{ignore}
+     */
+    TransformStore* getTransformStore() const;
+
+    /**
+     * Resolves the world matrices of all nodes whose transforms changed since the last call.
+     *
+     * This does nothing unless the transform store is enabled.
+     */
+    void updateTransforms();
+
+    /**
+     * Enables or disables the spatial index for this scene.
+     *
+     * When enabled, the bounds of the nodes in the scene that have a drawable
+     * or a light are kept in a bounding volume hierarchy, which is refit
+     * incrementally as nodes move. Culling then queries the index, for example
+     * with getSpatialIndex()->findNodes(camera->getFrustum(), nodes), instead of
+     * testing the bounds of every node in the scene.
+     *
+     * The index is disabled by default.
+     *
+     * @param enabled true to enable the spatial index, false to disable it.
+     *
+     * @see SpatialIndex
+     */
+    void setSpatialIndexEnabled(bool enabled);
+
+    /**
+     * Determines if the spatial index is enabled for this scene.
+     *
+     * @return true if the spatial index is enabled, false otherwise.
+     */
+    bool isSpatialIndexEnabled() const;
+
+    /**
+     * Gets the spatial index for this scene.
+     *
+     * @return The spatial index, or nullptr if it is not enabled.
+     * @script{ignore}
+     */
+    SpatialIndex* getSpatialIndex() const;
+
     /**
      * Updates all active nodes in the scene.
      *
@@ -307,11 +384,14 @@ namespace gameplay
     bool _bindAudioListenerToCamera;
     Node* _nextItr;
     bool _nextReset;
+    TransformStore* _transformStore;
+    SpatialIndex* _spatialIndex;
   };
 
   template <class T>
   void Scene::visit(T* instance, bool (T::* visitMethod)(Node*))
   {
+    updateTransforms();
     for (Node* node = getFirstNode(); node != nullptr; node = node->getNextSibling())
     {
       visitNode(node, instance, visitMethod);
@@ -321,6 +401,7 @@ namespace gameplay
   template <class T, class C>
   void Scene::visit(T* instance, bool (T::* visitMethod)(Node*, C), C cookie)
   {
+    updateTransforms();
     for (Node* node = getFirstNode(); node != nullptr; node = node->getNextSibling())
     {
       visitNode(node, instance, visitMethod, cookie);
@@ -329,6 +410,7 @@ namespace gameplay
 
   inline void Scene::visit(const char* visitMethod)
   {
+    updateTransforms();
     for (Node* node = getFirstNode(); node != nullptr; node = node->getNextSibling())
     {
       visitNode(node, visitMethod);
@@ -9,33 +9,43 @@
 #include "renderer/Text.h"
 #include "graphics/TileSet.h"
 #include "graphics/Light.h"
+#include "graphics/EffectManifest.h"
+#include "renderer/TextureDecoder.h"
 
 namespace gameplay
 {
 
   // Utility functions (shared with Properties).
   extern void calculateNamespacePath(const std::string& urlString, std::string& fileString, std::vector<std::string>& namespacePath);
-  extern Properties* getPropertiesFromNamespacePath(Properties* properties, const std::vector<std::string>& namespacePath);
+  extern Properties* getPropertiesFromNamespacePath(const Properties* properties, const std::vector<std::string>& namespacePath);
 
-  SceneLoader::SceneLoader() : _scene(nullptr)
+  SceneLoader::SceneLoader() : _scene(nullptr), _bundle(nullptr)
   {
   }
 
   Scene* SceneLoader::load(const char* url)
   {
     SceneLoader loader;
-    return loader.loadInternal(url);
+    return loader.loadInternal(url, nullptr);
   }
 
-  Scene* SceneLoader::loadInternal(const char* url)
+  Scene* SceneLoader::load(const char* url, Properties* properties, Bundle* bundle)
+  {
+    SceneLoader loader;
+    loader._bundle = bundle;
+    return loader.loadInternal(url, properties);
+  }
+
+  Scene* SceneLoader::loadInternal(const char* url, Properties* properties)
   {
     // Get the file part of the url that we are loading the scene from.
     std::string urlStr = url ? url : "";
     std::string id;
     splitURL(urlStr, &_path, &id);
 
-    // Load the scene properties from file.
-    Properties* properties = Properties::create(url);
+    // Load the scene properties from file, unless they were parsed ahead of time.
+    if (properties == nullptr)
+      properties = Properties::create(url);
     if (properties == nullptr)
     {
       GP_ERROR("Failed to load scene file '%s'.", url);
@@ -86,6 +96,13 @@ namespace gameplay
     // so that the transform (SRT) properties get applied before
     // processing physics collision objects.
     applyNodeUrls();
+
+    // Build the effects of all materials at once, keeping them loaded while the materials are created one node at a time.
+    std::unique_ptr<EffectManifest> effects(buildEffects());
+
+    // Likewise decode the textures of all materials concurrently before the materials look them up.
+    std::vector<Texture*> textures;
+    loadTextures(textures);
     applyNodeProperties(sceneProperties,
       SceneNodeProperty::AUDIO |
       SceneNodeProperty::MATERIAL |
@@ -102,6 +119,10 @@ namespace gameplay
       SceneNodeProperty::TEXT |
       SceneNodeProperty::ENABLED);
     applyNodeProperties(sceneProperties, SceneNodeProperty::COLLISION_OBJECT);
+    for (size_t i = 0, count = textures.size(); i < count; ++i)
+    {
+      SAFE_RELEASE(textures[i]);
+    }
 
     // Apply node tags
     for (size_t i = 0, sncount = _sceneNodes.size(); i < sncount; ++i)
@@ -912,8 +933,17 @@ namespace gameplay
   {
     assert(sceneProperties);
 
-    // Load the main scene from the specified path.
-    Bundle* bundle = Bundle::create(_gpbPath.c_str());
+    // Load the main scene from the specified path, reusing the bundle opened ahead of time if it matches.
+    Bundle* bundle = nullptr;
+    if (_bundle && _gpbPath == _bundle->_path)
+    {
+      bundle = _bundle;
+      bundle->addRef();
+    }
+    else
+    {
+      bundle = Bundle::create(_gpbPath.c_str());
+    }
     if (!bundle)
     {
       GP_WARN("Failed to load scene GPB file '%s'.", _gpbPath.c_str());
@@ -1041,6 +1071,114 @@ namespace gameplay
     }
   }
 
+  EffectManifest* SceneLoader::buildEffects()
+  {
+    EffectManifest* manifest = new EffectManifest();
+    for (size_t i = 0, count = _sceneNodes.size(); i < count; ++i)
+    {
+      addMaterialEffects(manifest, _sceneNodes[i]);
+    }
+    manifest->build(Game::getInstance()->getJobSystem());
+    return manifest;
+  }
+
+  void SceneLoader::addMaterialEffects(EffectManifest* manifest, const SceneNode& sceneNode)
+  {
+    assert(manifest);
+
+    for (size_t i = 0, count = sceneNode._properties.size(); i < count; ++i)
+    {
+      const SceneNodeProperty& snp = sceneNode._properties[i];
+      if (snp._type != SceneNodeProperty::MATERIAL)
+        continue;
+
+      // Pick the material namespace the same way applyNodeProperty() does; missing files are reported there.
+      std::map<std::string, Properties*>::const_iterator itr = _properties.find(snp._value);
+      Properties* p = itr != _properties.end() ? itr->second : nullptr;
+      if (!p)
+        continue;
+      p->rewind();
+      p = (strlen(p->getNamespace()) > 0) ? p : p->getNextNamespace();
+      if (p)
+        manifest->addMaterial(p);
+    }
+
+    for (size_t i = 0, count = sceneNode._children.size(); i < count; ++i)
+    {
+      addMaterialEffects(manifest, sceneNode._children[i]);
+    }
+  }
+
+  // Adds the paths of the PNG textures of the samplers in a material, technique or pass, and in the namespaces within it.
+  static void addSamplerPaths(Properties* properties, std::vector<std::string>* mipmapped, std::vector<std::string>* unmipmapped)
+  {
+    properties->rewind();
+    Properties* ns = nullptr;
+    while ((ns = properties->getNextNamespace()))
+    {
+      if (strcmp(ns->getNamespace(), "sampler") != 0)
+      {
+        addSamplerPaths(ns, mipmapped, unmipmapped);
+        continue;
+      }
+
+      std::string path;
+      if (!ns->getPath("path", &path))
+        continue;
+      const char* ext = strrchr(path.c_str(), '.');
+      if (!ext || strlen(ext) != 4 || tolower(ext[1]) != 'p' || tolower(ext[2]) != 'n' || tolower(ext[3]) != 'g')
+        continue;
+
+      std::vector<std::string>* paths = ns->getBool("mipmap") ? mipmapped : unmipmapped;
+      if (paths)
+        paths->push_back(path);
+    }
+    properties->rewind();
+  }
+
+  void SceneLoader::loadTextures(std::vector<Texture*>& textures)
+  {
+    // Mipmapped textures are left to the texture streamer when there is one.
+    std::vector<std::string> mipmapped;
+    std::vector<std::string> unmipmapped;
+    bool streamed = Game::getInstance()->getTextureStreamer() != nullptr;
+    for (size_t i = 0, count = _sceneNodes.size(); i < count; ++i)
+    {
+      addMaterialTextures(streamed ? nullptr : &mipmapped, &unmipmapped, _sceneNodes[i]);
+    }
+
+    JobSystem* jobSystem = Game::getInstance()->getJobSystem();
+    std::vector<Texture*> loaded;
+    TextureDecoder::load(jobSystem, mipmapped, true, loaded);
+    textures.insert(textures.end(), loaded.begin(), loaded.end());
+    TextureDecoder::load(jobSystem, unmipmapped, false, loaded);
+    textures.insert(textures.end(), loaded.begin(), loaded.end());
+  }
+
+  void SceneLoader::addMaterialTextures(std::vector<std::string>* mipmapped, std::vector<std::string>* unmipmapped, const SceneNode& sceneNode)
+  {
+    for (size_t i = 0, count = sceneNode._properties.size(); i < count; ++i)
+    {
+      const SceneNodeProperty& snp = sceneNode._properties[i];
+      if (snp._type != SceneNodeProperty::MATERIAL)
+        continue;
+
+      std::map<std::string, Properties*>::const_iterator itr = _properties.find(snp._value);
+      Properties* p = itr != _properties.end() ? itr->second : nullptr;
+      if (!p)
+        continue;
+      p->rewind();
+      p = (strlen(p->getNamespace()) > 0) ? p : p->getNextNamespace();
+      if (p)
+        addSamplerPaths(p, mipmapped, unmipmapped);
+    }
+
+    for (size_t i = 0, count = sceneNode._children.size(); i < count; ++i)
+    {
+      addMaterialTextures(mipmapped, unmipmapped, sceneNode._children[i]);
+    }
+  }
+
   void SceneLoader::loadReferencedFiles()
   {
     // Load all referenced properties files.
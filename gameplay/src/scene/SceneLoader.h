@@ -9,6 +9,9 @@
 namespace gameplay
 {
 
+  class Bundle;
+  class EffectManifest;
+
   /**
    * Defines an internal helper class for loading scenes from .scene files.
    *
@@ -17,6 +20,7 @@ namespace gameplay
   class SceneLoader
   {
     friend class Scene;
+    friend class AssetLoader;
 
   private:
 
@@ -29,6 +33,15 @@ namespace gameplay
      */
     static Scene* load(const char* url);
 
+    /**
+     * Loads a scene from a Properties object that has already been parsed from the specified URL.
+     *
+     * @param url The URL the properties were loaded from.
+     * @param properties The properties loaded from the URL. The loader takes ownership of them.
+     * @param bundle The main GPB for the scene if it was opened ahead of time, or nullptr.
+     */
+    static Scene* load(const char* url, Properties* properties, Bundle* bundle);
+
     /**
      * Helper structures and functions for SceneLoader::load(const char*).
      */
@@ -87,10 +100,14 @@ namespace gameplay
 
     SceneLoader();
 
-    Scene* loadInternal(const char* url);
+    Scene* loadInternal(const char* url, Properties* properties);
 
     void applyTags(SceneNode& sceneNode);
 
+    void addMaterialEffects(EffectManifest* manifest, const SceneNode& sceneNode);
+
+    void addMaterialTextures(std::vector<std::string>* mipmapped, std::vector<std::string>* unmipmapped, const SceneNode& sceneNode);
+
     void addSceneAnimation(const char* animationID, const char* targetID, const char* url);
 
     void addSceneNodeProperty(SceneNode& sceneNode, SceneNodeProperty::Type type, const char* value = nullptr, bool supportsUrl = false, int index = 0);
@@ -105,8 +122,12 @@ namespace gameplay
 
     void applyNodeUrls(SceneNode& sceneNode, Node* parent);
 
+    EffectManifest* buildEffects();
+
     void buildReferenceTables(Properties* sceneProperties);
 
+    void loadTextures(std::vector<Texture*>& textures);
+
     void parseNode(Properties* ns, SceneNode* parent, const std::string& path);
 
     void calculateNodesWithMeshRigidBodies(const Properties* sceneProperties);
@@ -140,6 +161,7 @@ namespace gameplay
     std::string _gpbPath;                                   // The path of the main GPB for the scene being loaded.
     std::string _path;                                      // The path of the scene file being loaded.
     Scene* _scene;                                          // The scene being loaded
+    Bundle* _bundle;                                        // The main GPB if it was opened ahead of time.
   };
 
   /**
@@ -0,0 +1,580 @@
+#include "framework/Base.h"
+#include "scene/SpatialIndex.h"
+#include "scene/Scene.h"
+#include "scene/Node.h"
+
+// Leaf boxes are enlarged by this fraction of the radius, so that small movements do not reinsert them.
+#define SPATIAL_INDEX_MARGIN 0.1f
+
+// All six frustum planes, as a mask of the planes that still need testing.
+#define SPATIAL_INDEX_ALL_PLANES 0x3F
+
+namespace gameplay
+{
+
+  static float getArea(const BoundingBox& box)
+  {
+    float x = box.max.x - box.min.x;
+    float y = box.max.y - box.min.y;
+    float z = box.max.z - box.min.z;
+    return 2.0f * (x * y + y * z + z * x);
+  }
+
+  static void merge(const BoundingBox& a, const BoundingBox& b, BoundingBox* dst)
+  {
+    dst->set(a);
+    dst->merge(b);
+  }
+
+  static bool contains(const BoundingBox& outer, const BoundingBox& inner)
+  {
+    return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+      outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+  }
+
+  SpatialIndex::SpatialIndex()
+    : _scene(nullptr), _root(-1), _freeList(-1), _nodeCount(0)
+  {
+  }
+
+  SpatialIndex::SpatialIndex(Scene* scene)
+    : _scene(scene), _root(-1), _freeList(-1), _nodeCount(0)
+  {
+  }
+
+  SpatialIndex::~SpatialIndex()
+  {
+  }
+
+  int SpatialIndex::insert(Node* node, const BoundingSphere& bounds)
+  {
+    int leaf = allocateEntry();
+    Entry& entry = _entries[leaf];
+    entry.node = node;
+    entry.bounds = bounds;
+    entry.box.set(bounds);
+    float margin = bounds.radius * SPATIAL_INDEX_MARGIN;
+    entry.box.min -= Vector3(margin, margin, margin);
+    entry.box.max += Vector3(margin, margin, margin);
+    insertLeaf(leaf);
+    ++_nodeCount;
+    return leaf;
+  }
+
+  void SpatialIndex::move(int proxy, const BoundingSphere& bounds)
+  {
+    assert(proxy >= 0 && (size_t)proxy < _entries.size() && _entries[proxy].height == 0);
+
+    Entry& entry = _entries[proxy];
+    entry.bounds = bounds;
+    BoundingBox box(bounds.center - Vector3(bounds.radius, bounds.radius, bounds.radius),
+      bounds.center + Vector3(bounds.radius, bounds.radius, bounds.radius));
+    if (contains(entry.box, box))
+      return;
+
+    removeLeaf(proxy);
+    float margin = bounds.radius * SPATIAL_INDEX_MARGIN;
+    box.min -= Vector3(margin, margin, margin);
+    box.max += Vector3(margin, margin, margin);
+    _entries[proxy].box = box;
+    insertLeaf(proxy);
+  }
+
+  void SpatialIndex::remove(int proxy)
+  {
+    assert(proxy >= 0 && (size_t)proxy < _entries.size() && _entries[proxy].height == 0);
+
+    removeLeaf(proxy);
+    freeEntry(proxy);
+    --_nodeCount;
+  }
+
+  void SpatialIndex::update()
+  {
+    // Deliver pending transform changes first, since they dirty nodes.
+    if (_scene)
+      _scene->updateTransforms();
+
+    // Nodes dirtied while refitting are appended and handled by this same loop.
+    for (size_t i = 0; i < _dirtyNodes.size(); ++i)
+    {
+      Node* node = _dirtyNodes[i];
+      if (node == nullptr)
+        continue;
+
+      node->_spatialDirtyIndex = -1;
+      if (node->getDrawable() || node->getLight())
+      {
+        const BoundingSphere& bounds = node->getBoundingSphere();
+        if (node->_spatialProxy < 0)
+          node->_spatialProxy = insert(node, bounds);
+        else
+          move(node->_spatialProxy, bounds);
+      }
+      else if (node->_spatialProxy >= 0)
+      {
+        remove(node->_spatialProxy);
+        node->_spatialProxy = -1;
+      }
+    }
+    _dirtyNodes.clear();
+  }
+
+  unsigned int SpatialIndex::getNodeCount() const
+  {
+    return _nodeCount;
+  }
+
+  unsigned int SpatialIndex::getHeight() const
+  {
+    return _root < 0 ? 0 : (unsigned int)_entries[_root].height + 1;
+  }
+
+  unsigned int SpatialIndex::findNodes(const Frustum& frustum, std::vector<Node*>& nodes)
+  {
+    update();
+
+    size_t count = nodes.size();
+    if (_root < 0)
+      return 0;
+
+    const Plane* planes[6] = { &frustum.getNear(), &frustum.getFar(), &frustum.getLeft(), &frustum.getRight(), &frustum.getBottom(), &frustum.getTop() };
+
+    // The stack holds pairs of an entry and the planes it still needs testing against.
+    _stack.clear();
+    _stack.push_back(_root);
+    _stack.push_back(SPATIAL_INDEX_ALL_PLANES);
+    while (!_stack.empty())
+    {
+      int mask = _stack.back();
+      _stack.pop_back();
+      int index = _stack.back();
+      _stack.pop_back();
+
+      // Planes that a branch is entirely in front of are not tested again below it.
+      const Entry& entry = _entries[index];
+      bool leaf = entry.height == 0;
+      bool outside = false;
+      for (int p = 0; p < 6 && !outside; ++p)
+      {
+        if (!(mask & (1 << p)))
+          continue;
+        float result = leaf ? entry.bounds.intersects(*planes[p]) : entry.box.intersects(*planes[p]);
+        if (result == Plane::INTERSECTS_BACK)
+          outside = true;
+        else if (result == Plane::INTERSECTS_FRONT)
+          mask &= ~(1 << p);
+      }
+      if (outside)
+        continue;
+
+      if (leaf)
+      {
+        nodes.push_back(entry.node);
+      }
+      else if (mask == 0)
+      {
+        addLeaves(index, nodes);
+      }
+      else
+      {
+        _stack.push_back(entry.child1);
+        _stack.push_back(mask);
+        _stack.push_back(entry.child2);
+        _stack.push_back(mask);
+      }
+    }
+    return (unsigned int)(nodes.size() - count);
+  }
+
+  unsigned int SpatialIndex::findNodes(const BoundingSphere& sphere, std::vector<Node*>& nodes)
+  {
+    update();
+
+    size_t count = nodes.size();
+    if (_root < 0)
+      return 0;
+
+    _stack.clear();
+    _stack.push_back(_root);
+    while (!_stack.empty())
+    {
+      const Entry& entry = _entries[_stack.back()];
+      _stack.pop_back();
+      if (entry.height == 0)
+      {
+        if (entry.bounds.intersects(sphere))
+          nodes.push_back(entry.node);
+      }
+      else if (entry.box.intersects(sphere))
+      {
+        _stack.push_back(entry.child1);
+        _stack.push_back(entry.child2);
+      }
+    }
+    return (unsigned int)(nodes.size() - count);
+  }
+
+  unsigned int SpatialIndex::findNodes(const BoundingBox& box, std::vector<Node*>& nodes)
+  {
+    update();
+
+    size_t count = nodes.size();
+    if (_root < 0)
+      return 0;
+
+    _stack.clear();
+    _stack.push_back(_root);
+    while (!_stack.empty())
+    {
+      const Entry& entry = _entries[_stack.back()];
+      _stack.pop_back();
+      if (entry.height == 0)
+      {
+        if (entry.bounds.intersects(box))
+          nodes.push_back(entry.node);
+      }
+      else if (entry.box.intersects(box))
+      {
+        _stack.push_back(entry.child1);
+        _stack.push_back(entry.child2);
+      }
+    }
+    return (unsigned int)(nodes.size() - count);
+  }
+
+  unsigned int SpatialIndex::findNodes(const Ray& ray, std::vector<Node*>& nodes, float maxDistance)
+  {
+    update();
+
+    size_t count = nodes.size();
+    if (_root < 0)
+      return 0;
+
+    _stack.clear();
+    _stack.push_back(_root);
+    while (!_stack.empty())
+    {
+      const Entry& entry = _entries[_stack.back()];
+      _stack.pop_back();
+      if (entry.height == 0)
+      {
+        // Spheres behind the origin of the ray report a negative distance.
+        float distance = entry.bounds.intersects(ray);
+        if (distance >= 0.0f && distance <= maxDistance)
+          nodes.push_back(entry.node);
+      }
+      else
+      {
+        // The distance is negative when the origin is inside the box.
+        float distance = entry.box.intersects(ray);
+        if (distance != Ray::INTERSECTS_NONE && distance <= maxDistance)
+        {
+          _stack.push_back(entry.child1);
+          _stack.push_back(entry.child2);
+        }
+      }
+    }
+    return (unsigned int)(nodes.size() - count);
+  }
+
+  void SpatialIndex::attach(Node* node)
+  {
+    assert(node);
+
+    node->_spatialIndex = this;
+    node->_spatialProxy = -1;
+    node->_spatialDirtyIndex = -1;
+    setDirty(node);
+    for (Node* child = node->getFirstChild(); child != nullptr; child = child->getNextSibling())
+    {
+      attach(child);
+    }
+  }
+
+  void SpatialIndex::detach(Node* node)
+  {
+    assert(node);
+
+    if (node->_spatialProxy >= 0)
+    {
+      remove(node->_spatialProxy);
+      node->_spatialProxy = -1;
+    }
+    if (node->_spatialDirtyIndex >= 0)
+    {
+      _dirtyNodes[node->_spatialDirtyIndex] = nullptr;
+      node->_spatialDirtyIndex = -1;
+    }
+    node->_spatialIndex = nullptr;
+    for (Node* child = node->getFirstChild(); child != nullptr; child = child->getNextSibling())
+    {
+      detach(child);
+    }
+  }
+
+  void SpatialIndex::setDirty(Node* node)
+  {
+    if (node->_spatialDirtyIndex < 0)
+    {
+      node->_spatialDirtyIndex = (int)_dirtyNodes.size();
+      _dirtyNodes.push_back(node);
+    }
+  }
+
+  int SpatialIndex::allocateEntry()
+  {
+    int index = _freeList;
+    if (index >= 0)
+    {
+      _freeList = _entries[index].parent;
+    }
+    else
+    {
+      index = (int)_entries.size();
+      _entries.push_back(Entry());
+    }
+    Entry& entry = _entries[index];
+    entry.node = nullptr;
+    entry.parent = -1;
+    entry.child1 = -1;
+    entry.child2 = -1;
+    entry.height = 0;
+    return index;
+  }
+
+  void SpatialIndex::freeEntry(int index)
+  {
+    Entry& entry = _entries[index];
+    entry.node = nullptr;
+    entry.parent = _freeList;
+    entry.height = -1;
+    _freeList = index;
+  }
+
+  void SpatialIndex::insertLeaf(int leaf)
+  {
+    if (_root < 0)
+    {
+      _root = leaf;
+      _entries[leaf].parent = -1;
+      return;
+    }
+
+    // Descend towards the sibling that grows the total surface area of the branches the least.
+    const BoundingBox leafBox = _entries[leaf].box;
+    BoundingBox combined;
+    int index = _root;
+    while (_entries[index].height > 0)
+    {
+      const Entry& entry = _entries[index];
+      float area = getArea(entry.box);
+      merge(entry.box, leafBox, &combined);
+      float combinedArea = getArea(combined);
+
+      // The cost of pairing the leaf with this branch, and the cost of pushing it further down.
+      float cost = 2.0f * combinedArea;
+      float inheritanceCost = 2.0f * (combinedArea - area);
+      float childCosts[2];
+      int children[2] = { entry.child1, entry.child2 };
+      for (int c = 0; c < 2; ++c)
+      {
+        const Entry& child = _entries[children[c]];
+        merge(child.box, leafBox, &combined);
+        childCosts[c] = getArea(combined) + inheritanceCost;
+        if (child.height > 0)
+          childCosts[c] -= getArea(child.box);
+      }
+      if (cost < childCosts[0] && cost < childCosts[1])
+        break;
+      index = childCosts[0] < childCosts[1] ? children[0] : children[1];
+    }
+
+    // Pair the leaf with the sibling under a new branch.
+    int sibling = index;
+    int oldParent = _entries[sibling].parent;
+    int newParent = allocateEntry();
+    Entry& branch = _entries[newParent];
+    branch.parent = oldParent;
+    merge(leafBox, _entries[sibling].box, &branch.box);
+    branch.height = _entries[sibling].height + 1;
+    branch.child1 = sibling;
+    branch.child2 = leaf;
+    _entries[sibling].parent = newParent;
+    _entries[leaf].parent = newParent;
+    if (oldParent >= 0)
+    {
+      if (_entries[oldParent].child1 == sibling)
+        _entries[oldParent].child1 = newParent;
+      else
+        _entries[oldParent].child2 = newParent;
+    }
+    else
+    {
+      _root = newParent;
+    }
+
+    refit(oldParent);
+  }
+
+  void SpatialIndex::removeLeaf(int leaf)
+  {
+    if (leaf == _root)
+    {
+      _root = -1;
+      return;
+    }
+
+    // Replace the parent of the leaf with the sibling of the leaf.
+    int parent = _entries[leaf].parent;
+    int grandParent = _entries[parent].parent;
+    int sibling = _entries[parent].child1 == leaf ? _entries[parent].child2 : _entries[parent].child1;
+    _entries[sibling].parent = grandParent;
+    if (grandParent >= 0)
+    {
+      if (_entries[grandParent].child1 == parent)
+        _entries[grandParent].child1 = sibling;
+      else
+        _entries[grandParent].child2 = sibling;
+    }
+    else
+    {
+      _root = sibling;
+    }
+    freeEntry(parent);
+    _entries[leaf].parent = -1;
+
+    refit(grandParent);
+  }
+
+  int SpatialIndex::balance(int indexA)
+  {
+    // Rotates the taller child of A up when the heights of its children differ by more than one.
+    Entry* a = &_entries[indexA];
+    if (a->height < 2)
+      return indexA;
+
+    int indexB = a->child1;
+    int indexC = a->child2;
+    Entry* b = &_entries[indexB];
+    Entry* c = &_entries[indexC];
+    int difference = c->height - b->height;
+    if (difference > 1)
+    {
+      // C takes the place of A, and A keeps the shorter child of C.
+      int indexF = c->child1;
+      int indexG = c->child2;
+      Entry* f = &_entries[indexF];
+      Entry* g = &_entries[indexG];
+      c->child1 = indexA;
+      c->parent = a->parent;
+      a->parent = indexC;
+      if (c->parent >= 0)
+      {
+        if (_entries[c->parent].child1 == indexA)
+          _entries[c->parent].child1 = indexC;
+        else
+          _entries[c->parent].child2 = indexC;
+      }
+      else
+      {
+        _root = indexC;
+      }
+
+      if (f->height > g->height)
+      {
+        c->child2 = indexF;
+        a->child2 = indexG;
+        g->parent = indexA;
+        merge(b->box, g->box, &a->box);
+        merge(a->box, f->box, &c->box);
+        a->height = 1 + std::max(b->height, g->height);
+        c->height = 1 + std::max(a->height, f->height);
+      }
+      else
+      {
+        c->child2 = indexG;
+        a->child2 = indexF;
+        f->parent = indexA;
+        merge(b->box, f->box, &a->box);
+        merge(a->box, g->box, &c->box);
+        a->height = 1 + std::max(b->height, f->height);
+        c->height = 1 + std::max(a->height, g->height);
+      }
+      return indexC;
+    }
+    if (difference < -1)
+    {
+      // B takes the place of A, and A keeps the shorter child of B.
+      int indexD = b->child1;
+      int indexE = b->child2;
+      Entry* d = &_entries[indexD];
+      Entry* e = &_entries[indexE];
+      b->child1 = indexA;
+      b->parent = a->parent;
+      a->parent = indexB;
+      if (b->parent >= 0)
+      {
+        if (_entries[b->parent].child1 == indexA)
+          _entries[b->parent].child1 = indexB;
+        else
+          _entries[b->parent].child2 = indexB;
+      }
+      else
+      {
+        _root = indexB;
+      }
+
+      if (d->height > e->height)
+      {
+        b->child2 = indexD;
+        a->child1 = indexE;
+        e->parent = indexA;
+        merge(c->box, e->box, &a->box);
+        merge(a->box, d->box, &b->box);
+        a->height = 1 + std::max(c->height, e->height);
+        b->height = 1 + std::max(a->height, d->height);
+      }
+      else
+      {
+        b->child2 = indexE;
+        a->child1 = indexD;
+        d->parent = indexA;
+        merge(c->box, d->box, &a->box);
+        merge(a->box, e->box, &b->box);
+        a->height = 1 + std::max(c->height, d->height);
+        b->height = 1 + std::max(a->height, e->height);
+      }
+      return indexB;
+    }
+    return indexA;
+  }
+
+  void SpatialIndex::refit(int index)
+  {
+    // Rebalance and refit the branches from the given one up to the root.
+    while (index >= 0)
+    {
+      index = balance(index);
+      Entry& entry = _entries[index];
+      const Entry& child1 = _entries[entry.child1];
+      const Entry& child2 = _entries[entry.child2];
+      entry.height = 1 + std::max(child1.height, child2.height);
+      merge(child1.box, child2.box, &entry.box);
+      index = entry.parent;
+    }
+  }
+
+  void SpatialIndex::addLeaves(int index, std::vector<Node*>& nodes)
+  {
+    const Entry& entry = _entries[index];
+    if (entry.height == 0)
+    {
+      nodes.push_back(entry.node);
+      return;
+    }
+    addLeaves(entry.child1, nodes);
+    addLeaves(entry.child2, nodes);
+  }
+
+}
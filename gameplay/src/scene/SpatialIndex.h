@@ -0,0 +1,216 @@
+#pragma once
+
+#include "graphics/BoundingBox.h"
+#include "graphics/BoundingSphere.h"
+#include "graphics/Frustum.h"
+#include "graphics/Ray.h"
+
+namespace gameplay
+{
+
+  class Node;
+  class Scene;
+
+  /**
+   * Defines a spatial index of node bounds, used to cull and query a scene
+   * without testing every node.
+   *
+   * The index is a dynamic bounding volume hierarchy: each indexed node is a
+   * leaf holding its bounding sphere inside a slightly enlarged box, and the
+   * branches are kept balanced by tree rotations as leaves are inserted and
+   * removed. Queries only descend into the branches whose boxes they touch,
+   * and frustum queries stop testing planes for branches that are entirely
+   * inside them, so their cost grows with the number of nodes found rather
+   * than with the size of the scene.
+   *
+   * A scene with its index enabled tracks the nodes of its hierarchy that
+   * have a drawable or a light. Changes are incremental: Node::setBoundsDirty()
+   * and transform changes flag a node, and the flagged nodes are refit before
+   * the next query. A leaf is only reinserted when its bounds leave its
+   * enlarged box, so small movements are cheap.
+   *
+   * The nodes found by a query are those whose Node::getBoundingSphere()
+   * intersects the query volume, the same as testing each node directly.
+   *
+   * An index created on its own is not attached to a scene, and holds what is
+   * inserted into it explicitly with insert(), move() and remove(). Those
+   * methods must not be used on the index of a scene.
+   *
+   * Joint hierarchies that are only referenced through a MeshSkin (and are not
+   * part of the scene hierarchy) are not indexed.
+   *
+   * @see Scene::setSpatialIndexEnabled
+   * @script{ignore}
+   */
+  class SpatialIndex
+  {
+    friend class Node;
+    friend class Scene;
+
+  public:
+
+    /**
+     * Constructor, for an index that is not attached to a scene.
+     */
+    SpatialIndex();
+
+    /**
+     * Destructor.
+     */
+    ~SpatialIndex();
+
+    /**
+     * Inserts a node with the given bounds.
+     *
+     * @param node The node, which the index does not dereference.
+     * @param bounds The bounds of the node.
+     *
+     * @return The proxy of the node, which identifies it in move() and remove().
+     */
+    int insert(Node* node, const BoundingSphere& bounds);
+
+    /**
+     * Updates the bounds of a node.
+     *
+     * @param proxy The proxy returned by insert().
+     * @param bounds The new bounds of the node.
+     */
+    void move(int proxy, const BoundingSphere& bounds);
+
+    /**
+     * Removes a node.
+     *
+     * @param proxy The proxy returned by insert().
+     */
+    void remove(int proxy);
+
+    /**
+     * Refits the nodes whose bounds changed since the last update. Called by every query.
+     */
+    void update();
+
+    /**
+     * Gets the number of indexed nodes.
+     *
+     * @return The number of indexed nodes.
+     */
+    unsigned int getNodeCount() const;
+
+    /**
+     * Gets the height of the hierarchy, which is 0 when empty and 1 for a single node.
+     *
+     * @return The height of the hierarchy.
+     */
+    unsigned int getHeight() const;
+
+    /**
+     * Finds the nodes whose bounds intersect a frustum.
+     *
+     * @param frustum The frustum.
+     * @param nodes The vector the nodes found are appended to.
+     *
+     * @return The number of nodes found.
+     */
+    unsigned int findNodes(const Frustum& frustum, std::vector<Node*>& nodes);
+
+    /**
+     * Finds the nodes whose bounds intersect a sphere.
+     *
+     * @param sphere The sphere.
+     * @param nodes The vector the nodes found are appended to.
+     *
+     * @return The number of nodes found.
+     */
+    unsigned int findNodes(const BoundingSphere& sphere, std::vector<Node*>& nodes);
+
+    /**
+     * Finds the nodes whose bounds intersect a box.
+     *
+     * @param box The box.
+     * @param nodes The vector the nodes found are appended to.
+     *
+     * @return The number of nodes found.
+     */
+    unsigned int findNodes(const BoundingBox& box, std::vector<Node*>& nodes);
+
+    /**
+     * Finds the nodes whose bounds a ray hits within a distance of its origin.
+     *
+     * @param ray The ray, with a normalized direction.
+     * @param nodes The vector the nodes found are appended to, in no particular order.
+     * @param maxDistance The distance along the ray beyond which hits are ignored.
+     *
+     * @return The number of nodes found.
+     */
+    unsigned int findNodes(const Ray& ray, std::vector<Node*>& nodes, float maxDistance = std::numeric_limits<float>::max());
+
+  private:
+
+    /**
+     * A leaf or a branch of the hierarchy. Free entries are linked through parent.
+     */
+    struct Entry
+    {
+      BoundingBox box;
+      BoundingSphere bounds;
+      Node* node;
+      int parent;
+      int child1;
+      int child2;
+      int height;
+    };
+
+    /**
+     * Constructor, for the index of a scene.
+     */
+    SpatialIndex(Scene* scene);
+
+    /**
+     * Hidden copy constructor.
+     */
+    SpatialIndex(const SpatialIndex& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    SpatialIndex& operator=(const SpatialIndex&);
+
+    /**
+     * Starts tracking the specified node and its subtree.
+     */
+    void attach(Node* node);
+
+    /**
+     * Stops tracking the specified node and its subtree, removing their leaves.
+     */
+    void detach(Node* node);
+
+    /**
+     * Flags a tracked node for refitting on the next update.
+     */
+    void setDirty(Node* node);
+
+    int allocateEntry();
+
+    void freeEntry(int index);
+
+    void insertLeaf(int leaf);
+
+    void removeLeaf(int leaf);
+
+    int balance(int index);
+
+    void refit(int index);
+
+    void addLeaves(int index, std::vector<Node*>& nodes);
+
+    Scene* _scene;
+    std::vector<Entry> _entries;
+    int _root;
+    int _freeList;
+    unsigned int _nodeCount;
+    std::vector<Node*> _dirtyNodes;
+    std::vector<int> _stack;
+  };
+
+}
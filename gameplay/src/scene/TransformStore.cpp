@@ -0,0 +1,228 @@
+#include "framework/Base.h"
+#include "scene/TransformStore.h"
+#include "scene/Scene.h"
+#include "scene/Node.h"
+
+// Transform store entry flags
+#define TRANSFORM_DIRTY 1
+#define TRANSFORM_NOTIFY 2
+#define TRANSFORM_STATIC 4
+#define TRANSFORM_IGNORE_PARENT 8
+
+namespace gameplay
+{
+
+  TransformStore::TransformStore(Scene* scene)
+    : _scene(scene), _firstDirty(UINT_MAX), _lastDirty(0), _updatedCount(0), _notifying(nullptr),
+    _dirty(false), _rebuild(true), _updating(false)
+  {
+  }
+
+  TransformStore::~TransformStore()
+  {
+  }
+
+  unsigned int TransformStore::getNodeCount() const
+  {
+    return (unsigned int)_nodes.size();
+  }
+
+  unsigned int TransformStore::getUpdatedCount() const
+  {
+    return _updatedCount;
+  }
+
+  void TransformStore::attach(Node* node)
+  {
+    assert(node);
+
+    node->_transformStore = this;
+    node->_transformIndex = -1;
+    for (Node* child = node->getFirstChild(); child != nullptr; child = child->getNextSibling())
+    {
+      attach(child);
+    }
+    _rebuild = true;
+  }
+
+  void TransformStore::detach(Node* node)
+  {
+    assert(node);
+
+    // Hand the resolved world matrix back to the node so that static nodes,
+    // which never recompute it lazily, keep a valid one.
+    int index = node->_transformIndex;
+    if (index >= 0 && (size_t)index < _nodes.size() && _nodes[index] == node)
+    {
+      node->_world = _world[index];
+    }
+    node->_transformStore = nullptr;
+    node->_transformIndex = -1;
+    for (Node* child = node->getFirstChild(); child != nullptr; child = child->getNextSibling())
+    {
+      detach(child);
+    }
+    _rebuild = true;
+  }
+
+  void TransformStore::setDirty(int index)
+  {
+    // A pending rebuild recomputes every entry anyway.
+    if (_rebuild || index < 0)
+      return;
+
+    assert((size_t)index < _flags.size());
+    _flags[index] |= TRANSFORM_DIRTY;
+    _firstDirty = std::min(_firstDirty, (unsigned int)index);
+    _lastDirty = std::max(_lastDirty, (unsigned int)index);
+    _dirty = true;
+  }
+
+  void TransformStore::rebuild()
+  {
+    std::vector<int> previous;
+    _nodes.clear();
+    _parents.clear();
+    for (Node* node = _scene->getFirstNode(); node != nullptr; node = node->getNextSibling())
+    {
+      addEntry(node, -1, previous);
+    }
+
+    // Entries are in pre-order, so a parent always precedes its children and
+    // subtree sizes can be accumulated in a single reverse pass.
+    size_t count = _nodes.size();
+    _subtreeSizes.assign(count, 1);
+    for (size_t i = count; i-- > 1;)
+    {
+      if (_parents[i] >= 0)
+        _subtreeSizes[_parents[i]] += _subtreeSizes[i];
+    }
+
+    // Static nodes never recompute their world matrix, so carry over whatever
+    // was resolved for them before (from the old arrays or from the node itself).
+    std::vector<Matrix> world(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+      int index = previous[i];
+      world[i] = (index >= 0 && (size_t)index < _world.size()) ? _world[index] : _nodes[i]->_world;
+    }
+    _world.swap(world);
+    _local.resize(count);
+
+    // Every entry needs its local matrix refreshed and its listeners notified
+    // since its place in the hierarchy may have changed.
+    _flags.assign(count, TRANSFORM_DIRTY | TRANSFORM_NOTIFY);
+    _firstDirty = 0;
+    _lastDirty = count ? (unsigned int)count - 1 : 0;
+    _dirty = count > 0;
+    _rebuild = false;
+  }
+
+  void TransformStore::addEntry(Node* node, int parent, std::vector<int>& previous)
+  {
+    assert(node);
+
+    int index = (int)_nodes.size();
+    previous.push_back(node->_transformStore == this ? node->_transformIndex : -1);
+    node->_transformStore = this;
+    node->_transformIndex = index;
+    _nodes.push_back(node);
+    _parents.push_back(parent);
+
+    for (Node* child = node->getFirstChild(); child != nullptr; child = child->getNextSibling())
+    {
+      addEntry(child, index, previous);
+    }
+  }
+
+  void TransformStore::update()
+  {
+    if (_updating)
+      return;
+
+    if (_rebuild)
+      rebuild();
+
+    if (!_dirty)
+      return;
+
+    _updating = true;
+    _updatedCount = 0;
+    while (_dirty && !_rebuild)
+    {
+      // Entries dirtied by listeners while this pass runs are handled by the next one.
+      _dirty = false;
+      unsigned int first = _firstDirty;
+      unsigned int last = std::min(_lastDirty, (unsigned int)_nodes.size() - 1);
+      _firstDirty = UINT_MAX;
+      _lastDirty = 0;
+
+      unsigned int i = first;
+      while (i <= last && !_rebuild)
+      {
+        if (!(_flags[i] & TRANSFORM_DIRTY))
+        {
+          ++i;
+          continue;
+        }
+
+        // The whole subtree of a dirty entry is a contiguous range that follows it.
+        unsigned int end = i + _subtreeSizes[i];
+        for (unsigned int j = i; j < end && !_rebuild; ++j)
+        {
+          updateEntry(j);
+        }
+        i = end;
+      }
+    }
+    _updating = false;
+
+    // A listener changed the hierarchy while we were notifying, so start over.
+    if (_rebuild)
+      update();
+  }
+
+  void TransformStore::updateEntry(unsigned int index)
+  {
+    unsigned char flags = _flags[index];
+    bool notify = (flags & TRANSFORM_NOTIFY) || !(flags & TRANSFORM_DIRTY);
+
+    if (flags & TRANSFORM_DIRTY)
+    {
+      // Only entries whose local transform changed touch their node here.
+      Node* node = _nodes[index];
+      _local[index] = node->getMatrix();
+      flags &= ~(TRANSFORM_STATIC | TRANSFORM_IGNORE_PARENT);
+      if (node->isStatic())
+        flags |= TRANSFORM_STATIC;
+      else if (node->_collisionObject && !node->_collisionObject->isKinematic())
+        flags |= TRANSFORM_IGNORE_PARENT;
+    }
+    _flags[index] = flags & ~(TRANSFORM_DIRTY | TRANSFORM_NOTIFY);
+
+    if (flags & TRANSFORM_STATIC)
+      return;
+
+    int parent = _parents[index];
+    if (parent >= 0 && !(flags & TRANSFORM_IGNORE_PARENT))
+    {
+      Matrix::multiply(_world[parent], _local[index], &_world[index]);
+    }
+    else
+    {
+      _world[index] = _local[index];
+    }
+    ++_updatedCount;
+
+    // Nodes that changed themselves were already notified when they were
+    // dirtied, the rest only inherited the change from an ancestor.
+    if (notify)
+    {
+      Node* node = _nodes[index];
+      _notifying = node;
+      node->transformChanged();
+      _notifying = nullptr;
+    }
+  }
+
+}
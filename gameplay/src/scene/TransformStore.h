@@ -0,0 +1,135 @@
+#pragma once
+
+#include "math/Matrix.h"
+
+namespace gameplay
+{
+
+  class Node;
+  class Scene;
+
+  /**
+   * Defines a flattened, scene-level store of node transforms.
+   *
+   * The store keeps the local and world matrices of every node in a scene
+   * hierarchy in contiguous arrays, sorted so that a parent always comes
+   * before its children (depth-first pre-order). Each node's subtree
+   * therefore occupies a contiguous range of the arrays.
+   *
+   * While a scene has a transform store enabled, changing the transform of a
+   * node only flags that node as dirty instead of recursively notifying its
+   * subtree. World matrices are then resolved in a single linear pass by
+   * update(), which only walks the subtree ranges below dirty nodes.
+   * Descendants whose world matrix changed are notified (Transform::Listener
+   * and script events) during that pass.
+   *
+   * Node::getWorldMatrix() reads from the store and triggers update() if
+   * there is pending work, so it remains API-compatible.
+   *
+   * Structural changes (adding or removing nodes) schedule a full rebuild on
+   * the next update, so the store is best suited for scenes whose hierarchy
+   * changes rarely compared to how often transforms are animated.
+   *
+   * Joint hierarchies that are only referenced through a MeshSkin (and are not
+   * part of the scene hierarchy) are not tracked by the store.
+   *
+   * @see Scene::setTransformStoreEnabled
+   */
+  class TransformStore
+  {
+    friend class Node;
+    friend class Scene;
+
+  public:
+
+    /**
+     * Resolves the world matrices of all dirty nodes and their descendants.
+     *
+     * This is a no-op if no node has changed since the last update.
+     */
+    void update();
+
+    /**
+     * Gets the number of nodes tracked by the store.
+     *
+     * @return The number of tracked nodes.
+     */
+    unsigned int getNodeCount() const;
+
+    /**
+     * Gets the number of world matrices that were recomputed by the last update.
+     *
+     * @return The number of recomputed world matrices.
+     */
+    unsigned int getUpdatedCount() const;
+
+  private:
+
+    /**
+     * Constructor.
+     */
+    TransformStore(Scene* scene);
+
+    /**
+     * Destructor.
+     */
+    ~TransformStore();
+
+    /**
+     * Hidden copy constructor.
+     */
+    TransformStore(const TransformStore& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    TransformStore& operator=(const TransformStore&);
+
+    /**
+     * Starts tracking the specified node and its subtree.
+     */
+    void attach(Node* node);
+
+    /**
+     * Stops tracking the specified node and its subtree.
+     */
+    void detach(Node* node);
+
+    /**
+     * Flags the entry at the specified index as locally dirty.
+     */
+    void setDirty(int index);
+
+    /**
+     * Re-sorts the arrays from the current scene hierarchy.
+     */
+    void rebuild();
+
+    /**
+     * Adds the specified node and its subtree to the sorted arrays, recording
+     * the index each node had before the rebuild.
+     */
+    void addEntry(Node* node, int parent, std::vector<int>& previous);
+
+    /**
+     * Recomputes the world matrix of a single entry.
+     */
+    void updateEntry(unsigned int index);
+
+    Scene* _scene;
+    std::vector<Node*> _nodes;
+    std::vector<int> _parents;
+    std::vector<unsigned int> _subtreeSizes;
+    std::vector<Matrix> _local;
+    std::vector<Matrix> _world;
+    std::vector<unsigned char> _flags;
+    unsigned int _firstDirty;
+    unsigned int _lastDirty;
+    unsigned int _updatedCount;
+    const Node* _notifying;
+    bool _dirty;
+    bool _rebuild;
+    bool _updating;
+  };
+
+}
@@ -65,6 +65,13 @@ namespace gameplay
   RefAllocationRecord* __refAllocations = 0;
   int __refAllocationCount = 0;
 
+  // Refs may be created and destroyed on the asset loader's threads.
+  static std::mutex& getRefAllocationMutex()
+  {
+    static std::mutex m;
+    return m;
+  }
+
   void Ref::printLeaks()
   {
     // Dump Ref object memory leaks
@@ -95,6 +102,7 @@ namespace gameplay
     rec->next = __refAllocations;
     rec->prev = 0;
 
+    std::lock_guard<std::mutex> lock(getRefAllocationMutex());
     if (__refAllocations)
       __refAllocations->prev = rec;
     __refAllocations = rec;
@@ -119,6 +127,7 @@ namespace gameplay
     }
 
     // Link this item out.
+    std::lock_guard<std::mutex> lock(getRefAllocationMutex());
     if (__refAllocations == rec)
       __refAllocations = rec->next;
     if (rec->prev)
@@ -0,0 +1,39 @@
+#include "framework/Base.h"
+#include "utils/ResourceRegistry.h"
+
+namespace gameplay
+{
+
+  // Function-local so that caches defined as statics in other files can register during static initialization.
+  static std::vector<ResourceRegistry*>& getRegistryList()
+  {
+    static std::vector<ResourceRegistry*> registries;
+    return registries;
+  }
+
+  ResourceRegistry::ResourceRegistry(const char* name)
+    : _name(name), _count(0), _hitCount(0), _missCount(0), _memoryUsage(0)
+  {
+    getRegistryList().push_back(this);
+  }
+
+  ResourceRegistry::~ResourceRegistry()
+  {
+    std::vector<ResourceRegistry*>& registries = getRegistryList();
+    std::vector<ResourceRegistry*>::iterator itr = std::find(registries.begin(), registries.end(), this);
+    if (itr != registries.end())
+      registries.erase(itr);
+  }
+
+  const std::vector<ResourceRegistry*>& ResourceRegistry::getRegistries()
+  {
+    return getRegistryList();
+  }
+
+  void ResourceRegistry::resetCounters()
+  {
+    _hitCount = 0;
+    _missCount = 0;
+  }
+
+}
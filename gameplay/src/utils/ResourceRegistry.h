@@ -0,0 +1,173 @@
+#pragma once
+
+namespace gameplay
+{
+
+  /**
+   * Defines the statistics common to every resource cache.
+   *
+   * Each cache registers itself on construction, so all caches can be listed
+   * with getRegistries() to report their hit rates and memory usage.
+   *
+   * @see ResourceCache
+   * @script{ignore}
+   */
+  class ResourceRegistry
+  {
+  public:
+
+    /**
+     * Gets all the resource caches that currently exist.
+     *
+     * @return The resource caches.
+     */
+    static const std::vector<ResourceRegistry*>& getRegistries();
+
+    /**
+     * Gets the name of the cache.
+     *
+     * @return The name of the cache.
+     */
+    const char* getName() const;
+
+    /**
+     * Gets the number of resources in the cache.
+     *
+     * @return The number of cached resources.
+     */
+    unsigned int getCount() const;
+
+    /**
+     * Gets the number of lookups that found a resource.
+     *
+     * @return The number of cache hits.
+     */
+    unsigned int getHitCount() const;
+
+    /**
+     * Gets the number of lookups that did not find a resource.
+     *
+     * @return The number of cache misses.
+     */
+    unsigned int getMissCount() const;
+
+    /**
+     * Gets the approximate number of bytes used by the cached resources.
+     *
+     * @return The memory used by the cached resources.
+     */
+    size_t getMemoryUsage() const;
+
+    /**
+     * Resets the hit and miss counts to zero.
+     */
+    void resetCounters();
+
+  protected:
+
+    /**
+     * Constructor.
+     *
+     * @param name The name of the cache.
+     */
+    ResourceRegistry(const char* name);
+
+    /**
+     * Destructor.
+     */
+    virtual ~ResourceRegistry();
+
+    const char* _name;
+    unsigned int _count;
+    unsigned int _hitCount;
+    unsigned int _missCount;
+    size_t _memoryUsage;
+
+  private:
+
+    /**
+     * Hidden copy constructor.
+     */
+    ResourceRegistry(const ResourceRegistry& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    ResourceRegistry& operator=(const ResourceRegistry&);
+  };
+
+  /**
+   * Defines a cache of resources indexed by path.
+   *
+   * Lookups are hashed, so finding a resource takes constant time no matter
+   * how many resources are cached. The cache does not own its resources or
+   * hold references to them; resources remove themselves when destroyed.
+   *
+   * @script{ignore}
+   */
+  template <class T>
+  class ResourceCache : public ResourceRegistry
+  {
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param name The name of the cache.
+     */
+    ResourceCache(const char* name);
+
+    /**
+     * Finds the resource cached under the given path, counting a hit or miss.
+     *
+     * @param path The path of the resource.
+     * @return The resource, or nullptr if none is cached under the path.
+     */
+    T* find(const std::string& path);
+
+    /**
+     * Adds a resource to the cache, replacing any resource cached under the same path.
+     *
+     * @param path The path of the resource.
+     * @param resource The resource.
+     * @param memoryUsage The approximate number of bytes used by the resource.
+     */
+    void add(const std::string& path, T* resource, size_t memoryUsage);
+
+    /**
+     * Removes a resource from the cache. Nothing happens if a different resource is cached under the path.
+     *
+     * @param path The path of the resource.
+     * @param resource The resource.
+     */
+    void remove(const std::string& path, const T* resource);
+
+    /**
+     * Removes the resource cached under the given path, without counting a hit or miss.
+     *
+     * @param path The path of the resource.
+     * @return The removed resource, or nullptr if none was cached under the path.
+     */
+    T* remove(const std::string& path);
+
+    /**
+     * Removes every resource from the cache.
+     *
+     * @param resources If not nullptr, receives the removed resources.
+     */
+    void clear(std::vector<T*>* resources = nullptr);
+
+  private:
+
+    struct Entry
+    {
+      T* resource;
+      size_t memoryUsage;
+    };
+
+    std::unordered_map<std::string, Entry> _entries;
+  };
+
+}
+
+#include "ResourceRegistry.inl"
@@ -0,0 +1,101 @@
+#include "utils/ResourceRegistry.h"
+
+namespace gameplay
+{
+
+  inline const char* ResourceRegistry::getName() const
+  {
+    return _name;
+  }
+
+  inline unsigned int ResourceRegistry::getCount() const
+  {
+    return _count;
+  }
+
+  inline unsigned int ResourceRegistry::getHitCount() const
+  {
+    return _hitCount;
+  }
+
+  inline unsigned int ResourceRegistry::getMissCount() const
+  {
+    return _missCount;
+  }
+
+  inline size_t ResourceRegistry::getMemoryUsage() const
+  {
+    return _memoryUsage;
+  }
+
+  template <class T>
+  ResourceCache<T>::ResourceCache(const char* name)
+    : ResourceRegistry(name)
+  {
+  }
+
+  template <class T>
+  T* ResourceCache<T>::find(const std::string& path)
+  {
+    typename std::unordered_map<std::string, Entry>::const_iterator itr = _entries.find(path);
+    if (itr == _entries.end())
+    {
+      ++_missCount;
+      return nullptr;
+    }
+    ++_hitCount;
+    return itr->second.resource;
+  }
+
+  template <class T>
+  void ResourceCache<T>::add(const std::string& path, T* resource, size_t memoryUsage)
+  {
+    assert(resource);
+
+    Entry& entry = _entries[path];
+    if (entry.resource)
+      _memoryUsage -= entry.memoryUsage;
+    entry.resource = resource;
+    entry.memoryUsage = memoryUsage;
+    _memoryUsage += memoryUsage;
+    _count = (unsigned int)_entries.size();
+  }
+
+  template <class T>
+  void ResourceCache<T>::remove(const std::string& path, const T* resource)
+  {
+    typename std::unordered_map<std::string, Entry>::iterator itr = _entries.find(path);
+    if (itr == _entries.end() || itr->second.resource != resource)
+      return;
+    _memoryUsage -= itr->second.memoryUsage;
+    _entries.erase(itr);
+    _count = (unsigned int)_entries.size();
+  }
+
+  template <class T>
+  T* ResourceCache<T>::remove(const std::string& path)
+  {
+    typename std::unordered_map<std::string, Entry>::iterator itr = _entries.find(path);
+    if (itr == _entries.end())
+      return nullptr;
+    T* resource = itr->second.resource;
+    _memoryUsage -= itr->second.memoryUsage;
+    _entries.erase(itr);
+    _count = (unsigned int)_entries.size();
+    return resource;
+  }
+
+  template <class T>
+  void ResourceCache<T>::clear(std::vector<T*>* resources)
+  {
+    if (resources)
+    {
+      for (typename std::unordered_map<std::string, Entry>::const_iterator itr = _entries.begin(); itr != _entries.end(); ++itr)
+        resources->push_back(itr->second.resource);
+    }
+    _entries.clear();
+    _memoryUsage = 0;
+    _count = 0;
+  }
+
+}
@@ -1,12 +1,21 @@
 #include "Base.h"
 #include "AnimationChannel.h"
 #include "Transform.h"
+#include "Quaternion.h"
 
 namespace gameplay
 {
 
+// Animation channel key formats, written since version BUNDLE_VERSION_MINOR_ANIMATION_KEY_FORMAT
+#define KEYS_RAW 0
+#define KEYS_COMPRESSED 1
+#define NO_QUATERNION 0xFFFFFFFF
+
+// Scale of the three smallest quaternion components, which lie in [-1/sqrt(2), 1/sqrt(2)]
+#define QUATERNION_RANGE 0.707106781186547524401f
+
 AnimationChannel::AnimationChannel(void) :
-    _targetAttrib(0)
+    _targetAttrib(0), _compressed(false)
 {
 }
 
@@ -28,6 +37,13 @@ void AnimationChannel::writeBinary(FILE* file)
     Object::writeBinary(file);
     write(_targetId, file);
     write(_targetAttrib, file);
+    if (_compressed)
+    {
+        write((unsigned int)KEYS_COMPRESSED, file);
+        writeCompressedBinary(file);
+        return;
+    }
+    write((unsigned int)KEYS_RAW, file);
     write((unsigned int)_keytimes.size(), file);
     for (std::vector<float>::const_iterator i = _keytimes.begin(); i != _keytimes.end(); ++i)
     {
@@ -49,6 +65,10 @@ void AnimationChannel::writeText(FILE* file)
     fprintfElement(file, "%f ", "tangentsIn", _tangentsIn);
     fprintfElement(file, "%f ", "tangentsOut", _tangentsOut);
     fprintfElement(file, "%u ", "interpolations", _interpolations);
+    if (_compressed)
+    {
+        fprintfElement(file, "compressed", "true");
+    }
     fprintElementEnd(file);
 }
 
@@ -245,4 +265,231 @@ void AnimationChannel::deleteRange(size_t begin, size_t end, size_t propSize)
     // TODO: also remove key frames from _tangentsIn and _tangentsOut once other curve types are supported.
 }
 
+void AnimationChannel::reduceKeys(float tolerance, float rotationTolerance)
+{
+    const size_t keyCount = _keytimes.size();
+    const size_t propSize = Transform::getPropertySize(_targetAttrib);
+    if (keyCount < 3 || propSize == 0 || !isLinear() || _keyValues.size() != keyCount * propSize)
+    {
+        return;
+    }
+
+    // The allowed error of each component.
+    std::vector<float> tolerances(propSize);
+    const int quaternionOffset = getQuaternionOffset();
+    for (size_t c = 0; c < propSize; ++c)
+    {
+        if (quaternionOffset >= 0 && c >= (size_t)quaternionOffset && c < (size_t)quaternionOffset + 4)
+        {
+            tolerances[c] = rotationTolerance;
+        }
+        else
+        {
+            float minValue = _keyValues[c];
+            float maxValue = minValue;
+            for (size_t i = 1; i < keyCount; ++i)
+            {
+                minValue = std::min(minValue, _keyValues[i * propSize + c]);
+                maxValue = std::max(maxValue, _keyValues[i * propSize + c]);
+            }
+            tolerances[c] = (maxValue - minValue) * tolerance;
+        }
+    }
+
+    // Extend each interpolated span for as long as the key frames it covers stay within tolerance.
+    std::vector<bool> keep(keyCount, false);
+    keep[0] = true;
+    keep[keyCount - 1] = true;
+    size_t begin = 0;
+    for (size_t end = 2; end < keyCount; ++end)
+    {
+        if (!canInterpolate(begin, end, tolerances))
+        {
+            begin = end - 1;
+            keep[begin] = true;
+        }
+    }
+
+    std::vector<float> keyTimes;
+    std::vector<float> keyValues;
+    std::vector<unsigned int> interpolations;
+    for (size_t i = 0; i < keyCount; ++i)
+    {
+        if (keep[i])
+        {
+            keyTimes.push_back(_keytimes[i]);
+            keyValues.insert(keyValues.end(), _keyValues.begin() + i * propSize, _keyValues.begin() + (i + 1) * propSize);
+            if (_interpolations.size() == keyCount)
+            {
+                interpolations.push_back(_interpolations[i]);
+            }
+        }
+    }
+    LOG(3, "      Reduced key frames from %lu to %lu.\n", keyCount, keyTimes.size());
+
+    _keytimes.swap(keyTimes);
+    _keyValues.swap(keyValues);
+    if (_interpolations.size() == keyCount)
+    {
+        _interpolations.swap(interpolations);
+    }
+}
+
+void AnimationChannel::setCompressed(bool compressed)
+{
+    _compressed = compressed && isLinear() && !_keytimes.empty() &&
+        _keyValues.size() == _keytimes.size() * Transform::getPropertySize(_targetAttrib);
+}
+
+bool AnimationChannel::isCompressed() const
+{
+    return _compressed;
+}
+
+bool AnimationChannel::isLinear() const
+{
+    for (std::vector<unsigned int>::const_iterator i = _interpolations.begin(); i != _interpolations.end(); ++i)
+    {
+        if (*i != LINEAR)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int AnimationChannel::getQuaternionOffset() const
+{
+    switch (_targetAttrib)
+    {
+    case Transform::ANIMATE_ROTATE:
+    case Transform::ANIMATE_ROTATE_TRANSLATE:
+        return 0;
+    case Transform::ANIMATE_SCALE_ROTATE:
+    case Transform::ANIMATE_SCALE_ROTATE_TRANSLATE:
+        return 3;
+    default:
+        return -1;
+    }
+}
+
+bool AnimationChannel::canInterpolate(size_t begin, size_t end, const std::vector<float>& tolerances) const
+{
+    const size_t propSize = tolerances.size();
+    const int quaternionOffset = getQuaternionOffset();
+    const float* from = &_keyValues[begin * propSize];
+    const float* to = &_keyValues[end * propSize];
+    const float duration = _keytimes[end] - _keytimes[begin];
+
+    for (size_t i = begin + 1; i < end; ++i)
+    {
+        const float t = duration > 0.0f ? (_keytimes[i] - _keytimes[begin]) / duration : 0.0f;
+        const float* value = &_keyValues[i * propSize];
+        for (size_t c = 0; c < propSize; ++c)
+        {
+            if ((int)c == quaternionOffset)
+            {
+                Quaternion q;
+                Quaternion::slerp(Quaternion(from[c], from[c + 1], from[c + 2], from[c + 3]),
+                    Quaternion(to[c], to[c + 1], to[c + 2], to[c + 3]), t, &q);
+
+                // q and -q are the same rotation.
+                float sign = q.x * value[c] + q.y * value[c + 1] + q.z * value[c + 2] + q.w * value[c + 3] < 0.0f ? -1.0f : 1.0f;
+                if (fabs(q.x * sign - value[c]) > tolerances[c] || fabs(q.y * sign - value[c + 1]) > tolerances[c + 1] ||
+                    fabs(q.z * sign - value[c + 2]) > tolerances[c + 2] || fabs(q.w * sign - value[c + 3]) > tolerances[c + 3])
+                {
+                    return false;
+                }
+                c += 3;
+            }
+            else if (fabs(from[c] + (to[c] - from[c]) * t - value[c]) > tolerances[c])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void AnimationChannel::writeCompressedBinary(FILE* file)
+{
+    const size_t keyCount = _keytimes.size();
+    const size_t propSize = Transform::getPropertySize(_targetAttrib);
+    const int quaternionOffset = getQuaternionOffset();
+
+    write((unsigned int)keyCount, file);
+    for (std::vector<float>::const_iterator i = _keytimes.begin(); i != _keytimes.end(); ++i)
+    {
+        write((unsigned int)*i, file);
+    }
+    write(quaternionOffset < 0 ? (unsigned int)NO_QUATERNION : (unsigned int)quaternionOffset, file);
+
+    // The minimum and extent of each scalar component.
+    std::vector<float> ranges(propSize * 2, 0.0f);
+    for (size_t c = 0; c < propSize; ++c)
+    {
+        if (quaternionOffset >= 0 && c >= (size_t)quaternionOffset && c < (size_t)quaternionOffset + 4)
+        {
+            continue;
+        }
+        float minValue = _keyValues[c];
+        float maxValue = minValue;
+        for (size_t i = 1; i < keyCount; ++i)
+        {
+            minValue = std::min(minValue, _keyValues[i * propSize + c]);
+            maxValue = std::max(maxValue, _keyValues[i * propSize + c]);
+        }
+        ranges[c * 2] = minValue;
+        ranges[c * 2 + 1] = maxValue - minValue;
+    }
+    write(ranges, file);
+
+    // Scalars are quantized to 16 bits relative to their range. Quaternions are stored as the
+    // index of their largest component followed by the other three in 15 bits each.
+    std::vector<unsigned short> values;
+    values.reserve(keyCount * propSize);
+    for (size_t i = 0; i < keyCount; ++i)
+    {
+        const float* value = &_keyValues[i * propSize];
+        for (size_t c = 0; c < propSize; ++c)
+        {
+            if ((int)c == quaternionOffset)
+            {
+                Quaternion q(value[c], value[c + 1], value[c + 2], value[c + 3]);
+                q.normalize();
+                float components[4] = { q.x, q.y, q.z, q.w };
+                unsigned int largest = 0;
+                for (unsigned int j = 1; j < 4; ++j)
+                {
+                    if (fabs(components[j]) > fabs(components[largest]))
+                        largest = j;
+                }
+                const float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+                unsigned long long bits = largest;
+                unsigned int shift = 2;
+                for (unsigned int j = 0; j < 4; ++j)
+                {
+                    if (j == largest)
+                        continue;
+                    float v = (components[j] * sign + QUATERNION_RANGE) * (32767.0f / (2.0f * QUATERNION_RANGE));
+                    v = std::max(0.0f, std::min(v, 32767.0f));
+                    bits |= (unsigned long long)(v + 0.5f) << shift;
+                    shift += 15;
+                }
+                values.push_back((unsigned short)bits);
+                values.push_back((unsigned short)(bits >> 16));
+                values.push_back((unsigned short)(bits >> 32));
+                c += 3;
+            }
+            else
+            {
+                const float extent = ranges[c * 2 + 1];
+                const float v = extent > 0.0f ? (value[c] - ranges[c * 2]) / extent * 65535.0f : 0.0f;
+                values.push_back((unsigned short)(v + 0.5f));
+            }
+        }
+    }
+    write(values, file);
+}
+
 }
@@ -65,6 +65,28 @@ public:
      */
     void removeDuplicates();
 
+    /**
+     * Removes the key frames of a linearly interpolated channel that can be
+     * rebuilt by interpolating between the remaining key frames.
+     * 
+     * @param tolerance The largest error allowed for scalar values, relative to the range of each value.
+     * @param rotationTolerance The largest error allowed for each quaternion component.
+     */
+    void reduceKeys(float tolerance, float rotationTolerance);
+
+    /**
+     * Sets whether the key values are written quantized.
+     * Only linearly interpolated channels can be compressed.
+     * 
+     * @param compressed True to write compressed key values.
+     */
+    void setCompressed(bool compressed);
+
+    /**
+     * Returns true if the key values are written quantized.
+     */
+    bool isCompressed() const;
+
     /**
      * Returns the interpolation type value for the given string or zero if not valid.
      * Example: "LINEAR" returns AnimationChannel::LINEAR
@@ -86,6 +108,27 @@ private:
      */
     void deleteRange(size_t begin, size_t end, size_t propSize);
 
+    /**
+     * Returns true if every key frame of the channel is linearly interpolated.
+     */
+    bool isLinear() const;
+
+    /**
+     * Returns the index of the quaternion within the key values, or -1 if there is none.
+     */
+    int getQuaternionOffset() const;
+
+    /**
+     * Returns true if the key frames between begin and end (exclusive) can be rebuilt
+     * by interpolating between begin and end within the given tolerances.
+     */
+    bool canInterpolate(size_t begin, size_t end, const std::vector<float>& tolerances) const;
+
+    /**
+     * Writes the key values quantized, in the format read by Curve::createPacked().
+     */
+    void writeCompressedBinary(FILE* file);
+
 private:
 
     std::string _targetId;
@@ -95,6 +138,7 @@ private:
     std::vector<float> _tangentsIn;
     std::vector<float> _tangentsOut;
     std::vector<unsigned int> _interpolations;
+    bool _compressed;
 };
 
 }
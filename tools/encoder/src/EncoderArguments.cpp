@@ -275,7 +275,9 @@ void EncoderArguments::printUsage() const
         "\t\tOptimizes animations by analyzing animation channel data and\n" \
         "\t\tremoving any channels that contain default/identity values\n" \
         "\t\tand removing any duplicate contiguous keyframes, which are \n" \
-        "\t\tcommon when exporting baked animation data.\n" \
+        "\t\tcommon when exporting baked animation data. Key frames that\n" \
+        "\t\tinterpolation rebuilds within tolerance are removed and the\n" \
+        "\t\tremaining key values are quantized to 16 bits.\n" \
     "  -h <size> \"<node ids>\" <filename>\n" \
         "\t\tGenerates a single heightmap image using meshes from the \n" \
         "\t\tspecified nodes. \n" \
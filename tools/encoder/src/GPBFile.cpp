@@ -7,6 +7,11 @@
 
 #define EPSILON 1.2e-7f;
 
+// The largest error allowed when removing animation key frames, relative to the
+// range of each value, and per component for rotations.
+#define ANIMATION_KEY_TOLERANCE 0.0005f
+#define ANIMATION_ROTATION_KEY_TOLERANCE 0.0005f
+
 namespace gameplay
 {
 
@@ -429,6 +434,14 @@ void GPBFile::optimizeAnimations()
                 }
             }
         }
+
+        // Drop the key frames that linear interpolation rebuilds and quantize the rest.
+        for (unsigned int channelIndex = 0; channelIndex < animation->getAnimationChannelCount(); ++channelIndex)
+        {
+            AnimationChannel* channel = animation->getAnimationChannel(channelIndex);
+            channel->reduceKeys(ANIMATION_KEY_TOLERANCE, ANIMATION_ROTATION_KEY_TOLERANCE);
+            channel->setCompressed(true);
+        }
     }
 }
 
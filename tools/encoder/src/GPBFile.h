@@ -14,6 +14,10 @@
 #include "Animation.h"
 #include "AnimationChannel.h"
 
+// Version numbers that added features, which must match the ones the runtime reads (see Bundle.cpp)
+#define BUNDLE_VERSION_MAJOR_ANIMATION_KEY_FORMAT  1
+#define BUNDLE_VERSION_MINOR_ANIMATION_KEY_FORMAT  6
+
 namespace gameplay
 {
 
@@ -21,7 +25,7 @@ namespace gameplay
  * Increment the version number when making a change that break binary compatibility.
  * [0] is major, [1] is minor.
  */
-const unsigned char GPB_VERSION[2] = {1, 5};
+const unsigned char GPB_VERSION[2] = {BUNDLE_VERSION_MAJOR_ANIMATION_KEY_FORMAT, BUNDLE_VERSION_MINOR_ANIMATION_KEY_FORMAT};
 
 /**
  * The GamePlay Binary file class handles writing the GamePlay Binary file.